@@ -21,10 +21,12 @@ Cinfo::Cinfo( const string& name,
 				DinfoBase* d,
 				const string* doc,
 				unsigned int numDoc,
-				bool banCreation
+				bool banCreation,
+				ConcurrencyCheck concurrencyCheck
 )
 		: name_( name ), baseCinfo_( baseCinfo ), dinfo_( d ),
-			numBindIndex_( 0 ), banCreation_( banCreation )
+			numBindIndex_( 0 ), banCreation_( banCreation ),
+			concurrencyCheck_( concurrencyCheck )
 {
 	if ( cinfoMap().find( name ) != cinfoMap().end() ) {
 		cout << "Warning: Duplicate Cinfo name " << name << endl;
@@ -49,12 +51,14 @@ Cinfo::Cinfo( const string& name,
 
 Cinfo::Cinfo()
 		: name_( "dummy" ), baseCinfo_( 0 ), dinfo_( 0 ),
-			numBindIndex_( 0 ), banCreation_( false )
+			numBindIndex_( 0 ), banCreation_( false ),
+			concurrencyCheck_( 0 )
 {;}
 
 Cinfo::Cinfo( const Cinfo& other )
 		: name_( "dummy" ), baseCinfo_( 0 ), dinfo_( 0 ),
-			numBindIndex_( 0 ), banCreation_( false )
+			numBindIndex_( 0 ), banCreation_( false ),
+			concurrencyCheck_( 0 )
 {;}
 
 /*
@@ -234,6 +238,11 @@ bool Cinfo::banCreation() const
 	return banCreation_;
 }
 
+bool Cinfo::isConcurrent( const Eref& e ) const
+{
+	return ( concurrencyCheck_ != 0 && concurrencyCheck_( e ) );
+}
+
 /**
  * looks up OpFunc by FuncId
  */
@@ -552,18 +561,26 @@ void Cinfo::setNumFinfo( unsigned int val ) // Dummy function
 const string& Cinfo::srcFinfoName( BindIndex bid ) const
 {
 	static const string err = "";
+	const SrcFinfo* sf = findSrcFinfo( bid );
+	if ( sf )
+		return sf->name();
+	cout << "Error: Cinfo::srcFinfoName( " << bid << " ): not found\n";
+	return err;
+}
+
+const SrcFinfo* Cinfo::findSrcFinfo( BindIndex bid ) const
+{
 	for ( vector< Finfo* >::const_iterator i = srcFinfos_.begin(); 
 		i != srcFinfos_.end(); ++i ) {
 		const SrcFinfo* sf = dynamic_cast< const SrcFinfo* >( *i );
 		assert( sf );
 		if ( sf->getBindIndex() == bid ) {
-			return sf->name();
+			return sf;
 		}
 	}
 	if ( baseCinfo_ )
-		return baseCinfo_->srcFinfoName( bid );
-	cout << "Error: Cinfo::srcFinfoName( " << bid << " ): not found\n";
-	return err;
+		return baseCinfo_->findSrcFinfo( bid );
+	return 0;
 }
 
 const string& Cinfo::destFinfoName( FuncId fid ) const
@@ -11,6 +11,17 @@
 #define _CINFO_H
 
 class DinfoBase;
+class Eref;
+
+/**
+ * A class may supply a function of this type to its Cinfo to declare
+ * that the process and reinit calls of the object on the Eref only 
+ * touch the object's own data, so that they can be run at the same 
+ * time as those of other such objects from a different thread.
+ * It is a per-object check because a solver that is self-contained in
+ * one model may send or fetch data from other objects in another.
+ */
+typedef bool ( *ConcurrencyCheck )( const Eref& e );
 
 /**
  * Class to manage class information for all the other classes.
@@ -36,7 +47,8 @@ class Cinfo
 					DinfoBase* d,	// A handle to lots of utility functions for the Data class.
 					const string* doc = 0,
 					unsigned int numDoc = 0,
-					bool banCreation = false
+					bool banCreation = false,
+					ConcurrencyCheck concurrencyCheck = 0
 			);
 
 			/**
@@ -101,6 +113,13 @@ class Cinfo
 			 * in isolation but only as a child of another class.
 			 */
 			bool banCreation() const;
+
+			/**
+			 * True if the class has a ConcurrencyCheck and it passes
+			 * for the specified object. False for all classes that do
+			 * not opt in. It is not inherited by derived classes.
+			 */
+			bool isConcurrent( const Eref& e ) const;
 //////////////////////////////////////////////////////////////////////////
 
 			const OpFunc* getOpFunc( FuncId fid ) const;
@@ -247,6 +266,13 @@ class Cinfo
 			 */
 			 const string& srcFinfoName( BindIndex bid ) const;
 
+			/**
+			 * Returns the SrcFinfo having the specified BindIndex, on
+			 * this Cinfo or its bases.
+			 * Returns 0 on failure.
+			 */
+			 const SrcFinfo* findSrcFinfo( BindIndex bid ) const;
+
 			/**
 			 * Returns the name of the DestFinfo having the specified 
 			 * FuncId, on this Cinfo.
@@ -287,6 +313,9 @@ class Cinfo
 			
 			bool banCreation_;
 
+			/// Zero unless the class opts in to concurrent process calls.
+			ConcurrencyCheck concurrencyCheck_;
+
 			/**
 			 * This looks up Finfos by name.
 			 */
@@ -466,20 +466,28 @@ void Element::putTargetsInDigest(
 // remote node. This Eref will then invoke its own send call to complete
 // the message transfer.
 void Element::putOffNodeTargetsInDigest(
-		unsigned int srcNum, vector< vector< bool > >& targetNodes )
+		unsigned int srcNum, const SrcFinfo* sf,
+		vector< vector< bool > >& targetNodes )
 // targetNodes[srcDataId][node]
 {
-	if ( msgBinding_[ srcNum ].size() == 0 )
-		return;
-	const MsgFuncBinding& mfb = msgBinding_[ srcNum ][0];
-	const Msg* msg = Msg::getMsg( mfb.mid );
-	const OpFunc* func;
-	if ( msg->e1() == this ) {
-		func = msg->e2()->cinfo()->getOpFunc( mfb.fid );
-	} else {
-		func = msg->e1()->cinfo()->getOpFunc( mfb.fid );
+	// Use the first func that matches the SrcFinfo, as digestMessages
+	// has dropped the others.
+	const OpFunc* func = 0;
+	for ( unsigned int i = 0; i < msgBinding_[ srcNum ].size(); ++i ) {
+		const MsgFuncBinding& mfb = msgBinding_[ srcNum ][i];
+		const Msg* msg = Msg::getMsg( mfb.mid );
+		if ( msg->e1() == this ) {
+			func = msg->e2()->cinfo()->getOpFunc( mfb.fid );
+		} else {
+			func = msg->e1()->cinfo()->getOpFunc( mfb.fid );
+		}
+		assert( func );
+		if ( !sf || func->checkFinfo( sf ) )
+			break;
+		func = 0;
 	}
-	assert( func );
+	if ( !func )
+		return;
 	// How do I eventually destroy these?
 	const OpFunc* hop = func->makeHopFunc( srcNum );
 	for ( unsigned int i = 0; i < numData(); ++i ) {
@@ -521,10 +529,24 @@ void Element::digestMessages()
 	// a target off-node, it should flag the entry here so that it can
 	// send the message request to the proxy on that node.
 	for ( unsigned int i = 0; i < msgBinding_.size(); ++i ) {
+		if ( msgBinding_[i].size() == 0 )
+			continue;
+		// The SrcFinfo::send functions static_cast the func to the type
+		// of the SrcFinfo, so funcs which do not match it are dropped
+		// here. A BindIndex which is not on the Cinfo was set up by hand
+		// and relies on the check in SrcFinfo::addMsg.
+		const SrcFinfo* sf = cinfo_->findSrcFinfo( i );
 		// Go through and identify functions with the same ptr.
 		vector< FuncOrder > fo = putFuncsInOrder( this, msgBinding_[i] );
 		for ( vector< FuncOrder >::const_iterator 
 						k = fo.begin(); k != fo.end(); ++k ) {
+			if ( sf && !k->func()->checkFinfo( sf ) ) {
+				cout << "Error: Element::digestMessages: " << name_ <<
+					"." << sf->name() << " of type " << sf->rttiType() <<
+					" cannot send to func of type " <<
+					k->func()->rttiType() << ". Msg ignored.\n";
+				continue;
+			}
 			const MsgFuncBinding& mfb = msgBinding_[i][ k->index() ];
 			putTargetsInDigest( i, mfb, *k, targetNodes );
 		}
@@ -532,7 +554,7 @@ void Element::digestMessages()
 			if ( report ) {
 				unsigned int numPre = findNumDigest( msgDigest_, 
 								msgBinding_.size(), numData(), i );
-				putOffNodeTargetsInDigest( i, targetNodes );
+				putOffNodeTargetsInDigest( i, sf, targetNodes );
 				unsigned int numPost = findNumDigest( msgDigest_, 
 								msgBinding_.size(), numData(), i );
 				cout << "\nfor Element " << name_;
@@ -547,7 +569,7 @@ void Element::digestMessages()
 				}
 				cout << endl;
 			} else {
-				putOffNodeTargetsInDigest( i, targetNodes );
+				putOffNodeTargetsInDigest( i, sf, targetNodes );
 			}
 		}
 	}
@@ -226,10 +226,12 @@ class Element
 						vector< vector< bool > >& targetNodes
 	   	);
 		/**
-		 * Inner function that adds off-node targets to the MsgDigest
+		 * Inner function that adds off-node targets to the MsgDigest.
+		 * sf is the SrcFinfo on srcNum, or 0 if it is not on the Cinfo.
 		 */
 		void putOffNodeTargetsInDigest(
-		   	unsigned int srcNum, vector< vector< bool > >& targetNodes );
+		   	unsigned int srcNum, const SrcFinfo* sf,
+			vector< vector< bool > >& targetNodes );
 
 		/**
 		 * Gets the class information for this Element
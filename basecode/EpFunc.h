@@ -72,6 +72,14 @@ template< class T, class A > class EpFunc1: public OpFunc1Base< A >
 			( reinterpret_cast< T* >( e.data() )->*func_ )( e, arg );
 		}
 
+		void opRange( Element* e, unsigned int start, unsigned int end,
+						A arg ) const {
+			for ( unsigned int k = start; k < end; ++k ) {
+				Eref er( e, k );
+				( reinterpret_cast< T* >( er.data() )->*func_ )( er, arg );
+			}
+		}
+
 	private:
 		void ( T::*func_ )( const Eref& e, A ); 
 };
@@ -88,6 +96,15 @@ template< class T, class A1, class A2 > class EpFunc2:
 			( reinterpret_cast< T* >( e.data() )->*func_ )( e, arg1, arg2 );
 		}
 
+		void opRange( Element* e, unsigned int start, unsigned int end,
+						A1 arg1, A2 arg2 ) const {
+			for ( unsigned int k = start; k < end; ++k ) {
+				Eref er( e, k );
+				( reinterpret_cast< T* >( er.data() )->*func_ )( 
+								er, arg1, arg2 );
+			}
+		}
+
 	private:
 		void ( T::*func_ )( const Eref& e, A1, A2 ); 
 };
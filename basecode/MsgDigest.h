@@ -17,6 +17,11 @@
  * As a further refinement, if the target DataIndex is ALLDATA, then it
  * means that all data entries in the target are to be iterated over. Note
  * that this does not extend to Field targets.
+ * Element::digestMessages checks each func against the type of the
+ * SrcFinfo on the Cinfo, and leaves out the ones that do not match, so
+ * the SrcFinfo::send functions use a static_cast to get at the typed
+ * OpFunc, rather than doing a dynamic_cast on every send. Debug builds
+ * still assert the cast.
  */
 class MsgDigest
 {
@@ -33,6 +33,13 @@ template< class T, class A > class OpFunc1: public OpFunc1Base<A>
 		void op( const Eref& e, A arg ) const {
 			(reinterpret_cast< T* >( e.data() )->*func_)( arg );
 		}
+		void opRange( Element* e, unsigned int start, unsigned int end,
+						A arg ) const {
+			for ( unsigned int k = start; k < end; ++k ) {
+				T* obj = reinterpret_cast< T* >( e->data( e->rawIndex( k ) ) );
+				(obj->*func_)( arg );
+			}
+		}
 	private:
 		void ( T::*func_ )( A ); 
 };
@@ -48,6 +55,13 @@ template< class T, class A1, class A2 > class OpFunc2:
 		void op( const Eref& e, A1 arg1, A2 arg2 ) const {
 			(reinterpret_cast< T* >( e.data() )->*func_)( arg1, arg2 );
 		}
+		void opRange( Element* e, unsigned int start, unsigned int end,
+						A1 arg1, A2 arg2 ) const {
+			for ( unsigned int k = start; k < end; ++k ) {
+				T* obj = reinterpret_cast< T* >( e->data( e->rawIndex( k ) ) );
+				(obj->*func_)( arg1, arg2 );
+			}
+		}
 
 	private:
 		void ( T::*func_ )( A1, A2 ); 
@@ -104,6 +104,18 @@ template< class A > class OpFunc1Base: public OpFunc
 
 		virtual void op( const Eref& e, A arg ) const = 0;
 
+		/**
+		 * Executes the OpFunc on data entries [start, end) of e. Used
+		 * by SrcFinfo1::send for ALLDATA targets. Derived classes 
+		 * override this to avoid a virtual call for each entry.
+		 */
+		virtual void opRange( Element* e, unsigned int start, 
+						unsigned int end, A arg ) const
+		{
+			for ( unsigned int k = start; k < end; ++k )
+				op( Eref( e, k ), arg );
+		}
+
 		const OpFunc* makeHopFunc( HopIndex hopIndex) const;
 
 		void opBuffer( const Eref& e, double* buf ) const {
@@ -152,6 +164,17 @@ template< class A1, class A2 > class OpFunc2Base: public OpFunc
 		virtual void op( const Eref& e, A1 arg1, A2 arg2 ) 
 				const = 0;
 
+		/**
+		 * Executes the OpFunc on data entries [start, end) of e. Used
+		 * by SrcFinfo2::send for ALLDATA targets.
+		 */
+		virtual void opRange( Element* e, unsigned int start, 
+						unsigned int end, A1 arg1, A2 arg2 ) const
+		{
+			for ( unsigned int k = start; k < end; ++k )
+				op( Eref( e, k ), arg1, arg2 );
+		}
+
 		const OpFunc* makeHopFunc( HopIndex hopIndex) const;
 
 		void opBuffer( const Eref& e, double* buf ) const {
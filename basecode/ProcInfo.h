@@ -13,10 +13,13 @@ class ProcInfo
 {
     public:
         ProcInfo() 
-            : dt( 1.0 ), currTime( 0.0 )
+            : dt( 1.0 ), currTime( 0.0 ), runTime( 0.0 )
         {;}
         double dt;
         double currTime;
+        /// Time at which the current run will end, so that objects can
+        /// preallocate for it. Zero during reinit.
+        double runTime;
 };
 
 typedef const ProcInfo* ProcPtr;
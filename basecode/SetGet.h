@@ -350,6 +350,184 @@ template< class A > class Field: public SetGet1< A >
 		}
 };
 
+/**
+ * FieldHandle looks up the set and get functions of a value field once,
+ * for one class, along with the hop functions used for objects on other
+ * nodes. Repeated gets and sets on objects of that class then skip the
+ * field name building, the Finfo lookup and the type checks of
+ * Field< A >, which matters when polling many objects every timestep.
+ * Objects of other classes, and fields which turn out to be child
+ * Elements, go through Field< A > as usual.
+ */
+template< class A > class FieldHandle
+{
+	public:
+		FieldHandle()
+			: cinfo_( 0 ), getOp_( 0 ), setOp_( 0 ),
+			getHop_( 0 ), getVecHop_( 0 ), setHop_( 0 ), setVecHop_( 0 )
+		{;}
+
+		/// Resolves field on objects of class cinfo.
+		FieldHandle( const Cinfo* cinfo, const string& field )
+			: cinfo_( 0 ), getOp_( 0 ), setOp_( 0 ),
+			getHop_( 0 ), getVecHop_( 0 ), setHop_( 0 ), setVecHop_( 0 )
+		{
+			resolve( cinfo, field );
+		}
+
+		FieldHandle( const FieldHandle< A >& other )
+			: cinfo_( 0 ), getOp_( 0 ), setOp_( 0 ),
+			getHop_( 0 ), getVecHop_( 0 ), setHop_( 0 ), setVecHop_( 0 )
+		{
+			resolve( other.cinfo_, other.field_ );
+		}
+
+		FieldHandle< A >& operator=( const FieldHandle< A >& other )
+		{
+			if ( this != &other )
+				resolve( other.cinfo_, other.field_ );
+			return *this;
+		}
+
+		~FieldHandle()
+		{
+			clearHops();
+		}
+
+		/// True if the class has a get function of type A for the field.
+		bool canGet() const
+		{
+			return getOp_ != 0;
+		}
+
+		/// True if the class has a set function of type A for the field.
+		bool canSet() const
+		{
+			return setOp_ != 0;
+		}
+
+		const string& getField() const
+		{
+			return field_;
+		}
+
+		/// Same as Field< A >::get( dest, field ).
+		A get( const ObjId& dest ) const
+		{
+			if ( getOp_ && dest.element()->cinfo() == cinfo_ ) {
+				if ( dest.isDataHere() )
+					return getOp_->returnOp( dest.eref() );
+				A ret;
+				getHop_->op( dest.eref(), &ret ); // Blocking function.
+				return ret;
+			}
+			return Field< A >::get( dest, field_ );
+		}
+
+		/// Same as Field< A >::getVec( dest, field, vec ).
+		void getVec( ObjId dest, vector< A >& vec ) const
+		{
+			if ( getOp_ && dest.element()->cinfo() == cinfo_ ) {
+				vec.resize( 0 );
+				getVecHop_->opGetVec( dest.eref(), vec, getOp_ );
+				return;
+			}
+			Field< A >::getVec( dest, field_, vec );
+		}
+
+		/// Same as Field< A >::set( dest, field, arg ).
+		bool set( const ObjId& dest, A arg ) const
+		{
+			if ( setOp_ && dest.element()->cinfo() == cinfo_ ) {
+				if ( dest.isOffNode() ) {
+					setHop_->op( dest.eref(), arg );
+					if ( dest.isGlobal() )
+						setOp_->op( dest.eref(), arg );
+				} else {
+					setOp_->op( dest.eref(), arg );
+				}
+				return true;
+			}
+			return Field< A >::set( dest, field_, arg );
+		}
+
+		/// Same as Field< A >::setVec( dest, field, arg ).
+		bool setVec( ObjId dest, const vector< A >& arg ) const
+		{
+			if ( arg.size() == 0 ) return 0;
+			if ( setOp_ && dest.element()->cinfo() == cinfo_ ) {
+				setVecHop_->opVec( dest.eref(), arg, setOp_ );
+				return true;
+			}
+			return Field< A >::setVec( dest, field_, arg );
+		}
+
+	private:
+		void resolve( const Cinfo* cinfo, const string& field )
+		{
+			clearHops();
+			cinfo_ = cinfo;
+			field_ = field;
+			getOp_ = 0;
+			setOp_ = 0;
+			if ( !cinfo || field.length() == 0 )
+				return;
+
+			string name = "get" + field;
+			name[3] = toupper( name[3] );
+			const DestFinfo* df = 
+					dynamic_cast< const DestFinfo* >( cinfo->findFinfo( name ) );
+			if ( df )
+				getOp_ = dynamic_cast< const GetOpFuncBase< A >* >( 
+								df->getOpFunc() );
+			if ( getOp_ ) {
+				getHop_ = dynamic_cast< const OpFunc1Base< A* >* >( 
+					getOp_->makeHopFunc( 
+						HopIndex( getOp_->opIndex(), MooseGetHop ) ) );
+				getVecHop_ = dynamic_cast< const GetHopFunc< A >* >( 
+					getOp_->makeHopFunc( 
+						HopIndex( getOp_->opIndex(), MooseGetVecHop ) ) );
+				assert( getHop_ && getVecHop_ );
+			}
+
+			name[0] = 's';
+			df = dynamic_cast< const DestFinfo* >( cinfo->findFinfo( name ) );
+			if ( df )
+				setOp_ = dynamic_cast< const OpFunc1Base< A >* >( 
+								df->getOpFunc() );
+			if ( setOp_ ) {
+				setHop_ = dynamic_cast< const OpFunc1Base< A >* >( 
+					setOp_->makeHopFunc( 
+						HopIndex( setOp_->opIndex(), MooseSetHop ) ) );
+				setVecHop_ = dynamic_cast< const OpFunc1Base< A >* >( 
+					setOp_->makeHopFunc( 
+						HopIndex( setOp_->opIndex(), MooseSetVecHop ) ) );
+				assert( setHop_ && setVecHop_ );
+			}
+		}
+
+		void clearHops()
+		{
+			delete getHop_;
+			delete getVecHop_;
+			delete setHop_;
+			delete setVecHop_;
+			getHop_ = 0;
+			getVecHop_ = 0;
+			setHop_ = 0;
+			setVecHop_ = 0;
+		}
+
+		const Cinfo* cinfo_;
+		string field_;
+		const GetOpFuncBase< A >* getOp_;
+		const OpFunc1Base< A >* setOp_;
+		const OpFunc1Base< A* >* getHop_;
+		const GetHopFunc< A >* getVecHop_;
+		const OpFunc1Base< A >* setHop_;
+		const OpFunc1Base< A >* setVecHop_;
+};
+
 /**
  * SetGet2 handles 2-argument Sets. It does not deal with Gets.
  */
@@ -548,6 +548,23 @@ template < class T > class SparseMatrix
 			}
 		}
 
+		/**
+		 * Fills the matrix directly from its compressed row form, which
+		 * must match the current size of the matrix. The vectors are
+		 * swapped in rather than copied, so they come back holding the
+		 * old contents.
+		 */
+		void csrFill( vector< T >& entry, vector< unsigned int >& colIndex,
+						vector< unsigned int >& rowStart )
+		{
+			assert( rowStart.size() == nrows_ + 1 );
+			assert( entry.size() == colIndex.size() );
+			assert( rowStart.back() == entry.size() );
+			N_.swap( entry );
+			colIndex_.swap( colIndex );
+			rowStart_.swap( rowStart );
+		}
+
 		void pairFill( const vector< unsigned int >& row, 
 						const vector< unsigned int >& col, T value )
 		{
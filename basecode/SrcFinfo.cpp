@@ -72,8 +72,8 @@ void SrcFinfo0::send( const Eref& e ) const {
 	for ( vector< MsgDigest >::const_iterator
 		i = md.begin(); i != md.end(); ++i ) {
 		const OpFunc0Base* f = 
-			dynamic_cast< const OpFunc0Base* >( i->func );
-		assert( f );
+			static_cast< const OpFunc0Base* >( i->func );
+		assert( dynamic_cast< const OpFunc0Base* >( i->func ) );
 		for ( vector< Eref >::const_iterator
 			j = i->targets.begin(); j != i->targets.end(); ++j ) {
 			if ( j->dataIndex() == ALLDATA ) {
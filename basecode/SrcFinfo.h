@@ -109,16 +109,14 @@ template < class T > class SrcFinfo1: public SrcFinfo
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc1Base< T >* f = 
-					dynamic_cast< const OpFunc1Base< T >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc1Base< T >* >( i->func );
+				assert(( dynamic_cast< const OpFunc1Base< T >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
-						unsigned int end = start + e->numLocalData();
-						for ( unsigned int k = start; k < end; ++k )
-							f->op( Eref( e, k ), arg );
+						f->opRange( e, start, start + e->numLocalData(), arg );
 					} else  {
 						f->op( *j, arg );
 						// Need to send stuff offnode too here. The 
@@ -137,8 +135,8 @@ template < class T > class SrcFinfo1: public SrcFinfo
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc1Base< T >* f = 
-					dynamic_cast< const OpFunc1Base< T >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc1Base< T >* >( i->func );
+				assert(( dynamic_cast< const OpFunc1Base< T >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->element() != tgt.element() )
@@ -146,9 +144,7 @@ template < class T > class SrcFinfo1: public SrcFinfo
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
-						unsigned int end = start + e->numLocalData();
-						for ( unsigned int k = start; k < end; ++k )
-							f->op( Eref( e, k ), arg );
+						f->opRange( e, start, start + e->numLocalData(), arg );
 					} else  {
 						f->op( *j, arg );
 						// Need to send stuff offnode too here. The 
@@ -175,8 +171,8 @@ template < class T > class SrcFinfo1: public SrcFinfo
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc1Base< T >* f = 
-					dynamic_cast< const OpFunc1Base< T >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc1Base< T >* >( i->func );
+				assert(( dynamic_cast< const OpFunc1Base< T >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -231,16 +227,16 @@ template < class T1, class T2 > class SrcFinfo2: public SrcFinfo
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc2Base< T1, T2 >* f = 
-					dynamic_cast< const OpFunc2Base< T1, T2 >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc2Base< T1, T2 >* >( i->func );
+				assert(( dynamic_cast< 
+					const OpFunc2Base< T1, T2 >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
-						unsigned int end = start + e->numData();
-						for ( unsigned int k = start; k < end; ++k )
-							f->op( Eref( e, k ), arg1, arg2 );
+						f->opRange( e, start, start + e->numData(), 
+										arg1, arg2 );
 					} else  {
 						f->op( *j, arg1, arg2 );
 					}
@@ -255,8 +251,9 @@ template < class T1, class T2 > class SrcFinfo2: public SrcFinfo
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc2Base< T1, T2 >* f = 
-					dynamic_cast< const OpFunc2Base< T1, T2 >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc2Base< T1, T2 >* >( i->func );
+				assert(( dynamic_cast< 
+					const OpFunc2Base< T1, T2 >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->element() != tgt.element() )
@@ -264,9 +261,8 @@ template < class T1, class T2 > class SrcFinfo2: public SrcFinfo
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
-						unsigned int end = start + e->numData();
-						for ( unsigned int k = start; k < end; ++k )
-							f->op( Eref( e, k ), arg1, arg2 );
+						f->opRange( e, start, start + e->numData(), 
+										arg1, arg2 );
 					} else  {
 						f->op( *j, arg1, arg2 );
 					}
@@ -309,9 +305,10 @@ template < class T1, class T2, class T3 > class SrcFinfo3: public SrcFinfo
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc3Base< T1, T2, T3 >* f = 
-					dynamic_cast< const OpFunc3Base< T1, T2, T3 >* >( 
+					static_cast< const OpFunc3Base< T1, T2, T3 >* >( 
 									i->func );
-				assert( f );
+				assert(( dynamic_cast< 
+					const OpFunc3Base< T1, T2, T3 >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -361,9 +358,10 @@ template < class T1, class T2, class T3, class T4 > class SrcFinfo4: public SrcF
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc4Base< T1, T2, T3, T4 >* f = 
-					dynamic_cast< const OpFunc4Base< T1, T2, T3, T4 >* >( 
+					static_cast< const OpFunc4Base< T1, T2, T3, T4 >* >( 
 									i->func );
-				assert( f );
+				assert(( dynamic_cast< 
+					const OpFunc4Base< T1, T2, T3, T4 >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -415,9 +413,10 @@ template < class T1, class T2, class T3, class T4, class T5 > class SrcFinfo5: p
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc5Base< T1, T2, T3, T4, T5 >* f = 
-					dynamic_cast< 
+					static_cast< 
 					const OpFunc5Base< T1, T2, T3, T4, T5 >* >( i->func );
-				assert( f );
+				assert(( dynamic_cast< 
+					const OpFunc5Base< T1, T2, T3, T4, T5 >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -472,10 +471,11 @@ template < class T1, class T2, class T3, class T4, class T5, class T6 > class Sr
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
 				const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* f = 
-					dynamic_cast< 
+					static_cast< 
 					const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* >( 
 									i->func );
-				assert( f );
+				assert(( dynamic_cast< 
+					const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* >( i->func ) ));
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -48,13 +48,16 @@ extern void testMpiBuiltins();
 extern void testMpiShell();
 extern void testMsg();
 extern void testMpiMsg();
+extern void testMpi();
 // extern void testKinetics();
 extern void testKsolve();
 extern void testKsolveProcess();
 extern void testBiophysics();
 extern void testBiophysicsProcess();
+extern void testIntFireProcess();
 extern void testDiffusion();
 extern void testHSolve();
+extern void testSynapse();
 // extern void testKineticsProcess();
 // extern void testGeom();
 extern void testMesh();
@@ -185,6 +188,12 @@ Id init( int argc, char** argv, bool& doUnitTests, bool& doRegressionTests,
 					benchmark = 2;
 				else if ( s == "gssa" )
 					benchmark = 3;
+				else if ( s == "gssaSelect" )
+					benchmark = 7;
+				else if ( s == "stiff" )
+					benchmark = 8;
+				else if ( s == "splitPhase" )
+					benchmark = 9;
 				else if ( s[0] == 'i' )
 					benchmark = 4;
 				else if ( s[0] == 'h' )
@@ -208,7 +217,7 @@ Id init( int argc, char** argv, bool& doUnitTests, bool& doRegressionTests,
 				break;
 			case 'h': // help
 			default:
-				cout << "Usage: moose -help -infiniteLoop -unit_tests -regression_tests -quit -n numNodes -benchmark [ee gsl gssa intFire hhNet msg_<msgType>_<size>]\n";
+				cout << "Usage: moose -help -infiniteLoop -unit_tests -regression_tests -quit -n numNodes -benchmark [ee gsl gssa gssaSelect stiff splitPhase intFire hhNet msg_<msgType>_<size>]\n";
 
 				exit( 1 );
 		}
@@ -300,6 +309,7 @@ void nonMpiTests( Shell* s )
 //		testBiophysics();
 		testDiffusion();
         testHSolve();
+		testSynapse();
 		// testGeom();
 		testMesh();
 		testSigNeur();
@@ -322,6 +332,7 @@ void processTests( Shell* s )
 	testBuiltinsProcess();
 	// testKineticsProcess();
 	testBiophysicsProcess();
+	testIntFireProcess();
 	// testKineticSolversProcess();
 	// testSimManager();
 	testSigNeurProcess();
@@ -343,6 +354,8 @@ void mpiTests()
 		cout << "." << flush;
 		testMpiScheduling();
 		cout << "." << flush;
+		testMpi();
+		cout << "." << flush;
 #endif
 }
 #if ! defined(PYMOOSE) && ! defined(MOOSE_LIB)
@@ -24,6 +24,9 @@
 #include "SingleMsg.h"
 #include "OneToOneMsg.h"
 #include "../randnum/randnum.h"
+#include "../randnum/Uniform.h"
+#include "../randnum/Normal.h"
+#include "../randnum/Poisson.h"
 #include "../scheduling/Clock.h"
 
 #include "../shell/Shell.h"
@@ -74,11 +77,13 @@ void testSendMsg()
 	assert( ver[55][0].element() == e2.element() );
 	assert( ver[55][0].dataIndex() == 55 );
 	
-	SrcFinfo1<double> s( "test", "" );
-	s.setBindIndex( 0 );
-	e1.element()->addMsgAndFunc( m->mid(), fid, s.getBindIndex() );
+	const SrcFinfo1< double >* s = dynamic_cast< const SrcFinfo1< double >* >(
+		ac->findFinfo( "output" ) );
+	assert( s != 0 );
+	e1.element()->addMsgAndFunc( m->mid(), fid, s->getBindIndex() );
 	// e1.element()->digestMessages();
-	const vector< MsgDigest >& md = e1.element()->msgDigest( 0 );
+	const vector< MsgDigest >& md =
+		e1.element()->msgDigest( s->getBindIndex() );
 	assert( md.size() == 1 );
 	assert( md[0].targets.size() == 1 );
 	assert( md[0].targets[0].element() == e2.element() );
@@ -86,7 +91,7 @@ void testSendMsg()
 
 	for ( unsigned int i = 0; i < size; ++i ) {
 		double x = i + i * i;
-		s.send( Eref( e1.element(), i ), x );
+		s->send( Eref( e1.element(), i ), x );
 	}
 
 	for ( unsigned int i = 0; i < size; ++i ) {
@@ -100,6 +105,63 @@ void testSendMsg()
 	delete i2.element();
 }
 
+/**
+ * Binds funcs straight onto a BindIndex with addMsgAndFunc, which skips
+ * the type check in SrcFinfo::addMsg. The digest should keep a func
+ * which matches the SrcFinfo of that BindIndex on the Cinfo, and drop
+ * one which does not. A BindIndex past the end of the Cinfo has no
+ * SrcFinfo to check against, so its func is kept.
+ */
+void testSrcFinfoBindCheck()
+{
+	const Cinfo* ac = Arith::initCinfo();
+	const DestFinfo* df = dynamic_cast< const DestFinfo* >(
+		ac->findFinfo( "setOutputValue" ) );
+	assert( df != 0 );
+	FuncId fid = df->getFid();
+	const DestFinfo* df2 = dynamic_cast< const DestFinfo* >(
+		ac->findFinfo( "arg1x2" ) );
+	assert( df2 != 0 );
+	const SrcFinfo1< double >* output =
+		dynamic_cast< const SrcFinfo1< double >* >(
+		ac->findFinfo( "output" ) );
+	assert( output != 0 );
+	BindIndex b = output->getBindIndex();
+
+	Id src = Id::nextId();
+	Id badSrc = Id::nextId();
+	Id tgt = Id::nextId();
+	new GlobalDataElement( src, ac, "src", 1 );
+	new GlobalDataElement( badSrc, ac, "badSrc", 1 );
+	new GlobalDataElement( tgt, ac, "tgt", 1 );
+	Arith* a = reinterpret_cast< Arith* >( tgt.eref().data() );
+
+	Msg* m = new SingleMsg( src.eref(), tgt.eref(), 0 );
+	src.element()->addMsgAndFunc( m->mid(), fid, b );
+	assert( src.element()->msgDigest( b ).size() == 1 );
+	output->send( src.eref(), 1234.5 );
+	assert( doubleEq( a->getOutput(), 1234.5 ) );
+
+	m = new SingleMsg( badSrc.eref(), tgt.eref(), 0 );
+	badSrc.element()->addMsgAndFunc( m->mid(), df2->getFid(), b );
+	assert( badSrc.element()->msgDigest( b ).size() == 0 );
+	output->send( badSrc.eref(), 1.0 );
+	assert( doubleEq( a->getOutput(), 1234.5 ) );
+
+	SrcFinfo1< double > s( "test", "" );
+	s.setBindIndex( ac->numBindIndex() );
+	m = new SingleMsg( src.eref(), tgt.eref(), 0 );
+	src.element()->addMsgAndFunc( m->mid(), fid, s.getBindIndex() );
+	assert( src.element()->msgDigest( s.getBindIndex() ).size() == 1 );
+	s.send( src.eref(), 2345.5 );
+	assert( doubleEq( a->getOutput(), 2345.5 ) );
+
+	cout << "." << flush;
+	delete src.element();
+	delete badSrc.element();
+	delete tgt.element();
+}
+
 // This used to use parent/child msg, but that has other implications
 // as it causes deletion of elements.
 void testCreateMsg()
@@ -334,6 +396,56 @@ void testSetGetDouble()
 	// delete i3.element();
 }
 
+void testFieldHandle()
+{
+	const Cinfo* ic = IntFire::initCinfo();
+	unsigned int size = 100;
+	Id i2 = Id::nextId();
+	Element* ret = new GlobalDataElement( i2, ic, "test2", size );
+	assert( ret );
+
+	FieldHandle< double > vm( ic, "Vm" );
+	assert( vm.canGet() );
+	assert( vm.canSet() );
+	FieldHandle< double > copy;
+	copy = vm;
+	for ( unsigned int i = 0; i < size; ++i ) {
+		ObjId oid( i2, i );
+		assert( vm.set( oid, i * 0.5 ) );
+		assert( doubleEq( Field< double >::get( oid, "Vm" ), i * 0.5 ) );
+		assert( doubleEq( copy.get( oid ), i * 0.5 ) );
+	}
+	vector< double > vec;
+	vm.getVec( i2, vec );
+	assert( vec.size() == size );
+	for ( unsigned int i = 0; i < size; ++i )
+		assert( doubleEq( vec[i], i * 0.5 ) );
+	vec.assign( 3, 0.0 );
+	vec[1] = 1.0;
+	vec[2] = 2.0;
+	assert( vm.setVec( i2, vec ) );
+	for ( unsigned int i = 0; i < size; ++i )
+		assert( doubleEq( vm.get( ObjId( i2, i ) ), i % 3 ) );
+
+	// A read-only field, a missing one, and another class.
+	FieldHandle< string > name( Neutral::initCinfo(), "name" );
+	assert( name.canGet() );
+	assert( name.canSet() );
+	assert( name.get( ObjId( i2, 3 ) ) == "test2" );
+	FieldHandle< string > className( ic, "className" );
+	assert( className.canGet() );
+	assert( !className.canSet() );
+	assert( className.get( ObjId( i2, 0 ) ) == "IntFire" );
+	FieldHandle< double > missing( ic, "foo" );
+	assert( !missing.canGet() );
+	assert( !missing.canSet() );
+	FieldHandle< int > wrongType( ic, "Vm" );
+	assert( !wrongType.canGet() );
+
+	cout << "." << flush;
+	delete i2.element();
+}
+
 void testSetGetSynapse()
 {
 	const Cinfo* ssh = SimpleSynHandler::initCinfo();
@@ -868,6 +980,84 @@ void testSparseMsg()
 	cout << "." << flush;
 }
 
+/**
+ * Checks that randomConnect fills in the matrix and the synapse counts
+ * consistently, with about the right number of connections, and that
+ * the connections depend only on the seed, not on the number of threads.
+ */
+void testSparseMsgRandomConnect()
+{
+	const Cinfo* ic = IntFire::initCinfo();
+	const Cinfo* sshc = SimpleSynHandler::initCinfo();
+	const Cinfo* sc = Synapse::initCinfo();
+	unsigned int nSrc = 300;
+	unsigned int nTgt = 200;
+	double p = 0.05;
+
+	Id sshid = Id::nextId();
+	Element* syns = new GlobalDataElement( sshid, sshc, "syns", nTgt );
+	Id synId( sshid.value() + 1 );
+	Id cells = Id::nextId();
+	Element* fire = new GlobalDataElement( cells, ic, "fire", nSrc );
+	SparseMsg* sm = new SparseMsg( fire, synId.element(), 0 );
+	const Finfo* f1 = ic->findFinfo( "spikeOut" );
+	const Finfo* f2 = sc->findFinfo( "addSpike" );
+	f1->addMsg( f2, sm->mid(), fire );
+
+	// Setting up the connectivity leaves the global generator alone.
+	mtseed( 5678 );
+	double r = mtrand();
+	mtseed( 5678 );
+	sm->setRandomConnectivity( p, 4321 );
+	assert( doubleEq( mtrand(), r ) );
+	SparseMatrix< unsigned int > orig = sm->getMatrix();
+	unsigned int num = orig.nEntries();
+	double mean = p * nSrc * nTgt;
+	double sd = sqrt( mean * ( 1.0 - p ) );
+	assert( fabs( num - mean ) < 5 * sd );
+
+	// Each target has synapses numbered in order of source.
+	unsigned int tot = 0;
+	for ( unsigned int i = 0; i < nTgt; ++i ) {
+		vector< unsigned int > entry;
+		vector< unsigned int > rowIndex;
+		unsigned int n = orig.getColumn( i, entry, rowIndex );
+		assert( n == Field< unsigned int >::get( 
+								ObjId( sshid, i ), "numSynapses" ) );
+		for ( unsigned int k = 0; k < n; ++k )
+			assert( entry[k] == k );
+		for ( unsigned int k = 1; k < n; ++k )
+			assert( rowIndex[k] > rowIndex[k-1] );
+		tot += n;
+	}
+	assert( tot == num );
+
+	unsigned int numCores = Shell::numCores();
+	Shell::setHardware( 4, Shell::numNodes(), Shell::myNode() );
+	sm->setRandomConnectivity( p, 4321 );
+	Shell::setHardware( numCores, Shell::numNodes(), Shell::myNode() );
+	const SparseMatrix< unsigned int >& again = sm->getMatrix();
+	assert( again.nEntries() == num );
+	for ( unsigned int j = 0; j < nSrc; ++j ) {
+		vector< unsigned int > e1, e2, c1, c2;
+		orig.getRow( j, e1, c1 );
+		again.getRow( j, e2, c2 );
+		assert( e1 == e2 );
+		assert( c1 == c2 );
+	}
+
+	sm->setRandomConnectivity( p, 1234 );
+	assert( sm->getMatrix().nEntries() != num ); // Very likely.
+	sm->setRandomConnectivity( 1.0, 1234 );
+	assert( sm->getMatrix().nEntries() == nSrc * nTgt );
+	sm->setRandomConnectivity( 0.0, 1234 );
+	assert( sm->getMatrix().nEntries() == 0 );
+
+	delete syns;
+	delete fire;
+	cout << "." << flush;
+}
+
 void test2ArgSetVec()
 {
 	const Cinfo* ac = Arith::initCinfo();
@@ -1254,13 +1444,14 @@ void testMsgField()
 	assert( sm->getI1() == 5 );
 	assert( sm->getI2() == 3 );
 	
-	SrcFinfo1<double> s( "test", "" );
-	s.setBindIndex( 0 );
-	e1.element()->addMsgAndFunc( m->mid(), fid, s.getBindIndex() );
+	const SrcFinfo1< double >* s = dynamic_cast< const SrcFinfo1< double >* >(
+		ac->findFinfo( "output" ) );
+	assert( s != 0 );
+	e1.element()->addMsgAndFunc( m->mid(), fid, s->getBindIndex() );
 
 	for ( unsigned int i = 0; i < size; ++i ) {
 		double x = i * 42;
-		s.send( Eref( e1.element(), i ), x );
+		s->send( Eref( e1.element(), i ), x );
 	}
 
 	// Check that regular msgs go through.
@@ -1276,7 +1467,7 @@ void testMsgField()
 	sm->setI2( 8 );
 	for ( unsigned int i = 0; i < size; ++i ) {
 		double x = i * 1000;
-		s.send( Eref( e1.element(), i ), x );
+		s->send( Eref( e1.element(), i ), x );
 	}
 	val = reinterpret_cast< Arith* >( tgt3.data() )->getOutput();
 	assert( doubleEq( val, 5 * 42 ) );
@@ -1788,13 +1979,96 @@ void testHopFunc()
 	cout << "." << flush;
 }
 
+/**
+ * Checks that the bulk fill and discard of CounterRng stay in step with
+ * one number at a time, and that distributions given their own streams
+ * repeat their samples regardless of the global generator.
+ */
+void testRandomStreams()
+{
+	const unsigned int n = 1000;
+	CounterRng single( 5678, 3 );
+	vector< double > ref( n );
+	for ( unsigned int i = 0; i < n; ++i )
+		ref[i] = single.uniform();
+
+	// Pick up from every offset within a block of four.
+	for ( unsigned int skip = 0; skip < 6; ++skip ) {
+		CounterRng rng( 5678, 3 );
+		for ( unsigned int i = 0; i < skip; ++i )
+			rng.uniform();
+		vector< double > x( n - skip - 7 );
+		rng.fill( &x[0], x.size() );
+		for ( unsigned int i = 0; i < x.size(); ++i )
+			assert( x[i] == ref[ i + skip ] );
+		assert( rng.uniform() == ref[ n - 7 ] );
+
+		CounterRng jump( 5678, 3 );
+		for ( unsigned int i = 0; i < skip; ++i )
+			jump.uniform();
+		jump.discard( 101 + skip );
+		assert( jump.uniform() == ref[ 101 + 2 * skip ] );
+	}
+	CounterRng ints( 5678, 3 );
+	vector< uint32_t > y( n );
+	ints.fillInt( &y[0], n );
+	for ( unsigned int i = 0; i < n; ++i )
+		assert( doubleEq( y[i] / 4294967296.0, ref[i] ) );
+
+	// Other streams are different.
+	CounterRng other( 5678, 4 );
+	assert( other.uniform() != ref[0] );
+
+	Uniform u( -1.0, 3.0 );
+	CounterRng urng( 99, 0 );
+	u.setRng( &urng );
+	vector< double > z( n );
+	u.fill( &z[0], n );
+	urng.setSeed( 99, 0 );
+	double sum = 0.0;
+	for ( unsigned int i = 0; i < n; ++i ) {
+		assert( z[i] >= -1.0 && z[i] < 3.0 );
+		assert( doubleEq( z[i], u.getNextSample() ) );
+		sum += z[i];
+	}
+	assert( fabs( sum / n - 1.0 ) < 0.2 );
+
+	Normal norm( 2.0, 4.0 );
+	Poisson pois( 25.0 );
+	CounterRng nrng( 99, 1 );
+	CounterRng prng( 99, 2 );
+	norm.setRng( &nrng );
+	pois.setRng( &prng );
+	vector< double > ns( n );
+	vector< double > ps( n );
+	norm.fill( &ns[0], n );
+	pois.fill( &ps[0], n );
+	nrng.setSeed( 99, 1 );
+	prng.setSeed( 99, 2 );
+	for ( unsigned int i = 0; i < n; ++i ) {
+		assert( doubleEq( ns[i], norm.getNextSample() ) );
+		assert( doubleEq( ps[i], pois.getNextSample() ) );
+	}
+	double nsum = 0.0;
+	double psum = 0.0;
+	for ( unsigned int i = 0; i < n; ++i ) {
+		nsum += ns[i];
+		psum += ps[i];
+	}
+	assert( fabs( nsum / n - 2.0 ) < 0.5 );
+	assert( fabs( psum / n - 25.0 ) < 2.0 );
+	cout << "." << flush;
+}
+
 void testAsync( )
 {
 	showFields();
 	testSendMsg();
+	testSrcFinfoBindCheck();
 	testCreateMsg();
 	testSetGet();
 	testSetGetDouble();
+	testFieldHandle();
 	testSetGetSynapse();
 	testSetGetVec();
 	test2ArgSetVec();
@@ -1808,6 +2082,8 @@ void testAsync( )
 	testSparseMatrixReorder();
 	testSparseMatrixFill();
 	testSparseMsg();
+	testSparseMsgRandomConnect();
+	testRandomStreams();
 	testSharedMsg();
 	testConvVector();
 	testConvVectorOfVectors();
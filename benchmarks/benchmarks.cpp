@@ -12,6 +12,9 @@ using namespace std;
 
 void runKineticsBenchmark1( const string& method );
 void testIntFireNetwork( unsigned int runsteps );
+void runGssaSelectBenchmark();
+void runStiffKineticsBenchmark();
+void runSplitPhaseBenchmark();
 
 void mooseBenchmarks( unsigned int option )
 {
@@ -33,6 +36,18 @@ void mooseBenchmarks( unsigned int option )
 			cout << "intFire benchmark: 104576 synapses, pconnect = 0.1, 2e5 timesteps\n";
 			testIntFireNetwork( 200000 );
 			break;
+		case 7:
+			cout << "Gssa reaction selection benchmark: linear scan vs sum tree, ring of 10 to 10000 reacs\n";
+			runGssaSelectBenchmark();
+			break;
+		case 8:
+			cout << "Stiff kinetics benchmark: Robertson model, Gsl rk5 vs Rosenbrock\n";
+			runStiffKineticsBenchmark();
+			break;
+		case 9:
+			cout << "PostMaster benchmark: blocking vs splitPhase exchange, ring of Arith across nodes, 1000 steps\n";
+			runSplitPhaseBenchmark();
+			break;
 		default:
 			cout << "Unknown benchmark specified, quitting\n";
 			break;
@@ -20,3 +20,141 @@ void runKineticsBenchmark1( const string& method )
 	s->doStart( 10000.0 );
 }
 
+
+/**
+ * Large model for the Gsolve reaction picking step: a ring of
+ * numReacs pools, each converting reversibly to the next. Every event
+ * changes only a few propensities, so for the linear scan the cost is
+ * dominated by picking the reaction.
+ * Returns the CPU time taken.
+ */
+double runGssaSelectBenchmark( const string& selectMethod, 
+				unsigned int numReacs, double runtime )
+{
+	Shell* s = reinterpret_cast< Shell* >( ObjId().data() );
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	Id kin = s->doCreate( "CubeMesh", model, "kinetics", 1 );
+	Field< double >::set( kin, "volume", 1e-18 );
+	vector< Id > pools( numReacs );
+	for ( unsigned int i = 0; i < numReacs; ++i ) {
+		stringstream ss;
+		ss << "A" << i;
+		pools[i] = s->doCreate( "Pool", kin, ss.str(), 1 );
+		Field< double >::set( pools[i], "nInit", 100 );
+	}
+	for ( unsigned int i = 0; i < numReacs; ++i ) {
+		stringstream ss;
+		ss << "r" << i;
+		Id r = s->doCreate( "Reac", kin, ss.str(), 1 );
+		s->doAddMsg( "Single", r, "sub", pools[i], "reac" );
+		s->doAddMsg( "Single", r, "prd", pools[(i + 1) % numReacs], "reac" );
+		Field< double >::set( r, "Kf", 0.1 );
+		Field< double >::set( r, "Kb", 0.1 );
+	}
+	Id gsolve = s->doCreate( "Gsolve", model, "gsolve", 1 );
+	Field< string >::set( gsolve, "selectMethod", selectMethod );
+	Field< unsigned int >::set( gsolve, "seed", 1 );
+	Id stoich = s->doCreate( "Stoich", gsolve, "stoich", 1 );
+	Field< Id >::set( stoich, "compartment", kin );
+	Field< Id >::set( stoich, "ksolve", gsolve );
+	Field< string >::set( stoich, "path", "/model/kinetics/##" );
+	s->doUseClock( "/model/gsolve", "process", 4 ); 
+	s->doSetClock( 4, 1.0 );
+	s->doReinit();
+
+	clock_t start = clock();
+	s->doStart( runtime );
+	double t = double( clock() - start ) / CLOCKS_PER_SEC;
+
+	double tot = 0.0;
+	for ( unsigned int i = 0; i < numReacs; ++i )
+		tot += Field< double >::get( pools[i], "n" );
+	cout << selectMethod << ": " << numReacs << " reacs, " << 
+			t << " sec, total n = " << tot << endl;
+	s->doDelete( model );
+	return t;
+}
+
+void runGssaSelectBenchmark()
+{
+	unsigned int sizes[] = { 10, 100, 1000, 10000 };
+	for ( unsigned int i = 0; i < 4; ++i ) {
+		// Keep the number of events about the same for each size.
+		double runtime = 1.0e4 / sizes[i];
+		double tLinear = runGssaSelectBenchmark( "linear", sizes[i], runtime );
+		double tTree = runGssaSelectBenchmark( "tree", sizes[i], runtime );
+		cout << "Speedup of tree over linear for " << sizes[i] << 
+			" reacs = " << tLinear / tTree << endl;
+	}
+}
+
+/**
+ * Stiff model for the Ksolve methods: the Robertson chemical kinetics
+ * problem, a standard test for stiff integrators.
+ * A ---> B slowly, 2B ---> B + C very fast, B + C ---> A + C fast.
+ * Returns the CPU time taken.
+ */
+double runStiffKineticsBenchmark( const string& method, double runtime )
+{
+	Shell* s = reinterpret_cast< Shell* >( ObjId().data() );
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	Id kin = s->doCreate( "CubeMesh", model, "kinetics", 1 );
+	Field< double >::set( kin, "volume", 1e-15 );
+	Id A = s->doCreate( "Pool", kin, "A", 1 );
+	Id B = s->doCreate( "Pool", kin, "B", 1 );
+	Id C = s->doCreate( "Pool", kin, "C", 1 );
+	Id r1 = s->doCreate( "Reac", kin, "r1", 1 );
+	Id r2 = s->doCreate( "Reac", kin, "r2", 1 );
+	Id r3 = s->doCreate( "Reac", kin, "r3", 1 );
+	s->doAddMsg( "Single", r1, "sub", A, "reac" );
+	s->doAddMsg( "Single", r1, "prd", B, "reac" );
+	s->doAddMsg( "Single", r2, "sub", B, "reac" );
+	s->doAddMsg( "Single", r2, "sub", B, "reac" );
+	s->doAddMsg( "Single", r2, "prd", B, "reac" );
+	s->doAddMsg( "Single", r2, "prd", C, "reac" );
+	s->doAddMsg( "Single", r3, "sub", B, "reac" );
+	s->doAddMsg( "Single", r3, "sub", C, "reac" );
+	s->doAddMsg( "Single", r3, "prd", A, "reac" );
+	s->doAddMsg( "Single", r3, "prd", C, "reac" );
+	Field< double >::set( A, "concInit", 1 );
+	Field< double >::set( r1, "Kf", 0.04 );
+	Field< double >::set( r1, "Kb", 0 );
+	Field< double >::set( r2, "Kf", 3e7 );
+	Field< double >::set( r2, "Kb", 0 );
+	Field< double >::set( r3, "Kf", 1e4 );
+	Field< double >::set( r3, "Kb", 0 );
+
+	Id ksolve = s->doCreate( "Ksolve", model, "ksolve", 1 );
+	Field< string >::set( ksolve, "method", method );
+	Id stoich = s->doCreate( "Stoich", ksolve, "stoich", 1 );
+	Field< Id >::set( stoich, "compartment", kin );
+	Field< Id >::set( stoich, "ksolve", ksolve );
+	Field< string >::set( stoich, "path", "/model/kinetics/##" );
+	s->doUseClock( "/model/ksolve", "process", 4 ); 
+	s->doSetClock( 4, 1.0 );
+	s->doReinit();
+
+	clock_t start = clock();
+	s->doStart( runtime );
+	double t = double( clock() - start ) / CLOCKS_PER_SEC;
+
+	cout << method << ": " << t << " sec, conc A = " << 
+		Field< double >::get( A, "conc" ) << ", B = " << 
+		Field< double >::get( B, "conc" ) << ", C = " << 
+		Field< double >::get( C, "conc" ) << endl;
+	s->doDelete( model );
+	return t;
+}
+
+void runStiffKineticsBenchmark()
+{
+	double runtime[] = { 10, 100, 1000 };
+	for ( unsigned int i = 0; i < 3; ++i ) {
+		cout << "Runtime " << runtime[i] << " sec:\n";
+		double tExplicit = runStiffKineticsBenchmark( "rk5", runtime[i] );
+		double tImplicit = 
+				runStiffKineticsBenchmark( "rosenbrock", runtime[i] );
+		cout << "Speedup of rosenbrock over rk5 = " << 
+				tExplicit / tImplicit << endl;
+	}
+}
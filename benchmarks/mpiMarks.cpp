@@ -0,0 +1,89 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+#include "../shell/Shell.h"
+
+/// Wall clock time, as the exchange is mostly spent waiting.
+static double wallTime()
+{
+#ifdef USE_MPI
+	return MPI_Wtime();
+#else
+	return double( clock() ) / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * Each node has numWork Arith objects on tick 0 which take no input
+ * from other nodes, and numRing on tick 1 each fed by one on the node
+ * before. With splitPhase the exchange goes on while tick 0 runs.
+ * Meant to be run on increasing numbers of nodes, as
+ * mpirun -np <n> moose -b splitPhase
+ * Returns the wall clock time taken.
+ */
+static double runSplitPhaseBenchmark( bool splitPhase,
+				unsigned int numWork, unsigned int numRing,
+				unsigned int numSteps )
+{
+	Shell* s = reinterpret_cast< Shell* >( ObjId().data() );
+	unsigned int numNodes = Shell::numNodes();
+	Id model = s->doCreate( "Neutral", ObjId(), "model", 1 );
+	if ( numWork > 0 ) { // Elements cannot be created empty.
+		Id work = s->doCreate( "Arith", model, "work", numWork * numNodes );
+		s->doAddMsg( "OneToOne", work, "output", work, "arg2" );
+		s->doUseClock( "/model/work", "process", 0 );
+	}
+	Id src = s->doCreate( "Arith", model, "src", numRing * numNodes );
+	Id dest = s->doCreate( "Arith", model, "dest", numRing * numNodes );
+	ObjId mid = s->doAddMsg( "Diagonal", src, "output", dest, "arg3" );
+	assert( !mid.bad() );
+	Field< int >::set( mid, "stride", numRing );
+	s->doUseClock( "/model/src", "process", 0 );
+	s->doUseClock( "/model/dest", "process", 1 );
+	s->doSetClock( 0, 1.0 );
+	s->doSetClock( 1, 1.0 );
+	ObjId pm( 3 );
+	Field< bool >::set( pm, "splitPhase", splitPhase );
+	s->doReinit();
+	vector< double > arg1( numRing * numNodes, 1.0 );
+	SetGet1< double >::setVec( src, "arg1", arg1 );
+
+	double start = wallTime();
+	s->doStart( numSteps );
+	double t = wallTime() - start;
+
+	vector< double > ret;
+	Field< double >::getVec( dest, "outputValue", ret );
+	double tot = 0.0;
+	for ( unsigned int i = 0; i < ret.size(); ++i )
+		tot += ret[i];
+	cout << "splitPhase = " << splitPhase << ": " << numNodes <<
+			" nodes, " << t << " sec, total = " << tot << endl;
+	Field< bool >::set( pm, "splitPhase", false );
+	s->doDelete( model );
+	return t;
+}
+
+void runSplitPhaseBenchmark()
+{
+	unsigned int numWork[] = { 0, 10000, 100000 };
+	for ( unsigned int i = 0; i < 3; ++i ) {
+		cout << numWork[i] << " local objects per node:\n";
+		double tBlocking = runSplitPhaseBenchmark( false, numWork[i],
+						1000, 1000 );
+		double tSplit = runSplitPhaseBenchmark( true, numWork[i],
+						1000, 1000 );
+		cout << "Speedup of splitPhase over blocking = " <<
+				tBlocking / tSplit << endl;
+	}
+}
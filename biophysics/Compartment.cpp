@@ -8,6 +8,7 @@
 **********************************************************************/
 
 #include "header.h"
+#include "ElementValueFinfo.h"
 #include "../randnum/randnum.h"
 #include "CompartmentBase.h"
 #include "Compartment.h"
@@ -26,7 +27,19 @@ const double Compartment::EPSILON = 1.0e-15;
 const Cinfo* Compartment::initCinfo()
 {
 	///////////////////////////////////////////////////////////////////
-	// static Finfo* compartmentFinfos[] = { };
+	static ElementValueFinfo< Compartment, long > seed( "seed",
+		"Seed for the random numbers used by randInject. Each entry of "
+		"an array of Compartments gets its own stream, restarted on "
+		"reinit, so that the injections are the same however the "
+		"simulation is split up among threads or nodes. "
+		"The default of 0 draws from the global random numbers.",
+		&Compartment::setSeed,
+		&Compartment::getSeed
+	);
+
+	static Finfo* compartmentFinfos[] = {
+		&seed,		// Value
+	};
 
 	static string doc[] =
 	{
@@ -38,10 +51,8 @@ const Cinfo* Compartment::initCinfo()
 	static Cinfo compartmentCinfo(
 				"Compartment",
 				CompartmentBase::initCinfo(),
-				0,
-				0,
-				// compartmentFinfos,
-				// sizeof( compartmentFinfos ) / sizeof( Finfo* ),
+				compartmentFinfos,
+				sizeof( compartmentFinfos ) / sizeof( Finfo* ),
 				&dinfo,
                 doc,
                 sizeof(doc)/sizeof(string)
@@ -86,6 +97,7 @@ Compartment::Compartment()
 	initVm_ = -0.06;
 	A_ = 0.0;
 	B_ = 0.0;
+	seed_ = 0;
 }
 
 Compartment::~Compartment()
@@ -173,6 +185,16 @@ double Compartment::vGetInitVm( const Eref& e ) const
 	return initVm_;
 }
 
+void Compartment::setSeed( const Eref& e, long seed )
+{
+	seed_ = seed;
+}
+
+long Compartment::getSeed( const Eref& e ) const
+{
+	return seed_;
+}
+
 
 //////////////////////////////////////////////////////////////////
 // Compartment::Dest function definitions.
@@ -208,6 +230,7 @@ void Compartment::vReinit(  const Eref& e, ProcPtr p )
         lastIm_ = 0.0;
 	sumInject_ = 0.0;
 	dt_ = p->dt;
+	rng_.setSeed( seed_, e.dataIndex() );
 	
 	// Send out the resting Vm to channels, SpikeGens, etc.
 	VmOut()->send( e, Vm_ );
@@ -254,7 +277,8 @@ void Compartment::vInjectMsg( const Eref& e, double current)
 
 void Compartment::vRandInject( const Eref& e, double prob, double current)
 {
-	if ( mtrand() < prob * dt_ ) {
+	double r = seed_ ? rng_.uniform() : mtrand();
+	if ( r < prob * dt_ ) {
 		sumInject_ += current;
 		Im_ += current;
 	}
@@ -11,6 +11,8 @@
 #ifndef _COMPARTMENT_H
 #define _COMPARTMENT_H
 
+#include "../randnum/CounterRng.h"
+
 /**
  * The Compartment class sets up an asymmetric compartment for
  * branched nerve calculations. Handles electronic structure and
@@ -41,6 +43,9 @@ class Compartment: public CompartmentBase
 			virtual double vGetInject( const Eref& e ) const;
 			virtual void vSetInitVm( const Eref& e, double initVm );
 			virtual double vGetInitVm( const Eref& e ) const;
+			/// Virtual so that zombies can keep the seed in a solver.
+			virtual void setSeed( const Eref& e, long seed );
+			virtual long getSeed( const Eref& e ) const;
 
 			// Dest function definitions.
 			/**
@@ -100,6 +105,8 @@ class Compartment: public CompartmentBase
 			 * compartment, with a probability prob. Note that it isn't
 			 * the current amplitude that is random, it is the presence
 			 * or absence of the current that is probabilistic.
+			 * The chance is drawn from this compartment's own stream
+			 * if it has a seed, otherwise from mtrand.
 			 */
 			void vRandInject( const Eref& e, double prob, double current);
 
@@ -131,6 +138,9 @@ class Compartment: public CompartmentBase
 	private:
 			double invRm_;
 			double dt_;
+			/// Seed of the stream for randInject, 0 for mtrand.
+			long seed_;
+			CounterRng rng_;
 			static const double EPSILON;
 };
 }
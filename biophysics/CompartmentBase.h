@@ -219,7 +219,7 @@ class CompartmentBase
 			// Required for solver setup
 			/////////////////////////////////////////////////////////////
 			
-			virtual void vSetSolver( const Eref& e, Id hsolve );
+			virtual void vSetSolver( const Eref& e, ObjId hsolve );
 			
 			/////////////////////////////////////////////////////////////
 			/**
@@ -246,7 +246,7 @@ class CompartmentBase
 			 * derived class. Used for making ZombieCompartments.
 			 */
 			static void zombify( Element* orig, const Cinfo* zClass,
-						Id hsolve );
+						ObjId hsolve );
 	private:
 			double diameter_;
 			double length_;
@@ -365,10 +365,10 @@ PFDD HHChannelBase::selectPower( double power )
 }
 /////////////////////////////////////////////////////////////////////
 // Dummy instantiation, the zombie derivatives make the real function
-void HHChannelBase::vSetSolver( const Eref& e, Id hsolve )
+void HHChannelBase::vSetSolver( const Eref& e, ObjId hsolve )
 {;}
 
-void HHChannelBase::zombify( Element* orig, const Cinfo* zClass, Id hsolve )
+void HHChannelBase::zombify( Element* orig, const Cinfo* zClass, ObjId hsolve )
 {
 	if ( orig->cinfo() == zClass )
 		return;
@@ -169,8 +169,8 @@ class HHChannelBase: public virtual ChanBase
 		/////////////////////////////////////////////////////////////
 		// Zombification functions.
 		/////////////////////////////////////////////////////////////
-		virtual void vSetSolver( const Eref& e, Id hsolve );
-		static void zombify( Element* orig, const Cinfo* zClass, Id hsolve);
+		virtual void vSetSolver( const Eref& e, ObjId hsolve );
+		static void zombify( Element* orig, const Cinfo* zClass, ObjId hsolve);
 
 		/////////////////////////////////////////////////////////////
 		static const Cinfo* initCinfo();
@@ -186,8 +186,8 @@ const Cinfo* MarkovSolverBase::initCinfo()
 
 static const Cinfo* markovSolverBaseCinfo = MarkovSolverBase::initCinfo();
 
-MarkovSolverBase::MarkovSolverBase() : Q_(0), expMats1d_(0), expMat_(0), 
-	expMats2d_(0), xMin_(DBL_MAX), xMax_(DBL_MIN), xDivs_(0u), 
+MarkovSolverBase::MarkovSolverBase() : Q_(0), lookupKind_( CONSTANT ),
+	numY_(1u), xMin_(DBL_MAX), xMax_(DBL_MIN), xDivs_(0u), 
 	yMin_(DBL_MAX), yMax_(DBL_MIN), yDivs_(0u), size_(0u), Vm_(0),
  	ligandConc_(0), dt_(0)
 {
@@ -198,28 +198,6 @@ MarkovSolverBase::~MarkovSolverBase()
 {
 	if ( Q_ )
 		delete Q_;
-
-	if ( !expMats1d_.empty() )
-	{
-		while ( !expMats1d_.empty() )
-		{
-			delete expMats1d_.back();
-			expMats1d_.pop_back();
-		}
-	}
-
-	if ( !expMats2d_.empty() )
-	{
-		unsigned int n = expMats2d_.size(); 
-		for( unsigned int i = 0; i < n; ++i )
-		{
-			for ( unsigned int j = 0; j < expMats2d_[i].size(); ++j )
-				delete expMats2d_[i][j];
-		}
-	}
-
-	if ( expMat_ != 0 )
-		delete expMat_;
 }
 
 ////////////////////////////////////
@@ -314,128 +292,95 @@ double MarkovSolverBase::getInvDy() const
 	return invDy_;		
 }
 
-Vector* MarkovSolverBase::bilinearInterpolate( ) const 
+const double* MarkovSolverBase::getExpMatrix( unsigned int xIndex, 
+											unsigned int yIndex ) const
 {
-	bool isEndOfX, isEndOfY;
-
-	unsigned int xIndex = 
-		static_cast< unsigned int >( ( Vm_ - xMin_ ) * invDx_ );
-	unsigned int yIndex = 
-		static_cast< unsigned int >( ( ligandConc_ - yMin_ ) * invDy_ );
-	double xv = (Vm_ - xMin_) * invDx_;
-	double yv = (ligandConc_ - yMin_) * invDy_;
-
-	double xF = xv - xIndex;
-	double yF = yv - yIndex;
-	double xFyF = xF * yF;
-
-	( xIndex == xDivs_ ) ? isEndOfX = true : isEndOfX = false;
-	( yIndex == yDivs_ ) ? isEndOfY = true : isEndOfY = false;
+	assert( yIndex < numY_ );
+	unsigned int offset = ( xIndex * numY_ + yIndex ) * size_ * size_;
+	assert( offset < expTable_.size() );
+	return &expTable_[ offset ];
+}
 
-	vector< vector< Matrix* > >::const_iterator iExpQ0 = 
-																					expMats2d_.begin() + xIndex;
-	vector< Matrix* >::const_iterator iExpQ00 = iExpQ0->begin() + yIndex;
-	vector< Matrix* >::const_iterator iExpQ10;
+void MarkovSolverBase::addWeightedState( const double* expQ, double weight )
+{
+	if ( weight == 0.0 )
+		return;
 
-	Matrix* expQ00 = *iExpQ00;
-	Matrix* expQ01;
-	Matrix* expQ10;
-	Matrix* expQ11;
-	Vector *state00, *state01, *state10, *state11, *result;
+	//Row vector times matrix. Going through expQ row by row keeps the
+	//inner loop on contiguous memory.
+	for ( unsigned int i = 0; i < size_; ++i )
+	{
+		double s = weight * state_[i];
+		const double* row = expQ + i * size_;
+		for ( unsigned int j = 0; j < size_; ++j )
+			nextState_[j] += s * row[j];
+	}
+}
 
-	state00 = vecMatMul( &state_, expQ00 );
-	if ( isEndOfX ) 
+//Finds the table index just below x, and the fractional distance of x
+//from it. Values outside the table are clamped to its ends.
+static void lookupIndex( double x, double xMin, double invDx, 
+				unsigned int xDivs, unsigned int& xIndex, double& xF )
+{
+	double xv = ( x - xMin ) * invDx;
+	if ( !( xv > 0.0 ) ) // Also catches NaN.
 	{
-		if ( isEndOfY )
-			return state00;
-		else
-		{
-			expQ01 = *(iExpQ00 + 1);
-			state01 = vecMatMul( &state_, expQ01 );
-			result =  vecVecScalAdd( state00, state01, 
-				 					  					(1 - yF), yF );
-		}
+		xIndex = 0;
+		xF = 0.0;
+	}
+	else if ( xv >= xDivs )
+	{
+		xIndex = xDivs;
+		xF = 0.0;
 	}
 	else
 	{
-		iExpQ10 = ( iExpQ0 + 1 )->begin() + yIndex;
-		expQ10 = *iExpQ10;
-		state10 = vecMatMul( &state_, expQ10 );
-
-		if ( isEndOfY )
-		{
-			result =  vecVecScalAdd( state00, state10, 
-							   							( 1 - xF ), xF );
-		}
-		else
-		{
-			expQ01 = *( iExpQ00 + 1 );
-			expQ11 = *( iExpQ10 + 1 );
-
-			state01 = vecMatMul( &state_, expQ01 );
-			state11 = vecMatMul( &state_, expQ11 );
-
-			Vector *temp1, *temp2;
-
-			temp1 = vecVecScalAdd( state00, state10, 
-												( 1 - xF - yF + xFyF ),
-												( xF - xFyF )
-														); 
+		xIndex = static_cast< unsigned int >( xv );
+		xF = xv - xIndex;
+	}
+}
 
-			temp2 = vecVecScalAdd( state01, state11, ( yF - xFyF ), xFyF );
+void MarkovSolverBase::bilinearInterpolate( ) 
+{
+	unsigned int xIndex, yIndex;
+	double xF, yF;
 
-			result = vecVecScalAdd( temp1, temp2, 1.0, 1.0 );
+	lookupIndex( Vm_, xMin_, invDx_, xDivs_, xIndex, xF );
+	lookupIndex( ligandConc_, yMin_, invDy_, yDivs_, yIndex, yF );
 
-			delete temp1;
-			delete temp2;
-		}
+	//Weights of the four corners are zero at the ends of the table, so 
+	//that the indices beyond the ends are never read.
+	addWeightedState( getExpMatrix( xIndex, yIndex ), 
+					( 1 - xF ) * ( 1 - yF ) );
+	if ( yF > 0.0 )
+		addWeightedState( getExpMatrix( xIndex, yIndex + 1 ), 
+						( 1 - xF ) * yF );
+	if ( xF > 0.0 )
+	{
+		addWeightedState( getExpMatrix( xIndex + 1, yIndex ), 
+						xF * ( 1 - yF ) );
+		if ( yF > 0.0 )
+			addWeightedState( getExpMatrix( xIndex + 1, yIndex + 1 ), 
+							xF * yF );
 	}
-
-	if ( state00 )
-		delete state00;	
-	if ( state01 )
-		delete state01;
-	if ( state10 )
-		delete state10;
-	if ( state11) 
-		delete state11;
-
-	return result;
 }
 
-Vector* MarkovSolverBase::linearInterpolate() const
+void MarkovSolverBase::linearInterpolate()
 {
 	double x;
 
-	if ( rateTable_->areAllRatesVoltageDep() )
+	if ( lookupKind_ == LINEAR_VOLTAGE )
 		x = Vm_;
 	else
 		x = ligandConc_;
 
-	if ( x < xMin_ )
-		return vecMatMul( &state_, expMats1d_[0] ); 
-	else if ( x > xMax_ )
-		return vecMatMul( &state_, expMats1d_.back() );
-
-	unsigned int xIndex = static_cast< unsigned int >( ( x - xMin_) * invDx_ );
-
-	double xv = ( x - xMin_ ) * invDx_;
-	double xF = xv - xIndex;
-
-	vector< Matrix* >::const_iterator iExpQ = 
-																					expMats1d_.begin() + xIndex;
-
-	Vector *state0, *state1, *result;
-
-	state0 = vecMatMul( &state_, *iExpQ );
-	state1 = vecMatMul( &state_, *( iExpQ + 1 ) );
+	unsigned int xIndex;
+	double xF;
+	lookupIndex( x, xMin_, invDx_, xDivs_, xIndex, xF );
 
-	result = vecVecScalAdd( state0, state1, 1 - xF, xF ); 
-
-	delete state0;
-	delete state1;
-
-	return result;
+	addWeightedState( getExpMatrix( xIndex, 0 ), 1 - xF );
+	if ( xF > 0.0 )
+		addWeightedState( getExpMatrix( xIndex + 1, 0 ), xF );
 }
 
 //Computes the updated state of the system. Is called from the process function.
@@ -447,37 +392,24 @@ Vector* MarkovSolverBase::linearInterpolate() const
 //states to calculate the final one.
 //In case all rates are 1D, then, the above-mentioned interpolation is
 //only one-dimensional in nature.
+//The interpolation is linear in the exponentials, so the weighted state
+//from each exponential is accumulated directly into nextState_.
 void MarkovSolverBase::computeState( )
 {
-	Vector* newState;
-	bool useBilinear = false;
-    // useLinear = false;
+	if ( expTable_.empty() || state_.size() != size_ )
+		return;
 
-	if ( rateTable_->areAnyRates2d() || 
-			( rateTable_->areAllRates1d() && 
- 			  rateTable_->areAnyRatesVoltageDep() && 
-			  rateTable_->areAnyRatesLigandDep() 
-			)  )
-	{
-		useBilinear = true;
-	}
-	/*
-	else if ( rateTable_->areAllRatesVoltageDep() ||
-						rateTable_->areAllRatesLigandDep() )
-	{
-		useLinear = true;
-	}
-	*/
+	nextState_.assign( size_, 0.0 );
 
 	//Heavily borrows from the Interpol2D::interpolate function.
-	if ( useBilinear ) 
-		newState = bilinearInterpolate();
+	if ( lookupKind_ == BILINEAR ) 
+		bilinearInterpolate();
+	else if ( lookupKind_ == CONSTANT )
+		addWeightedState( getExpMatrix( 0, 0 ), 1.0 );
 	else
-		newState = linearInterpolate();
-
-	state_ = *newState;
+		linearInterpolate();
 
-	delete newState;
+	state_.swap( nextState_ );
 }
 
 void MarkovSolverBase::innerFillupTable(  	
@@ -510,9 +442,6 @@ void MarkovSolverBase::innerFillupTable(
 																		 
 void MarkovSolverBase::fillupTable()
 {
-	double dx = (xMax_ - xMin_) / xDivs_;  			
-	double dy = (yMax_ - yMin_) / yDivs_;  			
-
 	vector< unsigned int > listOf1dRates = rateTable_->getListOf1dRates();
 	vector< unsigned int > listOf2dRates = rateTable_->getListOf2dRates();
 	vector< unsigned int > listOfConstantRates = 
@@ -524,17 +453,10 @@ void MarkovSolverBase::fillupTable()
 
 	//xIndex loops through all voltages, yIndex loops through all
 	//ligand concentrations.
-	if ( rateTable_->areAnyRates2d() || 
-			( rateTable_->areAllRates1d() && 
- 			  rateTable_->areAnyRatesVoltageDep() && 
-			  rateTable_->areAnyRatesLigandDep() 
-			)  )
+	if ( lookupKind_ == BILINEAR )
 	{
-		double voltage = xMin_, ligandConc = yMin_;
-
 		for ( unsigned int xIndex = 0; xIndex < xDivs_ + 1; ++xIndex )
 		{
-			ligandConc = yMin_;
 			for( unsigned int yIndex = 0; yIndex < yDivs_ + 1; ++yIndex ) 
 			{
 				innerFillupTable( listOf2dRates, "2D", xIndex, yIndex ); 
@@ -545,43 +467,61 @@ void MarkovSolverBase::fillupTable()
 				//to maintain.
 				innerFillupTable( listOf1dRates, "1D", xIndex, yIndex ); 
 
-				expMats2d_[xIndex][yIndex] = computeMatrixExponential();
-				ligandConc += dy;
+				storeMatrixExponential( xIndex, yIndex );
 			}
-			voltage += dx;
 		}
 	}
-	else if ( rateTable_->areAllRatesLigandDep() )
+	else if ( lookupKind_ == LINEAR_LIGAND )
 	{
-		double x = xMin_;
 		vector< unsigned int > listOfLigandRates = 
 													rateTable_->getListOfLigandRates();
 
 		for ( unsigned int xIndex = 0; xIndex < xDivs_ + 1; ++xIndex )
 		{
 			innerFillupTable( listOfLigandRates, "1D", xIndex, 0 );
-			expMats1d_[xIndex] = computeMatrixExponential();
-			x += dx;
+			storeMatrixExponential( xIndex, 0 );
 		}
 	}
-	else if ( rateTable_->areAllRatesVoltageDep() )
+	else if ( lookupKind_ == LINEAR_VOLTAGE )
 	{
-		double x = xMin_;
 		vector< unsigned int > listOfVoltageRates = 
 												 rateTable_->getListOfVoltageRates();
 
 		for ( unsigned int xIndex = 0; xIndex < xDivs_ + 1; ++xIndex )
 		{
 			innerFillupTable( listOfVoltageRates, "1D", xIndex, 0 );
-			expMats1d_[xIndex] = computeMatrixExponential();
-			x += dx;
+			storeMatrixExponential( xIndex, 0 );
 		}
 	}
-	else if ( rateTable_->areAllRatesConstant() ) 
+	else
+	{
+		storeMatrixExponential( 0, 0 );
+	}
+}
+
+void MarkovSolverBase::storeMatrixExponential( unsigned int xIndex, 
+											unsigned int yIndex )
+{
+	if ( expTable_.empty() ) //An earlier exponential has failed.
+		return;
+
+	Matrix* expQ = computeMatrixExponential();
+	if ( expQ == 0 )
 	{
-		expMat_ = computeMatrixExponential();
+		cout << "Warning: MarkovSolverBase::storeMatrixExponential: "
+				"no matrix exponential for this solver class.\n";
+		expTable_.clear();
 		return;
 	}
+	assert( expQ->size() == size_ );
+
+	double* dest = &expTable_[ ( xIndex * numY_ + yIndex ) * size_ * size_ ];
+	for ( unsigned int i = 0; i < size_; ++i )
+	{
+		assert( (*expQ)[i].size() == size_ );
+		copy( (*expQ)[i].begin(), (*expQ)[i].end(), dest + i * size_ );
+	}
+	delete expQ;
 }
 
 Matrix* MarkovSolverBase::computeMatrixExponential() 
@@ -634,27 +574,37 @@ void MarkovSolverBase::init( Id rateTableId, double dt )
 	rateTable_ = rateTable;
 	setLookupParams( );
 	
+	numY_ = 1;
 	if ( rateTable->areAnyRates2d() || 
 			( rateTable->areAllRates1d() && 
  			  rateTable->areAnyRatesVoltageDep() && 
 			  rateTable->areAnyRatesLigandDep() 
 			)  )
 	{
-		expMats2d_.resize( xDivs_ + 1 );
-		for( unsigned int i = 0; i < xDivs_ + 1; ++i )
-			expMats2d_[i].resize( yDivs_ + 1);
+		lookupKind_ = BILINEAR;
+		numY_ = yDivs_ + 1;
+		expTable_.assign( ( xDivs_ + 1 ) * numY_ * size_ * size_, 0.0 );
 	}
-	else if ( rateTable->areAllRatesLigandDep() ||
-						rateTable->areAllRatesVoltageDep() )
+	else if ( rateTable->areAllRatesLigandDep() )
 	{
-		expMats1d_.resize( xDivs_ + 1);
+		lookupKind_ = LINEAR_LIGAND;
+		expTable_.assign( ( xDivs_ + 1 ) * size_ * size_, 0.0 );
+	}
+	else if ( rateTable->areAllRatesVoltageDep() )
+	{
+		lookupKind_ = LINEAR_VOLTAGE;
+		expTable_.assign( ( xDivs_ + 1 ) * size_ * size_, 0.0 );
 	}
 	else	//All rates must be constant.
 	{
-		expMat_ = matAlloc( size_ );
+		lookupKind_ = CONSTANT;
+		expTable_.assign( size_ * size_, 0.0 );
 	}
+	nextState_.assign( size_, 0.0 );
 
 	//Initializing Q.
+	if ( Q_ )
+		delete Q_;
 	Q_ = matAlloc( size_ );		
 
 	//The state at t = t0 + dt is exp( dt * Q ) * [state at t = t0].
@@ -91,10 +91,16 @@ class MarkovSolverBase {
 
 	//This returns the pointer to the exponential of the Q matrix.
 	virtual Matrix* computeMatrixExponential();
+
+	//Returns the stored exponential at the given lookup table indices, as
+	//a row-major size_ x size_ array.
+	const double* getExpMatrix( unsigned int xIndex, unsigned int yIndex ) 
+		const;
 	
-	//State space interpolation routines.
-	Vector* bilinearInterpolate() const;
-	Vector* linearInterpolate() const;
+	//State space interpolation routines. These fill nextState_ with the
+	//updated state.
+	void bilinearInterpolate();
+	void linearInterpolate();
 
 	//Computes the updated state of the system. Is called from the process
 	//function.
@@ -144,35 +150,47 @@ class MarkovSolverBase {
 	//Sets the values of xMin, xMax, xDivs, yMin, yMax, yDivs.
 	void setLookupParams();
 
+	//Computes the exponential of the current Q_ and stores it in the
+	//lookup table at the given indices.
+	void storeMatrixExponential( unsigned int xIndex, unsigned int yIndex );
+
+	//Adds weight * ( state_ * expQ ) to nextState_. This is the only 
+	//kernel used in the state space interpolation, so that interpolating 
+	//and multiplying by the exponentials is done in one pass over each 
+	//matrix, without any temporary vectors.
+	void addWeightedState( const double* expQ, double weight );
+
 	//////////////
 	//Lookup table related stuff.
 	/////////////
 	/*
 	* Exponentials of all rate matrices that are generated over the 
-	* duration of the simulation. The idea is that when copies of the channel
-	* are made, they will all refer this table to get the appropriate 
-	* exponential matrix. 
+	* duration of the simulation. 
 	*
 	* The exponential matrices are computed over a range of voltage levels 
-	* and/or ligand concentrations and stored in the appropriate lookup table.
+	* and/or ligand concentrations and stored in the lookup table below.
 	*
 	* Depending on whether
 	* 1) All rates are constant,
 	* 2) Rates vary with only 1 parameter i.e. ligand/votage,
 	* 3) Some rates are 2D i.e. vary with two parameters,
-	* we store the table of exponentials in the appropriate pointers below.
+	* the table holds 1, xDivs_ + 1, or (xDivs_ + 1) * (yDivs_ + 1) 
+	* exponentials respectively.
 	*
-	* If a system contains both 2D and 1D rates, then, only the 2D pointer 
+	* If a system contains both 2D and 1D rates, then, the 2D table
 	* is used. 
 	*/
-	//Used for storing exponentials when at least one of the rates are 1D and
-	//none are 2D.
-	vector< Matrix* > expMats1d_;
+	enum LookupKind { CONSTANT, LINEAR_VOLTAGE, LINEAR_LIGAND, BILINEAR };
+	LookupKind lookupKind_;
 
-	Matrix* expMat_;
+	//All the exponentials, one after the other in row-major order, 
+	//indexed by xIndex * numY_ + yIndex. Keeping them in a single 
+	//contiguous block saves a pointer chase per row on every lookup.
+	vector< double > expTable_;
 
-	//Used for storing exponentials when at least one of the rates are 2D.
-	vector< vector< Matrix* > > expMats2d_;
+	//Number of y entries in the table for each x, which is 1 unless
+	//lookupKind_ is BILINEAR.
+	unsigned int numY_;
 
 	double xMin_;
 	double xMax_;
@@ -194,6 +212,10 @@ class MarkovSolverBase {
 	//Instantaneous state of the system.
 	Vector state_;
 
+	//Scratch space for the state being computed, swapped with state_ 
+	//at the end of each step.
+	Vector nextState_;
+
 	//Initial state of the system.
 	Vector initialState_;
 
@@ -9,6 +9,7 @@
 
 #include "header.h"
 #include "../randnum/randnum.h"
+#include "../randnum/CounterRng.h"
 #include "RandSpike.h"
 
 	///////////////////////////////////////////////////////
@@ -71,6 +72,15 @@ const Cinfo* RandSpike::initCinfo()
 		"True if RandSpike has just fired",
 		&RandSpike::getFired
 	);
+	static ValueFinfo< RandSpike, long > seed( "seed",
+		"Seed for a random number stream private to this RandSpike. "
+		"Each entry of an array of RandSpikes gets its own stream, "
+		"restarted on reinit, so that the spike trains are the same "
+		"however the simulation is split up among threads or nodes. "
+		"The default of 0 draws from the global random numbers.",
+		&RandSpike::setSeed,
+		&RandSpike::getSeed
+	);
 
 	static Finfo* spikeGenFinfos[] = 
 	{
@@ -80,6 +90,7 @@ const Cinfo* RandSpike::initCinfo()
 		&refractT,	// Value
 		&absRefract,	// Value
 		&hasFired,	// ReadOnlyValue
+		&seed,		// Value
 	};
 
 	static string doc[] =
@@ -111,7 +122,8 @@ RandSpike::RandSpike()
       refractT_(0.0),
       lastEvent_(0.0),
 	  threshold_(0.0),
-	  fired_( 0 )
+	  fired_( 0 ),
+	  seed_( 0 )
 {;}
 
 //////////////////////////////////////////////////////////////////
@@ -149,6 +161,21 @@ bool RandSpike::getFired() const
 	return fired_;
 }
 
+void RandSpike::setSeed( long seed )
+{
+	seed_ = seed;
+}
+
+long RandSpike::getSeed() const
+{
+	return seed_;
+}
+
+double RandSpike::uniform()
+{
+	return seed_ ? rng_.uniform() : mtrand();
+}
+
 
 //////////////////////////////////////////////////////////////////
 // RandSpike::Dest function definitions.
@@ -159,7 +186,7 @@ void RandSpike::process( const Eref& e, ProcPtr p )
 	if ( refractT_ > p->currTime - lastEvent_ )
 		return;
 	double prob = realRate_ * p->dt;
-	if ( prob >= 1.0 || prob >= mtrand() ) 
+	if ( prob >= 1.0 || prob >= uniform() ) 
 	{
 		lastEvent_ = p->currTime;
 		spikeOut()->send( e, p->currTime );
@@ -172,11 +199,12 @@ void RandSpike::process( const Eref& e, ProcPtr p )
 // Set it so that first spike is allowed.
 void RandSpike::reinit( const Eref& e, ProcPtr p )
 {
+	rng_.setSeed( seed_, e.dataIndex() );
 	if ( rate_ <= 0.0 ) {
 		lastEvent_ = 0.0;
 		realRate_ = 0.0;
 	} else {
-		double prob = mtrand();
+		double prob = uniform();
 		double m = 1.0 / rate_;
 		lastEvent_ = m * log( prob );
 	}
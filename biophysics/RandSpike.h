@@ -26,6 +26,9 @@ class RandSpike
 
         bool getFired() const;
 
+		void setSeed( long seed );
+		long getSeed() const;
+
 	//////////////////////////////////////////////////////////////////
 	// Message dest functions.
 	//////////////////////////////////////////////////////////////////
@@ -42,6 +45,12 @@ class RandSpike
 		double lastEvent_;
 		double threshold_;
 		bool fired_;
+		/// Seed of the stream for this spike train, 0 for mtrand.
+		long seed_;
+		CounterRng rng_;
+
+		/// Uniform number from rng_ or from the global generator.
+		double uniform();
 };
 
 #endif // _RANDSPIKE_H
@@ -13,6 +13,11 @@
 #include "../randnum/randnum.h"
 #include "CompartmentBase.h"
 #include "Compartment.h"
+#include "MatrixOps.h"
+#include "VectorTable.h"
+#include "../builtins/Interpol2D.h"
+#include "MarkovRateTable.h"
+#include "MarkovSolverBase.h"
 /*
 #include "HHGate.h"
 #include "ChanBase.h"
@@ -42,7 +47,7 @@ void testIntFireNetwork( unsigned int runsteps = 5 )
 	static const double delayMax = 4;
 	static const double delayMin = 0;
 	static const double connectionProbability = 0.1;
-	static const unsigned int NUM_TOT_SYN = 104576;
+	static const unsigned int NUM_TOT_SYN = 104806;
 	unsigned int size = 1024;
 	string arg;
 	Eref sheller( Id().eref() );
@@ -66,6 +71,9 @@ void testIntFireNetwork( unsigned int runsteps = 5 )
 	
 	SetGet2< double, long >::set( mid, "setRandomConnectivity", 
 		connectionProbability, 5489UL );
+	// The connections come from the msg's own stream, so seed the global
+	// generator used for the weights, delays and Vm below.
+	mtseed( 5489UL );
 
 	mid = shell->doAddMsg( "OneToOne", i2, "activationOut",
 		fire, "activation" );
@@ -75,12 +83,11 @@ void testIntFireNetwork( unsigned int runsteps = 5 )
 	if ( Shell::numNodes() == 1 )
 		assert( nd == NUM_TOT_SYN );
 	else if ( Shell::numNodes() == 2 )
-		assert( nd == 52446 );
+		assert( nd == 52578 );
 	else if ( Shell::numNodes() == 3 )
-		//assert( nd == 34969 );
-		assert( nd == 35087 );
+		assert( nd == 35075 );
 	else if ( Shell::numNodes() == 4 )
-		assert( nd == 26381 );
+		assert( nd == 26403 );
 
 	//////////////////////////////////////////////////////////////////
 	// Checking access to message info through SparseMsg on many nodes.
@@ -208,7 +215,6 @@ void testIntFireNetwork( unsigned int runsteps = 5 )
 		assert( doubleEq( retVm900, 0.12525297735741736 ) );
 		assert( doubleEq( retVm901, 0.28303358631241327 ) );
 		assert( doubleEq( retVm902, 0.0096374021108587178 ) );
-		*/
 		assert( doubleEq( retVm100, 0.069517018453329804 ) );
 		assert( doubleEq( retVm101, 0.32823493598699577 ) );
 		assert( doubleEq( retVm102, 0.35036493874475361 ) );
@@ -216,6 +222,14 @@ void testIntFireNetwork( unsigned int runsteps = 5 )
 		assert( doubleEq( retVm900, 0.26414663635984065 ) );
 		assert( doubleEq( retVm901, 0.39864519810259352 ) );
 		assert( doubleEq( retVm902, 0.04818717439429359 ) );
+		*/
+		assert( doubleEq( retVm100, 0.17501486504778269 ) );
+		assert( doubleEq( retVm101, 0.3775658718843759 ) );
+		assert( doubleEq( retVm102, 0.40885539462223658 ) );
+		assert( doubleEq( retVm99,  0.02932255813808636 ) );
+		assert( doubleEq( retVm900, 0.041695715546174801 ) );
+		assert( doubleEq( retVm901, 0.36636576602011922 ) );
+		assert( doubleEq( retVm902, 0.10124797721922399 ) );
 
 	}
 	/*
@@ -1217,6 +1231,46 @@ void testMarkovChannel()
 	Field< vector< double > >::set( exptlSolverId, "initialState", 
                                         initState );
 
+	//State space interpolation in the MarkovSolver. Stepping from the
+	//same state, the result midway between two voltage entries of the
+	//table must be the mean of the results at the two entries, and the 
+	//probabilities must still add up to 1.
+	MarkovSolverBase* exptlSolver = reinterpret_cast< MarkovSolverBase* >(
+					ObjId( exptlSolverId ).data() );
+	double xmin = exptlSolver->getXmin();
+	double dx = 1.0 / exptlSolver->getInvDx();
+	vector< double > stateAt[3];
+	for ( unsigned int i = 0; i < 3; ++i )
+	{
+		exptlSolver->setInitialState( initState );
+		exptlSolver->handleVm( xmin + ( 120 + 0.5 * i ) * dx );
+		exptlSolver->computeState();
+		stateAt[i] = exptlSolver->getState();
+		assert( stateAt[i].size() == 4 );
+		double sum = 0.0;
+		for ( unsigned int j = 0; j < 4; ++j )
+		{
+			assert( stateAt[i][j] >= 0.0 );
+			sum += stateAt[i][j];
+		}
+		assert( doubleEq( sum, 1.0 ) );
+	}
+	for ( unsigned int j = 0; j < 4; ++j )
+		assert( doubleEq( stateAt[1][j], 
+							0.5 * ( stateAt[0][j] + stateAt[2][j] ) ) );
+
+	//Voltages beyond the table use its last entry.
+	exptlSolver->setInitialState( initState );
+	exptlSolver->handleVm( exptlSolver->getXmax() );
+	exptlSolver->computeState();
+	stateAt[0] = exptlSolver->getState();
+	exptlSolver->setInitialState( initState );
+	exptlSolver->handleVm( 1.0 );
+	exptlSolver->computeState();
+	for ( unsigned int j = 0; j < 4; ++j )
+		assert( doubleEq( exptlSolver->getState()[j], stateAt[0][j] ) );
+	exptlSolver->setInitialState( initState );
+
 	Field< double >::set( gslSolverId, "relativeAccuracy", 1e-24 );
 	Field< double >::set( gslSolverId, "absoluteAccuracy", 1e-24 );
 	Field< double >::set( gslSolverId, "internalDt", 1e-24 );
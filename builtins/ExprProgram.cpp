@@ -0,0 +1,732 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include <cstdlib>
+#include <cctype>
+#include "ExprProgram.h"
+
+const unsigned int ExprProgram::MaxDepth;
+const unsigned int ExprProgram::BlockSize;
+
+namespace {
+
+enum OpCode {
+	CONST, VAR, ARG, TIME,
+	NEG, ADD, SUB, MUL, DIV, POW, SQR,
+	LT, GT, LE, GE, EQ, NE, AND, OR, SELECT,
+	FUNC1, ATAN2, SUM, AVG, MIN, MAX
+};
+
+// The builtin functions of mu::Parser, computed the same way as there.
+double fSin( double v ) { return sin( v ); }
+double fCos( double v ) { return cos( v ); }
+double fTan( double v ) { return tan( v ); }
+double fASin( double v ) { return asin( v ); }
+double fACos( double v ) { return acos( v ); }
+double fATan( double v ) { return atan( v ); }
+double fSinh( double v ) { return sinh( v ); }
+double fCosh( double v ) { return cosh( v ); }
+double fTanh( double v ) { return tanh( v ); }
+double fASinh( double v ) { return log( v + sqrt( v * v + 1 ) ); }
+double fACosh( double v ) { return log( v + sqrt( v * v - 1 ) ); }
+double fATanh( double v ) { return 0.5 * log( ( 1 + v ) / ( 1 - v ) ); }
+double fLog2( double v ) { return log( v ) / log( 2.0 ); }
+double fLog10( double v ) { return log10( v ); }
+double fLn( double v ) { return log( v ); }
+double fExp( double v ) { return exp( v ); }
+double fSqrt( double v ) { return sqrt( v ); }
+double fSign( double v ) { return ( v < 0 ) ? -1 : ( v > 0 ) ? 1 : 0; }
+double fRint( double v ) { return floor( v + 0.5 ); }
+double fAbs( double v ) { return ( v >= 0 ) ? v : -v; }
+
+struct Func1Entry {
+	const char* name;
+	double ( *f )( double );
+};
+
+const Func1Entry func1Table[] = {
+	{ "sin", fSin }, { "cos", fCos }, { "tan", fTan },
+	{ "asin", fASin }, { "acos", fACos }, { "atan", fATan },
+	{ "sinh", fSinh }, { "cosh", fCosh }, { "tanh", fTanh },
+	{ "asinh", fASinh }, { "acosh", fACosh }, { "atanh", fATanh },
+	{ "log2", fLog2 }, { "log10", fLog10 }, { "log", fLog10 },
+	{ "ln", fLn }, { "exp", fExp }, { "sqrt", fSqrt },
+	{ "sign", fSign }, { "rint", fRint }, { "abs", fAbs },
+	{ 0, 0 }
+};
+
+/**
+ * Runs a program on one pool vector. Both ExprProgram::eval and the
+ * constant folding in the compiler use this, so folded values are
+ * exactly those the unfolded program would give.
+ */
+double run( const vector< ExprProgram::Instr >& code,
+				const double* S, double t )
+{
+	double stack[ ExprProgram::MaxDepth ];
+	double* top = stack - 1;
+	for ( vector< ExprProgram::Instr >::const_iterator
+					i = code.begin(); i != code.end(); ++i ) {
+		switch ( i->op ) {
+			case CONST: *++top = i->x; break;
+			case VAR: *++top = *i->p; break;
+			case ARG: *++top = S[ i->n ]; break;
+			case TIME: *++top = t; break;
+			case NEG: *top = -*top; break;
+			case ADD: --top; top[0] += top[1]; break;
+			case SUB: --top; top[0] -= top[1]; break;
+			case MUL: --top; top[0] *= top[1]; break;
+			case DIV: --top; top[0] /= top[1]; break;
+			case POW: --top; top[0] = pow( top[0], top[1] ); break;
+			case SQR: top[0] *= top[0]; break;
+			case LT: --top; top[0] = top[0] < top[1]; break;
+			case GT: --top; top[0] = top[0] > top[1]; break;
+			case LE: --top; top[0] = top[0] <= top[1]; break;
+			case GE: --top; top[0] = top[0] >= top[1]; break;
+			case EQ: --top; top[0] = top[0] == top[1]; break;
+			case NE: --top; top[0] = top[0] != top[1]; break;
+			case AND: --top; top[0] = top[0] && top[1]; break;
+			case OR: --top; top[0] = top[0] || top[1]; break;
+			case SELECT:
+				top -= 2;
+				top[0] = ( top[0] != 0 ) ? top[1] : top[2];
+				break;
+			case FUNC1: *top = i->f( *top ); break;
+			case ATAN2: --top; top[0] = atan2( top[0], top[1] ); break;
+			case SUM:
+			case AVG: {
+				top -= i->n - 1;
+				double sum = 0.0;
+				for ( unsigned int k = 0; k < i->n; ++k )
+					sum += top[k];
+				top[0] = ( i->op == AVG ) ? sum / i->n : sum;
+				break;
+			}
+			case MIN:
+			case MAX: {
+				top -= i->n - 1;
+				double ret = top[0];
+				for ( unsigned int k = 1; k < i->n; ++k )
+					ret = ( i->op == MIN ) ?
+							min( ret, top[k] ) : max( ret, top[k] );
+				top[0] = ret;
+				break;
+			}
+			default:
+				assert( 0 );
+		}
+	}
+	assert( top == stack );
+	return stack[0];
+}
+
+/**
+ * Recursive descent parser for the muParser grammar. It builds a tree of
+ * instructions, folding each node whose arguments are all constants as
+ * it goes, and then emits the tree in postfix order.
+ * Precedence from lowest: ?:, ||, &&, comparisons, + and -, * and /,
+ * the sign, and ^.
+ */
+class ExprCompiler
+{
+	public:
+		ExprCompiler( const string& expr,
+				const map< string, double >& consts,
+				const map< string, ExprProgram::Var >& vars )
+			: s_( expr ), pos_( 0 ), consts_( consts ), vars_( vars )
+		{;}
+
+		/// Parses the whole expression, returns the root node.
+		bool parse( unsigned int& root )
+		{
+			if ( !ternary( root ) )
+				return false;
+			skipSpace();
+			return pos_ == s_.size();
+		}
+
+		/// Emits the tree under node in postfix order.
+		void emit( unsigned int node, vector< ExprProgram::Instr >& code,
+				unsigned int& depth, unsigned int& maxDepth ) const
+		{
+			const Node& nd = nodes_[ node ];
+			for ( unsigned int i = 0; i < nd.kids.size(); ++i )
+				emit( nd.kids[i], code, depth, maxDepth );
+			code.push_back( nd.in );
+			depth = depth + 1 - nd.kids.size();
+			if ( depth > maxDepth )
+				maxDepth = depth;
+		}
+
+	private:
+		struct Node {
+			ExprProgram::Instr in;
+			vector< unsigned int > kids;
+		};
+
+		static ExprProgram::Instr instr( unsigned int op )
+		{
+			ExprProgram::Instr in;
+			in.op = op;
+			in.n = 0;
+			in.x = 0.0;
+			in.p = 0;
+			in.f = 0;
+			return in;
+		}
+
+		unsigned int leaf( const ExprProgram::Instr& in )
+		{
+			Node nd;
+			nd.in = in;
+			nodes_.push_back( nd );
+			return nodes_.size() - 1;
+		}
+
+		bool isConst( unsigned int node ) const
+		{
+			return nodes_[ node ].in.op == CONST;
+		}
+
+		/// Makes an operator node, folding it if all its args are constant.
+		unsigned int node( const ExprProgram::Instr& in,
+						const vector< unsigned int >& kids )
+		{
+			bool allConst = true;
+			for ( unsigned int i = 0; i < kids.size(); ++i )
+				allConst = allConst && isConst( kids[i] );
+			if ( allConst ) {
+				vector< ExprProgram::Instr > code;
+				for ( unsigned int i = 0; i < kids.size(); ++i )
+					code.push_back( nodes_[ kids[i] ].in );
+				code.push_back( in );
+				ExprProgram::Instr c = instr( CONST );
+				c.x = run( code, 0, 0.0 );
+				return leaf( c );
+			}
+			if ( in.op == SELECT && isConst( kids[0] ) )
+				return ( nodes_[ kids[0] ].in.x != 0 ) ? kids[1] : kids[2];
+			Node nd;
+			nd.in = in;
+			nd.kids = kids;
+			nodes_.push_back( nd );
+			return nodes_.size() - 1;
+		}
+
+		unsigned int node( unsigned int op, unsigned int a )
+		{
+			return node( instr( op ), vector< unsigned int >( 1, a ) );
+		}
+
+		unsigned int node( unsigned int op, unsigned int a, unsigned int b )
+		{
+			vector< unsigned int > kids( 1, a );
+			kids.push_back( b );
+			return node( instr( op ), kids );
+		}
+
+		void skipSpace()
+		{
+			while ( pos_ < s_.size() &&
+					s_[ pos_ ] > 0 && s_[ pos_ ] <= 0x20 )
+				++pos_;
+		}
+
+		/// Consumes the token tok if it is next.
+		bool match( const char* tok )
+		{
+			skipSpace();
+			if ( s_.compare( pos_, strlen( tok ), tok ) != 0 )
+				return false;
+			pos_ += strlen( tok );
+			return true;
+		}
+
+		bool ternary( unsigned int& ret )
+		{
+			if ( !lor( ret ) )
+				return false;
+			if ( !match( "?" ) )
+				return true;
+			unsigned int a, b;
+			if ( !ternary( a ) || !match( ":" ) || !ternary( b ) )
+				return false;
+			vector< unsigned int > kids( 1, ret );
+			kids.push_back( a );
+			kids.push_back( b );
+			ret = node( instr( SELECT ), kids );
+			return true;
+		}
+
+		bool lor( unsigned int& ret )
+		{
+			if ( !land( ret ) )
+				return false;
+			while ( match( "||" ) ) {
+				unsigned int b;
+				if ( !land( b ) )
+					return false;
+				ret = node( OR, ret, b );
+			}
+			return true;
+		}
+
+		bool land( unsigned int& ret )
+		{
+			if ( !compare( ret ) )
+				return false;
+			while ( match( "&&" ) ) {
+				unsigned int b;
+				if ( !compare( b ) )
+					return false;
+				ret = node( AND, ret, b );
+			}
+			return true;
+		}
+
+		bool compare( unsigned int& ret )
+		{
+			static const char* tok[] = { "<=", ">=", "==", "!=", "<", ">" };
+			static const unsigned int op[] = { LE, GE, EQ, NE, LT, GT };
+			if ( !addSub( ret ) )
+				return false;
+			unsigned int i = 0;
+			while ( i < 6 ) {
+				if ( !match( tok[i] ) ) {
+					++i;
+					continue;
+				}
+				unsigned int b;
+				if ( !addSub( b ) )
+					return false;
+				ret = node( op[i], ret, b );
+				i = 0; // Look for another comparison.
+			}
+			return true;
+		}
+
+		bool addSub( unsigned int& ret )
+		{
+			if ( !mulDiv( ret ) )
+				return false;
+			while ( true ) {
+				unsigned int op;
+				if ( match( "+" ) )
+					op = ADD;
+				else if ( match( "-" ) )
+					op = SUB;
+				else
+					return true;
+				unsigned int b;
+				if ( !mulDiv( b ) )
+					return false;
+				ret = node( op, ret, b );
+			}
+		}
+
+		bool mulDiv( unsigned int& ret )
+		{
+			if ( !unary( ret ) )
+				return false;
+			while ( true ) {
+				unsigned int op;
+				if ( match( "*" ) )
+					op = MUL;
+				else if ( match( "/" ) )
+					op = DIV;
+				else
+					return true;
+				unsigned int b;
+				if ( !unary( b ) )
+					return false;
+				ret = node( op, ret, b );
+			}
+		}
+
+		// The sign binds less tightly than the power, so -2^2 is -4.
+		bool unary( unsigned int& ret )
+		{
+			if ( match( "-" ) ) {
+				if ( !unary( ret ) )
+					return false;
+				ret = node( NEG, ret );
+				return true;
+			}
+			return power( ret );
+		}
+
+		// The power is right associative, 2^3^2 is 2^9.
+		bool power( unsigned int& ret )
+		{
+			if ( !primary( ret ) )
+				return false;
+			if ( !match( "^" ) )
+				return true;
+			unsigned int b;
+			if ( !unary( b ) )
+				return false;
+			if ( isConst( b ) && nodes_[ b ].in.x == 2.0 )
+				ret = node( SQR, ret );
+			else
+				ret = node( POW, ret, b );
+			return true;
+		}
+
+		bool primary( unsigned int& ret )
+		{
+			skipSpace();
+			if ( pos_ >= s_.size() )
+				return false;
+			char c = s_[ pos_ ];
+			if ( isdigit( c ) || c == '.' )
+				return number( ret );
+			if ( c == '(' ) {
+				++pos_;
+				return ternary( ret ) && match( ")" );
+			}
+			if ( !( isalpha( c ) || c == '_' ) )
+				return false;
+			unsigned int begin = pos_;
+			while ( pos_ < s_.size() &&
+					( isalnum( s_[ pos_ ] ) || s_[ pos_ ] == '_' ) )
+				++pos_;
+			string name = s_.substr( begin, pos_ - begin );
+			// As in muParser, a function name must be followed directly
+			// by its bracket.
+			if ( pos_ < s_.size() && s_[ pos_ ] == '(' ) {
+				++pos_;
+				return function( name, ret );
+			}
+			map< string, double >::const_iterator ci = consts_.find( name );
+			if ( ci != consts_.end() ) {
+				ExprProgram::Instr in = instr( CONST );
+				in.x = ci->second;
+				ret = leaf( in );
+				return true;
+			}
+			map< string, ExprProgram::Var >::const_iterator vi =
+					vars_.find( name );
+			if ( vi == vars_.end() )
+				return false;
+			const ExprProgram::Var& v = vi->second;
+			ExprProgram::Instr in = instr( TIME );
+			if ( v.kind == ExprProgram::Var::POINTER ) {
+				in.op = VAR;
+				in.p = v.ptr;
+			} else if ( v.kind == ExprProgram::Var::ARG ) {
+				in.op = ARG;
+				in.n = v.index;
+			}
+			ret = leaf( in );
+			return true;
+		}
+
+		bool number( unsigned int& ret )
+		{
+			unsigned int begin = pos_;
+			while ( pos_ < s_.size() && isdigit( s_[ pos_ ] ) )
+				++pos_;
+			if ( pos_ < s_.size() && s_[ pos_ ] == '.' ) {
+				++pos_;
+				while ( pos_ < s_.size() && isdigit( s_[ pos_ ] ) )
+					++pos_;
+			}
+			if ( pos_ == begin + 1 && s_[ begin ] == '.' )
+				return false;
+			if ( pos_ < s_.size() && ( s_[ pos_ ] == 'e' || s_[ pos_ ] == 'E' ) ) {
+				unsigned int mark = pos_++;
+				if ( pos_ < s_.size() && ( s_[ pos_ ] == '+' || s_[ pos_ ] == '-' ) )
+					++pos_;
+				if ( pos_ < s_.size() && isdigit( s_[ pos_ ] ) ) {
+					while ( pos_ < s_.size() && isdigit( s_[ pos_ ] ) )
+						++pos_;
+				} else {
+					pos_ = mark;
+				}
+			}
+			ExprProgram::Instr in = instr( CONST );
+			in.x = strtod( s_.substr( begin, pos_ - begin ).c_str(), 0 );
+			ret = leaf( in );
+			return true;
+		}
+
+		/// Parses the arguments and closing bracket of a function call.
+		bool function( const string& name, unsigned int& ret )
+		{
+			vector< unsigned int > args;
+			do {
+				unsigned int a;
+				if ( !ternary( a ) )
+					return false;
+				args.push_back( a );
+			} while ( match( "," ) );
+			if ( !match( ")" ) )
+				return false;
+
+			ExprProgram::Instr in = instr( FUNC1 );
+			for ( const Func1Entry* f = func1Table; f->name; ++f ) {
+				if ( name == f->name ) {
+					if ( args.size() != 1 )
+						return false;
+					in.f = f->f;
+					ret = node( in, args );
+					return true;
+				}
+			}
+			if ( name == "atan2" ) {
+				if ( args.size() != 2 )
+					return false;
+				in.op = ATAN2;
+			} else if ( name == "sum" ) {
+				in.op = SUM;
+			} else if ( name == "avg" ) {
+				in.op = AVG;
+			} else if ( name == "min" ) {
+				in.op = MIN;
+			} else if ( name == "max" ) {
+				in.op = MAX;
+			} else {
+				return false;
+			}
+			in.n = args.size();
+			ret = node( in, args );
+			return true;
+		}
+
+		const string& s_;
+		unsigned int pos_;
+		const map< string, double >& consts_;
+		const map< string, ExprProgram::Var >& vars_;
+		vector< Node > nodes_;
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////
+
+ExprProgram::Var::Var()
+	: kind( POINTER ), index( 0 ), ptr( 0 )
+{;}
+
+ExprProgram::Var ExprProgram::Var::pointer( const double* p )
+{
+	Var v;
+	v.ptr = p;
+	return v;
+}
+
+ExprProgram::Var ExprProgram::Var::arg( unsigned int index )
+{
+	Var v;
+	v.kind = ARG;
+	v.index = index;
+	return v;
+}
+
+ExprProgram::Var ExprProgram::Var::time()
+{
+	Var v;
+	v.kind = TIME;
+	return v;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+ExprProgram::ExprProgram()
+	: depth_( 0 ), isCompiled_( false )
+{;}
+
+bool ExprProgram::compile( const string& expr,
+				const map< string, double >& consts,
+				const map< string, Var >& vars )
+{
+	clear();
+	ExprCompiler ec( expr, consts, vars );
+	unsigned int root;
+	if ( !ec.parse( root ) )
+		return false;
+	unsigned int depth = 0;
+	ec.emit( root, code_, depth, depth_ );
+	assert( depth == 1 );
+	if ( depth_ > MaxDepth ) {
+		clear();
+		return false;
+	}
+	isCompiled_ = true;
+	return true;
+}
+
+void ExprProgram::clear()
+{
+	code_.clear();
+	depth_ = 0;
+	isCompiled_ = false;
+}
+
+bool ExprProgram::isCompiled() const
+{
+	return isCompiled_;
+}
+
+unsigned int ExprProgram::getNumOps() const
+{
+	return code_.size();
+}
+
+double ExprProgram::eval( const double* S, double t ) const
+{
+	assert( isCompiled_ );
+	return run( code_, S, t );
+}
+
+void ExprProgram::evalBulk( const double* const* S, unsigned int numVoxels,
+				double t, double* out ) const
+{
+	assert( isCompiled_ );
+	double stack[ MaxDepth ][ BlockSize ];
+	for ( unsigned int v = 0; v < numVoxels; v += BlockSize ) {
+		const double* const* s = S + v;
+		unsigned int nv = numVoxels - v;
+		if ( nv > BlockSize )
+			nv = BlockSize;
+		unsigned int sp = 0; // Number of entries on the stack.
+		for ( vector< Instr >::const_iterator
+						i = code_.begin(); i != code_.end(); ++i ) {
+			if ( i->op <= TIME ) { // Push a value.
+				double* r = stack[ sp++ ];
+				if ( i->op == ARG ) {
+					for ( unsigned int k = 0; k < nv; ++k )
+						r[k] = s[k][ i->n ];
+				} else {
+					double x = ( i->op == CONST ) ? i->x :
+							( i->op == VAR ) ? *i->p : t;
+					for ( unsigned int k = 0; k < nv; ++k )
+						r[k] = x;
+				}
+				continue;
+			}
+			if ( i->op == NEG || i->op == SQR || i->op == FUNC1 ) {
+				double* a = stack[ sp - 1 ];
+				if ( i->op == NEG ) {
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = -a[k];
+				} else if ( i->op == SQR ) {
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] *= a[k];
+				} else {
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = i->f( a[k] );
+				}
+				continue;
+			}
+			if ( i->op >= SUM ) { // Functions of several arguments.
+				sp -= i->n - 1;
+				double* a = stack[ sp - 1 ];
+				bool isSum = ( i->op == SUM || i->op == AVG );
+				if ( isSum ) { // The scalar sum starts from zero.
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] += 0.0;
+				}
+				for ( unsigned int j = 1; j < i->n; ++j ) {
+					const double* b = stack[ sp - 1 + j ];
+					for ( unsigned int k = 0; k < nv; ++k ) {
+						if ( isSum )
+							a[k] += b[k];
+						else if ( i->op == MIN )
+							a[k] = min( a[k], b[k] );
+						else
+							a[k] = max( a[k], b[k] );
+					}
+				}
+				if ( i->op == AVG ) {
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] /= i->n;
+				}
+				continue;
+			}
+			if ( i->op == SELECT ) {
+				sp -= 2;
+				double* a = stack[ sp - 1 ];
+				const double* b = stack[ sp ];
+				const double* c = stack[ sp + 1 ];
+				for ( unsigned int k = 0; k < nv; ++k )
+					a[k] = ( a[k] != 0 ) ? b[k] : c[k];
+				continue;
+			}
+			// The binary operators.
+			--sp;
+			double* a = stack[ sp - 1 ];
+			const double* b = stack[ sp ];
+			switch ( i->op ) {
+				case ADD:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] += b[k];
+					break;
+				case SUB:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] -= b[k];
+					break;
+				case MUL:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] *= b[k];
+					break;
+				case DIV:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] /= b[k];
+					break;
+				case POW:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = pow( a[k], b[k] );
+					break;
+				case ATAN2:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = atan2( a[k], b[k] );
+					break;
+				case LT:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] < b[k];
+					break;
+				case GT:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] > b[k];
+					break;
+				case LE:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] <= b[k];
+					break;
+				case GE:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] >= b[k];
+					break;
+				case EQ:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] == b[k];
+					break;
+				case NE:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] != b[k];
+					break;
+				case AND:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] && b[k];
+					break;
+				case OR:
+					for ( unsigned int k = 0; k < nv; ++k )
+						a[k] = a[k] || b[k];
+					break;
+				default:
+					assert( 0 );
+			}
+		}
+		assert( sp == 1 );
+		for ( unsigned int k = 0; k < nv; ++k )
+			out[ v + k ] = stack[0][k];
+	}
+}
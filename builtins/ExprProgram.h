@@ -0,0 +1,98 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _EXPR_PROGRAM_H
+#define _EXPR_PROGRAM_H
+
+/**
+ * ExprProgram is a compiled form of a muParser expression, for the
+ * Function and FuncTerm classes which evaluate the same expression on
+ * every timestep. It is compiled once when the expression is set, into a
+ * flat stack program in which constant subexpressions have been folded.
+ * The grammar, operator precedences, builtin functions and arithmetic
+ * are those of muParser, so the results agree with mu::Parser::Eval.
+ * Expressions using anything beyond that, such as user-defined
+ * operators, do not compile and the caller keeps using muParser.
+ *
+ * Variables are either fixed addresses, as in Function, or entries of
+ * the pool vector S and the time t passed in to eval, as in FuncTerm.
+ * The latter kind can also be evaluated across many voxels in one call.
+ */
+class ExprProgram
+{
+	public:
+		/// Where a variable of the expression reads its value from.
+		class Var
+		{
+			public:
+				enum Kind { POINTER, ARG, TIME };
+				Var();
+				/// Variable held at a fixed address.
+				static Var pointer( const double* p );
+				/// Variable held in S[ index ].
+				static Var arg( unsigned int index );
+				/// The time argument of eval.
+				static Var time();
+
+				Kind kind;
+				unsigned int index;
+				const double* ptr;
+		};
+
+		ExprProgram();
+
+		/**
+		 * Compiles the expression, looking up names first in consts and
+		 * then in vars. Returns false, and leaves the program empty, if
+		 * the expression has a name or construct it does not handle.
+		 */
+		bool compile( const string& expr,
+				const map< string, double >& consts,
+				const map< string, Var >& vars );
+		/// Empties the program.
+		void clear();
+		/// True if the last compile succeeded.
+		bool isCompiled() const;
+		/// Number of instructions, which shows how far constants folded.
+		unsigned int getNumOps() const;
+
+		/// Evaluates the program on the pool vector S at time t.
+		double eval( const double* S, double t ) const;
+
+		/**
+		 * Evaluates the program for each of numVoxels pool vectors
+		 * S[i], at time t, into out[i]. Each instruction is applied
+		 * across a block of voxels at a time, so the dispatch is
+		 * amortized and the inner loops are simple enough to vectorize.
+		 */
+		void evalBulk( const double* const* S, unsigned int numVoxels,
+				double t, double* out ) const;
+
+		/// Deepest stack any compiled program may use.
+		static const unsigned int MaxDepth = 32;
+		/// Number of voxels handled together by evalBulk.
+		static const unsigned int BlockSize = 16;
+
+		/// Internal instruction, public only for the compiler in the .cpp.
+		struct Instr
+		{
+			unsigned int op;
+			unsigned int n; /// S index, or number of arguments.
+			double x;	/// Constant value.
+			const double* p; /// Variable address.
+			double ( *f )( double ); /// Single argument function.
+		};
+
+	private:
+		vector< Instr > code_;
+		unsigned int depth_;
+		bool isCompiled_;
+};
+
+#endif // _EXPR_PROGRAM_H
@@ -380,6 +380,7 @@ Function::~Function()
 void Function::_clearBuffer()
 {
     _numVar = 0;
+    _program.clear();
     _parser.ClearVar();
     for (unsigned int ii = 0; ii < _varbuf.size(); ++ii){
         if ( _varbuf[ii] ){
@@ -395,6 +396,32 @@ void Function::_clearBuffer()
     _pullbuf.clear();
 }
 
+/**
+   Compile the expression for the variables in the buffers, so that
+   getValue does not go through muParser on every step. If it does not
+   compile, for example because it uses a variable that has not been
+   created yet, getValue keeps using the parser.
+ */
+void Function::_compile()
+{
+    map< string, ExprProgram::Var > vars;
+    for (unsigned int ii = 0; ii < _varbuf.size(); ++ii){
+        if (_varbuf[ii]){
+            stringstream name;
+            name << "x" << ii;
+            vars[name.str()] = ExprProgram::Var::pointer(&(_varbuf[ii]->value));
+        }
+    }
+    for (unsigned int ii = 0; ii < _pullbuf.size(); ++ii){
+        if (_pullbuf[ii]){
+            stringstream name;
+            name << "y" << ii;
+            vars[name.str()] = ExprProgram::Var::pointer(_pullbuf[ii]);
+        }
+    }
+    _program.compile(_parser.GetExpr(), _parser.GetConst(), vars);
+}
+
 void Function::_showError(mu::Parser::exception_type &e) const
 {
     cout << "Error occurred in parser.\n" 
@@ -506,7 +533,9 @@ void Function::setExpr(const Eref& eref, string expr)
         _valid = true;
     } catch (mu::Parser::exception_type &e){
         _showError(e);
+        return;
     }
+    _compile();
 }
 
 string Function::getExpr( const Eref& e ) const
@@ -535,6 +564,9 @@ double Function::getValue() const
         cout << "Error: Function::getValue() - invalid state" << endl;        
         return value;
     }
+    if (_program.isCompiled()){
+        return _program.eval(0, 0.0);
+    }
     try{
         value = _parser.Eval();
     } catch (mu::Parser::exception_type &e){
@@ -597,6 +629,9 @@ void Function::setNumVar(const unsigned int num)
         name << "x" << ii;
         _functionAddVar(name.str().c_str(), this);
     }
+    if (_valid){
+        _compile();
+    }
 }
 
 unsigned int Function::getNumVar() const
@@ -628,6 +663,10 @@ Variable * Function::getVar(unsigned int ii)
 void Function::setConst(string name, double value)
 {
     _parser.DefineConst(name, value);
+    // The compiled program has the old value folded in.
+    if (_valid){
+        _compile();
+    }
 }
 
 double Function::getConst(string name) const
@@ -49,6 +49,7 @@
 #define _FUNCTION_H
 
 #include "muParser.h"
+#include "ExprProgram.h"
 
 /**
    Simple function parser and evaluator for MOOSE. This can take a mathematical
@@ -125,7 +126,9 @@ protected:
     map< string, double *> _constbuf;  // for constants
     string _independent; // index of independent variable
     mu::Parser _parser;
+    ExprProgram _program; // compiled form of the expression, if possible
     void _clearBuffer();
+    void _compile();
     void _showError(mu::Parser::exception_type &e) const;
 	char* _stoich; // Used by kinetic solvers when this is zombified.
 };
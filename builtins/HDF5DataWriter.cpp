@@ -76,9 +76,19 @@ const Cinfo * HDF5DataWriter::initCinfo()
       &HDF5DataWriter::setFlushLimit,
       &HDF5DataWriter::getFlushLimit);
 
+    static ValueFinfo< HDF5DataWriter, unsigned int> queueLimit(
+      "queueLimit",
+      "Number of filled buffers that may wait to be written by the"
+      " background writer thread. Once this many are waiting, process"
+      " blocks until one is written. Zero makes writes synchronous."
+      " Default is 2.",
+      &HDF5DataWriter::setQueueLimit,
+      &HDF5DataWriter::getQueueLimit);
+
     static Finfo * finfos[] = {
         requestOut(),
         &flushLimit,
+        &queueLimit,
         &proc,
     };
 
@@ -100,7 +110,11 @@ const Cinfo * HDF5DataWriter::initCinfo()
         " not handled.\n"
         "At every process call it writes the contents of the tables to the file"
         " and clears the table vectors. You can explicitly force writing of the"
-        " data via the `flush` function."
+        " data via the `flush` function.\n"
+        "Each time `flushLimit` steps have been collected, the data are"
+        " handed to a background thread that writes them to the file, so the"
+        " simulation does not wait for the disk unless `queueLimit` buffers"
+        " are already waiting."
     };
 
     static Dinfo< HDF5DataWriter > dinfo;
@@ -126,6 +140,7 @@ HDF5DataWriter::~HDF5DataWriter()
         return;
     }
     this->flush();
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     for (map < string, hid_t >::iterator ii = nodemap_.begin();
          ii != nodemap_.end(); ++ii){
         if (ii->second >= 0){
@@ -147,7 +162,9 @@ void HDF5DataWriter::flush()
                 "Filehandle invalid. Cannot write data." << endl;
         return;
     }
-    
+    // Earlier buffers must reach the file first.
+    writeQueue_.drain();
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
         herr_t status = appendToDataset(datasets_[ii], data_[ii]);
         data_[ii].clear();
@@ -161,36 +178,32 @@ void HDF5DataWriter::flush()
 }
         
 /**
-   Write data to datasets in HDF5 file. Clear all data in the table
-   objects associated with this object. */
+   Collect data from the sources. Once flushLimit_ steps have been
+   collected, hand the data to the background writer, which appends it
+   to the datasets in the HDF5 file. */
 void HDF5DataWriter::process(const Eref & e, ProcPtr p)
 {
     if (filehandle_ < 0){
         return;
     }
     
-    vector <double> dataBuf;
-        requestOut()->send(e, &dataBuf);
-    for (unsigned int ii = 0; ii < dataBuf.size(); ++ii){
-        data_[ii].push_back(dataBuf[ii]);
+    dataBuf_.clear();
+    requestOut()->send(e, &dataBuf_);
+    for (unsigned int ii = 0; ii < dataBuf_.size(); ++ii){
+        data_[ii].push_back(dataBuf_[ii]);
     }
     ++steps_;
     if (steps_ >= flushLimit_){
         steps_ = 0;
-        for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
-            herr_t status = appendToDataset(datasets_[ii], data_[ii]);
-            data_[ii].clear();
-            if (status < 0){
-                cerr << "Warning: appending data for object " << src_[ii]
-                     << " returned status " << status << endl;                
-            }
-        }
+        writeQueue_.push(data_);
     }
 }
 
 void HDF5DataWriter::reinit(const Eref & e, ProcPtr p)
 {
     steps_ = 0;
+    writeQueue_.drain();
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     for (unsigned int ii = 0; ii < data_.size(); ++ii){
         H5Dclose(datasets_[ii]);
     }
@@ -237,6 +250,7 @@ void HDF5DataWriter::reinit(const Eref & e, ProcPtr p)
         datasets_.push_back(dataset_id);
     }
     data_.resize(src_.size());
+    writeQueue_.setDatasets(datasets_, src_);
 }
 
 /**
@@ -366,6 +380,16 @@ unsigned int HDF5DataWriter::getFlushLimit() const
 {
     return flushLimit_;
 }
+
+void HDF5DataWriter::setQueueLimit(unsigned int value)
+{
+    writeQueue_.setLimit(value);
+}
+
+unsigned int HDF5DataWriter::getQueueLimit() const
+{
+    return writeQueue_.getLimit();
+}
         
 #endif // USE_HDF5
 // 
@@ -37,6 +37,7 @@
 #ifndef _HDF5DATAWRITER_H
 
 #include "HDF5WriterBase.h"
+#include "HDF5WriteQueue.h"
 
 class HDF5DataWriter: public HDF5WriterBase
 {
@@ -45,11 +46,14 @@ class HDF5DataWriter: public HDF5WriterBase
     virtual ~HDF5DataWriter();
     void setFlushLimit(unsigned int limit);
     unsigned int getFlushLimit() const;
+    void setQueueLimit(unsigned int limit);
+    unsigned int getQueueLimit() const;
     // void flush();
     void process(const Eref &e, ProcPtr p);
     void reinit(const Eref &e, ProcPtr p);
     virtual void flush();
     static const Cinfo* initCinfo();
+    static herr_t appendToDataset(hid_t dataset, const vector<double>& data);
   protected:
     unsigned int flushLimit_;
     // Maps the paths of data sources to vectors storing the data
@@ -59,9 +63,12 @@ class HDF5DataWriter: public HDF5WriterBase
     vector <string> func_;
     vector <hid_t> datasets_;
     unsigned long steps_;
+    // Reused for the values returned by requestOut
+    vector <double> dataBuf_;
+    // Writes out data_ in the background each time it fills
+    HDF5WriteQueue writeQueue_;
     hid_t get_dataset(string path);
     hid_t create_dataset(hid_t parent, string name);
-    herr_t appendToDataset(hid_t dataset, const vector<double>& data);
 };
 #endif // _HDF5DATAWRITER_H
 #endif // USE_HDF5
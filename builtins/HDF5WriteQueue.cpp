@@ -0,0 +1,181 @@
+// HDF5WriteQueue.cpp ---
+//
+// Filename: HDF5WriteQueue.cpp
+// Description:
+// Author:
+// Maintainer:
+// Created: Sat Oct 17 2026
+// Version:
+// URL:
+// Keywords:
+// Compatibility:
+//
+//
+
+// Commentary:
+//
+//
+//
+
+// Change log:
+//
+//
+//
+
+// Code:
+
+#ifdef USE_HDF5
+
+#include "hdf5.h"
+
+#include "header.h"
+
+#include "HDF5DataWriter.h"
+
+HDF5WriteQueue::HDF5WriteQueue():
+        limit_(2),
+        busy_(false),
+        quit_(false)
+{
+}
+
+HDF5WriteQueue::HDF5WriteQueue(const HDF5WriteQueue& other):
+        limit_(other.limit_),
+        busy_(false),
+        quit_(false)
+{
+}
+
+HDF5WriteQueue::~HDF5WriteQueue()
+{
+    stop();
+}
+
+HDF5WriteQueue& HDF5WriteQueue::operator=(const HDF5WriteQueue& other)
+{
+    if (this != &other){
+        stop();
+        limit_ = other.limit_;
+        datasets_.clear();
+        src_.clear();
+    }
+    return *this;
+}
+
+void HDF5WriteQueue::setLimit(unsigned int limit)
+{
+    std::lock_guard< std::mutex > lock(mutex_);
+    limit_ = limit;
+}
+
+unsigned int HDF5WriteQueue::getLimit() const
+{
+    return limit_;
+}
+
+void HDF5WriteQueue::setDatasets(const vector< hid_t >& datasets,
+                                 const vector< ObjId >& src)
+{
+    assert(datasets.size() == src.size());
+    drain();
+    datasets_ = datasets;
+    src_ = src;
+}
+
+void HDF5WriteQueue::push(vector< vector< double > >& data)
+{
+    assert(data.size() == datasets_.size());
+    std::unique_lock< std::mutex > lock(mutex_);
+    if (limit_ == 0){
+        // Synchronous mode: earlier buffers must still go first.
+        while (!pending_.empty() || busy_){
+            doneCond_.wait(lock);
+        }
+        lock.unlock();
+        write(data);
+        return;
+    }
+    if (!thread_.joinable()){
+        quit_ = false;
+        thread_ = std::thread(&HDF5WriteQueue::ioLoop, this);
+    }
+    // Backpressure: wait for the I/O thread to catch up.
+    while (pending_.size() >= limit_){
+        doneCond_.wait(lock);
+    }
+    vector< vector< double > > empty;
+    if (!free_.empty()){
+        empty.swap(free_.back());
+        free_.pop_back();
+    }
+    empty.resize(data.size());
+    pending_.push_back(vector< vector< double > >());
+    pending_.back().swap(data);
+    data.swap(empty);
+    workCond_.notify_one();
+}
+
+void HDF5WriteQueue::drain()
+{
+    std::unique_lock< std::mutex > lock(mutex_);
+    while (!pending_.empty() || busy_){
+        doneCond_.wait(lock);
+    }
+}
+
+void HDF5WriteQueue::write(vector< vector< double > >& data) const
+{
+    std::lock_guard< std::recursive_mutex > lock(
+        HDF5WriterBase::libraryMutex());
+    for (unsigned int ii = 0; ii < data.size(); ++ii){
+        herr_t status = HDF5DataWriter::appendToDataset(datasets_[ii],
+                                                        data[ii]);
+        data[ii].clear();
+        if (status < 0){
+            cerr << "Warning: appending data for object " << src_[ii]
+                 << " returned status " << status << endl;
+        }
+    }
+}
+
+void HDF5WriteQueue::ioLoop()
+{
+    std::unique_lock< std::mutex > lock(mutex_);
+    while (true){
+        while (!quit_ && pending_.empty()){
+            workCond_.wait(lock);
+        }
+        if (pending_.empty()){ // quit_ is set and all the work is done.
+            return;
+        }
+        vector< vector< double > > data;
+        data.swap(pending_.front());
+        pending_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        write(data);
+        lock.lock();
+        free_.push_back(vector< vector< double > >());
+        free_.back().swap(data);
+        busy_ = false;
+        doneCond_.notify_all();
+    }
+}
+
+void HDF5WriteQueue::stop()
+{
+    if (!thread_.joinable()){
+        return;
+    }
+    {
+        std::lock_guard< std::mutex > lock(mutex_);
+        quit_ = true;
+    }
+    workCond_.notify_all();
+    thread_.join();
+}
+
+#endif // USE_HDF5
+
+//
+// HDF5WriteQueue.cpp ends here
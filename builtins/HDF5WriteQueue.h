@@ -0,0 +1,99 @@
+// HDF5WriteQueue.h ---
+//
+// Filename: HDF5WriteQueue.h
+// Description:
+// Author:
+// Maintainer:
+// Created: Sat Oct 17 2026
+// Version:
+// URL:
+// Keywords:
+// Compatibility:
+//
+//
+
+// Commentary:
+//
+// Background writer for HDF5DataWriter. The simulation thread fills a
+// set of data buffers, one per dataset, and hands them over with
+// push(). A dedicated I/O thread appends them to their datasets while
+// the simulation carries on filling a second set of buffers. The
+// number of buffers waiting for the I/O thread is bounded: push()
+// only blocks when that many are already queued.
+//
+// The serial HDF5 library is not thread safe, so every call into it,
+// from any writer or from the I/O threads, is made holding
+// HDF5WriterBase::libraryMutex().
+//
+
+// Change log:
+//
+//
+//
+
+// Code:
+#ifdef USE_HDF5
+#ifndef _HDF5WRITEQUEUE_H
+#define _HDF5WRITEQUEUE_H
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class HDF5WriteQueue
+{
+  public:
+    HDF5WriteQueue();
+    /// Copies only the queue limit: the copy starts its own thread.
+    HDF5WriteQueue(const HDF5WriteQueue& other);
+    ~HDF5WriteQueue();
+    HDF5WriteQueue& operator=(const HDF5WriteQueue& other);
+
+    /// Number of filled buffers that may wait for the I/O thread
+    /// before push() blocks. With 0 push() writes synchronously.
+    void setLimit(unsigned int limit);
+    unsigned int getLimit() const;
+
+    /// Assigns the datasets that buffer ii is appended to, and the
+    /// sources used in error messages. Waits for pending writes first.
+    void setDatasets(const vector< hid_t >& datasets,
+                     const vector< ObjId >& src);
+
+    /// Queues the buffers in data for writing, and swaps in a set of
+    /// empty buffers, which keep the capacity of earlier ones.
+    void push(vector< vector< double > >& data);
+
+    /// Blocks until everything queued has been written.
+    void drain();
+
+  private:
+    /// Appends the buffers to the datasets and clears them.
+    void write(vector< vector< double > >& data) const;
+    void ioLoop();
+    /// Waits for pending writes and stops the I/O thread.
+    void stop();
+
+    unsigned int limit_;
+    vector< hid_t > datasets_;
+    vector< ObjId > src_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    /// Signals the I/O thread that there is work, or that it should quit.
+    std::condition_variable workCond_;
+    /// Signals the simulation thread that a buffer has been written.
+    std::condition_variable doneCond_;
+    std::deque< vector< vector< double > > > pending_;
+    /// Written buffers, kept for reuse.
+    vector< vector< vector< double > > > free_;
+    /// True while the I/O thread is writing a buffer.
+    bool busy_;
+    bool quit_;
+};
+
+#endif // _HDF5WRITEQUEUE_H
+#endif // USE_HDF5
+
+//
+// HDF5WriteQueue.h ends here
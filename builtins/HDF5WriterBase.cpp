@@ -368,6 +368,7 @@ HDF5WriterBase::~HDF5WriterBase()
     if (filehandle_ < 0){
         return;
     }
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     flush();
     herr_t err = H5Fclose(filehandle_);
     filehandle_ = -1;
@@ -404,8 +405,15 @@ bool HDF5WriterBase::isOpen() const
     return filehandle_ >= 0;
 }
 
+std::recursive_mutex& HDF5WriterBase::libraryMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
 herr_t HDF5WriterBase::openFile()
 {
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     herr_t status = 0;
     if (filehandle_ >= 0){
         cout << "Warning: closing already open file and opening " << filename_ <<  endl;
@@ -502,6 +510,7 @@ void HDF5WriterBase::flushAttributes()
     if (filehandle_ < 0){
         return;
     }    
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     // Write all scalar attributes
     writeScalarAttributesFromMap< string >(filehandle_, sattr_);
     writeScalarAttributesFromMap< double >(filehandle_, dattr_);
@@ -518,6 +527,7 @@ void HDF5WriterBase::close()
         return;
     }
     flush();
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     herr_t status = H5Fclose(filehandle_);
     filehandle_ = -1;
     if (status < 0){
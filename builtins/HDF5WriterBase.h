@@ -32,6 +32,7 @@
 #ifndef _HDF5IO_H
 #define _HDF5IO_H
 #include <typeinfo>
+#include <mutex>
 
 hid_t require_attribute(hid_t file_id, string path,
                         hid_t data_type, hid_t data_id);
@@ -71,6 +72,11 @@ class HDF5WriterBase
     virtual void close();
     
     static const Cinfo* initCinfo();
+
+    /// The serial HDF5 library is not thread safe. All calls into it
+    /// are made holding this lock, as HDF5DataWriter writes from a
+    /// background thread.
+    static std::recursive_mutex& libraryMutex();
     
   protected:
     herr_t openFile();
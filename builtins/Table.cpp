@@ -143,24 +143,37 @@ Table::Table()
 // MsgDest Definitions
 //////////////////////////////////////////////////////////////
 
+/**
+ * The requested values are appended straight onto the table. Once the
+ * number of values per step is known, the table reserves space for the
+ * rest of the run, so that recording does not reallocate on every step.
+ * The space at least doubles each time, so that many short runs without
+ * a reinit do not reallocate on every step either.
+ */
 void Table::process( const Eref& e, ProcPtr p )
 {
 	lastTime_ = p->currTime;
-	vector< double > ret;
-	requestOut()->send( e, &ret );
-	vec().insert( vec().end(), ret.begin(), ret.end() );
+	unsigned int prevSize = vec().size();
+	requestOut()->send( e, &vec() );
+	unsigned int perSample = vec().size() - prevSize;
+	if ( perSample > 0 && 
+		vec().capacity() - vec().size() < perSample &&
+		p->runTime > p->currTime ) {
+		double numSamples = floor( ( p->runTime - p->currTime ) / p->dt + 0.5 );
+		vec().reserve( max( 2 * vec().capacity(), 
+			vec().size() + perSample * ( unsigned int )numSamples ) );
+	}
 }
 
 void Table::reinit( const Eref& e, ProcPtr p )
 {
 	input_ = 0.0;
+	// Keeps the capacity from the previous run.
 	vec().resize( 0 );
 	lastTime_ = 0;
 	// cout << "tabReinit on :" << p->groupId << ":" << p->threadIndexInGroup << endl << flush;
 	// requestOut()->send( e, handleInput()->getFid());
-	vector< double > ret;
-	requestOut()->send( e, &ret );
-	vec().insert( vec().end(), ret.begin(), ret.end() );
+	requestOut()->send( e, &vec() );
 }
 
 //////////////////////////////////////////////////////////////
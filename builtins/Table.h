@@ -15,6 +15,7 @@
  */
 class Table: public TableBase
 {
+	friend void testGetMsg();
 	public: 
 		Table();
 		//////////////////////////////////////////////////////////////////
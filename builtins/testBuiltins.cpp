@@ -14,6 +14,8 @@
 #include "Arith.h"
 #include "TableBase.h"
 #include "Table.h"
+#include "muParser.h"
+#include "ExprProgram.h"
 #include <queue>
 
 #include "../shell/Shell.h"
@@ -264,6 +266,33 @@ void testTable()
 	cout << "." << flush;
 }
 
+/**
+ * Calls process on the Table by hand for each step of a run of numSteps,
+ * as the Clock would, starting from an empty vector. The table should
+ * reserve room for the whole run on the first step, and not reallocate
+ * after that. The vec is the table's own, passed in by testGetMsg.
+ */
+static void checkTableReserve( Id tabid, vector< double >& vec,
+	unsigned int numSteps )
+{
+	Table* t = reinterpret_cast< Table* >( tabid.eref().data() );
+	vector< double >().swap( vec );
+	ProcInfo p;
+	p.dt = 1.0;
+	p.runTime = numSteps;
+	p.currTime = 1.0;
+	t->process( tabid.eref(), &p );
+	unsigned int perSample = vec.size();
+	assert( perSample > 0 );
+	const double* data = vec.data();
+	for ( unsigned int i = 2; i <= numSteps; ++i ) {
+		p.currTime = i;
+		t->process( tabid.eref(), &p );
+	}
+	assert( vec.size() == perSample * numSteps );
+	assert( vec.data() == data );
+}
+
 /**
  * Tests capacity to send a request for a field value to an object
  */
@@ -274,7 +303,7 @@ void testGetMsg()
 	assert( tabid != ObjId() );
 	ObjId arithid = shell->doCreate( "Arith", ObjId(), "arith", 1 );
 	assert( arithid != ObjId() );
-	// Table* t = reinterpret_cast< Table* >( tabid.eref().data() );
+	Table* t = reinterpret_cast< Table* >( tabid.eref().data() );
 	ObjId ret = shell->doAddMsg( "Single", 
 		tabid.eref().objId(), "requestOut",
 		arithid.eref().objId(), "getOutputValue" );
@@ -308,6 +337,7 @@ void testGetMsg()
 		assert( doubleEq( ret, 2 * i ) );
 		assert( doubleEq( temp[i], 2 * i ) );
 	}
+	checkTableReserve( tabid, t->vec(), 100 );
 
 	/////////////////////////////////////////////////////////////////
 	// Here we check using the 'get' message with multiple targets
@@ -333,6 +363,23 @@ void testGetMsg()
 		assert( doubleEq( temp[2 * i], 2 * i ) );
 		assert( doubleEq( temp[2 * i + 1], 10 + 12 * i ) );
 	}
+	checkTableReserve( tabid, t->vec(), 100 );
+
+	// Many short runs without a reinit. Each one knows only its own
+	// length, but the table should still not reallocate on every run.
+	shell->doReinit();
+	const double* data = t->vec().data();
+	unsigned int numRealloc = 0;
+	for ( unsigned int i = 0; i < 500; ++i ) {
+		shell->doStart( 2 );
+		if ( t->vec().data() != data ) {
+			data = t->vec().data();
+			++numRealloc;
+		}
+	}
+	numEntries = Field< unsigned int >::get( tabid, "size" );
+	assert( numEntries == 2 + 2 * 1000 );
+	assert( numRealloc < 20 );
 
 
 	// Perhaps I should do another test without reinit.
@@ -419,10 +466,169 @@ void testStats()
 	cout << "." << flush;
 }
 
+void testExprProgram()
+{
+	static const char* exprs[] = {
+		"x0 + x1 * t",
+		"-x0^2 + 2^3^2",
+		"x0^x2 - (x0 + 1)^2 / x1",
+		"-(x0 - x1)/t * -x2",
+		"x0 < x1 ? sin(x0) : cos(x1)",
+		"x1 < 0 ? x1 < -1 ? 1 : 2 : 3",
+		"x0 > 1 && x1 < 0 || t == 2.5",
+		"x0 >= x2 + (x1 != 0) * (x0 <= 1.7)",
+		"sum(x0, x1, t) + avg(x0, t) - min(x0, x1, 3) * max(t, 1e-3)",
+		"atan2(x1, x0) + log(x0) + ln(t) + log2(t) + log10(x0) + exp(x1)",
+		"sqrt(abs(x1)) + sign(x1) + rint(x0) + tanh(x1) + asinh(x0)",
+		"acosh(t) + atanh(x1) + sinh(x2) + cosh(x2) + tan(x1) + atan(x2)",
+		"asin(x1) + acos(x1) + pi * e * x0 / _pi - _e",
+		"1.5e-3 * x0 + .5 - 3. + 2E2 * x2",
+		0
+	};
+	double S[] = { 0.25, 4.0, 1.7, -0.3, 0.45 };
+	double t = 2.5;
+	mu::Parser p;
+	p.DefineConst( "pi", M_PI );
+	p.DefineConst( "e", M_E );
+	p.DefineVar( "x0", &S[2] );
+	p.DefineVar( "x1", &S[3] );
+	p.DefineVar( "x2", &S[0] );
+	p.DefineVar( "t", &t );
+	map< string, ExprProgram::Var > vars;
+	vars[ "x0" ] = ExprProgram::Var::arg( 2 );
+	vars[ "x1" ] = ExprProgram::Var::arg( 3 );
+	vars[ "x2" ] = ExprProgram::Var::pointer( &S[0] );
+	vars[ "t" ] = ExprProgram::Var::time();
+
+	ExprProgram prog;
+	for ( unsigned int i = 0; exprs[i]; ++i ) {
+		p.SetExpr( exprs[i] );
+		double ref = p.Eval();
+		assert( prog.compile( exprs[i], p.GetConst(), vars ) );
+		assert( doubleEq( prog.eval( S, t ), ref ) );
+	}
+
+	// Constant subexpressions are folded.
+	assert( prog.compile( "2 * pi * (3 + 1) / e", p.GetConst(), vars ) );
+	assert( prog.getNumOps() == 1 );
+	assert( doubleEq( prog.eval( S, t ), 8 * M_PI / M_E ) );
+	assert( prog.compile( "x0 * (2 + 3) + (1 < 2 ? t : x1)", 
+							p.GetConst(), vars ) );
+	assert( prog.getNumOps() == 5 );
+
+	// These are left to muParser.
+	assert( !prog.compile( "x0 = 3", p.GetConst(), vars ) );
+	assert( !prog.compile( "foo(x0)", p.GetConst(), vars ) );
+	assert( !prog.compile( "x0 + y", p.GetConst(), vars ) );
+	assert( !prog.compile( "sin(x0, x1)", p.GetConst(), vars ) );
+	assert( !prog.compile( "(x0 + 1", p.GetConst(), vars ) );
+	assert( !prog.isCompiled() );
+
+	// The bulk evaluation spans more than one block of voxels.
+	const unsigned int numVoxels = ExprProgram::BlockSize + 5;
+	vector< vector< double > > voxels( numVoxels, vector< double >( 5 ) );
+	vector< const double* > voxelS( numVoxels );
+	for ( unsigned int i = 0; i < numVoxels; ++i ) {
+		for ( unsigned int j = 0; j < 5; ++j )
+			voxels[i][j] = S[j] + 0.1 * i * ( j % 2 ? 1 : -1 );
+		voxelS[i] = &voxels[i][0];
+	}
+	vector< double > out( numVoxels );
+	for ( unsigned int i = 0; exprs[i]; ++i ) {
+		prog.compile( exprs[i], p.GetConst(), vars );
+		prog.evalBulk( &voxelS[0], numVoxels, t, &out[0] );
+		for ( unsigned int j = 0; j < numVoxels; ++j ) {
+			double x = prog.eval( voxelS[j], t );
+			// NaNs from the domain of the functions must match too.
+			assert( out[j] == x || ( std::isnan( x ) && std::isnan( out[j] ) ) );
+		}
+	}
+	cout << "." << flush;
+}
+
+#ifdef USE_HDF5
+#include "hdf5.h"
+#include "HDF5DataWriter.h"
+
+/**
+ * Pushes numbered buffers for two datasets through an HDF5WriteQueue,
+ * for queue limits from 0 (synchronous) to 3, and checks that all the
+ * data reaches the file in the order it was queued.
+ */
+void testHDF5WriteQueue()
+{
+	const char* filename = "testHDF5WriteQueue.h5";
+	const unsigned int numPush = 50;
+	const unsigned int numPerPush = 7;
+	for ( unsigned int limit = 0; limit < 4; ++limit ) {
+		hid_t file = H5Fcreate( filename, H5F_ACC_TRUNC, 
+						H5P_DEFAULT, H5P_DEFAULT );
+		assert( file >= 0 );
+		vector< hid_t > datasets;
+		vector< ObjId > src;
+		for ( unsigned int i = 0; i < 2; ++i ) {
+			hsize_t dims[1] = { 0 };
+			hsize_t maxdims[1] = { H5S_UNLIMITED };
+			hsize_t chunkDims[1] = { 16 };
+			hid_t params = H5Pcreate( H5P_DATASET_CREATE );
+			H5Pset_chunk( params, 1, chunkDims );
+			hid_t space = H5Screate_simple( 1, dims, maxdims );
+			string name = i == 0 ? "a" : "b";
+			datasets.push_back( H5Dcreate2( file, name.c_str(), 
+				H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, params, 
+				H5P_DEFAULT ) );
+			assert( datasets.back() >= 0 );
+			H5Sclose( space );
+			H5Pclose( params );
+			src.push_back( ObjId() );
+		}
+
+		HDF5WriteQueue q;
+		q.setLimit( limit );
+		q.setDatasets( datasets, src );
+		vector< vector< double > > data( 2 );
+		double next = 0.0;
+		for ( unsigned int i = 0; i < numPush; ++i ) {
+			for ( unsigned int j = 0; j < numPerPush; ++j ) {
+				data[0].push_back( next );
+				data[1].push_back( -next );
+				next += 1.0;
+			}
+			q.push( data );
+			// The queue hands back a set of empty buffers.
+			assert( data.size() == 2 );
+			assert( data[0].empty() && data[1].empty() );
+		}
+		q.drain();
+
+		for ( unsigned int i = 0; i < 2; ++i ) {
+			hid_t space = H5Dget_space( datasets[i] );
+			hsize_t n = H5Sget_simple_extent_npoints( space );
+			assert( n == numPush * numPerPush );
+			vector< double > ret( n );
+			herr_t status = H5Dread( datasets[i], H5T_NATIVE_DOUBLE, 
+					H5S_ALL, H5S_ALL, H5P_DEFAULT, &ret[0] );
+			assert( status >= 0 );
+			for ( unsigned int k = 0; k < n; ++k )
+				assert( ret[k] == ( i == 0 ? 1.0 : -1.0 ) * k );
+			H5Sclose( space );
+			H5Dclose( datasets[i] );
+		}
+		H5Fclose( file );
+	}
+	remove( filename );
+	cout << "." << flush;
+}
+#endif // USE_HDF5
+
 void testBuiltins()
 {
 	testArith();
+	testExprProgram();
 	testTable();
+#ifdef USE_HDF5
+	testHDF5WriteQueue();
+#endif
 }
 
 void testBuiltinsProcess()
@@ -0,0 +1,159 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <cassert>
+#include <string>
+#include <iostream>
+using namespace std;
+
+#include "SparseMatrix.h"
+#include "DiffPoolVec.h"
+#include "DiffPoolBatch.h"
+
+DiffPoolBatch::DiffPoolBatch()
+	: numVoxels_( 0 ), isContiguous_( true )
+{;}
+
+bool DiffPoolBatch::sameOps( const vector< Triplet< double > >& a,
+				const vector< Triplet< double > >& b )
+{
+	if ( a.size() != b.size() )
+		return false;
+	for ( unsigned int i = 0; i < a.size(); ++i )
+		if ( a[i].b_ != b[i].b_ || a[i].c_ != b[i].c_ )
+			return false;
+	return true;
+}
+
+void DiffPoolBatch::setup( unsigned int numVoxels,
+				const vector< unsigned int >& pools,
+				const vector< vector< Triplet< double > > >& ops,
+				const vector< vector< double > >& diagVal )
+{
+	assert( pools.size() == ops.size() );
+	assert( pools.size() == diagVal.size() );
+	numVoxels_ = numVoxels;
+	pools_ = pools;
+	opIndex_.clear();
+	coeff_.clear();
+	diag_.clear();
+	n_.clear();
+	unsigned int numPools = pools.size();
+	isContiguous_ = true;
+	for ( unsigned int p = 1; p < numPools; ++p )
+		if ( pools[p] != pools[0] + p )
+			isContiguous_ = false;
+	if ( numPools == 0 )
+		return;
+
+	const vector< Triplet< double > >& first = ops[0];
+	opIndex_.resize( 2 * first.size() );
+	for ( unsigned int i = 0; i < first.size(); ++i ) {
+		opIndex_[ 2 * i ] = first[i].b_;
+		opIndex_[ 2 * i + 1 ] = first[i].c_;
+	}
+	coeff_.resize( first.size() * numPools );
+	diag_.resize( numVoxels * numPools );
+	n_.resize( numVoxels * numPools );
+	for ( unsigned int p = 0; p < numPools; ++p ) {
+		assert( sameOps( first, ops[p] ) );
+		assert( diagVal[p].size() == numVoxels );
+		for ( unsigned int i = 0; i < first.size(); ++i )
+			coeff_[ i * numPools + p ] = ops[p][i].a_;
+		for ( unsigned int v = 0; v < numVoxels; ++v )
+			diag_[ v * numPools + p ] = diagVal[p][v];
+	}
+}
+
+void DiffPoolBatch::advance( vector< DiffPoolVec >& pools )
+{
+	unsigned int numPools = pools_.size();
+	if ( numPools == 0 )
+		return;
+	for ( unsigned int p = 0; p < numPools; ++p ) {
+		assert( pools[ pools_[p] ].getNumVoxels() == numVoxels_ );
+		pools[ pools_[p] ].getNstrided( &n_[p], numPools );
+	}
+
+	double* n = &n_[0];
+	const double* a = &coeff_[0];
+	vector< unsigned int >::const_iterator i;
+	for ( i = opIndex_.begin(); i != opIndex_.end(); i += 2 ) {
+		// The row and column of an op always differ, so nb and nc
+		// do not overlap.
+		const double* nb = n + *i * numPools;
+		double* nc = n + *( i + 1 ) * numPools;
+		for ( unsigned int p = 0; p < numPools; ++p )
+			nc[p] -= nb[p] * a[p];
+		a += numPools;
+	}
+	const double* d = &diag_[0];
+	unsigned int size = n_.size();
+	for ( unsigned int j = 0; j < size; ++j )
+		n[j] *= d[j];
+
+	for ( unsigned int p = 0; p < numPools; ++p )
+		pools[ pools_[p] ].setNstrided( &n_[p], numPools );
+}
+
+void DiffPoolBatch::advanceShared( const vector< double* >& voxelS )
+{
+	unsigned int numPools = pools_.size();
+	if ( numPools == 0 )
+		return;
+	assert( voxelS.size() == numVoxels_ );
+	const double* a = &coeff_[0];
+	const double* d = &diag_[0];
+	vector< unsigned int >::const_iterator i;
+	if ( isContiguous_ ) {
+		// The usual case, where all the diffusing pools are in a row
+		// in each voxel. Same as advance, but on the shared arrays.
+		unsigned int first = pools_[0];
+		for ( i = opIndex_.begin(); i != opIndex_.end(); i += 2 ) {
+			const double* nb = voxelS[ *i ] + first;
+			double* nc = voxelS[ *( i + 1 ) ] + first;
+			for ( unsigned int p = 0; p < numPools; ++p )
+				nc[p] -= nb[p] * a[p];
+			a += numPools;
+		}
+		for ( unsigned int v = 0; v < numVoxels_; ++v ) {
+			double* n = voxelS[v] + first;
+			for ( unsigned int p = 0; p < numPools; ++p )
+				n[p] *= d[p];
+			d += numPools;
+		}
+		return;
+	}
+	const unsigned int* pool = &pools_[0];
+	for ( i = opIndex_.begin(); i != opIndex_.end(); i += 2 ) {
+		const double* nb = voxelS[ *i ];
+		double* nc = voxelS[ *( i + 1 ) ];
+		for ( unsigned int p = 0; p < numPools; ++p )
+			nc[ pool[p] ] -= nb[ pool[p] ] * a[p];
+		a += numPools;
+	}
+	for ( unsigned int v = 0; v < numVoxels_; ++v ) {
+		double* n = voxelS[v];
+		for ( unsigned int p = 0; p < numPools; ++p )
+			n[ pool[p] ] *= d[p];
+		d += numPools;
+	}
+}
+
+unsigned int DiffPoolBatch::getNumPools() const
+{
+	return pools_.size();
+}
+
+const vector< unsigned int >& DiffPoolBatch::getPools() const
+{
+	return pools_;
+}
@@ -0,0 +1,76 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _DIFF_POOL_BATCH_H
+#define _DIFF_POOL_BATCH_H
+
+/**
+ * DiffPoolBatch advances many diffusing pools together. All pools on
+ * the same mesh that diffuse get the same sequence of elimination
+ * operations from FastMatrixElim, differing only in the coefficients.
+ * So the batch stores the row and column of each operation once, and
+ * the coefficients and the 'n' values are interleaved with the pool as
+ * the fastest index: coeff_[op][pool] and n_[voxel][pool]. Each
+ * operation is then a short loop over the pools, which the compiler
+ * can vectorize, and the operation indices are only read once per
+ * timestep instead of once per pool.
+ * The arithmetic for each pool is the same as in DiffPoolVec::advance,
+ * in the same order, so the results are identical.
+ */
+class DiffPoolBatch
+{
+	public:
+		DiffPoolBatch();
+
+		/**
+		 * Sets up the batch for the given pools. ops[i] and diagVal[i]
+		 * are what would have gone to DiffPoolVec::setOps for pool
+		 * pools[i]. All the ops must have the same rows and columns, as
+		 * checked by sameOps.
+		 */
+		void setup( unsigned int numVoxels, 
+				const vector< unsigned int >& pools,
+				const vector< vector< Triplet< double > > >& ops,
+				const vector< vector< double > >& diagVal );
+
+		/// True if the two sequences of ops have the same rows and cols.
+		static bool sameOps( const vector< Triplet< double > >& a,
+				const vector< Triplet< double > >& b );
+
+		/// Advances all the pools in the batch by one timestep.
+		void advance( vector< DiffPoolVec >& pools );
+
+		/**
+		 * Advances the pools in place when their 'n' is shared with
+		 * another solver, as voxelS[voxel][pool]. See
+		 * DiffPoolVec::setShared.
+		 */
+		void advanceShared( const vector< double* >& voxelS );
+
+		unsigned int getNumPools() const;
+		/// Indices, into the Dsolve pool vector, of the pools in the batch
+		const vector< unsigned int >& getPools() const;
+
+	private:
+		unsigned int numVoxels_;
+		/// Indices of the pools handled.
+		vector< unsigned int > pools_;
+		/// Flag: pools_ is a run of consecutive indices.
+		bool isContiguous_;
+		/// Row b_ and column c_ of each operation, in pairs.
+		vector< unsigned int > opIndex_;
+		/// coeff_[ op * numPools + pool ] is the a_ of that operation.
+		vector< double > coeff_;
+		/// diag_[ voxel * numPools + pool ]
+		vector< double > diag_;
+		/// n_[ voxel * numPools + pool ], only used during advance.
+		vector< double > n_;
+};
+
+#endif // _DIFF_POOL_BATCH_H
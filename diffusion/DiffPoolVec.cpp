@@ -24,7 +24,8 @@ using namespace std;
  */
 DiffPoolVec::DiffPoolVec()
 	: id_( 0 ), n_( 1, 0.0 ), nInit_( 1, 0.0 ), 
-		diffConst_( 1.0e-12 ), motorConst_( 0.0 )
+		diffConst_( 1.0e-12 ), motorConst_( 0.0 ),
+		shared_( 0 ), sharedPool_( 0 )
 {;}
 
 double DiffPoolVec::getNinit( unsigned int voxel ) const
@@ -42,35 +43,82 @@ void DiffPoolVec::setNinit( unsigned int voxel, double v )
 double DiffPoolVec::getN( unsigned int voxel ) const
 {
 	assert( voxel < n_.size() );
+	if ( shared_ )
+		return ( *shared_ )[ voxel ][ sharedPool_ ];
 	return n_[ voxel ];
 }
 
 void DiffPoolVec::setN( unsigned int voxel, double v )
 {
 	assert( voxel < n_.size() );
-	n_[ voxel ] = v;
+	if ( shared_ )
+		( *shared_ )[ voxel ][ sharedPool_ ] = v;
+	else
+		n_[ voxel ] = v;
 }
 
-const vector< double >& DiffPoolVec::getNvec() const
+vector< double > DiffPoolVec::getNvec() const
 {
+	if ( shared_ ) {
+		vector< double > ret( n_.size() );
+		for ( unsigned int i = 0; i < n_.size(); ++i )
+			ret[i] = ( *shared_ )[i][ sharedPool_ ];
+		return ret;
+	}
 	return n_;
 }
 
 void DiffPoolVec::setNvec( const vector< double >& vec )
 {
 	assert( vec.size() == n_.size() );
-	n_ = vec;
+	setNvec( 0, vec.size(), vec.begin() );
 }
 
 void DiffPoolVec::setNvec( unsigned int start, unsigned int num,
 				vector< double >::const_iterator q )
 {
 	assert( start + num <= n_.size() );
+	if ( shared_ ) {
+		for ( unsigned int i = start; i < start + num; ++i )
+			( *shared_ )[i][ sharedPool_ ] = *q++;
+		return;
+	}
 	vector< double >::iterator p = n_.begin() + start;
 	for ( unsigned int i = 0; i < num; ++i )
 		*p++ = *q++;
 }
 
+void DiffPoolVec::getNstrided( double* buf, unsigned int stride ) const
+{
+	assert( !shared_ );
+	for ( vector< double >::const_iterator 
+			i = n_.begin(); i != n_.end(); ++i ) {
+		*buf = *i;
+		buf += stride;
+	}
+}
+
+void DiffPoolVec::setNstrided( const double* buf, unsigned int stride )
+{
+	assert( !shared_ );
+	for ( vector< double >::iterator i = n_.begin(); i != n_.end(); ++i ) {
+		*i = *buf;
+		buf += stride;
+	}
+}
+
+void DiffPoolVec::setShared( const vector< double* >* voxelS, 
+				unsigned int pool )
+{
+	if ( shared_ && !voxelS ) {
+		n_ = getNvec();
+	} else if ( voxelS ) {
+		assert( voxelS->size() == n_.size() );
+	}
+	shared_ = voxelS;
+	sharedPool_ = pool;
+}
+
 double DiffPoolVec::getDiffConst() const
 {
 	return diffConst_;
@@ -128,6 +176,10 @@ void DiffPoolVec::setOps(const vector< Triplet< double > >& ops,
 void DiffPoolVec::advance( double dt )
 {
 	if ( ops_.size() == 0 ) return;
+	if ( shared_ ) {
+		advanceShared();
+		return;
+	}
 	for ( vector< Triplet< double > >::const_iterator
 				i = ops_.begin(); i != ops_.end(); ++i )
 		n_[i->c_] -= n_[i->b_] * i->a_;
@@ -139,8 +191,25 @@ void DiffPoolVec::advance( double dt )
 		*iy++ *= *i;
 }
 
+// Same as the unshared advance, done in place in the other solver.
+void DiffPoolVec::advanceShared()
+{
+	double* const* s = &( *shared_ )[0];
+	unsigned int p = sharedPool_;
+	for ( vector< Triplet< double > >::const_iterator
+				i = ops_.begin(); i != ops_.end(); ++i )
+		s[i->c_][p] -= s[i->b_][p] * i->a_;
+
+	assert( shared_->size() == diagVal_.size() );
+	for ( unsigned int i = 0; i < diagVal_.size(); ++i )
+		s[i][p] *= diagVal_[i];
+}
+
 void DiffPoolVec::reinit() // Not called by the clock, but by parent.
 {
 	assert( n_.size() == nInit_.size() );
-	n_ = nInit_;
+	if ( shared_ )
+		setNvec( nInit_ );
+	else
+		n_ = nInit_;
 }
@@ -41,21 +41,39 @@ class DiffPoolVec
 
 		/////////////////////////////////////////////////
 		/// Used by parent solver to manipulate 'n'
-		const vector< double >& getNvec() const; 
+		vector< double > getNvec() const; 
 		/// Used by parent solver to manipulate 'n'
 		void setNvec( const vector< double >& n ); 
 		void setNvec( unsigned int start, unsigned int num, 
 						vector< double >::const_iterator q ); 
+		/// Copies n into every stride'th entry of buf. Used for batching
+		void getNstrided( double* buf, unsigned int stride ) const;
+		/// Copies n from every stride'th entry of buf.
+		void setNstrided( const double* buf, unsigned int stride );
+		/**
+		 * Keeps 'n' in the per-voxel arrays of another solver instead
+		 * of in n_: the value for voxel v is voxelS[v][pool]. A null
+		 * voxelS goes back to n_, first copying the shared values in.
+		 * The vector of pointers must outlive the sharing.
+		 */
+		void setShared( const vector< double* >* voxelS, unsigned int pool );
 		void setOps( const vector< Triplet< double > >& ops_, 
 				const vector< double >& diagVal_ ); /// Assign operations.
 
 		// static const Cinfo* initCinfo();
 	private:
+		/// advance() for when 'n' is shared.
+		void advanceShared();
+
 		unsigned int id_; /// Integer conversion of Id of pool handled.
 		vector< double > n_; /// Number of molecules of pool in each voxel
 		vector< double > nInit_; /// Boundary condition: Initial 'n'.
 		double diffConst_; /// Diffusion const, assumed uniform
 		double motorConst_; /// Motor const, ie, transport rate.
+		/// Per-voxel arrays holding 'n', if shared. Otherwise zero.
+		const vector< double* >* shared_;
+		/// Index of this pool in the shared arrays.
+		unsigned int sharedPool_;
 		vector< Triplet< double > > ops_;
 		vector< double > diagVal_;
 };
@@ -16,6 +16,7 @@
 #include "XferInfo.h"
 #include "ZombiePoolInterface.h"
 #include "DiffPoolVec.h"
+#include "DiffPoolBatch.h"
 #include "FastMatrixElim.h"
 #include "../mesh/VoxelJunction.h"
 #include "DiffJunction.h"
@@ -24,6 +25,7 @@
 #include "../mesh/MeshEntry.h"
 #include "../mesh/ChemCompt.h"
 #include "../mesh/MeshCompt.h"
+#include "../mesh/CubeMesh.h"
 #include "../shell/Wildcard.h"
 #include "../kinetics/PoolBase.h"
 #include "../kinetics/Pool.h"
@@ -82,6 +84,38 @@ const Cinfo* Dsolve::initCinfo()
 			&Dsolve::getNumPools
 		);
 
+		static ValueFinfo< Dsolve, bool > batchDiffusion (
+			"batchDiffusion",
+			"Flag: when true, all diffusing pools are advanced together "
+			"in one sweep over the voxels, with the molecule numbers "
+			"interleaved by pool. This gives the same answers as "
+			"advancing each pool separately, but is faster when there "
+			"are many diffusing species. Takes effect at the next reinit."
+			" Defaults to true.",
+			&Dsolve::setBatchDiffusion,
+			&Dsolve::getBatchDiffusion
+		);
+
+		static ReadOnlyValueFinfo< Dsolve, unsigned int > numBatchPools (
+			"numBatchPools",
+			"Number of pools that are advanced together when "
+			"batchDiffusion is set.",
+			&Dsolve::getNumBatchPools
+		);
+
+		static ReadOnlyValueFinfo< Dsolve, bool > isStateShared (
+			"isStateShared",
+			"Flag: true when the molecule numbers of the pools are held "
+			"in the arrays of the Ksolve, so that the two solvers work "
+			"on them in place rather than copying them each timestep. "
+			"Set up by the Ksolve when the Stoich assigns this Dsolve "
+			"to it. Cleared when the pools of the Dsolve are "
+			"reallocated, in which case the values are copied each "
+			"timestep until the Ksolve sets up the sharing again at "
+			"reinit.",
+			&Dsolve::isStateShared
+		);
+
 		static ValueFinfo< Dsolve, Id > compartment (
 			"compartment",
 			"Reac-diff compartment in which this diffusion system is "
@@ -127,6 +161,9 @@ const Cinfo* Dsolve::initCinfo()
 		&numAllVoxels,			// ReadOnlyValue
 		&nVec,				// LookupValue
 		&numPools,			// Value
+		&batchDiffusion,	// Value
+		&numBatchPools,		// ReadOnlyValue
+		&isStateShared,		// ReadOnlyValue
 		&buildNeuroMeshJunctions, 	// DestFinfo
 		&proc,				// SharedFinfo
 	};
@@ -154,7 +191,8 @@ Dsolve::Dsolve()
 		numTotPools_( 0 ),
 		numLocalPools_( 0 ),
 		poolStartIndex_( 0 ),
-		numVoxels_( 0 )
+		numVoxels_( 0 ),
+		batchDiffusion_( true )
 {;}
 
 Dsolve::~Dsolve()
@@ -185,6 +223,24 @@ vector< double > Dsolve::getNvec( unsigned int pool ) const
 	return ret;
 }
 
+void Dsolve::setBatchDiffusion( bool value )
+{
+	if ( value != batchDiffusion_ ) {
+		batchDiffusion_ = value;
+		dt_ = -1.0; // Forces a rebuild at the next reinit.
+	}
+}
+
+bool Dsolve::getBatchDiffusion() const
+{
+	return batchDiffusion_;
+}
+
+unsigned int Dsolve::getNumBatchPools() const
+{
+	return batch_.getNumPools();
+}
+
 //////////////////////////////////////////////////////////////
 // Process operations.
 //////////////////////////////////////////////////////////////
@@ -251,6 +307,12 @@ void Dsolve::calcJunction( const DiffJunction& jn, double dt )
 
 void Dsolve::process( const Eref& e, ProcPtr p )
 {
+	// Pools in the batch have had their own ops cleared, so advance
+	// does nothing for them.
+	if ( sharedS_.size() > 0 )
+		batch_.advanceShared( sharedS_ );
+	else
+		batch_.advance( pools_ );
 	for ( vector< DiffPoolVec >::iterator 
 					i = pools_.begin(); i != pools_.end(); ++i ) {
 		i->advance( p->dt );
@@ -318,9 +380,13 @@ void Dsolve::setCompartment( Id id )
 {
 	const Cinfo* c = id.element()->cinfo();
 	if ( c->isA( "NeuroMesh" ) || c->isA( "SpineMesh" ) || 
-					c->isA( "PsdMesh" ) || c->isA( "CylMesh" ) ) {
+					c->isA( "PsdMesh" ) || c->isA( "CylMesh" ) ||
+					c->isA( "CubeMesh" ) ) {
 		compartment_ = id;
-		numVoxels_ = Field< unsigned int >::get( id, "numMesh" );
+		unsigned int numVoxels = Field< unsigned int >::get( id, "numMesh" );
+		if ( numVoxels != numVoxels_ )
+			clearSharedState();
+		numVoxels_ = numVoxels;
 		/*
 		const MeshCompt* m = reinterpret_cast< const MeshCompt* >( 
 						id.eref().data() );
@@ -328,7 +394,7 @@ void Dsolve::setCompartment( Id id )
 		*/
 	} else {
 		cout << "Warning: Dsolve::setCompartment:: compartment must be "
-				"NeuroMesh or CylMesh, you tried :" << c->name() << endl;
+				"NeuroMesh, CylMesh or CubeMesh, you tried :" << c->name() << endl;
 	}
 }
 
@@ -444,31 +510,132 @@ void Dsolve::build( double dt )
 	const MeshCompt* m = reinterpret_cast< const MeshCompt* >( 
 						compartment_.eref().data() );
 	unsigned int numVoxels = m->getNumEntries();
+	vector< vector< Triplet< double > > > allOps( numLocalPools_ );
+	vector< vector< double > > allDiagVal( numLocalPools_ );
+
+	if ( compartment_.element()->cinfo()->isA( "CubeMesh" ) )
+		buildCubeOps( dt, allOps, allDiagVal );
+	else {
+		for ( unsigned int i = 0; i < numLocalPools_; ++i ) {
+			bool debugFlag = false;
+			vector< unsigned int > diagIndex;
+			vector< double > diagVal;
+			vector< Triplet< double > > fops;
+			FastMatrixElim elim( numVoxels, numVoxels );
+			if ( elim.buildForDiffusion( 
+				m->getParentVoxel(), m->getVoxelVolume(), 
+				m->getVoxelArea(), m->getVoxelLength(), 
+			    pools_[i].getDiffConst(), pools_[i].getMotorConst(), dt ) ) 
+			{
+				vector< unsigned int > parentVoxel = m->getParentVoxel();
+				assert( elim.checkSymmetricShape() );
+				vector< unsigned int > lookupOldRowsFromNew;
+				elim.hinesReorder( parentVoxel, lookupOldRowsFromNew );
+				assert( elim.checkSymmetricShape() );
+				pools_[i].setNumVoxels( numVoxels_ );
+				elim.buildForwardElim( diagIndex, fops );
+				elim.buildBackwardSub( diagIndex, fops, diagVal );
+				elim.opsReorder( lookupOldRowsFromNew, fops, diagVal );
+				if (debugFlag )
+					elim.print();
+			}
+			allOps[i].swap( fops );
+			allDiagVal[i].swap( diagVal );
+		}
+	}
+
+	// Batch up the diffusing pools whose ops match the first one. On a
+	// single mesh this is all of them, as the ops only depend on the
+	// mesh topology. Any others are advanced on their own.
+	vector< unsigned int > batchPools;
+	vector< vector< Triplet< double > > > batchOps;
+	vector< vector< double > > batchDiagVal;
+	if ( batchDiffusion_ ) {
+		for ( unsigned int i = 0; i < numLocalPools_; ++i ) {
+			if ( allOps[i].size() == 0 )
+				continue;
+			if ( batchPools.size() > 0 && 
+				!DiffPoolBatch::sameOps( batchOps[0], allOps[i] ) )
+				continue;
+			batchPools.push_back( i );
+			batchOps.push_back( vector< Triplet< double > >() );
+			batchOps.back().swap( allOps[i] );
+			batchDiagVal.push_back( vector< double >() );
+			batchDiagVal.back().swap( allDiagVal[i] );
+		}
+		if ( batchPools.size() < 2 ) { // Nothing to gain, undo it.
+			for ( unsigned int j = 0; j < batchPools.size(); ++j ) {
+				allOps[ batchPools[j] ].swap( batchOps[j] );
+				allDiagVal[ batchPools[j] ].swap( batchDiagVal[j] );
+			}
+			batchPools.clear();
+			batchOps.clear();
+			batchDiagVal.clear();
+		}
+	}
+	batch_.setup( numVoxels_, batchPools, batchOps, batchDiagVal );
+	for ( unsigned int i = 0; i < numLocalPools_; ++i )
+		pools_[i].setOps( allOps[i], allDiagVal[i] );
+}
+
+/**
+ * Finds the direction of each entry in the stencil of a CubeMesh, from
+ * the offset between the two voxels in the space of the cuboid.
+ * 0 is x, 1 is y and 2 is z.
+ */
+static void cubeStencilAxes( const CubeMesh* cm, vector< unsigned int >& axis )
+{
+	const SparseMatrix< double >& stencil = cm->getStencil();
+	vector< unsigned int > m2s = cm->getMeshToSpace();
+	unsigned int nx = cm->getNx();
+	unsigned int ny = cm->getNy();
+	axis.clear();
+	for ( unsigned int i = 0; i < stencil.nRows(); ++i ) {
+		const double* entry;
+		const unsigned int* colIndex;
+		unsigned int num = stencil.getRow( i, &entry, &colIndex );
+		for ( unsigned int j = 0; j < num; ++j ) {
+			unsigned int p = m2s[i];
+			unsigned int q = m2s[ colIndex[j] ];
+			unsigned int d = ( p > q ) ? p - q : q - p;
+			if ( d == 1 && nx > 1 )
+				axis.push_back( 0 );
+			else if ( d == nx && ny > 1 )
+				axis.push_back( 1 );
+			else
+				axis.push_back( 2 );
+		}
+	}
+}
+
+/**
+ * The CubeMesh has cycles, so the tree method of build does not apply.
+ * Here each timestep is split into implicit steps along x, y and z.
+ */
+void Dsolve::buildCubeOps( double dt, 
+				vector< vector< Triplet< double > > >& allOps,
+				vector< vector< double > >& allDiagVal )
+{
+	const CubeMesh* cm = reinterpret_cast< const CubeMesh* >( 
+						compartment_.eref().data() );
+	unsigned int numVoxels = cm->getNumEntries();
+	vector< unsigned int > axis;
+	cubeStencilAxes( cm, axis );
+	vector< double > volume( numVoxels );
+	for ( unsigned int i = 0; i < numVoxels; ++i )
+		volume[i] = cm->getMeshEntryVolume( i );
 
 	for ( unsigned int i = 0; i < numLocalPools_; ++i ) {
-		bool debugFlag = false;
-		vector< unsigned int > diagIndex;
-		vector< double > diagVal;
-		vector< Triplet< double > > fops;
-		FastMatrixElim elim( numVoxels, numVoxels );
-		if ( elim.buildForDiffusion( 
-			m->getParentVoxel(), m->getVoxelVolume(), 
-			m->getVoxelArea(), m->getVoxelLength(), 
-		    pools_[i].getDiffConst(), pools_[i].getMotorConst(), dt ) ) 
-		{
-			vector< unsigned int > parentVoxel = m->getParentVoxel();
-			assert( elim.checkSymmetricShape() );
-			vector< unsigned int > lookupOldRowsFromNew;
-			elim.hinesReorder( parentVoxel, lookupOldRowsFromNew );
-			assert( elim.checkSymmetricShape() );
-			pools_[i].setNumVoxels( numVoxels_ );
-			elim.buildForwardElim( diagIndex, fops );
-			elim.buildBackwardSub( diagIndex, fops, diagVal );
-			elim.opsReorder( lookupOldRowsFromNew, fops, diagVal );
-			if (debugFlag )
-				elim.print();
+		pools_[i].setNumVoxels( numVoxels_ );
+		if ( !FastMatrixElim::buildForGridDiffusion( cm->getStencil(), 
+			axis, 3, volume, pools_[i].getDiffConst(), dt, 
+			allOps[i], allDiagVal[i] ) ) {
+			if ( pools_[i].getDiffConst() >= 1e-18 )
+				cout << "Warning: Dsolve::buildCubeOps: Could not set up "
+						"diffusion on '" << compartment_.path() << "'\n";
+			allOps[i].clear();
+			allDiagVal[i].clear();
 		}
-		pools_[i].setOps( fops, diagVal );
 	}
 }
 
@@ -562,6 +729,8 @@ unsigned int Dsolve::getNumVoxels() const
 
 void Dsolve::setNumAllVoxels( unsigned int num ) 
 {
+	if ( num != numVoxels_ )
+		clearSharedState();
 	numVoxels_ = num;
 	for ( unsigned int i = 0 ; i < numLocalPools_; ++i )
 		pools_[i].setNumVoxels( numVoxels_ );
@@ -661,6 +830,7 @@ void Dsolve::setMotorConst( const Eref& e, double v )
 void Dsolve::setNumPools( unsigned int numPoolSpecies )
 {
 	// Decompose numPoolSpecies here, assigning some to each node.
+	clearSharedState();
 	numTotPools_ = numPoolSpecies;
 	numLocalPools_ = numPoolSpecies;
 	poolStartIndex_ = 0;
@@ -694,11 +864,9 @@ void Dsolve::getBlock( vector< double >& values ) const
 	for ( unsigned int i = 0; i < numPools; ++i ) {
 		unsigned int j = i + startPool;
 		if ( j >= poolStartIndex_ && j < poolStartIndex_ + numLocalPools_ ){
-			vector< double >::const_iterator q =
-				pools_[ j - poolStartIndex_ ].getNvec().begin();
-				
-			values.insert( values.end(),
-				q + startVoxel, q + startVoxel + numVoxels );
+			const DiffPoolVec& dpv = pools_[ j - poolStartIndex_ ];
+			for ( unsigned int k = 0; k < numVoxels; ++k )
+				values.push_back( dpv.getN( startVoxel + k ) );
 		}
 	}
 }
@@ -725,6 +893,38 @@ void Dsolve::setBlock( const vector< double >& values )
 	}
 }
 
+bool Dsolve::setSharedState( const vector< double* >& voxelS,
+				unsigned int numPools )
+{
+	clearSharedState();
+	if ( voxelS.size() != numVoxels_ || numVoxels_ == 0 ||
+			poolStartIndex_ + numLocalPools_ > numPools )
+		return false;
+	sharedS_ = voxelS;
+	for ( unsigned int i = 0; i < numLocalPools_; ++i ) {
+		if ( pools_[i].getNumVoxels() != numVoxels_ ) {
+			clearSharedState();
+			return false;
+		}
+		pools_[i].setShared( &sharedS_, i + poolStartIndex_ );
+	}
+	return true;
+}
+
+void Dsolve::clearSharedState()
+{
+	if ( sharedS_.size() == 0 )
+		return;
+	for ( unsigned int i = 0; i < numLocalPools_; ++i )
+		pools_[i].setShared( 0, 0 );
+	sharedS_.clear();
+}
+
+bool Dsolve::isStateShared() const
+{
+	return sharedS_.size() > 0;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Inherited virtual
 
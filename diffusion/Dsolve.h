@@ -53,6 +53,11 @@ class Dsolve: public ZombiePoolInterface
 		vector< double > getNvec( unsigned int pool ) const;
 		void setNvec( unsigned int pool, vector< double > vec );
 
+		void setBatchDiffusion( bool value );
+		bool getBatchDiffusion() const;
+		/// Number of pools advanced together by batch_.
+		unsigned int getNumBatchPools() const;
+
 		//////////////////////////////////////////////////////////////////
 		// Dest Finfos
 		//////////////////////////////////////////////////////////////////
@@ -108,6 +113,12 @@ class Dsolve: public ZombiePoolInterface
 
 		void getBlock( vector< double >& values ) const;
 		void setBlock( const vector< double >& values );
+		/// Inherited. Shares the 'n' of all the pools with a Ksolve.
+		bool setSharedState( const vector< double* >& voxelS,
+						unsigned int numPools );
+		void clearSharedState();
+		/// Inherited. True if the pool 'n' are held by the reac solver.
+		bool isStateShared() const;
 
 		// This one isn't used in Dsolve, but is defined as a dummy.
 		void setupCrossSolverReacs( 
@@ -142,6 +153,14 @@ class Dsolve: public ZombiePoolInterface
 		void build( double dt );
 		void rebuildPools();
 
+		/**
+		 * Builds the ops for all pools for a CubeMesh, which may be
+		 * 2 or 3 dimensional and so has no tree ordering.
+		 */
+		void buildCubeOps( double dt, 
+				vector< vector< Triplet< double > > >& allOps,
+				vector< vector< double > >& allDiagVal );
+
 		/**
 		 * Utility func for debugging: Prints N_ matrix
 		 */
@@ -165,6 +184,18 @@ class Dsolve: public ZombiePoolInterface
 		/// Internal vector, one for each pool species managed by Dsolve.
 		vector< DiffPoolVec > pools_;
 
+		/// Flag: advance all the diffusing pools together in batch_.
+		bool batchDiffusion_;
+
+		/// Holds the diffusing pools when batchDiffusion_ is set.
+		DiffPoolBatch batch_;
+
+		/**
+		 * The S arrays of the reac solver, one per voxel, when the
+		 * pool 'n' are shared with it. Otherwise empty.
+		 */
+		vector< double* > sharedS_;
+
 		/// smallest Id value for poolMap_
 		unsigned int poolMapStart_;
 
@@ -506,6 +506,89 @@ void FastMatrixElim::opsReorder(
 	}
 }
 
+/**
+ * The first step leaves the true values as diagVal[i] * y[i]. The ops
+ * of the next step are rescaled to act on y in that form, and the two
+ * diagonals are multiplied at the end.
+ */
+void FastMatrixElim::opsCompose( 
+		vector< Triplet< double > >& ops,
+		vector< double >& diagVal,
+		const vector< Triplet< double > >& nextOps,
+		const vector< double >& nextDiagVal )
+{
+	assert( diagVal.size() == nextDiagVal.size() );
+	for ( vector< Triplet< double > >::const_iterator
+			i = nextOps.begin(); i != nextOps.end(); ++i ) {
+		ops.push_back( Triplet< double >( 
+			i->a_ * diagVal[ i->b_ ] / diagVal[ i->c_ ], i->b_, i->c_ ) );
+	}
+	for ( unsigned int i = 0; i < diagVal.size(); ++i )
+		diagVal[i] *= nextDiagVal[i];
+}
+
+bool FastMatrixElim::buildForGridDiffusion(
+			const SparseMatrix< double >& stencil,
+			const vector< unsigned int >& axis, unsigned int numAxes,
+			const vector< double >& volume,
+			double diffConst, double dt,
+			vector< Triplet< double > >& ops,
+			vector< double >& diagVal )
+{
+	ops.clear();
+	diagVal.clear();
+	if ( diffConst < 1e-18 ) 
+		return false;
+	unsigned int nrows = stencil.nRows();
+	assert( volume.size() == nrows );
+	diagVal.resize( nrows, 1.0 );
+	for ( unsigned int ax = 0; ax < numAxes; ++ax ) {
+		FastMatrixElim elim( nrows, nrows );
+		unsigned int k = 0; // Index of the stencil entry.
+		for ( unsigned int i = 0; i < nrows; ++i ) {
+			const double* entry;
+			const unsigned int* colIndex;
+			unsigned int num = stencil.getRow( i, &entry, &colIndex );
+			vector< double > e;
+			vector< unsigned int > c;
+			double diag = 1.0;
+			unsigned int numBelow = 0;
+			unsigned int numAbove = 0;
+			for ( unsigned int j = 0; j < num; ++j ) {
+				assert( k + j < axis.size() );
+				if ( axis[ k + j ] != ax )
+					continue;
+				unsigned int col = colIndex[j];
+				if ( col < i ) 
+					++numBelow;
+				else
+					++numAbove;
+				diag += dt * diffConst * entry[j] / volume[i];
+				e.push_back( -dt * diffConst * entry[j] / volume[col] );
+				c.push_back( col );
+			}
+			k += num;
+			// Each voxel must be in a single chain along each axis.
+			if ( numBelow > 1 || numAbove > 1 ) {
+				ops.clear();
+				diagVal.clear();
+				return false;
+			}
+			// Stencil columns are sorted, so the diagonal goes in between.
+			vector< double >::iterator pos = e.begin() + numBelow;
+			e.insert( pos, diag );
+			c.insert( c.begin() + numBelow, i );
+			elim.addRow( i, e, c );
+		}
+		vector< unsigned int > diagIndex;
+		vector< Triplet< double > > axisOps;
+		vector< double > axisDiagVal;
+		elim.buildForwardElim( diagIndex, axisOps );
+		elim.buildBackwardSub( diagIndex, axisOps, axisDiagVal );
+		opsCompose( ops, diagVal, axisOps, axisDiagVal );
+	}
+	return true;
+}
 
 // Build up colIndices for each row.
 void buildColIndex( unsigned int nrows,
@@ -101,6 +101,39 @@ class FastMatrixElim: public SparseMatrix< double >
 			const vector< double >& length,
 			double diffConst, double motorConst, double dt );
 
+		/**
+		 * Makes the ops for diffusion on a mesh with cycles, such as a
+		 * 3-D CubeMesh, where the Hines ordering cannot be used. The
+		 * stencil has the diffusive coupling (area/length) between
+		 * neighbouring voxels, and axis has the direction, from 0 to
+		 * numAxes - 1, of each of its entries. The step is split into
+		 * one Backward Euler step along each axis in turn. Each of these
+		 * is a set of independent tridiagonal systems, so the split
+		 * step is cheap, conserves mass, and is stable for any dt.
+		 * Along each axis the voxel index must increase, as it does in
+		 * the CubeMesh. Returns false if it does not, or if diffConst
+		 * is too small to matter.
+		 * The resulting ops and diagVal are used just as for a tree.
+		 */
+		static bool buildForGridDiffusion(
+			const SparseMatrix< double >& stencil,
+			const vector< unsigned int >& axis, unsigned int numAxes,
+			const vector< double >& volume,
+			double diffConst, double dt,
+			vector< Triplet< double > >& ops,
+			vector< double >& diagVal );
+
+		/**
+		 * Static function. Appends the step given by nextOps and
+		 * nextDiagVal to that in ops and diagVal, so that the combined
+		 * ops and diagVal do the two steps one after the other.
+		 */
+		static void opsCompose( 
+				vector< Triplet< double > >& ops,
+				vector< double >& diagVal,
+				const vector< Triplet< double > >& nextOps,
+				const vector< double >& nextDiagVal );
+
 		/**
 		 * Does the actual computation of the matrix inversion, which is
 		 * equivalent to advancing one timestem in Backward Euler.
@@ -705,6 +705,8 @@ void testCylDiffnWithStoich()
 	Field< Id >::set( stoich, "dsolve", dsolve );
 	Field< string >::set( stoich, "path", "/model/cyl/#" );
 	assert( pool1.element()->numData() == ndc );
+	// The Ksolve and Dsolve work on the same pool arrays.
+	assert( Field< bool >::get( dsolve, "isStateShared" ) );
 
 	// Then find a way to test it.
 	vector< double > poolVec;
@@ -764,6 +766,88 @@ void testCylDiffnWithStoich()
 	s->doDelete( model );
 	cout << "." << flush;
 }
+
+/**
+ * Reallocating the pools of the Dsolve ends the sharing of state with the
+ * Ksolve. Check that the two solvers still exchange values after that,
+ * by matching the run against one done with the state shared throughout,
+ * and that reinit sets up the sharing again.
+ */
+void testDsolveReallocUnshares()
+{
+	Shell* s = reinterpret_cast< Shell* >( Id().eref().data() );
+	double len = 10e-6;
+	double diffLength = 1e-6;
+	double runtime = 5.0;
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	Id cyl = s->doCreate( "CylMesh", model, "cyl", 1 );
+	Field< double >::set( cyl, "r0", 1e-6 );
+	Field< double >::set( cyl, "r1", 1e-6 );
+	Field< double >::set( cyl, "x0", 0 );
+	Field< double >::set( cyl, "x1", len );
+	Field< double >::set( cyl, "diffLength", diffLength );
+	unsigned int ndc = Field< unsigned int >::get( cyl, "numMesh" );
+	Id pool1 = s->doCreate( "Pool", cyl, "pool1", 1 );
+	Id pool2 = s->doCreate( "Pool", cyl, "pool2", 1 );
+	Field< double >::set( pool1, "diffConst", 1e-12 );
+	Field< double >::set( pool2, "diffConst", 0.0 );
+	// A reaction, so that the Ksolve has to see the diffused values.
+	Id reac = s->doCreate( "Reac", cyl, "reac", 1 );
+	s->doAddMsg( "Single", reac, "sub", pool1, "reac" );
+	s->doAddMsg( "Single", reac, "prd", pool2, "reac" );
+	Field< double >::set( reac, "Kf", 0.2 );
+	Field< double >::set( reac, "Kb", 0.1 );
+
+	Id stoich = s->doCreate( "Stoich", model, "stoich", 1 );
+	Id ksolve = s->doCreate( "Ksolve", model, "ksolve", 1 );
+	Id dsolve = s->doCreate( "Dsolve", model, "dsolve", 1 );
+	Field< Id >::set( stoich, "compartment", cyl );
+	Field< Id >::set( stoich, "ksolve", ksolve );
+	Field< Id >::set( stoich, "dsolve", dsolve );
+	Field< string >::set( stoich, "path", "/model/cyl/#" );
+	assert( pool1.element()->numData() == ndc );
+	Field< double >::set( ObjId( pool1, 0 ), "nInit", 1.0 );
+
+	s->doUseClock( "/model/dsolve", "process", 0 );
+	s->doUseClock( "/model/ksolve", "process", 1 );
+	s->doSetClock( 0, 0.1 );
+	s->doSetClock( 1, 0.1 );
+	s->doReinit();
+	assert( Field< bool >::get( dsolve, "isStateShared" ) );
+	s->doStart( runtime );
+	vector< double > ref1;
+	vector< double > ref2;
+   	Field< double >::getVec( pool1, "n", ref1 );
+   	Field< double >::getVec( pool2, "n", ref2 );
+	assert( ref1.size() == ndc );
+	assert( ref2[ndc - 1] > 0.0 ); // pool1 diffused and then reacted.
+
+	s->doReinit();
+	unsigned int numPools = Field< unsigned int >::get( dsolve, "numPools" );
+	Field< unsigned int >::set( dsolve, "numPools", numPools );
+	assert( !Field< bool >::get( dsolve, "isStateShared" ) );
+	s->doStart( runtime );
+	vector< double > n1;
+	vector< double > n2;
+   	Field< double >::getVec( pool1, "n", n1 );
+   	Field< double >::getVec( pool2, "n", n2 );
+	vector< double > nvec = 
+		LookupField< unsigned int, vector< double > >::get( 
+						dsolve, "nVec", 0);
+	assert( nvec.size() == ndc );
+	for ( unsigned int i = 0; i < ndc; ++i ) {
+		assert( doubleEq( n1[i], ref1[i] ) );
+		assert( doubleEq( n2[i], ref2[i] ) );
+		assert( doubleEq( nvec[i], n1[i] ) );
+	}
+
+	s->doReinit();
+	assert( Field< bool >::get( dsolve, "isStateShared" ) );
+
+	s->doDelete( model );
+	cout << "." << flush;
+}
+
 #if 0
 void testBuildTree()
 {
@@ -907,6 +991,148 @@ void testCalcJunction()
 	cout << "." << flush;
 }
 
+/**
+ * Runs diffusion from one corner of a 3-D CubeMesh, and returns the
+ * final n of the pool in each voxel.
+ */
+static vector< double > runCubeDiffn( double dt, double runtime )
+{
+	Shell* s = reinterpret_cast< Shell* >( Id().eref().data() );
+	const unsigned int nx = 8;
+	double dx = 1e-6;
+	double diffConst = 1.0e-12; 
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	Id cube = s->doCreate( "CubeMesh", model, "cube", 1 );
+	vector< double > coords( 9, 0.0 );
+	coords[3] = coords[4] = coords[5] = nx * dx;
+	coords[6] = coords[7] = coords[8] = dx;
+	Field< vector< double > >::set( cube, "coords", coords );
+	unsigned int ndc = Field< unsigned int >::get( cube, "numMesh" );
+	assert( ndc == nx * nx * nx );
+	Id pool = s->doCreate( "Pool", cube, "pool", 1 );
+	Field< double >::set( pool, "diffConst", diffConst );
+
+	Id dsolve = s->doCreate( "Dsolve", model, "dsolve", 1 );
+	Field< Id >::set( dsolve, "compartment", cube );
+	s->doUseClock( "/model/dsolve", "process", 1 );
+	s->doSetClock( 1, dt );
+	Field< string >::set( dsolve, "path", "/model/cube/pool" );
+	Field< double >::set( ObjId( pool, 0 ), "nInit", 1.0 );
+	s->doReinit();
+	s->doStart( runtime );
+
+	vector< double > nvec;
+   	Field< double >::getVec( pool, "n", nvec );
+	assert( nvec.size() == ndc );
+	s->doDelete( model );
+	return nvec;
+}
+
+/**
+ * The CubeMesh has cycles, so it is solved by splitting each step
+ * into implicit steps along x, y and z. Checks that this conserves
+ * mass, keeps its symmetry, stays positive at a large dt, and is close
+ * to the answer from a small dt.
+ */
+void testCubeDiffn()
+{
+	const unsigned int nx = 8;
+	// D * dt / dx^2 is 2 here, 12 times the explicit stability limit.
+	vector< double > big = runCubeDiffn( 2.0, 10.0 );
+	vector< double > small = runCubeDiffn( 0.02, 10.0 );
+	double tot = 0.0;
+	double err = 0.0;
+	for ( unsigned int i = 0; i < big.size(); ++i ) {
+		assert( big[i] >= 0.0 );
+		tot += big[i];
+		err += ( big[i] - small[i] ) * ( big[i] - small[i] );
+	}
+	assert( doubleEq( tot, 1.0 ) );
+	// Not yet uniform, but within 20% of the mean of the small dt run.
+	assert( big[0] > 10.0 * big.back() );
+	assert( sqrt( err / big.size() ) < 0.2 / big.size() );
+	// The source is at the corner, so swapping axes changes nothing.
+	for ( unsigned int z = 0; z < nx; ++z ) {
+		for ( unsigned int y = 0; y < nx; ++y ) {
+			for ( unsigned int x = 0; x < nx; ++x ) {
+				double n = big[ x + nx * ( y + nx * z ) ];
+				assert( doubleEq( n, big[ y + nx * ( x + nx * z ) ] ) );
+				assert( doubleEq( n, big[ z + nx * ( y + nx * x ) ] ) );
+			}
+		}
+	}
+	cout << "." << flush;
+}
+
+/**
+ * Checks that advancing the pools together in a batch gives the same
+ * answers as advancing them one at a time.
+ */
+void testBatchDiffusion()
+{
+	Shell* s = reinterpret_cast< Shell* >( Id().eref().data() );
+	double len = 25e-6;
+	double diffLength = 1e-6;
+	double runtime = 10.0;
+	double dt = 0.1;
+	const unsigned int numPools = 4;
+	double diffConst[] = { 1.0e-12, 2.0e-12, 0.0, 5.0e-13 };
+	double motorConst[] = { 0.0, 0.0, 0.0, 1.0e-7 };
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	Id cyl = s->doCreate( "CylMesh", model, "cyl", 1 );
+	Field< double >::set( cyl, "r0", 1e-6 );
+	Field< double >::set( cyl, "r1", 0.5e-6 );
+	Field< double >::set( cyl, "x0", 0 );
+	Field< double >::set( cyl, "x1", len );
+	Field< double >::set( cyl, "diffLength", diffLength );
+	unsigned int ndc = Field< unsigned int >::get( cyl, "numMesh" );
+	vector< Id > pools;
+	for ( unsigned int i = 0; i < numPools; ++i ) {
+		stringstream ss;
+		ss << "pool" << i;
+		Id pool = s->doCreate( "Pool", cyl, ss.str(), 1 );
+		Field< double >::set( pool, "diffConst", diffConst[i] );
+		Field< double >::set( pool, "motorConst", motorConst[i] );
+		pools.push_back( pool );
+	}
+	Id dsolve = s->doCreate( "Dsolve", model, "dsolve", 1 );
+	Field< Id >::set( dsolve, "compartment", cyl );
+	s->doUseClock( "/model/dsolve", "process", 1 );
+	s->doSetClock( 1, dt );
+	Field< string >::set( dsolve, "path", "/model/cyl/#" );
+	for ( unsigned int i = 0; i < numPools; ++i ) {
+		Field< double >::set( ObjId( pools[i], i ), "nInit", 1.0 + i );
+		Field< double >::set( ObjId( pools[i], ndc - 1 ), "nInit", 2.0 );
+	}
+
+	vector< vector< double > > single( numPools );
+	Field< bool >::set( dsolve, "batchDiffusion", false );
+	s->doReinit();
+	assert( Field< unsigned int >::get( dsolve, "numBatchPools" ) == 0 );
+	s->doStart( runtime );
+	for ( unsigned int i = 0; i < numPools; ++i )
+   		Field< double >::getVec( pools[i], "n", single[i] );
+
+	Field< bool >::set( dsolve, "batchDiffusion", true );
+	s->doReinit();
+	// The pool that neither diffuses nor moves is left out.
+	assert( Field< unsigned int >::get( dsolve, "numBatchPools" ) == 3 );
+	s->doStart( runtime );
+	for ( unsigned int i = 0; i < numPools; ++i ) {
+		vector< double > batch;
+   		Field< double >::getVec( pools[i], "n", batch );
+		assert( batch.size() == ndc );
+		assert( single[i].size() == ndc );
+		for ( unsigned int j = 0; j < ndc; ++j )
+			assert( doubleEq( batch[j], single[i][j] ) );
+	}
+	assert( !doubleEq( single[0][1], 0.0 ) ); // It did diffuse.
+	assert( doubleEq( single[2][1], 0.0 ) ); // But not this one.
+
+	s->doDelete( model );
+	cout << "." << flush;
+}
+
 void testDiffusion()
 {
 	testSorting();
@@ -917,5 +1143,8 @@ void testDiffusion()
 	testSmallCellDiffn();
 	testCellDiffn();
 	testCylDiffnWithStoich();
+	testDsolveReallocUnshares();
 	testCalcJunction();
+	testBatchDiffusion();
+	testCubeDiffn();
 }
@@ -24,6 +24,7 @@
 #include "../biophysics/ChanCommon.h"
 #include "../biophysics/HHChannel.h"
 #include "ZombieHHChannel.h"
+#include "../biophysics/SpikeGen.h"
 #include "../shell/Shell.h"
 
 const Cinfo* HSolve::initCinfo()
@@ -167,7 +168,10 @@ const Cinfo* HSolve::initCinfo()
         "Name",             "HSolve",
         "Author",           "Niraj Dudani, 2007, NCBS",
         "Description",      "HSolve: Hines solver, for solving "
-        "branching neuron models.",
+        "branching neuron models. An HSolve element may have many entries, "
+        "each with its own target cell. Cells that have the same branching "
+        "structure have their matrices solved together, and entries share "
+        "their rate lookup tables where these are identical.",
     };
 
     static Dinfo< HSolve > dinfo;
@@ -178,7 +182,9 @@ const Cinfo* HSolve::initCinfo()
         sizeof( hsolveFinfos ) / sizeof( Finfo* ),
 		&dinfo,
         doc,
-        sizeof(doc)/sizeof(string)
+        sizeof(doc)/sizeof(string),
+        false,
+        &HSolve::isSelfContained
     );
 
     return &hsolveCinfo;
@@ -186,8 +192,13 @@ const Cinfo* HSolve::initCinfo()
 
 static const Cinfo* hsolveCinfo = HSolve::initCinfo();
 
+/// Largest number of cells solved together. More would not fit in cache,
+/// and would leave too few batches to spread over threads.
+static const unsigned int MAX_BATCH = 16;
+
 HSolve::HSolve()
-    : dt_( 50e-6 )
+    : dt_( 50e-6 ),
+      inBatch_( false )
 {
     ;
 }
@@ -199,7 +210,30 @@ HSolve::HSolve()
 
 void HSolve::process( const Eref& hsolve, ProcPtr p )
 {
-    this->HSolveActive::step( p );
+    if ( inBatch_ )
+        return;    // The first entry of the batch does this cell too.
+
+    if ( batch_.empty() )
+        this->HSolveActive::step( p );
+    else
+        processBatch( hsolve, p );
+}
+
+void HSolve::processBatch( const Eref& hsolve, ProcPtr p )
+{
+    Element* e = hsolve.element();
+    vector< unsigned int >::iterator i;
+
+    prepareSolve( p );
+    for ( i = batch_.begin(); i != batch_.end(); ++i )
+        reinterpret_cast< HSolve* >( Eref( e, *i ).data() )->prepareSolve( p );
+
+    forwardEliminateBatch();
+    backwardSubstituteBatch();
+
+    finishStep( p );
+    for ( i = batch_.begin(); i != batch_.end(); ++i )
+        reinterpret_cast< HSolve* >( Eref( e, *i ).data() )->finishStep( p );
 }
 
 void HSolve::reinit( const Eref& hsolve, ProcPtr p )
@@ -217,30 +251,146 @@ void HSolve::zombify( Eref hsolve ) const
 		temp.push_back( ObjId( *i, 0 ) );
     for ( i = compartmentId_.begin(); i != compartmentId_.end(); ++i )
         CompartmentBase::zombify( i->eref().element(),
-					   ZombieCompartment::initCinfo(), hsolve.id() );
+					   ZombieCompartment::initCinfo(), hsolve.objId() );
 
 	temp.clear();
     for ( i = caConcId_.begin(); i != caConcId_.end(); ++i )
 		temp.push_back( ObjId( *i, 0 ) );
 	// Shell::dropClockMsgs( temp, "process" );
     for ( i = caConcId_.begin(); i != caConcId_.end(); ++i )
-        CaConcBase::zombify( i->eref().element(), ZombieCaConc::initCinfo(), hsolve.id() );
+        CaConcBase::zombify( i->eref().element(), ZombieCaConc::initCinfo(), hsolve.objId() );
 
 	temp.clear();
     for ( i = channelId_.begin(); i != channelId_.end(); ++i )
 		temp.push_back( ObjId( *i, 0 ) );
     for ( i = channelId_.begin(); i != channelId_.end(); ++i )
         HHChannelBase::zombify( i->eref().element(),
-						ZombieHHChannel::initCinfo(), hsolve.id() );
+						ZombieHHChannel::initCinfo(), hsolve.objId() );
 }
 
 void HSolve::setup( Eref hsolve )
 {
     // Setup solver.
     this->HSolveActive::setup( seed_, dt_ );
+    shareTables( hsolve );
 
     mapIds();
     zombify( hsolve );
+    buildBatches( hsolve.element() );
+}
+
+void HSolve::shareTables( const Eref& hsolve )
+{
+    Element* e = hsolve.element();
+    unsigned int start = e->localDataStart();
+    unsigned int end = start + e->numLocalData();
+    bool vShared = false;
+    bool caShared = false;
+    for ( unsigned int k = start; k < end && !( vShared && caShared ); ++k )
+    {
+        if ( k == hsolve.dataIndex() )
+            continue;
+        HSolve* other = reinterpret_cast< HSolve* >( Eref( e, k ).data() );
+        if ( other->nCompt_ <= 0 )
+            continue;
+        if ( !vShared )
+            vShared = vTable_.share( other->vTable_ );
+        if ( !caShared )
+            caShared = caTable_.share( other->caTable_ );
+    }
+}
+
+void HSolve::buildBatches( Element* e )
+{
+    unsigned int start = e->localDataStart();
+    unsigned int end = start + e->numLocalData();
+
+    vector< HSolve* > cells;
+    for ( unsigned int k = start; k < end; ++k )
+    {
+        HSolve* cell = reinterpret_cast< HSolve* >( Eref( e, k ).data() );
+        cell->unbindBatch();
+        cell->batch_.clear();
+        cell->inBatch_ = false;
+        cell->batchData_.reset();
+        cells.push_back( cell );
+    }
+
+    for ( unsigned int k = 0; k < cells.size(); ++k )
+    {
+        HSolve* leader = cells[ k ];
+        if ( leader->nCompt_ <= 0 || leader->inBatch_ )
+            continue;
+
+        vector< unsigned int > members;
+        for ( unsigned int j = k + 1;
+                j < cells.size() && members.size() + 1 < MAX_BATCH; ++j )
+            if ( cells[ j ]->nCompt_ > 0 && !cells[ j ]->inBatch_ &&
+                    leader->sameTopology( *cells[ j ] ) )
+            {
+                members.push_back( j );
+                cells[ j ]->inBatch_ = true;
+            }
+
+        if ( members.empty() )
+            continue;
+
+        /*
+         * The extra row at the end leaves room for the end() of the last
+         * array of each cell.
+         */
+        unsigned int numCells = members.size() + 1;
+        std::shared_ptr< vector< double > > data(
+            new vector< double >( ( leader->batchSize() + 1 ) * numCells ) );
+
+        leader->bindBatch( &( *data )[ 0 ], 0, numCells );
+        leader->batchData_ = data;
+        for ( unsigned int i = 0; i < members.size(); ++i )
+        {
+            HSolve* cell = cells[ members[ i ] ];
+            cell->bindBatch( &( *data )[ 0 ], i + 1, numCells );
+            cell->batchData_ = data;
+            leader->batch_.push_back( start + members[ i ] );
+        }
+    }
+}
+
+// Static function
+bool HSolve::isSelfContained( const Eref& e )
+{
+    const HSolve* cell = reinterpret_cast< const HSolve* >( e.data() );
+    if ( cell->inBatch_ )
+        return true;    // Its process does nothing.
+
+    if ( cell->sendsMsgs() )
+        return false;
+
+    vector< unsigned int >::const_iterator i;
+    for ( i = cell->batch_.begin(); i != cell->batch_.end(); ++i )
+    {
+        const HSolve* other = reinterpret_cast< const HSolve* >(
+                                  Eref( e.element(), *i ).data() );
+        if ( other->sendsMsgs() )
+            return false;
+    }
+
+    return true;
+}
+
+bool HSolve::sendsMsgs() const
+{
+    if ( !outVm_.empty() || !outCa_.empty() )
+        return true;
+
+    static const SrcFinfo* spikeOut = dynamic_cast< const SrcFinfo* >(
+            SpikeGen::initCinfo()->findFinfo( "spikeOut" ) );
+    assert( spikeOut );
+    vector< SpikeGenStruct >::const_iterator ispike;
+    for ( ispike = spikegen_.begin(); ispike != spikegen_.end(); ++ispike )
+        if ( ispike->e_.element()->hasMsgs( spikeOut->getBindIndex() ) )
+            return true;
+
+    return false;
 }
 
 ///////////////////////////////////////////////////
@@ -534,3 +684,211 @@ void testHSolvePassiveSingleComp()
 
 #endif // if 0
 
+
+#ifdef DO_UNIT_TESTS
+#include <sstream>
+#include "../scheduling/Clock.h"
+
+/**
+ * Runs an HSolve element with several cells, one on each entry, and
+ * checks one of them against the same cell on its own HSolve. The cells
+ * of the same topology on the element are solved as a batch, so this
+ * checks that the batch gives exactly the same result as a single cell,
+ * and that the zombies of each cell talk to their own entry.
+ */
+void testHSolveBatch()
+{
+    Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+    const unsigned int nCells = 5;
+    const double scale[] = { 1.0, 1.3, 1.6, 1.3, 1.0 };
+    vector< Id > cell( nCells );
+    vector< vector< Id > > compt( nCells );
+    for ( unsigned int k = 0; k < nCells; ++k )
+    {
+        ostringstream name;
+        name << "hb" << k;
+        cell[ k ] = shell->doCreate( "Neutral", Id(), name.str(), 1 );
+        for ( unsigned int i = 0; i < 5; ++i )
+        {
+            ostringstream cname;
+            cname << "c" << i;
+            Id c = shell->doCreate( "Compartment", cell[ k ], cname.str(), 1 );
+            Field< double >::set( c, "Ra", scale[ k ] * ( 15.0 + 3.0 * i ) );
+            Field< double >::set( c, "Rm", 45.0 + 15.0 * i );
+            Field< double >::set( c, "Cm", scale[ k ] * 1.0e-3 );
+            Field< double >::set( c, "Em", -0.06 );
+            Field< double >::set( c, "initVm", -0.06 );
+            Field< double >::set( c, "inject", i == 0 ? 1.0e-3 : 0.0 );
+            compt[ k ].push_back( c );
+        }
+        if ( k == 4 )
+        {
+            // An unbranched cable, which has another topology.
+            for ( unsigned int i = 0; i < 4; ++i )
+                shell->doAddMsg( "Single", compt[ k ][ i ], "axial",
+                                 compt[ k ][ i + 1 ], "raxial" );
+            continue;
+        }
+        // 0 has children 1, 2 and 3, and 2 has child 4.
+        for ( unsigned int i = 1; i < 4; ++i )
+            shell->doAddMsg( "Single", compt[ k ][ 0 ], "axial",
+                             compt[ k ][ i ], "raxial" );
+        shell->doAddMsg( "Single", compt[ k ][ 2 ], "axial",
+                         compt[ k ][ 4 ], "raxial" );
+    }
+
+    // Entries 0, 1 and 2 of multi make a batch. Entry 3 has the cable.
+    Id multi = shell->doCreate( "HSolve", Id(), "hbMulti", 4 );
+    Id single = shell->doCreate( "HSolve", Id(), "hbSingle", 1 );
+    for ( unsigned int k = 0; k < 3; ++k )
+        Field< string >::set( ObjId( multi, k ), "target", cell[ k ].path() );
+    Field< string >::set( ObjId( multi, 3 ), "target", cell[ 4 ].path() );
+    Field< string >::set( single, "target", cell[ 3 ].path() );
+
+    vector< HSolve* > hs;
+    for ( unsigned int k = 0; k < 4; ++k )
+        hs.push_back( reinterpret_cast< HSolve* >(
+                          ObjId( multi, k ).eref().data() ) );
+    assert( hs[ 0 ]->batch_.size() == 2 );
+    assert( hs[ 0 ]->batch_[ 0 ] == 1 && hs[ 0 ]->batch_[ 1 ] == 2 );
+    assert( !hs[ 0 ]->inBatch_ && hs[ 1 ]->inBatch_ && hs[ 2 ]->inBatch_ );
+    assert( hs[ 3 ]->batch_.empty() && !hs[ 3 ]->inBatch_ );
+    // The batch keeps its matrices interleaved, in one block.
+    assert( hs[ 0 ]->HS_.stride() == 3 && hs[ 2 ]->V_.stride() == 3 );
+    assert( &hs[ 1 ]->HS_[ 0 ] == &hs[ 0 ]->HS_[ 0 ] + 1 );
+    assert( hs[ 3 ]->HS_.stride() == 1 );
+
+    shell->doSetClock( 6, 50e-6 );
+    shell->doReinit();
+    shell->doStart( 0.002 );
+
+    for ( unsigned int i = 0; i < 5; ++i )
+    {
+        double Vm = Field< double >::get( compt[ 1 ][ i ], "Vm" );
+        assert( Vm > -0.06 );
+        assert( Vm == Field< double >::get( compt[ 3 ][ i ], "Vm" ) );
+        assert( Vm != Field< double >::get( compt[ 0 ][ i ], "Vm" ) );
+        assert( Field< double >::get( compt[ 4 ][ i ], "Vm" ) > -0.06 );
+    }
+
+    shell->doDelete( multi );
+    shell->doDelete( single );
+    for ( unsigned int k = 0; k < nCells; ++k )
+        shell->doDelete( cell[ k ] );
+    // Leave the clock at zero, as later tests run without a reinit.
+    shell->doReinit();
+    cout << "." << flush;
+}
+
+/**
+ * Runs cells like those of testHSolveBatch on two HSolve elements, with
+ * the Clock using the specified number of threads. Returns the final Vm
+ * of every compartment, and puts the number of ticks that the Clock
+ * split among threads into numThreadedTicks.
+ */
+static vector< double > runHSolvesOnClockThreads( unsigned int numThreads,
+        unsigned long& numThreadedTicks )
+{
+    Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+    Id clock( 1 );
+    Field< unsigned int >::set( clock, "numThreads", numThreads );
+    const unsigned int nCells = 5;
+    const double scale[] = { 1.0, 1.3, 1.6, 0.7, 1.0 };
+    vector< Id > cell( nCells );
+    vector< Id > compt;
+    for ( unsigned int k = 0; k < nCells; ++k )
+    {
+        ostringstream name;
+        name << "ht" << k;
+        cell[ k ] = shell->doCreate( "Neutral", Id(), name.str(), 1 );
+        vector< Id > c;
+        for ( unsigned int i = 0; i < 5; ++i )
+        {
+            ostringstream cname;
+            cname << "c" << i;
+            c.push_back( shell->doCreate( "Compartment", cell[ k ],
+                                          cname.str(), 1 ) );
+            Field< double >::set( c[ i ], "Ra", scale[ k ] * ( 15.0 + 3.0 * i ) );
+            Field< double >::set( c[ i ], "Rm", 45.0 + 15.0 * i );
+            Field< double >::set( c[ i ], "Cm", scale[ k ] * 1.0e-3 );
+            Field< double >::set( c[ i ], "Em", -0.06 );
+            Field< double >::set( c[ i ], "initVm", -0.06 );
+            Field< double >::set( c[ i ], "inject", i == 0 ? 1.0e-3 : 0.0 );
+        }
+        // Cells 0 to 3 branch like those of testHSolveBatch. Cell 4 is a
+        // cable.
+        for ( unsigned int i = 0; i < 4; ++i )
+            shell->doAddMsg( "Single", c[ k == 4 ? i : ( i == 3 ? 2 : 0 ) ],
+                             "axial", c[ i + 1 ], "raxial" );
+        compt.insert( compt.end(), c.begin(), c.end() );
+    }
+
+    // Entries 0, 1 and 2 of multi make a batch, and its entry 3 and
+    // single have other cells of their own.
+    Id multi = shell->doCreate( "HSolve", Id(), "htMulti", 4 );
+    Id single = shell->doCreate( "HSolve", Id(), "htSingle", 1 );
+    for ( unsigned int k = 0; k < 3; ++k )
+        Field< string >::set( ObjId( multi, k ), "target", cell[ k ].path() );
+    Field< string >::set( ObjId( multi, 3 ), "target", cell[ 4 ].path() );
+    Field< string >::set( single, "target", cell[ 3 ].path() );
+    for ( unsigned int k = 0; k < 4; ++k )
+        assert( HSolve::isSelfContained( ObjId( multi, k ).eref() ) );
+    assert( HSolve::isSelfContained( single.eref() ) );
+
+    shell->doSetClock( 6, 50e-6 );
+    shell->doReinit();
+    shell->doStart( 0.002 );
+
+    vector< double > ret;
+    for ( unsigned int i = 0; i < compt.size(); ++i )
+        ret.push_back( Field< double >::get( compt[ i ], "Vm" ) );
+    numThreadedTicks = reinterpret_cast< const Clock* >(
+                           clock.eref().data() )->getNumThreadedTicks();
+
+    shell->doDelete( multi );
+    shell->doDelete( single );
+    for ( unsigned int k = 0; k < nCells; ++k )
+        shell->doDelete( cell[ k ] );
+    Field< unsigned int >::set( clock, "numThreads", 1 );
+    shell->doReinit();
+    return ret;
+}
+
+/**
+ * Checks that the HSolves of runHSolvesOnClockThreads give the same Vm
+ * when their entries run on several threads as when they run serially,
+ * and that an HSolve whose cell sends Vm out stays on the main thread.
+ */
+void testHSolveThreads()
+{
+    unsigned long numSerialTicks = 0;
+    unsigned long numThreadedTicks = 0;
+    vector< double > serial = runHSolvesOnClockThreads( 1, numSerialTicks );
+    vector< double > threaded =
+        runHSolvesOnClockThreads( 3, numThreadedTicks );
+    assert( numSerialTicks == 0 );
+    // Each of the 40 steps of tick 6 went to the threads.
+    assert( numThreadedTicks >= 40 );
+    assert( serial.size() == threaded.size() );
+    for ( unsigned int i = 0; i < serial.size(); ++i )
+    {
+        assert( serial[ i ] > -0.06 );
+        assert( serial[ i ] == threaded[ i ] );
+    }
+
+    Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+    Id cell = shell->doCreate( "Neutral", Id(), "htOut", 1 );
+    Id c0 = shell->doCreate( "Compartment", cell, "c0", 1 );
+    Id c1 = shell->doCreate( "Compartment", cell, "c1", 1 );
+    shell->doAddMsg( "Single", c0, "axial", c1, "raxial" );
+    Id tab = shell->doCreate( "Table", Id(), "htTab", 1 );
+    shell->doAddMsg( "Single", c1, "VmOut", tab, "input" );
+    Id hsolve = shell->doCreate( "HSolve", Id(), "htOutSolve", 1 );
+    Field< string >::set( hsolve, "target", cell.path() );
+    assert( !HSolve::isSelfContained( hsolve.eref() ) );
+    shell->doDelete( hsolve );
+    shell->doDelete( tab );
+    shell->doDelete( cell );
+    cout << "." << flush;
+}
+#endif // DO_UNIT_TESTS
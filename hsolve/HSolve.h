@@ -10,11 +10,16 @@
 #ifndef _HSOLVE_H
 #define _HSOLVE_H
 #include <set>
+#include <memory>
 /**
  * HSolve adapts the integrator HSolveActive into a MOOSE class.
  */
 class HSolve: public HSolveActive
 {
+#ifdef DO_UNIT_TESTS
+	friend void testHSolveBatch();
+#endif
+	
 public:
 	HSolve();
 	
@@ -145,6 +150,16 @@ public:
 	
 	static const Cinfo* initCinfo();
 
+	/**
+	 * ConcurrencyCheck for the Cinfo. True if process on the entry e
+	 * touches no other object, so that it can run on a different thread
+	 * from other entries and solvers. An entry whose cell is solved by
+	 * the first entry of its batch does nothing on process. Otherwise
+	 * none of the cells that the entry solves may send out Vm or Ca, or
+	 * have a SpikeGen with targets. Shared lookup tables are only read.
+	 */
+	static bool isSelfContained( const Eref& e );
+
     static const std::set<string>& handledClasses();
 						/**< Returns the set of classes "handled" by HSolve */
     static void deleteIncomingMessages( Element * orig, const string finfo);
@@ -158,6 +173,28 @@ private:
 	void setup( Eref hsolve );
 	void zombify( Eref hsolve ) const;
 	
+	/**
+	 * Makes the lookup tables use the storage of those of another entry
+	 * of the same HSolve element, if they are identical. Many cells of a
+	 * network then use a single copy of the tables.
+	 */
+	void shareTables( const Eref& hsolve );
+	
+	/**
+	 * Groups the set-up entries of the element by topology, and binds the
+	 * matrices and voltages of each group to storage shared by the group,
+	 * interleaved so that they are solved in lockstep. The first entry of
+	 * each group then advances all of its cells, and the others do nothing
+	 * on process. Called whenever an entry is set up.
+	 */
+	static void buildBatches( Element* e );
+	
+	/// Advances this cell and the ones in batch_ by one time-step.
+	void processBatch( const Eref& hsolve, ProcPtr p );
+	
+	/// True if process on this cell sends messages to other objects.
+	bool sendsMsgs() const;
+	
 	// Mapping global Id to local index. Defined in HSolveInterface.cpp.
 	void mapIds();
 	void mapIds( vector< Id > id );
@@ -167,6 +204,14 @@ private:
 	double dt_;
 	string path_;
 	Id seed_;
+	
+	/// Data indices of the other entries that this one solves along with
+	/// its own cell. Only the first entry of a batch has any.
+	vector< unsigned int > batch_;
+	/// True if another entry solves this cell as part of its batch.
+	bool inBatch_;
+	/// Interleaved HS_, HJ_, VMid_ and V_ of the cells of the batch.
+	std::shared_ptr< vector< double > > batchData_;
 };
 
 #endif // _HSOLVE_H
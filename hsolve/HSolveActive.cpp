@@ -46,6 +46,14 @@ void HSolveActive::step( ProcPtr info )
     if ( nCompt_ <= 0 )
         return;
 
+    prepareSolve( info );
+    HSolvePassive::forwardEliminate();
+    HSolvePassive::backwardSubstitute();
+    finishStep( info );
+}
+
+void HSolveActive::prepareSolve( ProcPtr info )
+{
     if ( !current_.size() )
     {
         current_.resize( channel_.size() );
@@ -54,8 +62,10 @@ void HSolveActive::step( ProcPtr info )
     advanceChannels( info->dt );
     calculateChannelCurrents();
     updateMatrix();
-    HSolvePassive::forwardEliminate();
-    HSolvePassive::backwardSubstitute();
+}
+
+void HSolveActive::finishStep( ProcPtr info )
+{
     advanceCalcium();
     advanceSynChans( info );
 
@@ -65,6 +75,27 @@ void HSolveActive::step( ProcPtr info )
     externalCurrent_.assign( externalCurrent_.size(), 0.0 );
 }
 
+double* HSolveActive::bindBatch( double* data, unsigned int column,
+                                 unsigned int numCells )
+{
+    data = HSolvePassive::bindBatch( data, column, numCells );
+
+    vector< SpikeGenStruct >::iterator ispike;
+    for ( ispike = spikegen_.begin(); ispike != spikegen_.end(); ++ispike )
+        ispike->Vm_ = &V_[ ispike->compt_ ];
+
+    return data;
+}
+
+void HSolveActive::unbindBatch()
+{
+    HSolvePassive::unbindBatch();
+
+    vector< SpikeGenStruct >::iterator ispike;
+    for ( ispike = spikegen_.begin(); ispike != spikegen_.end(); ++ispike )
+        ispike->Vm_ = &V_[ ispike->compt_ ];
+}
+
 void HSolveActive::calculateChannelCurrents()
 {
     vector< ChannelStruct >::iterator ichan;
@@ -85,16 +116,15 @@ void HSolveActive::calculateChannelCurrents()
 void HSolveActive::updateMatrix()
 {
     /*
-     * Copy contents of HJCopy_ into HJ_. Cannot do a vector assign() because
-     * iterators to HJ_ get invalidated in MS VC++
+     * Copy contents of HJCopy_ into HJ_. HJ_ may be interleaved with the
+     * HJ_ of other cells in a batch, so this goes entry by entry.
      */
-    if ( HJ_.size() != 0 )
-        memcpy( &HJ_[ 0 ], &HJCopy_[ 0 ], sizeof( double ) * HJ_.size() );
+    copy( HJCopy_.begin(), HJCopy_.end(), HJ_.begin() );
 
     double GkSum, GkEkSum; vector< CurrentStruct >::iterator icurrent = current_.begin();
     vector< currentVecIter >::iterator iboundary = currentBoundary_.begin();
-    vector< double >::iterator ihs = HS_.begin();
-    vector< double >::iterator iv = V_.begin();
+    HinesArray::iterator ihs = HS_.begin();
+    HinesArray::iterator iv = V_.begin();
 
     vector< CompartmentStruct >::iterator ic;
     for ( ic = compartment_.begin(); ic != compartment_.end(); ++ic )
@@ -152,7 +182,7 @@ void HSolveActive::updateMatrix()
 void HSolveActive::advanceCalcium()
 {
     vector< double* >::iterator icatarget = caTarget_.begin();
-    vector< double >::iterator ivmid = VMid_.begin();
+    HinesArray::iterator ivmid = VMid_.begin();
     vector< CurrentStruct >::iterator icurrent = current_.begin();
     vector< currentVecIter >::iterator iboundary = currentBoundary_.begin();
 
@@ -181,7 +211,7 @@ void HSolveActive::advanceCalcium()
     }
     else if ( caAdvance_ == 0 )
     {
-        vector< double >::iterator iv = V_.begin();
+        HinesArray::iterator iv = V_.begin();
         double v0;
 
         for ( ; iboundary != currentBoundary_.end(); ++iboundary )
@@ -216,20 +246,22 @@ void HSolveActive::advanceCalcium()
 
 void HSolveActive::advanceChannels( double dt )
 {
-    vector< double >::iterator iv;
-    vector< double >::iterator istate = state_.begin();
-    vector< int >::iterator ichannelcount = channelCount_.begin();
-    vector< ChannelStruct >::iterator ichan = channel_.begin();
-    vector< ChannelStruct >::iterator chanBoundary;
+    if ( state_.size() == 0 )
+        return;
+
+    HinesArray::iterator iv;
+    vector< unsigned int >::iterator igatecount = gateCount_.begin();
     vector< unsigned int >::iterator icacount = caCount_.begin();
     vector< double >::iterator ica = ca_.begin();
     vector< double >::iterator caBoundary;
-    vector< LookupColumn >::iterator icolumn = column_.begin();
     vector< LookupRow >::iterator icarowcompt;
-    vector< LookupRow* >::iterator icarow = caRow_.begin();
 
+    /*
+     * First pass: look up the table rows for each compartment and copy
+     * out the table entries for each gate.
+     */
     LookupRow vRow;
-    double C1, C2;
+    unsigned int ig = 0;
     for ( iv = V_.begin(); iv != V_.end(); ++iv )
     {
         vTable_.row( *iv, vRow );
@@ -241,79 +273,119 @@ void HSolveActive::advanceChannels( double dt )
             ++icarowcompt;
         }
 
-        /*
-         * Optimize by moving "if ( instant )" outside the loop, because it is
-         * rarely used. May also be able to avoid "if ( power )".
-         *
-         * Or not: excellent branch predictors these days.
-         *
-         * Will be nice to test these optimizations.
-         */
-        chanBoundary = ichan + *ichannelcount;
-        for ( ; ichan < chanBoundary; ++ichan )
+        unsigned int gateBoundary = ig + *igatecount;
+        for ( ; ig < gateBoundary; ++ig )
         {
-            if ( ichan->Xpower_ > 0.0 )
+            LookupRow* caRow = gateCaRow_[ ig ];
+            if ( caRow )
             {
-                vTable_.lookup( *icolumn, vRow, C1, C2 );
-                //~ *istate = *istate * C1 + C2;
-                //~ *istate = ( C1 + ( 2 - C2 ) * *istate ) / C2;
-                if ( ichan->instant_ & INSTANT_X )
-                    *istate = C1 / C2;
-                else
-                {
-                    double temp = 1.0 + dt / 2.0 * C2;
-                    *istate = ( *istate * ( 2.0 - temp ) + dt * C1 ) / temp;
-                }
-
-                ++icolumn, ++istate;
+                caTable_.entries( column_[ ig ], *caRow,
+                    gateC1a_[ ig ], gateC1b_[ ig ],
+                    gateC2a_[ ig ], gateC2b_[ ig ] );
+                gateFraction_[ ig ] = caRow->fraction;
             }
-
-            if ( ichan->Ypower_ > 0.0 )
+            else
             {
-                vTable_.lookup( *icolumn, vRow, C1, C2 );
-                //~ *istate = *istate * C1 + C2;
-                //~ *istate = ( C1 + ( 2 - C2 ) * *istate ) / C2;
-                if ( ichan->instant_ & INSTANT_Y )
-                    *istate = C1 / C2;
-                else
-                {
-                    double temp = 1.0 + dt / 2.0 * C2;
-                    *istate = ( *istate * ( 2.0 - temp ) + dt * C1 ) / temp;
-                }
-
-                ++icolumn, ++istate;
+                vTable_.entries( column_[ ig ], vRow,
+                    gateC1a_[ ig ], gateC1b_[ ig ],
+                    gateC2a_[ ig ], gateC2b_[ ig ] );
+                gateFraction_[ ig ] = vRow.fraction;
             }
+        }
 
-            if ( ichan->Zpower_ > 0.0 )
-            {
-                LookupRow* caRow = *icarow;
-                if ( caRow )
-                {
-                    caTable_.lookup( *icolumn, *caRow, C1, C2 );
-                }
-                else
-                {
-                    vTable_.lookup( *icolumn, vRow, C1, C2 );
-                }
+        ++igatecount, ++icacount;
+    }
 
-                //~ *istate = *istate * C1 + C2;
-                //~ *istate = ( C1 + ( 2 - C2 ) * *istate ) / C2;
-                if ( ichan->instant_ & INSTANT_Z )
-                    *istate = C1 / C2;
-                else
-                {
-                    double temp = 1.0 + dt / 2.0 * C2;
-                    *istate = ( *istate * ( 2.0 - temp ) + dt * C1 ) / temp;
-                }
+    /*
+     * Second pass: interpolate and update all gates in one loop.
+     */
+    advanceGatesFunc()( state_.size(), dt, &gateFraction_[ 0 ],
+        &gateC1a_[ 0 ], &gateC1b_[ 0 ], &gateC2a_[ 0 ], &gateC2b_[ 0 ],
+        &state_[ 0 ] );
 
-                ++icolumn, ++istate, ++icarow;
-            }
-        }
+    /*
+     * Instant gates are rare. They were given the regular update above,
+     * and are overwritten here with their steady state value.
+     */
+    vector< unsigned int >::iterator iinstant;
+    for ( iinstant = instantGate_.begin(); iinstant != instantGate_.end();
+          ++iinstant )
+    {
+        unsigned int i = *iinstant;
+        double C1 = gateC1a_[ i ] + ( gateC1b_[ i ] - gateC1a_[ i ] ) *
+            gateFraction_[ i ];
+        double C2 = gateC2a_[ i ] + ( gateC2b_[ i ] - gateC2a_[ i ] ) *
+            gateFraction_[ i ];
+        state_[ i ] = C1 / C2;
+    }
+}
 
-        ++ichannelcount, ++icacount;
+/**
+ * Interpolates the rate tables and does the Crank-Nicolson update of the
+ * gate states. This is written as a simple loop over arrays so that the
+ * compiler can vectorize it. It is compiled more than once, for different
+ * instruction sets, and the best one for the CPU is picked at run time.
+ * The arithmetic is the same for all the versions, so they give the same
+ * results.
+ */
+#ifdef __GNUC__
+#define GATES_INLINE inline __attribute__(( always_inline ))
+#else
+#define GATES_INLINE inline
+#endif
+
+static GATES_INLINE void advanceGatesKernel( unsigned int n, double dt,
+    const double* fraction,
+    const double* C1a, const double* C1b,
+    const double* C2a, const double* C2b,
+    double* state )
+{
+    for ( unsigned int i = 0; i < n; ++i )
+    {
+        double C1 = C1a[ i ] + ( C1b[ i ] - C1a[ i ] ) * fraction[ i ];
+        double C2 = C2a[ i ] + ( C2b[ i ] - C2a[ i ] ) * fraction[ i ];
+        double temp = 1.0 + dt / 2.0 * C2;
+        state[ i ] = ( state[ i ] * ( 2.0 - temp ) + dt * C1 ) / temp;
     }
 }
 
+void HSolveActive::advanceGates( unsigned int n, double dt,
+    const double* fraction,
+    const double* C1a, const double* C1b,
+    const double* C2a, const double* C2b,
+    double* state )
+{
+    advanceGatesKernel( n, dt, fraction, C1a, C1b, C2a, C2b, state );
+}
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+/*
+ * AVX2 version. AVX-512 is not used, because enabling it also enables
+ * FMA, which would change the rounding and hence the results.
+ */
+__attribute__(( target( "avx2" ) ))
+static void advanceGatesAvx2( unsigned int n, double dt,
+    const double* fraction,
+    const double* C1a, const double* C1b,
+    const double* C2a, const double* C2b,
+    double* state )
+{
+    advanceGatesKernel( n, dt, fraction, C1a, C1b, C2a, C2b, state );
+}
+#endif
+
+HSolveActive::AdvanceGatesFunc HSolveActive::advanceGatesFunc()
+{
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    static const AdvanceGatesFunc func =
+        __builtin_cpu_supports( "avx2" ) ? &advanceGatesAvx2 :
+        &HSolveActive::advanceGates;
+    return func;
+#else
+    return &HSolveActive::advanceGates;
+#endif
+}
+
 /**
  * SynChans are currently not under solver's control
  */
@@ -352,3 +424,160 @@ void HSolveActive::sendValues( ProcPtr info )
             ca_[ *i ]
         );
 }
+
+#ifdef DO_UNIT_TESTS
+#include <sstream>
+#include "../shell/Shell.h"
+
+/**
+ * Sets up an HH gate with rates of the form 
+ * ( A + B * V ) / ( C + exp( ( V + D ) / F ) ), as in setupAlpha.
+ */
+static void setupTestGate( Id gate, const double* parms )
+{
+    vector< double > p( parms, parms + 10 );
+    p.push_back( 150 );     // xdivs
+    p.push_back( -0.1 );    // xmin
+    p.push_back( 0.05 );    // xmax
+    SetGet1< vector< double > >::set( gate, "setupAlpha", p );
+    Field< bool >::set( gate, "useInterpolation", true );
+}
+
+/**
+ * Runs two HH squid compartments under an HSolve, one step at a time,
+ * and checks the gate states held by the solver against the per-gate
+ * Crank-Nicolson update done here from the voltage of the last step and
+ * the A and B values looked up from HHGates with the same parameters.
+ * These are on channels outside the solver, as the solved ones are
+ * zombified. This covers
+ * the batched gate update in advanceChannels, including the ordering of
+ * gates across channels and compartments and the instant gates.
+ */
+void testHSolveGates()
+{
+    Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+    const double EREST = -0.07;
+    const double dt = 50e-6;
+    const unsigned int nSteps = 400;
+    const double naM[] = { 0.1e6 * ( EREST + 0.025 ), -0.1e6, -1.0,
+        -( EREST + 0.025 ), -0.01, 4e3, 0.0, 0.0, -EREST, 0.018 };
+    const double naH[] = { 70.0, 0.0, 0.0, -EREST, 0.02,
+        1e3, 0.0, 1.0, -( EREST + 0.03 ), -0.01 };
+    const double kN[] = { 1e4 * ( 0.01 + EREST ), -1e4, -1.0,
+        -( EREST + 0.01 ), -0.01, 0.125e3, 0.0, 0.0, -EREST, 0.08 };
+
+    Id nid = shell->doCreate( "Neutral", Id(), "hgates", 1 );
+    vector< Id > compt;
+    vector< Id > chan;      // Channels in the order Na0, K0, Na1, K1
+
+    // Reference gates, in the order m, h, n.
+    Id refId = shell->doCreate( "Neutral", Id(), "hgatesRef", 1 );
+    Id naRef = shell->doCreate( "HHChannel", refId, "Na", 1 );
+    Field< double >::set( naRef, "Xpower", 3.0 );
+    Field< double >::set( naRef, "Ypower", 1.0 );
+    Id kRef = shell->doCreate( "HHChannel", refId, "K", 1 );
+    Field< double >::set( kRef, "Xpower", 4.0 );
+    vector< Id > gate;
+    gate.push_back( Id( naRef.path() + "/gateX" ) );
+    gate.push_back( Id( naRef.path() + "/gateY" ) );
+    gate.push_back( Id( kRef.path() + "/gateX" ) );
+    setupTestGate( gate[ 0 ], naM );
+    setupTestGate( gate[ 1 ], naH );
+    setupTestGate( gate[ 2 ], kN );
+
+    for ( unsigned int i = 0; i < 2; ++i )
+    {
+        ostringstream name;
+        name << "c" << i;
+        Id c = shell->doCreate( "Compartment", nid, name.str(), 1 );
+        Field< double >::set( c, "Cm", 0.007854e-6 );
+        Field< double >::set( c, "Ra", 7639.44e3 );
+        Field< double >::set( c, "Rm", 424.4e3 );
+        Field< double >::set( c, "Em", EREST + 0.010613 );
+        Field< double >::set( c, "initVm", EREST );
+        Field< double >::set( c, "inject", ( i + 1 ) * 0.1e-6 );
+        compt.push_back( c );
+
+        Id na = shell->doCreate( "HHChannel", c, "Na", 1 );
+        shell->doAddMsg( "Single", c, "channel", na, "channel" );
+        Field< double >::set( na, "Gbar", 0.94248e-3 );
+        Field< double >::set( na, "Ek", EREST + 0.115 );
+        Field< double >::set( na, "Xpower", 3.0 );
+        Field< double >::set( na, "Ypower", 1.0 );
+        // The Na m gate of the second compartment is instantaneous.
+        // 1 is the 'instant' flag for the X gate.
+        Field< int >::set( na, "instant", i == 1 ? 1 : 0 );
+        Id m( na.path() + "/gateX" );
+        Id h( na.path() + "/gateY" );
+        setupTestGate( m, naM );
+        setupTestGate( h, naH );
+
+        Id k = shell->doCreate( "HHChannel", c, "K", 1 );
+        shell->doAddMsg( "Single", c, "channel", k, "channel" );
+        Field< double >::set( k, "Gbar", 0.282743e-3 );
+        Field< double >::set( k, "Ek", EREST - 0.012 );
+        Field< double >::set( k, "Xpower", 4.0 );
+        Id n( k.path() + "/gateX" );
+        setupTestGate( n, kN );
+
+        chan.push_back( na );
+        chan.push_back( k );
+    }
+    shell->doAddMsg( "Single", compt[ 0 ], "axial", compt[ 1 ], "raxial" );
+
+    Id hsolve = shell->doCreate( "HSolve", nid, "hsolve", 1 );
+    Field< double >::set( hsolve, "dt", dt );
+    Field< string >::set( hsolve, "target", nid.path() );
+    shell->doSetClock( 6, dt );
+    shell->doReinit();
+
+    // Gate states in the order m0, h0, n0, m1, h1, n1.
+    vector< double > x( 3 * compt.size() );
+    vector< double > V( compt.size() );
+    vector< double > peakV( compt.size(), EREST );
+    for ( unsigned int step = 0; step <= nSteps; ++step )
+    {
+        for ( unsigned int i = 0; i < compt.size(); ++i )
+        {
+            const string xy[] = { "X", "Y" };
+            for ( unsigned int j = 0; j < 3; ++j )
+            {
+                unsigned int ig = 3 * i + j;
+                double solved = Field< double >::get(
+                    chan[ 2 * i + j / 2 ], xy[ j % 2 ] );
+                if ( step > 0 )
+                {
+                    double A = LookupField< double, double >::get(
+                        gate[ j ], "A", V[ i ] );
+                    double B = LookupField< double, double >::get(
+                        gate[ j ], "B", V[ i ] );
+                    if ( i == 1 && j == 0 )
+                        x[ ig ] = A / B;
+                    else
+                    {
+                        double temp = 1.0 + dt / 2.0 * B;
+                        x[ ig ] = ( x[ ig ] * ( 2.0 - temp ) + dt * A ) /
+                            temp;
+                    }
+                    assert( fabs( solved - x[ ig ] ) < 1.0e-9 );
+                }
+                x[ ig ] = solved;
+            }
+            V[ i ] = Field< double >::get( compt[ i ], "Vm" );
+            if ( V[ i ] > peakV[ i ] )
+                peakV[ i ] = V[ i ];
+        }
+        if ( step < nSteps )
+            shell->doStart( dt );
+    }
+    // Both compartments have fired, so the gates went through their
+    // full range.
+    assert( peakV[ 0 ] > 0.0 );
+    assert( peakV[ 1 ] > 0.0 );
+
+    shell->doDelete( nid );
+    shell->doDelete( refId );
+    shell->doReinit();
+    cout << "." << flush;
+}
+#endif
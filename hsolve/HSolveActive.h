@@ -37,6 +37,28 @@ public:
     void step( ProcPtr info );			///< Equivalent to process
     void reinit( ProcPtr info );
 
+    /**
+     * Interpolates the rate tables and updates n gate states. This is
+     * the portable version.
+     */
+    static void advanceGates( unsigned int n, double dt,
+        const double* fraction,
+        const double* C1a, const double* C1b,
+        const double* C2a, const double* C2b,
+        double* state );
+
+    typedef void ( *AdvanceGatesFunc )( unsigned int n, double dt,
+        const double* fraction,
+        const double* C1a, const double* C1b,
+        const double* C2a, const double* C2b,
+        double* state );
+
+    /**
+     * Returns the version of advanceGates to use on this CPU, such as
+     * one using AVX2 if available.
+     */
+    static AdvanceGatesFunc advanceGatesFunc();
+
 protected:
     /**
      * Solver parameters: exposed as fields in MOOSE
@@ -106,6 +128,23 @@ protected:
 		*   caRowCompt vector. This value is then used by the channel. Also
 		*   happens in HSolveActive::advanceChannels */
 
+    /**
+     * Gate state update in advanceChannels is done in two passes. The
+     * first pass looks up the table entries for each gate. The second
+     * interpolates and does the Crank-Nicolson update for all gates in a
+     * single loop over the following arrays, so that it can be vectorized.
+     * All of these are in the same order as state_.
+     */
+    vector< LookupRow* >      gateCaRow_;		///< Ca row for Ca-dependent
+		///< gates, 0 for voltage-dependent gates.
+    vector< unsigned int >    gateCount_;		///< Number of gates in each
+		///< compartment.
+    vector< unsigned int >    instantGate_;		///< Indices of instant gates.
+    vector< double >          gateFraction_;	///< Interpolation fraction.
+    vector< double >          gateC1a_;			///< C1 at the lower row.
+    vector< double >          gateC1b_;			///< C1 at the upper row.
+    vector< double >          gateC2a_;			///< C2 at the lower row.
+    vector< double >          gateC2b_;			///< C2 at the upper row.
     vector< int >             channelCount_;	///< Number of channels in each
     ///< compartment
     vector< currentVecIter >  currentBoundary_;	///< Used to designate compt
@@ -132,6 +171,19 @@ protected:
 		*   channels so that you can send out Calcium concentrations in only
 		*   those compartments. */
 
+    /**
+     * The parts of step before and after the matrix solve. A cell that
+     * is solved in a batch goes through these, and the batch is solved
+     * in lockstep in between.
+     */
+    void prepareSolve( ProcPtr info );
+    void finishStep( ProcPtr info );
+
+    /// As in HSolvePassive, but also points the SpikeGens at the new V_.
+    double* bindBatch( double* data, unsigned int column,
+                       unsigned int numCells );
+    void unbindBatch();
+
 private:
     /**
      * Setting up of data structures: Defined in HSolveActiveSetup.cpp
@@ -142,6 +194,7 @@ private:
     void readSynapses();
     void readExternalChannels();
     void createLookupTables();
+    void buildGateArrays();
     void manageOutgoingMessages();
 
     void cleanup();
@@ -163,6 +216,7 @@ private:
     void backwardSubstitute();
     void advanceCalcium();
     void advanceChannels( double dt );
+
     void advanceSynChans( ProcPtr info );
     void sendSpikes( ProcPtr info );
     void sendValues( ProcPtr info );
@@ -77,7 +77,7 @@ void HSolveActive::reinitCalcium()
 
 void HSolveActive::reinitChannels()
 {
-    vector< double >::iterator iv;
+    HinesArray::iterator iv;
     vector< double >::iterator istate = state_.begin();
     vector< int >::iterator ichannelcount = channelCount_.begin();
     vector< ChannelStruct >::iterator ichan = channel_.begin();
@@ -491,6 +491,62 @@ void HSolveActive::createLookupTables()
                 caRow_.push_back( &caRowCompt_[ index ] );
         }
     }
+
+    buildGateArrays();
+}
+
+/**
+ * Flattens the per-gate information needed by advanceChannels into arrays
+ * in the order of state_, so that the gate update does not have to
+ * branch on the gate powers.
+ */
+void HSolveActive::buildGateArrays()
+{
+    gateCaRow_.clear();
+    gateCount_.clear();
+    instantGate_.clear();
+
+    vector< ChannelStruct >::iterator ichan = channel_.begin();
+    vector< LookupRow* >::iterator icarow = caRow_.begin();
+    vector< int >::iterator ichannelcount;
+    for ( ichannelcount = channelCount_.begin();
+          ichannelcount != channelCount_.end(); ++ichannelcount )
+    {
+        unsigned int nGates = gateCaRow_.size();
+        for ( int i = 0; i < *ichannelcount; ++i, ++ichan )
+        {
+            if ( ichan->Xpower_ > 0.0 )
+            {
+                if ( ichan->instant_ & INSTANT_X )
+                    instantGate_.push_back( gateCaRow_.size() );
+                gateCaRow_.push_back( 0 );
+            }
+
+            if ( ichan->Ypower_ > 0.0 )
+            {
+                if ( ichan->instant_ & INSTANT_Y )
+                    instantGate_.push_back( gateCaRow_.size() );
+                gateCaRow_.push_back( 0 );
+            }
+
+            if ( ichan->Zpower_ > 0.0 )
+            {
+                if ( ichan->instant_ & INSTANT_Z )
+                    instantGate_.push_back( gateCaRow_.size() );
+                gateCaRow_.push_back( *icarow );
+                ++icarow;
+            }
+        }
+        gateCount_.push_back( gateCaRow_.size() - nGates );
+    }
+    assert( gateCaRow_.size() == state_.size() );
+    assert( gateCaRow_.size() == column_.size() );
+
+    gateFraction_.resize( state_.size() );
+    gateC1a_.resize( state_.size() );
+    gateC1b_.resize( state_.size() );
+    gateC2a_.resize( state_.size() );
+    gateC2b_.resize( state_.size() );
 }
 
 /**
@@ -534,7 +590,7 @@ void HSolveActive::readSynapses()
         for ( spike = spikeId.begin(); spike != spikeId.end(); ++spike )
         {
             spikegen_.push_back(
-                SpikeGenStruct( &V_[ ic ], spike->eref() )
+                SpikeGenStruct( ic, &V_[ ic ], spike->eref() )
             );
 
             ObjId mid = spike->element()->findCaller( df->getFid() );
@@ -211,14 +211,13 @@ void HSolvePassive::storeTree()
 void HSolvePassive::updateMatrix()
 {
     /*
-     * Copy contents of HJCopy_ into HJ_. Cannot do a vector assign() because
-     * iterators to HJ_ get invalidated in MS VC++
+     * Copy contents of HJCopy_ into HJ_. HJ_ may be interleaved with the
+     * HJ_ of other cells in a batch, so this goes entry by entry.
      */
-    if ( HJ_.size() != 0 )
-        memcpy( &HJ_[ 0 ], &HJCopy_[ 0 ], sizeof( double ) * HJ_.size() );
+    copy( HJCopy_.begin(), HJCopy_.end(), HJ_.begin() );
 
-    vector< double >::iterator ihs = HS_.begin();
-    vector< double >::iterator iv  = V_.begin();
+    HinesArray::iterator ihs = HS_.begin();
+    HinesArray::iterator iv  = V_.begin();
 
     vector< CompartmentStruct >::iterator ic;
     for ( ic = compartment_.begin(); ic != compartment_.end(); ++ic )
@@ -246,7 +245,7 @@ void HSolvePassive::updateMatrix()
 void HSolvePassive::forwardEliminate()
 {
     unsigned int ic = 0;
-    vector< double >::iterator ihs = HS_.begin();
+    HinesArray::iterator ihs = HS_.begin();
     vector< vdIterator >::iterator iop = operand_.begin();
     vector< JunctionStruct >::iterator junction;
 
@@ -325,9 +324,9 @@ void HSolvePassive::forwardEliminate()
 void HSolvePassive::backwardSubstitute()
 {
     int ic = nCompt_ - 1;
-    vector< double >::reverse_iterator ivmid = VMid_.rbegin();
-    vector< double >::reverse_iterator iv = V_.rbegin();
-    vector< double >::reverse_iterator ihs = HS_.rbegin();
+    HinesArray::reverse_iterator ivmid = VMid_.rbegin();
+    HinesArray::reverse_iterator iv = V_.rbegin();
+    HinesArray::reverse_iterator ihs = HS_.rbegin();
     vector< vdIterator >::reverse_iterator iop = operand_.rbegin();
     vector< vdIterator >::reverse_iterator ibop = backOperand_.rbegin();
     vector< JunctionStruct >::reverse_iterator junction;
@@ -400,6 +399,236 @@ void HSolvePassive::backwardSubstitute()
     stage_ = 2;    // Backward substitution done.
 }
 
+//////////////////////////////////////////////////////////////////////
+// Numerical integration of a batch of cells in lockstep.
+//
+// The batch versions below do the same operations as forwardEliminate and
+// backwardSubstitute, in the same order for each cell, so that the result
+// is exactly the same as solving the cells one at a time. Entry i of the
+// cell in column c is at i * nc + c, so the innermost loops run over the
+// cells, on adjacent doubles.
+//////////////////////////////////////////////////////////////////////
+
+/**
+ * Eliminates the off-diagonal entry below compartment ic, where ic is not
+ * at a junction. hs points at the entries of compartment ic.
+ */
+static inline void eliminateSeries( double* hs, unsigned int nc )
+{
+    for ( unsigned int c = 0; c < nc; ++c )
+    {
+        hs[ 4 * nc + c ] -= hs[ nc + c ] / hs[ c ] * hs[ nc + c ];
+        hs[ 7 * nc + c ] -= hs[ nc + c ] / hs[ c ] * hs[ 3 * nc + c ];
+    }
+}
+
+/**
+ * Finds VMid and V of compartment ic from those of compartment ic + 1,
+ * where ic is not at a junction.
+ */
+static inline void substituteSeries(
+    const double* hs, double* vmid, double* v, unsigned int nc )
+{
+    for ( unsigned int c = 0; c < nc; ++c )
+    {
+        vmid[ c ] = ( hs[ 3 * nc + c ] - hs[ nc + c ] * vmid[ nc + c ] ) /
+                    hs[ c ];
+        v[ c ] = 2 * vmid[ c ] - v[ c ];
+    }
+}
+
+void HSolvePassive::forwardEliminateBatch()
+{
+    const unsigned int nc = HS_.stride();
+    double* const hs0 = &HS_[ 0 ];
+    unsigned int ic = 0;
+    vector< vdIterator >::iterator iop = operand_.begin();
+    vector< JunctionStruct >::iterator junction;
+
+    unsigned int index;
+    unsigned int rank;
+    for ( junction = junction_.begin();
+            junction != junction_.end();
+            junction++ )
+    {
+        index = junction->index;
+        rank = junction->rank;
+
+        for ( ; ic < index; ++ic )
+            eliminateSeries( hs0 + 4 * nc * ic, nc );
+
+        double* hs = hs0 + 4 * nc * ic;
+        if ( rank == 1 )
+        {
+            double* j = &**iop;
+            double* s = &**( iop + 1 );
+
+            for ( unsigned int c = 0; c < nc; ++c )
+            {
+                double division = j[ nc + c ] / hs[ c ];
+                s[ c ]          -= division * j[ c ];
+                s[ 3 * nc + c ] -= division * hs[ 3 * nc + c ];
+            }
+
+            iop += 3;
+        }
+        else if ( rank == 2 )
+        {
+            double* j = &**iop;
+            double* s1 = &**( iop + 1 );
+            double* s2 = &**( iop + 3 );
+
+            for ( unsigned int c = 0; c < nc; ++c )
+            {
+                double division  = j[ nc + c ] / hs[ c ];
+                s1[ c ]          -= division * j[ c ];
+                j[ 4 * nc + c ]  -= division * j[ 2 * nc + c ];
+                s1[ 3 * nc + c ] -= division * hs[ 3 * nc + c ];
+
+                division         = j[ 3 * nc + c ] / hs[ c ];
+                j[ 5 * nc + c ]  -= division * j[ c ];
+                s2[ c ]          -= division * j[ 2 * nc + c ];
+                s2[ 3 * nc + c ] -= division * hs[ 3 * nc + c ];
+            }
+
+            iop += 5;
+        }
+        else
+        {
+            vector< vdIterator >::iterator
+            end = iop + 3 * rank * ( rank + 1 );
+            for ( ; iop < end; iop += 3 )
+            {
+                double* target = &**iop;
+                const double* left = &**( iop + 1 );
+                const double* above = &**( iop + 2 );
+
+                for ( unsigned int c = 0; c < nc; ++c )
+                    target[ c ] -= above[ c ] / hs[ c ] * left[ c ];
+            }
+        }
+
+        ++ic;
+    }
+
+    for ( ; ic < nCompt_ - 1; ++ic )
+        eliminateSeries( hs0 + 4 * nc * ic, nc );
+
+    stage_ = 1;    // Forward elimination done.
+}
+
+void HSolvePassive::backwardSubstituteBatch()
+{
+    const unsigned int nc = HS_.stride();
+    const double* const hs0 = &HS_[ 0 ];
+    double* const vmid0 = &VMid_[ 0 ];
+    double* const v0 = &V_[ 0 ];
+    int ic = nCompt_ - 1;
+    vector< vdIterator >::reverse_iterator iop = operand_.rbegin();
+    vector< vdIterator >::reverse_iterator ibop = backOperand_.rbegin();
+    vector< JunctionStruct >::reverse_iterator junction;
+
+    const double* hs = hs0 + 4 * nc * ic;
+    double* vmid = vmid0 + nc * ic;
+    double* v = v0 + nc * ic;
+    for ( unsigned int c = 0; c < nc; ++c )
+    {
+        vmid[ c ] = hs[ 3 * nc + c ] / hs[ c ];
+        v[ c ] = 2 * vmid[ c ] - v[ c ];
+    }
+    --ic;
+
+    int index;
+    int rank;
+    for ( junction = junction_.rbegin();
+            junction != junction_.rend();
+            junction++ )
+    {
+        index = junction->index;
+        rank = junction->rank;
+
+        for ( ; ic > index; --ic )
+            substituteSeries( hs0 + 4 * nc * ic, vmid0 + nc * ic,
+                              v0 + nc * ic, nc );
+
+        hs = hs0 + 4 * nc * ic;
+        vmid = vmid0 + nc * ic;
+        v = v0 + nc * ic;
+        if ( rank == 1 )
+        {
+            const double* vfar = &**iop;
+            const double* j = &**( iop + 2 );
+
+            for ( unsigned int c = 0; c < nc; ++c )
+                vmid[ c ] = ( hs[ 3 * nc + c ] - vfar[ c ] * j[ c ] ) /
+                            hs[ c ];
+
+            iop += 3;
+        }
+        else if ( rank == 2 )
+        {
+            const double* vfar0 = &**( iop );
+            const double* vfar1 = &**( iop + 2 );
+            const double* j = &**( iop + 4 );
+
+            for ( unsigned int c = 0; c < nc; ++c )
+                vmid[ c ] = ( hs[ 3 * nc + c ]
+                              - vfar0[ c ] * j[ 2 * nc + c ]
+                              - vfar1[ c ] * j[ c ]
+                            ) / hs[ c ];
+
+            iop += 5;
+        }
+        else
+        {
+            for ( unsigned int c = 0; c < nc; ++c )
+                vmid[ c ] = hs[ 3 * nc + c ];
+            for ( int i = 0; i < rank; ++i )
+            {
+                const double* vfar = &**ibop;
+                const double* j = &**( ibop + 1 );
+                for ( unsigned int c = 0; c < nc; ++c )
+                    vmid[ c ] -= vfar[ c ] * j[ c ];
+                ibop += 2;
+            }
+            for ( unsigned int c = 0; c < nc; ++c )
+                vmid[ c ] /= hs[ c ];
+
+            iop += 3 * rank * ( rank + 1 );
+        }
+
+        for ( unsigned int c = 0; c < nc; ++c )
+            v[ c ] = 2 * vmid[ c ] - v[ c ];
+        --ic;
+    }
+
+    for ( ; ic >= 0; --ic )
+        substituteSeries( hs0 + 4 * nc * ic, vmid0 + nc * ic,
+                          v0 + nc * ic, nc );
+
+    stage_ = 2;    // Backward substitution done.
+}
+
+unsigned int HSolvePassive::batchSize() const
+{
+    return HinesMatrix::batchSize() + V_.size();
+}
+
+double* HSolvePassive::bindBatch( double* data, unsigned int column,
+                                  unsigned int numCells )
+{
+    data = HinesMatrix::bindBatch( data, column, numCells );
+    V_.bind( data + column, numCells );
+
+    return data + V_.size() * numCells;
+}
+
+void HSolvePassive::unbindBatch()
+{
+    HinesMatrix::unbindBatch();
+    V_.unbind();
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Public interface.
 ///////////////////////////////////////////////////////////////////////////
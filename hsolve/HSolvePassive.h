@@ -33,9 +33,29 @@ protected:
 	void forwardEliminate();
 	void backwardSubstitute();
 	
+	/**
+	 * Same as forwardEliminate and backwardSubstitute, but for all the
+	 * cells of a batch at once. This cell must be in column 0 of the
+	 * batch storage, and the others must have the same topology.
+	 */
+	void forwardEliminateBatch();
+	void backwardSubstituteBatch();
+	
+	/// Number of doubles per cell that bindBatch uses.
+	unsigned int batchSize() const;
+	/**
+	 * Binds HS_, HJ_, VMid_ and V_ to storage shared by a batch of
+	 * numCells cells with this topology, as the cell in the given column.
+	 * Returns the part of the storage that comes after the one used here.
+	 */
+	double* bindBatch( double* data, unsigned int column,
+		unsigned int numCells );
+	/// Moves the arrays back into storage of their own.
+	void unbindBatch();
+	
 	vector< CompartmentStruct >       compartment_;
 	vector< Id >                      compartmentId_;
-	vector< double >                  V_;				/**< Compartment Vm.
+	HinesArray                        V_;				/**< Compartment Vm.
 		* V_ is addressed using a compartment index. V_ stores the Vm value
 		* of each compartment. */
 	vector< TreeNodeStruct >          tree_;			/**< Tree info.
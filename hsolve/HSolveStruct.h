@@ -113,12 +113,15 @@ private:
  */
 struct SpikeGenStruct
 {
-	SpikeGenStruct( double* Vm, Eref e )
+	SpikeGenStruct( unsigned int compt, double* Vm, Eref e )
 		:
+		compt_( compt ),
 		Vm_( Vm ),
 		e_( e )
 	{ ; }
 	
+	// Index of parent compartment
+	unsigned int compt_;
 	double* Vm_;
 	Eref e_;
 	
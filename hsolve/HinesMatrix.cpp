@@ -13,6 +13,97 @@
 #include <iomanip>
 #include <stdexcept>
 
+HinesArray::HinesArray()
+    :
+    data_( 0 ),
+    size_( 0 ),
+    stride_( 1 )
+{
+    ;
+}
+
+HinesArray::HinesArray( const HinesArray& other )
+    :
+    data_( 0 ),
+    size_( 0 ),
+    stride_( 1 )
+{
+    *this = other;
+}
+
+/**
+ * A copy always gets storage of its own, even if the original is bound to
+ * a batch.
+ */
+HinesArray& HinesArray::operator=( const HinesArray& other )
+{
+    if ( this == &other )
+        return *this;
+
+    own_.resize( other.size_ );
+    for ( unsigned int i = 0; i < other.size_; ++i )
+        own_[ i ] = other[ i ];
+    data_ = own_.empty() ? 0 : &own_[ 0 ];
+    size_ = other.size_;
+    stride_ = 1;
+
+    return *this;
+}
+
+void HinesArray::clear()
+{
+    own_.clear();
+    data_ = 0;
+    size_ = 0;
+    stride_ = 1;
+}
+
+void HinesArray::resize( unsigned int n, double value )
+{
+    unbind();
+    own_.resize( n, value );
+    data_ = own_.empty() ? 0 : &own_[ 0 ];
+    size_ = n;
+}
+
+void HinesArray::reserve( unsigned int n )
+{
+    unbind();
+    own_.reserve( n );
+    data_ = own_.empty() ? 0 : &own_[ 0 ];
+}
+
+void HinesArray::push_back( double value )
+{
+    unbind();
+    own_.push_back( value );
+    data_ = &own_[ 0 ];
+    ++size_;
+}
+
+void HinesArray::bind( double* data, unsigned int stride )
+{
+    assert( stride > 0 );
+    for ( unsigned int i = 0; i < size_; ++i )
+        data[ i * stride ] = ( *this )[ i ];
+    vector< double >().swap( own_ );
+    data_ = data;
+    stride_ = stride;
+}
+
+void HinesArray::unbind()
+{
+    if ( data_ == 0 || ( !own_.empty() && data_ == &own_[ 0 ] ) )
+        return;
+
+    vector< double > values( size_ );
+    for ( unsigned int i = 0; i < size_; ++i )
+        values[ i ] = ( *this )[ i ];
+    own_.swap( values );
+    data_ = own_.empty() ? 0 : &own_[ 0 ];
+    stride_ = 1;
+}
+
 HinesMatrix::HinesMatrix()
     :
     nCompt_( 0 ),
@@ -47,6 +138,10 @@ void HinesMatrix::setup( const vector< TreeNodeStruct >& tree, double dt )
 
     makeJunctions();
     makeMatrix();
+
+    // Allocate space in VMid. Needed, since we will store pointers to its
+    // elements in makeOperands.
+    VMid_.resize( nCompt_ );
     makeOperands();
 }
 
@@ -200,7 +295,7 @@ void HinesMatrix::makeMatrix()
 
         for ( i = group->begin(); i != group->end() - 1; ++i )
         {
-            int base = HJ_.size();
+            unsigned int base = HJ_.size();
 
             for ( j = i + 1; j != group->end(); ++j )
             {
@@ -210,8 +305,7 @@ void HinesMatrix::makeMatrix()
                 HJ_.push_back( -gij );
             }
 
-            //~ operandBase_[ *i ] = &HJ_[ base ];
-            operandBase_[ *i ] = HJ_.begin() + base;
+            operandBase_[ *i ] = base;
         }
     }
 
@@ -231,16 +325,12 @@ void HinesMatrix::makeOperands()
     vdIterator base;
     vector< JunctionStruct >::iterator junction;
 
-    // Allocate space in VMid. Needed, since we will store pointers to its
-    // elements below.
-    VMid_.resize( nCompt_ );
-
     // Operands for forward-elimination
     for ( junction = junction_.begin(); junction != junction_.end(); ++junction )
     {
         index = junction->index;
         rank = junction->rank;
-        base = operandBase_[ index ];
+        base = HJ_.begin() + operandBase_[ index ];
 
         // This is the list of compartments connected at a junction.
         const vector< unsigned int >& group =
@@ -347,7 +437,7 @@ void HinesMatrix::makeOperands()
 
         index = junction->index;
         rank = junction->rank;
-        base = operandBase_[ index ];
+        base = HJ_.begin() + operandBase_[ index ];
 
         // This is the list of compartments connected at a junction.
         const vector< unsigned int >& group =
@@ -364,6 +454,50 @@ void HinesMatrix::makeOperands()
     }
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Solving many matrices in lockstep
+///////////////////////////////////////////////////////////////////////////
+bool HinesMatrix::sameTopology( const HinesMatrix& other ) const
+{
+    return nCompt_ == other.nCompt_ && coupled_ == other.coupled_;
+}
+
+unsigned int HinesMatrix::batchSize() const
+{
+    return HS_.size() + HJ_.size() + VMid_.size();
+}
+
+double* HinesMatrix::bindBatch( double* data, unsigned int column,
+                                unsigned int numCells )
+{
+    assert( column < numCells );
+
+    HS_.bind( data + column, numCells );
+    data += HS_.size() * numCells;
+    HJ_.bind( data + column, numCells );
+    data += HJ_.size() * numCells;
+    VMid_.bind( data + column, numCells );
+    data += VMid_.size() * numCells;
+
+    // The operands point into the arrays, so they must follow them.
+    operand_.clear();
+    backOperand_.clear();
+    makeOperands();
+
+    return data;
+}
+
+void HinesMatrix::unbindBatch()
+{
+    HS_.unbind();
+    HJ_.unbind();
+    VMid_.unbind();
+
+    operand_.clear();
+    backOperand_.clear();
+    makeOperands();
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Public interface to matrix
 ///////////////////////////////////////////////////////////////////////////
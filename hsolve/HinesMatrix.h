@@ -10,6 +10,9 @@
 #ifndef _HINES_MATRIX_H
 #define _HINES_MATRIX_H
 
+#include <cstddef>
+#include <iterator>
+
 #ifdef DO_UNIT_TESTS
 # define ASSERT( isOK, message ) \
 	if ( !(isOK) ) { \
@@ -42,6 +45,189 @@ struct JunctionStruct
     ///< with a larger Hines index, +1 for the parent.
 };
 
+/**
+ * Array of doubles, used for the Hines matrix and the compartment
+ * voltages. It normally keeps its values in storage of its own. A cell
+ * that is solved in lockstep with other cells of the same topology has
+ * its arrays bound instead to storage shared by the batch, interleaved
+ * so that entry i of the cell in column c is at i * stride + c. The
+ * elimination can then run over all the cells in the inner loop, and
+ * nothing needs to be copied around at each step.
+ */
+class HinesArray
+{
+public:
+    /// Random access iterator, that steps over the other cells' entries.
+    class iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef double value_type;
+        typedef ptrdiff_t difference_type;
+        typedef double* pointer;
+        typedef double& reference;
+
+        iterator()
+            : p_( 0 ), stride_( 1 )
+        { ; }
+        iterator( double* p, unsigned int stride )
+            : p_( p ), stride_( stride )
+        { ; }
+
+        double& operator*() const
+        {
+            return *p_;
+        }
+        double& operator[]( difference_type n ) const
+        {
+            return p_[ n * stride_ ];
+        }
+        iterator& operator++()
+        {
+            p_ += stride_;
+            return *this;
+        }
+        iterator operator++( int )
+        {
+            iterator ret( *this );
+            p_ += stride_;
+            return ret;
+        }
+        iterator& operator--()
+        {
+            p_ -= stride_;
+            return *this;
+        }
+        iterator operator--( int )
+        {
+            iterator ret( *this );
+            p_ -= stride_;
+            return ret;
+        }
+        iterator& operator+=( difference_type n )
+        {
+            p_ += n * stride_;
+            return *this;
+        }
+        iterator& operator-=( difference_type n )
+        {
+            p_ -= n * stride_;
+            return *this;
+        }
+        iterator operator+( difference_type n ) const
+        {
+            return iterator( p_ + n * stride_, stride_ );
+        }
+        iterator operator-( difference_type n ) const
+        {
+            return iterator( p_ - n * stride_, stride_ );
+        }
+        difference_type operator-( const iterator& other ) const
+        {
+            return ( p_ - other.p_ ) / stride_;
+        }
+        bool operator==( const iterator& other ) const
+        {
+            return p_ == other.p_;
+        }
+        bool operator!=( const iterator& other ) const
+        {
+            return p_ != other.p_;
+        }
+        bool operator<( const iterator& other ) const
+        {
+            return p_ < other.p_;
+        }
+        bool operator>( const iterator& other ) const
+        {
+            return p_ > other.p_;
+        }
+        bool operator<=( const iterator& other ) const
+        {
+            return p_ <= other.p_;
+        }
+        bool operator>=( const iterator& other ) const
+        {
+            return p_ >= other.p_;
+        }
+
+    private:
+        double* p_;
+        difference_type stride_;
+    };
+    typedef std::reverse_iterator< iterator > reverse_iterator;
+
+    HinesArray();
+    HinesArray( const HinesArray& other );
+    HinesArray& operator=( const HinesArray& other );
+
+    double& operator[]( unsigned int i )
+    {
+        return data_[ i * stride_ ];
+    }
+    const double& operator[]( unsigned int i ) const
+    {
+        return data_[ i * stride_ ];
+    }
+
+    iterator begin()
+    {
+        return iterator( data_, stride_ );
+    }
+    iterator end()
+    {
+        return iterator( data_ + size_ * stride_, stride_ );
+    }
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator( end() );
+    }
+    reverse_iterator rend()
+    {
+        return reverse_iterator( begin() );
+    }
+
+    unsigned int size() const
+    {
+        return size_;
+    }
+    /// Number of cells whose entries are interleaved with these.
+    unsigned int stride() const
+    {
+        return stride_;
+    }
+
+    /*
+     * These change the size, so they move the values back into storage
+     * of the array's own first, if it is bound.
+     */
+    void clear();
+    void resize( unsigned int n, double value = 0.0 );
+    void reserve( unsigned int n );
+    void push_back( double value );
+
+    /**
+     * Moves the values to data, at intervals of stride, and keeps them
+     * there from now on. The caller owns data, which must stay valid
+     * until unbind.
+     */
+    void bind( double* data, unsigned int stride );
+    /// Moves the values back into storage of the array's own.
+    void unbind();
+
+private:
+    vector< double > own_;
+    double* data_;
+    unsigned int size_;
+    unsigned int stride_;
+};
+
+inline HinesArray::iterator operator+(
+    HinesArray::iterator::difference_type n, const HinesArray::iterator& i )
+{
+    return i + n;
+}
+
 struct TreeNodeStruct
 {
     vector< unsigned int > children;	///< Hines indices of child compts
@@ -64,29 +250,49 @@ public:
     double getB( unsigned int row ) const;
     double getVMid( unsigned int row ) const;
 
+    /**
+     * True if the other matrix has the same size and the same junctions,
+     * so that both can be eliminated by the same sequence of operations.
+     */
+    bool sameTopology( const HinesMatrix& other ) const;
+
 protected:
-    typedef vector< double >::iterator vdIterator;
+    typedef HinesArray::iterator vdIterator;
 
     unsigned int              nCompt_;
     double                    dt_;
 
     vector< JunctionStruct >  junction_;
-    vector< double >          HS_;			/**< Hines, series.
+    HinesArray                HS_;			/**< Hines, series.
 		* Flattened array containing the tridiagonal of the approximately
 		* tridiagonal Hines matrix, stacked against the column vector "b" that
 		* appears on the RHS of the equation that we're trying to solve: Ax=b.
 		*/
-    vector< double >          HJ_;			/**< Hines, junctions.
+    HinesArray                HJ_;			/**< Hines, junctions.
 		* Flattened array containing the off-diagonal elements of the Hines
 		* matrix */
     vector< double >          HJCopy_;
-    vector< double >          VMid_;		///< Compartment voltage at the
+    HinesArray                VMid_;		///< Compartment voltage at the
     ///< middle of a time step.
     vector< vdIterator >      operand_;
     vector< vdIterator >      backOperand_;
     int                       stage_;		///< Which stage the simulation has
     ///< reached. Used in getA.
 
+    /**
+     * Number of doubles per cell that bindBatch uses for the matrix.
+     */
+    unsigned int batchSize() const;
+    /**
+     * Binds HS_, HJ_ and VMid_ to storage shared by a batch of numCells
+     * cells with this topology, as the cell in the given column. Returns
+     * the part of the storage that comes after the one used here.
+     */
+    double* bindBatch( double* data, unsigned int column,
+                       unsigned int numCells );
+    /// Moves HS_, HJ_ and VMid_ back into storage of their own.
+    void unbindBatch();
+
 private:
     void clear();
     void makeJunctions();
@@ -118,8 +324,8 @@ private:
      *   one child, coupled_ stores a vector containing the children of the
      *   compartment and the compartment itself.
      *   coupled_ is therefore a vector of such vectors. */
-    map< unsigned int, vdIterator >    operandBase_;
-    /**< Contains iterators into HJ_ demarcating where a child's neighbours
+    map< unsigned int, unsigned int >  operandBase_;
+    /**< Contains offsets into HJ_ demarcating where a child's neighbours
      *   begin. Used for iterating through HJ_ along with junction_. */
     map< unsigned int, unsigned int >  groupNumber_;
     /**< Tells you the index of a compartment's group within coupled_,
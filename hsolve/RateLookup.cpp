@@ -12,8 +12,19 @@ using namespace std;
 
 #include "RateLookup.h"
 
+LookupTable::LookupTable()
+	:
+		table_( new vector< double >() ),
+		min_( 0.0 ),
+		max_( 0.0 ),
+		nPts_( 0 ),
+		dx_( 0.0 ),
+		nColumns_( 0 )
+{ ; }
+
 LookupTable::LookupTable(
 	double min, double max, unsigned int nDivs, unsigned int nSpecies )
+	: table_( new vector< double >() )
 {
 	min_ = min;
 	max_ = max;
@@ -25,7 +36,7 @@ LookupTable::LookupTable(
 	nColumns_ = 2 * nSpecies;
 	
 	//~ interpolate_.resize( nSpecies );
-	table_.resize( nPts_ * nColumns_ );
+	table_->resize( nPts_ * nColumns_ );
 }
 
 void LookupTable::addColumns(
@@ -37,7 +48,7 @@ void LookupTable::addColumns(
 {
 	vector< double >::const_iterator ic1 = C1.begin();
 	vector< double >::const_iterator ic2 = C2.begin();
-	vector< double >::iterator iTable = table_.begin() + 2 * species;
+	vector< double >::iterator iTable = table_->begin() + 2 * species;
 	// Loop until last but one point
 	for ( unsigned int igrid = 0; igrid < nPts_ - 1 ; ++igrid ) {
 		*( iTable )     = *ic1;
@@ -70,7 +81,7 @@ void LookupTable::row( double x, LookupRow& row )
 	unsigned int integer = ( unsigned int )( div );
 	
 	row.fraction = div - integer;
-	row.row = &( table_.front() ) + integer * nColumns_;
+	row.row = table_->data() + integer * nColumns_;
 }
 
 void LookupTable::lookup(
@@ -101,3 +112,34 @@ void LookupTable::lookup(
 	b = *( bp + 1 );
 	C2 = a + ( b - a ) * row.fraction;
 }
+
+void LookupTable::entries(
+	const LookupColumn& column,
+	const LookupRow& row,
+	double& C1a,
+	double& C1b,
+	double& C2a,
+	double& C2b )
+{
+	double* ap = row.row + column.column;
+	double* bp = ap + nColumns_;
+	
+	C1a = *ap;
+	C1b = *bp;
+	C2a = *( ap + 1 );
+	C2b = *( bp + 1 );
+}
+
+bool LookupTable::share( const LookupTable& other )
+{
+	if ( table_ == other.table_ )
+		return true;
+	
+	if ( min_ != other.min_ || max_ != other.max_ || nPts_ != other.nPts_ ||
+			dx_ != other.dx_ || nColumns_ != other.nColumns_ ||
+			*table_ != *other.table_ )
+		return false;
+	
+	table_ = other.table_;
+	return true;
+}
@@ -10,6 +10,8 @@
 #ifndef _RATE_LOOKUP_H
 #define _RATE_LOOKUP_H
 
+#include <memory>
+
 struct LookupRow
 {
 	double* row;		///< Pointer to the first column on a row
@@ -27,7 +29,7 @@ struct LookupColumn
 class LookupTable
 {
 public:
-	LookupTable() { ; }
+	LookupTable();
 	
 	LookupTable(
 		double min,					///< min of range
@@ -61,10 +63,33 @@ public:
 		const LookupRow& row,
 		double& C1,
 		double& C2 );
+
+	/**
+	 * Returns the table entries for C1 and C2 at the row (a) and the 
+	 * next row (b), without interpolating. Used when the interpolation
+	 * is done later for many gates at once.
+	 */
+	void entries(
+		const LookupColumn& column,
+		const LookupRow& row,
+		double& C1a,
+		double& C1b,
+		double& C2a,
+		double& C2b );
+	
+	/**
+	 * Makes this table use the same storage as 'other', if the two have
+	 * the same range, size and contents. This is used to keep one copy
+	 * of the table for many identical cells. Returns true if the storage
+	 * is now shared.
+	 */
+	bool share( const LookupTable& other );
 	
 private:
 	//~ vector< bool >       interpolate_;
-	vector< double >     table_;		///< Flattened table
+	std::shared_ptr< vector< double > > table_;	///< Flattened table.
+										///< May be shared between
+										///< identical tables.
 	double               min_;			///< min of the voltage / caConc range
 	double               max_;			///< max of the voltage / caConc range
 	unsigned int         nPts_;			///< Number of rows in the table.
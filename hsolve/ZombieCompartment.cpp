@@ -203,7 +203,7 @@ void ZombieCompartment::vRandInject( const Eref& e , double prob, double current
 }
 //////////////////////////////////////////////////////////////////
 
-void ZombieCompartment::vSetSolver( const Eref& e , Id hsolve )
+void ZombieCompartment::vSetSolver( const Eref& e , ObjId hsolve )
 {
 	if ( !hsolve.element()->cinfo()->isA( "HSolve" ) ) {
 		cout << "Error: ZombieCompartment::vSetSolver: Object: " <<
@@ -211,5 +211,5 @@ void ZombieCompartment::vSetSolver( const Eref& e , Id hsolve )
 		hsolve_ = 0;
 		return;
 	}
-	hsolve_ = reinterpret_cast< HSolve* >( hsolve.eref().data() );
+	hsolve_ = reinterpret_cast< HSolve* >( hsolve.data() );
 }
@@ -210,7 +210,7 @@ HHGate* ZombieHHChannel::vGetZgate( unsigned int i ) const
 void ZombieHHChannel::vHandleVm( double Vm )
 {;}
 
-void ZombieHHChannel::vSetSolver( const Eref& e , Id hsolve )
+void ZombieHHChannel::vSetSolver( const Eref& e , ObjId hsolve )
 {
 	if ( !hsolve.element()->cinfo()->isA( "HSolve" ) ) {
 		cout << "Error: ZombieHHChannel::vSetSolver: Object: " <<
@@ -219,5 +219,5 @@ void ZombieHHChannel::vSetSolver( const Eref& e , Id hsolve )
 		assert( 0 );
 		return;
 	}
-	hsolve_ = reinterpret_cast< HSolve* >( hsolve.eref().data() );
+	hsolve_ = reinterpret_cast< HSolve* >( hsolve.data() );
 }
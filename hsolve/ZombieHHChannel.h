@@ -114,7 +114,7 @@ public:
      */
     HHGate* vGetZgate( unsigned int i ) const;
     /////////////////////////////////////////////////////////////
-	void vSetSolver( const Eref& e , Id hsolve );
+	void vSetSolver( const Eref& e , ObjId hsolve );
 
     static const Cinfo* initCinfo();
 
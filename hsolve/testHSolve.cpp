@@ -20,7 +20,10 @@ using namespace std;
 
 extern void testHinesMatrix(); // Defined in HinesMatrix.cpp
 extern void testHSolvePassive(); // Defined in HSolvePassive.cpp
+extern void testHSolveBatch(); // Defined in HSolve.cpp
+extern void testHSolveThreads(); // Defined in HSolve.cpp
 extern void testHSolveUtils(); // Defined in HSolveUtils.cpp
+extern void testHSolveGates(); // Defined in HSolveActive.cpp
 extern void runRallpackBenchmarks();                 /* Defined in RallPacks.cpp */
 
 void testHSolve()
@@ -28,6 +31,9 @@ void testHSolve()
 	testHSolveUtils();
 	testHinesMatrix();
 	testHSolvePassive();
+	testHSolveBatch();
+	testHSolveThreads();
+	testHSolveGates();
 }
 
 //////////////////////////////////////////////////////////////////////////////
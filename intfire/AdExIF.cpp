@@ -142,6 +142,25 @@ void AdExIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void AdExIF::vGetModelFields( const Eref& e, vector< double >& ret ) const
+{
+	ExIF::vGetModelFields( e, ret );
+	ret.push_back( getW( e ) );
+	ret.push_back( getTauW( e ) );
+	ret.push_back( getA0( e ) );
+	ret.push_back( getB0( e ) );
+}
+
+void AdExIF::vSetModelFields( const Eref& e, const double** buf )
+{
+	ExIF::vSetModelFields( e, buf );
+	setW( e, (*buf)[0] );
+	setTauW( e, (*buf)[1] );
+	setA0( e, (*buf)[2] );
+	setB0( e, (*buf)[3] );
+	*buf += 4;
+}
+
 void AdExIF::setW( const Eref& e, double val )
 {
 	w_ = val;
@@ -22,14 +22,16 @@ class AdExIF: public ExIF
 			AdExIF();
 			virtual ~AdExIF();
 
-			void setW( const Eref& e,  double val );
-			double getW( const Eref& e  ) const;
-			void setTauW( const Eref& e,  double val );
-			double getTauW( const Eref& e  ) const;
-			void setA0( const Eref& e,  double val );
-			double getA0( const Eref& e  ) const;
-			void setB0( const Eref& e,  double val );
-			double getB0( const Eref& e  ) const;
+			// These are virtual so that zombies can keep the fields
+			// in a solver.
+			virtual void setW( const Eref& e,  double val );
+			virtual double getW( const Eref& e  ) const;
+			virtual void setTauW( const Eref& e,  double val );
+			virtual double getTauW( const Eref& e  ) const;
+			virtual void setA0( const Eref& e,  double val );
+			virtual double getA0( const Eref& e  ) const;
+			virtual void setB0( const Eref& e,  double val );
+			virtual double getB0( const Eref& e  ) const;
 
 			/**
 			 * The process function does the object updating and sends out
@@ -42,6 +44,11 @@ class AdExIF: public ExIF
 			 */
 			void vReinit( const Eref& e, ProcPtr p );
 
+			/// The AdExIF fields, for IntFireBase::zombify.
+			void vGetModelFields( const Eref& e, vector< double >& ret )
+					const;
+			void vSetModelFields( const Eref& e, const double** buf );
+
 			/**
 			 * Initializes the class info.
 			 */
@@ -140,6 +140,23 @@ void AdThreshIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void AdThreshIF::vGetModelFields( const Eref& e, vector< double >& ret ) const
+{
+	ret.push_back( getThreshAdaptive( e ) );
+	ret.push_back( getTauThresh( e ) );
+	ret.push_back( getA0( e ) );
+	ret.push_back( getThreshJump( e ) );
+}
+
+void AdThreshIF::vSetModelFields( const Eref& e, const double** buf )
+{
+	setThreshAdaptive( e, (*buf)[0] );
+	setTauThresh( e, (*buf)[1] );
+	setA0( e, (*buf)[2] );
+	setThreshJump( e, (*buf)[3] );
+	*buf += 4;
+}
+
 void AdThreshIF::setThreshAdaptive( const Eref& e, double val )
 {
 	threshAdaptive_ = val;
@@ -22,14 +22,16 @@ class AdThreshIF: public IntFireBase
 			AdThreshIF();
 			virtual ~AdThreshIF();
 
-			void setThreshAdaptive( const Eref& e,  double val );
-			double getThreshAdaptive( const Eref& e  ) const;
-			void setTauThresh( const Eref& e,  double val );
-			double getTauThresh( const Eref& e  ) const;
-			void setA0( const Eref& e,  double val );
-			double getA0( const Eref& e  ) const;
-			void setThreshJump( const Eref& e,  double val );
-			double getThreshJump( const Eref& e  ) const;
+			// These are virtual so that zombies can keep the fields
+			// in a solver.
+			virtual void setThreshAdaptive( const Eref& e,  double val );
+			virtual double getThreshAdaptive( const Eref& e  ) const;
+			virtual void setTauThresh( const Eref& e,  double val );
+			virtual double getTauThresh( const Eref& e  ) const;
+			virtual void setA0( const Eref& e,  double val );
+			virtual double getA0( const Eref& e  ) const;
+			virtual void setThreshJump( const Eref& e,  double val );
+			virtual double getThreshJump( const Eref& e  ) const;
 
 			/**
 			 * The process function does the object updating and sends out
@@ -42,6 +44,11 @@ class AdThreshIF: public IntFireBase
 			 */
 			void vReinit( const Eref& e, ProcPtr p );
 
+			/// The AdThreshIF fields, for IntFireBase::zombify.
+			void vGetModelFields( const Eref& e, vector< double >& ret )
+					const;
+			void vSetModelFields( const Eref& e, const double** buf );
+
 			/**
 			 * Initializes the class info.
 			 */
@@ -117,6 +117,19 @@ void ExIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void ExIF::vGetModelFields( const Eref& e, vector< double >& ret ) const
+{
+	ret.push_back( getDeltaThresh( e ) );
+	ret.push_back( getVPeak( e ) );
+}
+
+void ExIF::vSetModelFields( const Eref& e, const double** buf )
+{
+	setDeltaThresh( e, (*buf)[0] );
+	setVPeak( e, (*buf)[1] );
+	*buf += 2;
+}
+
 void ExIF::setDeltaThresh( const Eref& e, double val )
 {
 	deltaThresh_ = val;
@@ -22,10 +22,12 @@ class ExIF: public IntFireBase
 			ExIF();
 			virtual ~ExIF();
 
-			void setDeltaThresh( const Eref& e,  double val );
-			double getDeltaThresh( const Eref& e  ) const;
-			void setVPeak( const Eref& e,  double val );
-			double getVPeak( const Eref& e  ) const;
+			// These are virtual so that zombies can keep the fields
+			// in a solver.
+			virtual void setDeltaThresh( const Eref& e,  double val );
+			virtual double getDeltaThresh( const Eref& e  ) const;
+			virtual void setVPeak( const Eref& e,  double val );
+			virtual double getVPeak( const Eref& e  ) const;
 
 			/**
 			 * The process function does the object updating and sends out
@@ -38,6 +40,11 @@ class ExIF: public IntFireBase
 			 */
 			void vReinit( const Eref& e, ProcPtr p );
 
+			/// The ExIF fields, for IntFireBase::zombify.
+			void vGetModelFields( const Eref& e, vector< double >& ret )
+					const;
+			void vSetModelFields( const Eref& e, const double** buf );
+
 			/**
 			 * Initializes the class info.
 			 */
@@ -11,6 +11,7 @@
 #include "ElementValueFinfo.h"
 #include "../biophysics/CompartmentBase.h"
 #include "../biophysics/Compartment.h"
+#include "../biophysics/CompartmentDataHolder.h"
 #include "IntFireBase.h"
 
 using namespace moose;
@@ -66,7 +67,7 @@ const Cinfo* IntFireBase::initCinfo()
 		//////////////////////////////////////////////////////////////
 		static DestFinfo activation( "activation",
 			"Handles value of synaptic activation arriving on this object",
-			new OpFunc1< IntFireBase, double >( &IntFireBase::activation ));
+			new EpFunc1< IntFireBase, double >( &IntFireBase::activation ));
 
 		//////////////////////////////////////////////////////////////
 
@@ -166,7 +167,60 @@ bool IntFireBase::hasFired( const Eref& e ) const
 // IntFireBase::Dest function definitions.
 //////////////////////////////////////////////////////////////////
 
-void IntFireBase::activation( double v )
+void IntFireBase::activation( const Eref& e, double v )
 {
 	activation_ += v;
 }
+
+void IntFireBase::vGetModelFields( const Eref& e, vector< double >& ret )
+		const
+{;}
+
+void IntFireBase::vSetModelFields( const Eref& e, const double** buf )
+{;}
+
+//////////////////////////////////////////////////////////////////
+// IntFireBase::Zombification.
+//////////////////////////////////////////////////////////////////
+
+// static func
+void IntFireBase::zombify( Element* orig, const Cinfo* zClass,
+				ObjId solver )
+{
+	if ( orig->cinfo() == zClass )
+		return;
+	unsigned int start = orig->localDataStart();
+	unsigned int num = orig->numLocalData();
+	if ( num == 0 )
+		return;
+	vector< CompartmentDataHolder > cdh( num );
+	vector< double > vals( 4 * num );
+	vector< long > seeds( num );
+	vector< double > modelVals;
+	for ( unsigned int i = 0; i < num; ++i ) {
+		Eref er( orig, i + start );
+		const IntFireBase* ifb =
+			reinterpret_cast< const IntFireBase* >( er.data() );
+		cdh[i].readData( ifb, er );
+		vals[ 4 * i ] = ifb->getVm( er );
+		vals[ 4 * i + 1 ] = ifb->getThresh( er );
+		vals[ 4 * i + 2 ] = ifb->getVReset( er );
+		vals[ 4 * i + 3 ] = ifb->getRefractoryPeriod( er );
+		seeds[i] = ifb->getSeed( er );
+		ifb->vGetModelFields( er, modelVals );
+	}
+	orig->zombieSwap( zClass );
+	const double* buf = modelVals.empty() ? 0 : &modelVals[0];
+	for ( unsigned int i = 0; i < num; ++i ) {
+		Eref er( orig, i + start );
+		IntFireBase* ifb = reinterpret_cast< IntFireBase* >( er.data() );
+		ifb->vSetSolver( er, solver );
+		cdh[i].writeData( ifb, er );
+		ifb->setVm( er, vals[ 4 * i ] );
+		ifb->setThresh( er, vals[ 4 * i + 1 ] );
+		ifb->setVReset( er, vals[ 4 * i + 2 ] );
+		ifb->setRefractoryPeriod( er, vals[ 4 * i + 3 ] );
+		ifb->setSeed( er, seeds[i] );
+		ifb->vSetModelFields( er, &buf );
+	}
+}
@@ -23,14 +23,16 @@ class IntFireBase: public Compartment
 			virtual ~IntFireBase();
 
 			// Value Field access function definitions.
-			void setThresh( const Eref& e,  double val );
-			double getThresh( const Eref& e  ) const;
-			void setVReset( const Eref& e,  double val );
-			double getVReset( const Eref& e  ) const;
-			void setRefractoryPeriod( const Eref& e,  double val );
-			double getRefractoryPeriod( const Eref& e  ) const;
-			double getLastEventTime( const Eref& e  ) const;
-			bool hasFired( const Eref& e ) const;
+			// These are virtual so that zombies can keep the fields
+			// in a solver.
+			virtual void setThresh( const Eref& e,  double val );
+			virtual double getThresh( const Eref& e  ) const;
+			virtual void setVReset( const Eref& e,  double val );
+			virtual double getVReset( const Eref& e  ) const;
+			virtual void setRefractoryPeriod( const Eref& e,  double val );
+			virtual double getRefractoryPeriod( const Eref& e  ) const;
+			virtual double getLastEventTime( const Eref& e  ) const;
+			virtual bool hasFired( const Eref& e ) const;
 
 			// Dest function definitions.
 			/**
@@ -48,11 +50,37 @@ class IntFireBase: public Compartment
 			 * activation handles information coming from the SynHandler
 			 * to the intFire.
 			 */
-			void activation( double val );
+			virtual void activation( const Eref& e, double val );
+
+			/**
+			 * Appends the fields particular to the derived class to
+			 * ret, so that zombify can carry them over. There are none
+			 * in IntFireBase.
+			 */
+			virtual void vGetModelFields( const Eref& e,
+						vector< double >& ret ) const;
+
+			/**
+			 * Sets the fields particular to the derived class from
+			 * *buf, in the order given by vGetModelFields, and moves
+			 * *buf on past them.
+			 */
+			virtual void vSetModelFields( const Eref& e,
+						const double** buf );
 			
 			/// Message src for outgoing spikes.
 			static SrcFinfo1< double >* spikeOut();
 
+			/**
+			 * Swaps the Cinfo of an IntFireBase derived class, carrying
+			 * over the compartment and firing parameters, and those
+			 * particular to the class. Used to make and unmake zombies,
+			 * so zClass must either be the zombie of the class of orig,
+			 * which derives from it, or the other way around.
+			 */
+			static void zombify( Element* orig, const Cinfo* zClass,
+						ObjId solver );
+
 			/**
 			 * Initializes the class info.
 			 */
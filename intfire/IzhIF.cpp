@@ -200,6 +200,33 @@ void IzhIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void IzhIF::vGetModelFields( const Eref& e, vector< double >& ret ) const
+{
+	ret.push_back( getA0( e ) );
+	ret.push_back( getB0( e ) );
+	ret.push_back( getC0( e ) );
+	ret.push_back( getA( e ) );
+	ret.push_back( getB( e ) );
+	ret.push_back( getD( e ) );
+	ret.push_back( getVPeak( e ) );
+	ret.push_back( getU( e ) );
+	ret.push_back( getUInit( e ) );
+}
+
+void IzhIF::vSetModelFields( const Eref& e, const double** buf )
+{
+	setA0( e, (*buf)[0] );
+	setB0( e, (*buf)[1] );
+	setC0( e, (*buf)[2] );
+	setA( e, (*buf)[3] );
+	setB( e, (*buf)[4] );
+	setD( e, (*buf)[5] );
+	setVPeak( e, (*buf)[6] );
+	setU( e, (*buf)[7] );
+	setUInit( e, (*buf)[8] );
+	*buf += 9;
+}
+
 void IzhIF::setA0( const Eref& e, double val )
 {
 	a0_ = val;
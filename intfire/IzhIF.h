@@ -22,24 +22,26 @@ class IzhIF: public IntFireBase
 			IzhIF();
 			virtual ~IzhIF();
 
-			void setA0( const Eref& e,  double val );
-			double getA0( const Eref& e  ) const;
-			void setB0( const Eref& e,  double val );
-			double getB0( const Eref& e  ) const;
-			void setC0( const Eref& e,  double val );
-			double getC0( const Eref& e  ) const;
-			void setA( const Eref& e,  double val );
-			double getA( const Eref& e  ) const;
-			void setB( const Eref& e,  double val );
-			double getB( const Eref& e  ) const;
-			void setD( const Eref& e,  double val );
-			double getD( const Eref& e  ) const;
-			void setVPeak( const Eref& e,  double val );
-			double getVPeak( const Eref& e  ) const;
-			void setU( const Eref& e,  double val );
-			double getU( const Eref& e  ) const;
-			void setUInit( const Eref& e,  double val );
-			double getUInit( const Eref& e  ) const;
+			// These are virtual so that zombies can keep the fields
+			// in a solver.
+			virtual void setA0( const Eref& e,  double val );
+			virtual double getA0( const Eref& e  ) const;
+			virtual void setB0( const Eref& e,  double val );
+			virtual double getB0( const Eref& e  ) const;
+			virtual void setC0( const Eref& e,  double val );
+			virtual double getC0( const Eref& e  ) const;
+			virtual void setA( const Eref& e,  double val );
+			virtual double getA( const Eref& e  ) const;
+			virtual void setB( const Eref& e,  double val );
+			virtual double getB( const Eref& e  ) const;
+			virtual void setD( const Eref& e,  double val );
+			virtual double getD( const Eref& e  ) const;
+			virtual void setVPeak( const Eref& e,  double val );
+			virtual double getVPeak( const Eref& e  ) const;
+			virtual void setU( const Eref& e,  double val );
+			virtual double getU( const Eref& e  ) const;
+			virtual void setUInit( const Eref& e,  double val );
+			virtual double getUInit( const Eref& e  ) const;
 
 			/**
 			 * The process function does the object updating and sends out
@@ -52,6 +54,11 @@ class IzhIF: public IntFireBase
 			 */
 			void vReinit( const Eref& e, ProcPtr p );
 
+			/// The IzhIF fields, for IntFireBase::zombify.
+			void vGetModelFields( const Eref& e, vector< double >& ret )
+					const;
+			void vSetModelFields( const Eref& e, const double** buf );
+
 			/**
 			 * Initializes the class info.
 			 */
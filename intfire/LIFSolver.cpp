@@ -0,0 +1,562 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "ElementValueFinfo.h"
+#include "../randnum/randnum.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "IntFireBase.h"
+#include "LIFSolver.h"
+
+using namespace moose;
+
+// Below this, Compartment uses forward Euler rather than exponential.
+static const double EPSILON = 1.0e-15;
+
+const Cinfo* LIFSolver::initCinfo()
+{
+		//////////////////////////////////////////////////////////////
+		// Field Definitions
+		//////////////////////////////////////////////////////////////
+		static ElementValueFinfo< LIFSolver, Id > target(
+			"target",
+			"Array of neurons to be solved, of one of the classes LIF, "
+			"ExIF, AdExIF, QIF, AdThreshIF or IzhIF. These are turned "
+			"into zombies of their class, such as ZombieLIF, until the "
+			"target is changed, unzombify is called, or the solver is "
+			"deleted. Set it before reinit, as the time of the last "
+			"spike is not carried over.",
+			&LIFSolver::setTarget,
+			&LIFSolver::getTarget
+		);
+
+		static ReadOnlyValueFinfo< LIFSolver, unsigned int > numNeurons(
+			"numNeurons",
+			"Number of neurons on this node handled by the solver.",
+			&LIFSolver::getNumNeurons
+		);
+
+		//////////////////////////////////////////////////////////////
+		// MsgDest Definitions
+		//////////////////////////////////////////////////////////////
+		static DestFinfo unzombify( "unzombify",
+			"Restore the target neurons to their original class",
+			new OpFunc0< LIFSolver >( &LIFSolver::unzombify )
+		);
+
+		static DestFinfo process( "process",
+			"Handles process call",
+			new ProcOpFunc< LIFSolver >( &LIFSolver::process ) );
+		static DestFinfo reinit( "reinit",
+			"Handles reinit call",
+			new ProcOpFunc< LIFSolver >( &LIFSolver::reinit ) );
+
+		//////////////////////////////////////////////////////////////
+		// SharedFinfo Definitions
+		//////////////////////////////////////////////////////////////
+		static Finfo* procShared[] = {
+			&process, &reinit
+		};
+		static SharedFinfo proc( "proc",
+			"Shared message for process and reinit",
+			procShared, sizeof( procShared ) / sizeof( const Finfo* )
+		);
+
+	static Finfo* lifSolverFinfos[] = {
+		&target,		// Value
+		&numNeurons,	// ReadOnlyValue
+		&unzombify,		// DestFinfo
+		&proc,			// SharedFinfo
+	};
+
+	static string doc[] =
+	{
+		"Name", "LIFSolver",
+		"Author", "Upi Bhalla",
+		"Description", "Solver for an array of integrate-and-fire "
+		"neurons of any of the IntFireBase classes. It holds "
+		"their state in one vector per field and advances the whole "
+		"array on each timestep. Spikes go out from the neurons as "
+		"usual. Vm is only sent out on VmOut if the array has messages "
+		"from it, and otherwise is read from the fields on demand. "
+		"LIFs are integrated in a single branch-free loop, except for "
+		"any which get input from channels or have too large an Rm "
+		"for the exponential Euler method. These are integrated one "
+		"at a time until the next reinit.",
+	};
+
+	static Dinfo< LIFSolver > dinfo;
+	static Cinfo lifSolverCinfo(
+				"LIFSolver",
+				Neutral::initCinfo(),
+				lifSolverFinfos,
+				sizeof( lifSolverFinfos ) / sizeof (Finfo*),
+				&dinfo,
+				doc,
+				sizeof(doc)/sizeof(string)
+	);
+
+	return &lifSolverCinfo;
+}
+
+static const Cinfo* lifSolverCinfo = LIFSolver::initCinfo();
+
+//////////////////////////////////////////////////////////////////
+// Here we put the LIFSolver class functions.
+//////////////////////////////////////////////////////////////////
+
+LIFSolver::LIFSolver()
+	: origClass_( 0 ), model_( LIF_MODEL ),
+	start_( 0 ), numNeurons_( 0 ), dt_( 0.0 )
+{;}
+
+LIFSolver::~LIFSolver()
+{
+	unzombify();
+}
+
+// static func
+const Cinfo* LIFSolver::zombieClass( const Cinfo* c, Model& model )
+{
+	// In the order of Model.
+	static const char* names[][2] = {
+		{ "LIF", "ZombieLIF" },
+		{ "ExIF", "ZombieExIF" },
+		{ "AdExIF", "ZombieAdExIF" },
+		{ "QIF", "ZombieQIF" },
+		{ "AdThreshIF", "ZombieAdThreshIF" },
+		{ "IzhIF", "ZombieIzhIF" },
+	};
+	for ( unsigned int m = 0; m < NUM_MODELS; ++m ) {
+		if ( c == Cinfo::find( names[m][0] ) ) {
+			model = static_cast< Model >( m );
+			return Cinfo::find( names[m][1] );
+		}
+	}
+	return 0;
+}
+
+/// True if the neurons of model m have the field f.
+static bool hasField( LIFSolver::Model m, unsigned int f )
+{
+	if ( f < LIFSolver::NUM_COMMON )
+		return true;
+	switch ( m ) {
+		case LIFSolver::EXIF_MODEL:
+			return f == LIFSolver::DELTA_THRESH || f == LIFSolver::V_PEAK;
+		case LIFSolver::ADEXIF_MODEL:
+			return f == LIFSolver::DELTA_THRESH || f == LIFSolver::V_PEAK ||
+				f == LIFSolver::W || f == LIFSolver::TAU_W ||
+				f == LIFSolver::A0 || f == LIFSolver::B0;
+		case LIFSolver::QIF_MODEL:
+			return f == LIFSolver::V_CRITICAL || f == LIFSolver::A0;
+		case LIFSolver::ADTHRESHIF_MODEL:
+			return f == LIFSolver::THRESH_ADAPTIVE ||
+				f == LIFSolver::TAU_THRESH || f == LIFSolver::A0 ||
+				f == LIFSolver::THRESH_JUMP;
+		case LIFSolver::IZHIF_MODEL:
+			return f == LIFSolver::A0 || f == LIFSolver::B0 ||
+				f == LIFSolver::C0 || f == LIFSolver::IZH_A ||
+				f == LIFSolver::IZH_B || f == LIFSolver::IZH_D ||
+				f == LIFSolver::V_PEAK || f == LIFSolver::U ||
+				f == LIFSolver::U_INIT;
+		default:
+			return false;
+	}
+}
+
+void LIFSolver::setTarget( const Eref& e, Id target )
+{
+	unzombify();
+	if ( target == Id() )
+		return;
+	Element* elm = target.element();
+	Model model = LIF_MODEL;
+	const Cinfo* zClass = zombieClass( elm->cinfo(), model );
+	if ( !zClass ) {
+		cerr << "Error: LIFSolver::setTarget: '" << target.path() <<
+			"' is a " << elm->cinfo()->name() << ", which cannot be "
+			"solved. Target not set.\n";
+		return;
+	}
+	target_ = target;
+	origClass_ = elm->cinfo();
+	model_ = model;
+	start_ = elm->localDataStart();
+	numNeurons_ = elm->numLocalData();
+	// The defaults of Compartment, overwritten during zombify.
+	for ( unsigned int f = 0; f < NUM_FIELDS; ++f ) {
+		if ( hasField( model_, f ) )
+			s_[f].assign( numNeurons_, 0.0 );
+	}
+	s_[VM].assign( numNeurons_, -0.06 );
+	s_[INIT_VM].assign( numNeurons_, -0.06 );
+	s_[EM].assign( numNeurons_, -0.06 );
+	s_[CM].assign( numNeurons_, 1.0 );
+	s_[RM].assign( numNeurons_, 1.0 );
+	s_[INV_RM].assign( numNeurons_, 1.0 );
+	s_[DECAY].assign( numNeurons_, 1.0 );
+	seed_.assign( numNeurons_, 0 );
+	rng_.assign( numNeurons_, CounterRng() );
+	general_.clear();
+	IntFireBase::zombify( elm, zClass, e.objId() );
+}
+
+Id LIFSolver::getTarget( const Eref& e ) const
+{
+	return target_;
+}
+
+unsigned int LIFSolver::getNumNeurons() const
+{
+	return numNeurons_;
+}
+
+void LIFSolver::unzombify()
+{
+	if ( target_ == Id() )
+		return;
+	Element* elm = target_.element();
+	Model model;
+	if ( elm && !elm->isDoomed() &&
+			elm->cinfo() == zombieClass( origClass_, model ) )
+		IntFireBase::zombify( elm, origClass_, ObjId() );
+	target_ = Id();
+	origClass_ = 0;
+	numNeurons_ = 0;
+	for ( unsigned int f = 0; f < NUM_FIELDS; ++f )
+		s_[f].clear();
+	seed_.clear();
+	rng_.clear();
+	general_.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+// Access for the zombies
+//////////////////////////////////////////////////////////////////
+
+double LIFSolver::get( const Eref& e, Field f ) const
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < s_[f].size() );
+	return s_[f][i];
+}
+
+void LIFSolver::set( const Eref& e, Field f, double v )
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < s_[f].size() );
+	s_[f][i] = v;
+	if ( f == RM ) {
+		s_[INV_RM][i] = 1.0 / v;
+		if ( !( s_[INV_RM][i] > EPSILON ) )
+			setGeneral( i );
+		updateDecay( i );
+	} else if ( f == CM ) {
+		updateDecay( i );
+	}
+}
+
+void LIFSolver::activation( const Eref& e, double v )
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < numNeurons_ );
+	s_[ACTIVATION][i] += v;
+}
+
+void LIFSolver::injectMsg( const Eref& e, double current )
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < numNeurons_ );
+	s_[SUM_INJECT][i] += current;
+	s_[IM][i] += current;
+}
+
+void LIFSolver::randInject( const Eref& e, double prob, double current )
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < numNeurons_ );
+	double r = seed_[i] ? rng_[i].uniform() : mtrand();
+	if ( r < prob * dt_ )
+		injectMsg( e, current );
+}
+
+void LIFSolver::setSeed( const Eref& e, long seed )
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < numNeurons_ );
+	seed_[i] = seed;
+}
+
+long LIFSolver::getSeed( const Eref& e ) const
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < numNeurons_ );
+	return seed_[i];
+}
+
+void LIFSolver::handleChannel( const Eref& e, double Gk, double Ek )
+{
+	unsigned int i = e.dataIndex() - start_;
+	assert( i < numNeurons_ );
+	s_[A][i] += Gk * Ek;
+	s_[B][i] += Gk;
+	setGeneral( i );
+}
+
+void LIFSolver::updateDecay( unsigned int i )
+{
+	// Same expression as Compartment::vProcess, so the results match.
+	s_[DECAY][i] = exp( -s_[INV_RM][i] * dt_ / s_[CM][i] );
+}
+
+void LIFSolver::setGeneral( unsigned int i )
+{
+	// The other models are always done a neuron at a time.
+	if ( model_ == LIF_MODEL && s_[GENERAL][i] == 0.0 ) {
+		s_[GENERAL][i] = 1.0;
+		general_.push_back( i );
+	}
+}
+
+//////////////////////////////////////////////////////////////////
+// LIFSolver::Dest function definitions.
+//////////////////////////////////////////////////////////////////
+
+void LIFSolver::advanceLeaky( double t )
+{
+	const double dt = dt_;
+	double* Vm = &s_[VM][0];
+	double* A = &s_[LIFSolver::A][0];
+	double* B = &s_[LIFSolver::B][0];
+	double* sumInject = &s_[SUM_INJECT][0];
+	double* Im = &s_[IM][0];
+	double* lastIm = &s_[LAST_IM][0];
+	double* lastEvent = &s_[LAST_EVENT][0];
+	double* activation = &s_[ACTIVATION][0];
+	double* fired = &s_[FIRED][0];
+	const double* Em = &s_[EM][0];
+	const double* invRm = &s_[INV_RM][0];
+	const double* inject = &s_[INJECT][0];
+	const double* thresh = &s_[THRESH][0];
+	const double* vReset = &s_[V_RESET][0];
+	const double* refractT = &s_[REFRACT_T][0];
+	const double* decay = &s_[DECAY][0];
+	const double* general = &s_[GENERAL][0];
+	const unsigned int n = numNeurons_;
+
+	for ( unsigned int i = 0; i < n; ++i ) {
+		bool isRefract = t < lastEvent[i] + refractT[i];
+		double v = Vm[i] + activation[i] * dt;
+		bool isFired = !isRefract && v > thresh[i];
+		bool isIntegrated = !isRefract && !isFired;
+		double a = A[i] + ( inject[i] + sumInject[i] + Em[i] * invRm[i] );
+		double x = decay[i];
+		double vNew = v * x + ( a / B[i] ) * ( 1.0 - x );
+		// Neurons flagged general are left for advanceNeuron.
+		bool keep = general[i] != 0.0;
+
+		Vm[i] = keep ? Vm[i] : ( isIntegrated ? vNew : vReset[i] );
+		activation[i] = ( keep || isRefract ) ? activation[i] : 0.0;
+		lastEvent[i] = ( isFired && !keep ) ? t : lastEvent[i];
+		fired[i] = ( isFired && !keep ) ? 1.0 : 0.0;
+		// A firing neuron keeps its inputs for the next step, as in LIF.
+		A[i] = ( keep || isFired ) ? A[i] : 0.0;
+		B[i] = ( keep || isFired ) ? B[i] : invRm[i];
+		sumInject[i] = ( keep || isFired ) ? sumInject[i] : 0.0;
+		lastIm[i] = ( isIntegrated && !keep ) ? Im[i] : lastIm[i];
+		Im[i] = ( isIntegrated && !keep ) ? 0.0 : Im[i];
+	}
+}
+
+void LIFSolver::advanceCompartment( unsigned int i )
+{
+	double& Vm = s_[VM][i];
+	double& A = s_[LIFSolver::A][i];
+	double& B = s_[LIFSolver::B][i];
+	double& sumInject = s_[SUM_INJECT][i];
+	A += s_[INJECT][i] + sumInject + s_[EM][i] * s_[INV_RM][i];
+	if ( B > EPSILON ) {
+		double x = exp( -B * dt_ / s_[CM][i] );
+		Vm = Vm * x + ( A / B ) * ( 1.0 - x );
+	} else {
+		Vm += ( A - Vm * B ) * dt_ / s_[CM][i];
+	}
+	A = 0.0;
+	B = s_[INV_RM][i];
+	s_[LAST_IM][i] = s_[IM][i];
+	s_[IM][i] = 0.0;
+	sumInject = 0.0;
+}
+
+void LIFSolver::advanceNeuron( unsigned int i, double t )
+{
+	const double dt = dt_;
+	double& Vm = s_[VM][i];
+	// The quadratic models have no use for A and B.
+	bool isQuadratic = ( model_ == QIF_MODEL || model_ == IZHIF_MODEL );
+	s_[FIRED][i] = 0.0;
+	if ( t < s_[LAST_EVENT][i] + s_[REFRACT_T][i] ) {
+		Vm = s_[V_RESET][i];
+		if ( !isQuadratic ) {
+			s_[LIFSolver::A][i] = 0.0;
+			s_[LIFSolver::B][i] = s_[INV_RM][i];
+		}
+		s_[SUM_INJECT][i] = 0.0;
+		return;
+	}
+	Vm += s_[ACTIVATION][i] * dt;
+	s_[ACTIVATION][i] = 0.0;
+
+	bool isFired;
+	switch ( model_ ) {
+		case EXIF_MODEL:
+		case ADEXIF_MODEL:
+			isFired = Vm >= s_[V_PEAK][i];
+			break;
+		case ADTHRESHIF_MODEL:
+			isFired = Vm > ( s_[THRESH][i] + s_[THRESH_ADAPTIVE][i] );
+			break;
+		case IZHIF_MODEL:
+			isFired = Vm > s_[V_PEAK][i];
+			break;
+		default:
+			isFired = Vm > s_[THRESH][i];
+			break;
+	}
+	if ( isFired ) {
+		Vm = s_[V_RESET][i];
+		s_[LAST_EVENT][i] = t;
+		s_[FIRED][i] = 1.0;
+		if ( model_ == ADEXIF_MODEL )
+			s_[W][i] += s_[B0][i];
+		else if ( model_ == ADTHRESHIF_MODEL )
+			s_[THRESH_ADAPTIVE][i] += s_[THRESH_JUMP][i];
+		else if ( model_ == IZHIF_MODEL )
+			s_[U][i] += s_[IZH_D][i];
+		return;
+	}
+
+	// Each case follows the vProcess of its class, term by term.
+	const double Rm = s_[RM][i];
+	const double Cm = s_[CM][i];
+	switch ( model_ ) {
+		case EXIF_MODEL: {
+			double dT = s_[DELTA_THRESH][i];
+			Vm += dT * exp( ( Vm - s_[THRESH][i] ) / dT ) * dt / Rm / Cm;
+			break;
+		}
+		case ADEXIF_MODEL: {
+			double dT = s_[DELTA_THRESH][i];
+			double& w = s_[W][i];
+			Vm += ( dT * exp( ( Vm - s_[THRESH][i] ) / dT ) - Rm * w )
+					* dt / Rm / Cm;
+			w += ( -w + s_[A0][i] * ( Vm - s_[EM][i] ) ) * dt / s_[TAU_W][i];
+			break;
+		}
+		case ADTHRESHIF_MODEL: {
+			double& th = s_[THRESH_ADAPTIVE][i];
+			th += ( -th + s_[A0][i] * ( Vm - s_[EM][i] ) ) *
+					dt / s_[TAU_THRESH][i];
+			break;
+		}
+		case QIF_MODEL:
+			Vm += ( ( s_[INJECT][i] + s_[SUM_INJECT][i] ) + s_[A0][i] *
+				( Vm - s_[EM][i] ) * ( Vm - s_[V_CRITICAL][i] ) / Rm ) *
+				dt / Cm;
+			break;
+		case IZHIF_MODEL: {
+			double& u = s_[U][i];
+			Vm += ( ( s_[INJECT][i] + s_[SUM_INJECT][i] ) / Cm +
+				s_[A0][i] * pow( Vm, 2.0 ) + s_[B0][i] * Vm + s_[C0][i] -
+				u ) * dt;
+			u += s_[IZH_A][i] * ( s_[IZH_B][i] * Vm - u ) * dt;
+			break;
+		}
+		default:
+			break;
+	}
+	if ( isQuadratic ) {
+		s_[LAST_IM][i] = s_[IM][i];
+		s_[IM][i] = 0.0;
+		s_[SUM_INJECT][i] = 0.0;
+	} else {
+		advanceCompartment( i );
+	}
+}
+
+void LIFSolver::process( const Eref& e, ProcPtr p )
+{
+	if ( numNeurons_ == 0 )
+		return;
+	if ( p->dt != dt_ ) {
+		dt_ = p->dt;
+		for ( unsigned int i = 0; i < numNeurons_; ++i )
+			updateDecay( i );
+	}
+	if ( model_ == LIF_MODEL ) {
+		advanceLeaky( p->currTime );
+		for ( vector< unsigned int >::const_iterator
+				i = general_.begin(); i != general_.end(); ++i )
+			advanceNeuron( *i, p->currTime );
+	} else {
+		for ( unsigned int i = 0; i < numNeurons_; ++i )
+			advanceNeuron( i, p->currTime );
+	}
+
+	Element* elm = target_.element();
+	const double* fired = &s_[FIRED][0];
+	for ( unsigned int i = 0; i < numNeurons_; ++i ) {
+		if ( fired[i] != 0.0 )
+			IntFireBase::spikeOut()->send( Eref( elm, start_ + i ),
+							p->currTime );
+	}
+	if ( elm->hasMsgs( CompartmentBase::VmOut()->getBindIndex() ) ) {
+		for ( unsigned int i = 0; i < numNeurons_; ++i )
+			CompartmentBase::VmOut()->send( Eref( elm, start_ + i ),
+							s_[VM][i] );
+	}
+}
+
+void LIFSolver::reinit( const Eref& e, ProcPtr p )
+{
+	dt_ = p->dt;
+	general_.clear();
+	for ( unsigned int i = 0; i < numNeurons_; ++i ) {
+		s_[ACTIVATION][i] = 0.0;
+		s_[FIRED][i] = 0.0;
+		s_[LAST_EVENT][i] = -s_[REFRACT_T][i]; // Allow it to fire at once.
+		s_[VM][i] = s_[INIT_VM][i];
+		s_[LIFSolver::A][i] = 0.0;
+		s_[LIFSolver::B][i] = s_[INV_RM][i];
+		s_[IM][i] = 0.0;
+		s_[LAST_IM][i] = 0.0;
+		s_[SUM_INJECT][i] = 0.0;
+		rng_[i].setSeed( seed_[i], start_ + i );
+		s_[GENERAL][i] = 0.0;
+		if ( !( s_[INV_RM][i] > EPSILON ) )
+			setGeneral( i );
+		updateDecay( i );
+	}
+	if ( model_ == ADEXIF_MODEL )
+		s_[W].assign( numNeurons_, 0.0 );
+	else if ( model_ == ADTHRESHIF_MODEL )
+		s_[THRESH_ADAPTIVE].assign( numNeurons_, 0.0 );
+	else if ( model_ == IZHIF_MODEL )
+		s_[U] = s_[U_INIT];
+	if ( numNeurons_ == 0 )
+		return;
+	Element* elm = target_.element();
+	if ( elm->hasMsgs( CompartmentBase::VmOut()->getBindIndex() ) ) {
+		for ( unsigned int i = 0; i < numNeurons_; ++i )
+			CompartmentBase::VmOut()->send( Eref( elm, start_ + i ),
+							s_[VM][i] );
+	}
+}
@@ -0,0 +1,142 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _LIF_SOLVER_H
+#define _LIF_SOLVER_H
+
+namespace moose
+{
+/**
+ * LIFSolver advances a whole array of integrate-and-fire neurons
+ * together. The array may be of any of the IntFireBase classes: LIF,
+ * ExIF, AdExIF, QIF, AdThreshIF or IzhIF. It turns the target array into
+ * zombies of its class, and keeps their state as one vector per field,
+ * so that each timestep is a few loops over the population rather than
+ * a process call per neuron. Spikes still go out from each neuron
+ * through spikeOut, but Vm is only sent out if something is listening
+ * on VmOut; otherwise it is just read on demand from the zombies.
+ *
+ * LIFs go through a branch-free loop using decay factors worked out
+ * in advance, which needs the only conductance to be 1/Rm. A LIF which
+ * gets a conductance from a channel, or whose 1/Rm is too small for the
+ * exponential Euler step, is instead integrated on its own as
+ * LIF::vProcess does. This holds for that neuron until the next reinit,
+ * as channels send their conductance on every step. The other classes
+ * are always integrated a neuron at a time, following their own
+ * vProcess.
+ */
+class LIFSolver
+{
+	public:
+		/**
+		 * The fields held for each neuron, one vector each. Those
+		 * after NUM_COMMON are only kept for the classes that have them.
+		 */
+		enum Field {
+			VM, INIT_VM, EM, CM, RM, INV_RM, INJECT, SUM_INJECT, IM,
+			LAST_IM, A, B, THRESH, V_RESET, REFRACT_T, LAST_EVENT,
+			ACTIVATION, DECAY, FIRED, GENERAL, NUM_COMMON = GENERAL + 1,
+			DELTA_THRESH = NUM_COMMON, V_PEAK, W, TAU_W, A0, B0, C0,
+			V_CRITICAL, THRESH_ADAPTIVE, TAU_THRESH, THRESH_JUMP,
+			IZH_A, IZH_B, IZH_D, U, U_INIT, NUM_FIELDS
+		};
+
+		/// The neuron classes handled, one per solver.
+		enum Model {
+			LIF_MODEL, EXIF_MODEL, ADEXIF_MODEL, QIF_MODEL,
+			ADTHRESHIF_MODEL, IZHIF_MODEL, NUM_MODELS
+		};
+
+		LIFSolver();
+		~LIFSolver();
+
+		//////////////////////////////////////////////////////////////
+		// Field assignment stuff
+		//////////////////////////////////////////////////////////////
+		/**
+		 * Zombifies the neuron array target, first restoring any
+		 * previous target. Id() just restores the previous target.
+		 */
+		void setTarget( const Eref& e, Id target );
+		Id getTarget( const Eref& e ) const;
+		unsigned int getNumNeurons() const;
+
+		//////////////////////////////////////////////////////////////
+		// Dest funcs
+		//////////////////////////////////////////////////////////////
+		void process( const Eref& e, ProcPtr p );
+		void reinit( const Eref& e, ProcPtr p );
+		/// Turns the zombies back into the class they started as.
+		void unzombify();
+
+		//////////////////////////////////////////////////////////////
+		// Access for the zombies, by the Eref of the neuron.
+		//////////////////////////////////////////////////////////////
+		double get( const Eref& e, Field f ) const;
+		void set( const Eref& e, Field f, double v );
+		void activation( const Eref& e, double v );
+		void injectMsg( const Eref& e, double current );
+		void randInject( const Eref& e, double prob, double current );
+		void handleChannel( const Eref& e, double Gk, double Ek );
+		void setSeed( const Eref& e, long seed );
+		long getSeed( const Eref& e ) const;
+
+		/**
+		 * Returns the zombie class for neurons of class c, and sets
+		 * model to the way they are integrated. Returns 0 if c cannot
+		 * be solved.
+		 */
+		static const Cinfo* zombieClass( const Cinfo* c, Model& model );
+
+		static const Cinfo* initCinfo();
+	private:
+		/// Updates DECAY for neuron i from its Rm and Cm.
+		void updateDecay( unsigned int i );
+
+		/**
+		 * Takes LIF neuron i out of the branch-free loop, until reinit.
+		 */
+		void setGeneral( unsigned int i );
+
+		/**
+		 * Integrates all LIFs which are not flagged GENERAL, using the
+		 * decay factors worked out at reinit. The branches of
+		 * LIF::vProcess are written as selects over the field vectors,
+		 * so the loop has no data-dependent jumps.
+		 */
+		void advanceLeaky( double t );
+
+		/// Integrates neuron i following the vProcess of its class.
+		void advanceNeuron( unsigned int i, double t );
+
+		/**
+		 * The exponential Euler step of Compartment::vProcess, and the
+		 * clearing of the inputs which follows it.
+		 */
+		void advanceCompartment( unsigned int i );
+
+		Id target_;
+		/// The class the target had before it was zombified.
+		const Cinfo* origClass_;
+		Model model_;
+		/// Data index of the first local neuron of the target.
+		unsigned int start_;
+		unsigned int numNeurons_;
+		double dt_;
+		/// LIFs integrated by advanceNeuron, those flagged GENERAL.
+		vector< unsigned int > general_;
+		vector< double > s_[ NUM_FIELDS ];
+		/// Seed of each neuron's randInject stream, 0 for mtrand.
+		vector< long > seed_;
+		/// The randInject streams, restarted at reinit as in Compartment.
+		vector< CounterRng > rng_;
+};
+}
+
+#endif // _LIF_SOLVER_H
@@ -121,6 +121,19 @@ void QIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void QIF::vGetModelFields( const Eref& e, vector< double >& ret ) const
+{
+	ret.push_back( getVCritical( e ) );
+	ret.push_back( getA0( e ) );
+}
+
+void QIF::vSetModelFields( const Eref& e, const double** buf )
+{
+	setVCritical( e, (*buf)[0] );
+	setA0( e, (*buf)[1] );
+	*buf += 2;
+}
+
 void QIF::setVCritical( const Eref& e, double val )
 {
 	vCritical_ = val;
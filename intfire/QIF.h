@@ -24,10 +24,12 @@ class QIF: public IntFireBase
 			QIF();
 			virtual ~QIF();
             
-			void setVCritical( const Eref& e,  double val );
-			double getVCritical( const Eref& e  ) const;
-			void setA0( const Eref& e,  double val );
-			double getA0( const Eref& e  ) const;
+			// These are virtual so that zombies can keep the fields
+			// in a solver.
+			virtual void setVCritical( const Eref& e,  double val );
+			virtual double getVCritical( const Eref& e  ) const;
+			virtual void setA0( const Eref& e,  double val );
+			virtual double getA0( const Eref& e  ) const;
 
 			/**
 			 * The process function does the object updating and sends out
@@ -40,6 +42,11 @@ class QIF: public IntFireBase
 			 */
 			void vReinit( const Eref& e, ProcPtr p );
 
+			/// The QIF fields, for IntFireBase::zombify.
+			void vGetModelFields( const Eref& e, vector< double >& ret )
+					const;
+			void vSetModelFields( const Eref& e, const double** buf );
+
 			/**
 			 * Initializes the class info.
 			 */
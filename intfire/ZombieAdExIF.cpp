@@ -0,0 +1,109 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "ElementValueFinfo.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "IntFireBase.h"
+#include "ExIF.h"
+#include "AdExIF.h"
+#include "LIFSolver.h"
+#include "ZombieIntFire.h"
+#include "ZombieAdExIF.h"
+
+using namespace moose;
+
+const Cinfo* ZombieAdExIF::initCinfo()
+{
+	static string doc[] =
+	{
+		"Name", "ZombieAdExIF",
+		"Author", "Upi Bhalla",
+		"Description", "AdExIF neuron whose calculations are done by a "
+		"LIFSolver, along with the rest of its array."
+	};
+	static Dinfo< ZombieAdExIF > dinfo;
+	static Cinfo zombieAdExIFCinfo(
+				"ZombieAdExIF",
+				AdExIF::initCinfo(),
+				0, 0,
+				&dinfo,
+				doc,
+				sizeof(doc)/sizeof(string)
+	);
+
+	return &zombieAdExIFCinfo;
+}
+
+static const Cinfo* zombieAdExIFCinfo = ZombieAdExIF::initCinfo();
+
+//////////////////////////////////////////////////////////////////
+// Here we put the ZombieAdExIF class functions.
+//////////////////////////////////////////////////////////////////
+
+void ZombieAdExIF::setDeltaThresh( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::DELTA_THRESH, val );
+}
+
+double ZombieAdExIF::getDeltaThresh( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::DELTA_THRESH );
+}
+
+void ZombieAdExIF::setVPeak( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::V_PEAK, val );
+}
+
+double ZombieAdExIF::getVPeak( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::V_PEAK );
+}
+
+void ZombieAdExIF::setW( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::W, val );
+}
+
+double ZombieAdExIF::getW( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::W );
+}
+
+void ZombieAdExIF::setTauW( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::TAU_W, val );
+}
+
+double ZombieAdExIF::getTauW( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::TAU_W );
+}
+
+void ZombieAdExIF::setA0( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::A0, val );
+}
+
+double ZombieAdExIF::getA0( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::A0 );
+}
+
+void ZombieAdExIF::setB0( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::B0, val );
+}
+
+double ZombieAdExIF::getB0( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::B0 );
+}
@@ -0,0 +1,40 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ZOMBIE_ADEXIF_H
+#define _ZOMBIE_ADEXIF_H
+
+namespace moose
+{
+/**
+ * Zombie AdExIF whose state lives in a LIFSolver, along with the rest
+ * of its array. The AdExIF fields go through to the solver as well.
+ */
+class ZombieAdExIF: public ZombieIntFire< AdExIF >
+{
+	public:
+		// ExIF and AdExIF fields handled by the solver.
+		void setDeltaThresh( const Eref& e, double val );
+		double getDeltaThresh( const Eref& e ) const;
+		void setVPeak( const Eref& e, double val );
+		double getVPeak( const Eref& e ) const;
+		void setW( const Eref& e, double val );
+		double getW( const Eref& e ) const;
+		void setTauW( const Eref& e, double val );
+		double getTauW( const Eref& e ) const;
+		void setA0( const Eref& e, double val );
+		double getA0( const Eref& e ) const;
+		void setB0( const Eref& e, double val );
+		double getB0( const Eref& e ) const;
+
+		static const Cinfo* initCinfo();
+};
+}
+
+#endif // _ZOMBIE_ADEXIF_H
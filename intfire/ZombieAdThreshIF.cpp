@@ -0,0 +1,88 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "ElementValueFinfo.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "IntFireBase.h"
+#include "AdThreshIF.h"
+#include "LIFSolver.h"
+#include "ZombieIntFire.h"
+#include "ZombieAdThreshIF.h"
+
+using namespace moose;
+
+const Cinfo* ZombieAdThreshIF::initCinfo()
+{
+	static string doc[] =
+	{
+		"Name", "ZombieAdThreshIF",
+		"Author", "Upi Bhalla",
+		"Description", "AdThreshIF neuron whose calculations are done by a "
+		"LIFSolver, along with the rest of its array."
+	};
+	static Dinfo< ZombieAdThreshIF > dinfo;
+	static Cinfo zombieAdThreshIFCinfo(
+				"ZombieAdThreshIF",
+				AdThreshIF::initCinfo(),
+				0, 0,
+				&dinfo,
+				doc,
+				sizeof(doc)/sizeof(string)
+	);
+
+	return &zombieAdThreshIFCinfo;
+}
+
+static const Cinfo* zombieAdThreshIFCinfo = ZombieAdThreshIF::initCinfo();
+
+//////////////////////////////////////////////////////////////////
+// Here we put the ZombieAdThreshIF class functions.
+//////////////////////////////////////////////////////////////////
+
+void ZombieAdThreshIF::setThreshAdaptive( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::THRESH_ADAPTIVE, val );
+}
+
+double ZombieAdThreshIF::getThreshAdaptive( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::THRESH_ADAPTIVE );
+}
+
+void ZombieAdThreshIF::setTauThresh( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::TAU_THRESH, val );
+}
+
+double ZombieAdThreshIF::getTauThresh( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::TAU_THRESH );
+}
+
+void ZombieAdThreshIF::setA0( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::A0, val );
+}
+
+double ZombieAdThreshIF::getA0( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::A0 );
+}
+
+void ZombieAdThreshIF::setThreshJump( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::THRESH_JUMP, val );
+}
+
+double ZombieAdThreshIF::getThreshJump( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::THRESH_JUMP );
+}
@@ -0,0 +1,36 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ZOMBIE_ADTHRESHIF_H
+#define _ZOMBIE_ADTHRESHIF_H
+
+namespace moose
+{
+/**
+ * Zombie AdThreshIF whose state lives in a LIFSolver, along with the rest
+ * of its array. The AdThreshIF fields go through to the solver as well.
+ */
+class ZombieAdThreshIF: public ZombieIntFire< AdThreshIF >
+{
+	public:
+		// AdThreshIF fields handled by the solver.
+		void setThreshAdaptive( const Eref& e, double val );
+		double getThreshAdaptive( const Eref& e ) const;
+		void setTauThresh( const Eref& e, double val );
+		double getTauThresh( const Eref& e ) const;
+		void setA0( const Eref& e, double val );
+		double getA0( const Eref& e ) const;
+		void setThreshJump( const Eref& e, double val );
+		double getThreshJump( const Eref& e ) const;
+
+		static const Cinfo* initCinfo();
+};
+}
+
+#endif // _ZOMBIE_ADTHRESHIF_H
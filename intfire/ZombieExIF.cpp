@@ -0,0 +1,68 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "ElementValueFinfo.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "IntFireBase.h"
+#include "ExIF.h"
+#include "LIFSolver.h"
+#include "ZombieIntFire.h"
+#include "ZombieExIF.h"
+
+using namespace moose;
+
+const Cinfo* ZombieExIF::initCinfo()
+{
+	static string doc[] =
+	{
+		"Name", "ZombieExIF",
+		"Author", "Upi Bhalla",
+		"Description", "ExIF neuron whose calculations are done by a "
+		"LIFSolver, along with the rest of its array."
+	};
+	static Dinfo< ZombieExIF > dinfo;
+	static Cinfo zombieExIFCinfo(
+				"ZombieExIF",
+				ExIF::initCinfo(),
+				0, 0,
+				&dinfo,
+				doc,
+				sizeof(doc)/sizeof(string)
+	);
+
+	return &zombieExIFCinfo;
+}
+
+static const Cinfo* zombieExIFCinfo = ZombieExIF::initCinfo();
+
+//////////////////////////////////////////////////////////////////
+// Here we put the ZombieExIF class functions.
+//////////////////////////////////////////////////////////////////
+
+void ZombieExIF::setDeltaThresh( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::DELTA_THRESH, val );
+}
+
+double ZombieExIF::getDeltaThresh( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::DELTA_THRESH );
+}
+
+void ZombieExIF::setVPeak( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::V_PEAK, val );
+}
+
+double ZombieExIF::getVPeak( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::V_PEAK );
+}
@@ -0,0 +1,32 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ZOMBIE_EXIF_H
+#define _ZOMBIE_EXIF_H
+
+namespace moose
+{
+/**
+ * Zombie ExIF whose state lives in a LIFSolver, along with the rest
+ * of its array. The ExIF fields go through to the solver as well.
+ */
+class ZombieExIF: public ZombieIntFire< ExIF >
+{
+	public:
+		// ExIF fields handled by the solver.
+		void setDeltaThresh( const Eref& e, double val );
+		double getDeltaThresh( const Eref& e ) const;
+		void setVPeak( const Eref& e, double val );
+		double getVPeak( const Eref& e ) const;
+
+		static const Cinfo* initCinfo();
+};
+}
+
+#endif // _ZOMBIE_EXIF_H
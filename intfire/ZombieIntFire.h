@@ -0,0 +1,143 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ZOMBIE_INT_FIRE_H
+#define _ZOMBIE_INT_FIRE_H
+
+namespace moose
+{
+/**
+ * Zombie of the IntFireBase derived class T, whose state lives in a
+ * LIFSolver. The Compartment and IntFireBase fields, and the incoming
+ * synaptic, injection and channel messages, all go through to the
+ * solver, which also does the process and reinit. Each zombie class
+ * derives from this, and also routes the fields particular to T.
+ * Deriving from T means that the zombie has the same fields and
+ * messages as T, and that IntFireBase::zombify can carry them over.
+ */
+template< class T > class ZombieIntFire: public T
+{
+	public:
+		ZombieIntFire()
+			: solver_( 0 )
+		{;}
+
+		// Compartment fields handled by the solver.
+		void vSetVm( const Eref& e, double Vm ) {
+			solver_->set( e, LIFSolver::VM, Vm );
+		}
+		double vGetVm( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::VM );
+		}
+		void vSetEm( const Eref& e, double Em ) {
+			solver_->set( e, LIFSolver::EM, Em );
+		}
+		double vGetEm( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::EM );
+		}
+		void vSetCm( const Eref& e, double Cm ) {
+			if ( this->rangeWarning( "Cm", Cm ) ) return;
+			solver_->set( e, LIFSolver::CM, Cm );
+		}
+		double vGetCm( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::CM );
+		}
+		void vSetRm( const Eref& e, double Rm ) {
+			if ( this->rangeWarning( "Rm", Rm ) ) return;
+			solver_->set( e, LIFSolver::RM, Rm );
+		}
+		double vGetRm( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::RM );
+		}
+		double vGetIm( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::LAST_IM );
+		}
+		void vSetInject( const Eref& e, double inject ) {
+			solver_->set( e, LIFSolver::INJECT, inject );
+		}
+		double vGetInject( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::INJECT );
+		}
+		void vSetInitVm( const Eref& e, double initVm ) {
+			solver_->set( e, LIFSolver::INIT_VM, initVm );
+		}
+		double vGetInitVm( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::INIT_VM );
+		}
+		void setSeed( const Eref& e, long seed ) {
+			solver_->setSeed( e, seed );
+		}
+		long getSeed( const Eref& e ) const {
+			return solver_->getSeed( e );
+		}
+
+		// IntFireBase fields handled by the solver.
+		void setThresh( const Eref& e, double val ) {
+			solver_->set( e, LIFSolver::THRESH, val );
+		}
+		double getThresh( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::THRESH );
+		}
+		void setVReset( const Eref& e, double val ) {
+			solver_->set( e, LIFSolver::V_RESET, val );
+		}
+		double getVReset( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::V_RESET );
+		}
+		void setRefractoryPeriod( const Eref& e, double val ) {
+			solver_->set( e, LIFSolver::REFRACT_T, val );
+		}
+		double getRefractoryPeriod( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::REFRACT_T );
+		}
+		double getLastEventTime( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::LAST_EVENT );
+		}
+		bool hasFired( const Eref& e ) const {
+			return solver_->get( e, LIFSolver::FIRED ) != 0.0;
+		}
+
+		// Dest functions. Process and reinit are done by the solver.
+		void vProcess( const Eref& e, ProcPtr p )
+		{;}
+		void vReinit( const Eref& e, ProcPtr p )
+		{;}
+		void vInitProc( const Eref& e, ProcPtr p )
+		{;}
+		void vInitReinit( const Eref& e, ProcPtr p )
+		{;}
+		void vHandleChannel( const Eref& e, double Gk, double Ek ) {
+			solver_->handleChannel( e, Gk, Ek );
+		}
+		void vInjectMsg( const Eref& e, double current ) {
+			solver_->injectMsg( e, current );
+		}
+		void vRandInject( const Eref& e, double prob, double current ) {
+			solver_->randInject( e, prob, current );
+		}
+		void activation( const Eref& e, double val ) {
+			solver_->activation( e, val );
+		}
+
+		void vSetSolver( const Eref& e, ObjId solver ) {
+			if ( !solver.element()->cinfo()->isA( "LIFSolver" ) ) {
+				cout << "Error: ZombieIntFire::vSetSolver: Object: " <<
+					solver.path() << " is not a LIFSolver. Aborted\n";
+				solver_ = 0;
+				return;
+			}
+			solver_ = reinterpret_cast< LIFSolver* >( solver.data() );
+		}
+
+	protected:
+		LIFSolver* solver_;
+};
+}
+
+#endif // _ZOMBIE_INT_FIRE_H
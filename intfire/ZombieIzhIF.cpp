@@ -0,0 +1,138 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "ElementValueFinfo.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "IntFireBase.h"
+#include "IzhIF.h"
+#include "LIFSolver.h"
+#include "ZombieIntFire.h"
+#include "ZombieIzhIF.h"
+
+using namespace moose;
+
+const Cinfo* ZombieIzhIF::initCinfo()
+{
+	static string doc[] =
+	{
+		"Name", "ZombieIzhIF",
+		"Author", "Upi Bhalla",
+		"Description", "IzhIF neuron whose calculations are done by a "
+		"LIFSolver, along with the rest of its array."
+	};
+	static Dinfo< ZombieIzhIF > dinfo;
+	static Cinfo zombieIzhIFCinfo(
+				"ZombieIzhIF",
+				IzhIF::initCinfo(),
+				0, 0,
+				&dinfo,
+				doc,
+				sizeof(doc)/sizeof(string)
+	);
+
+	return &zombieIzhIFCinfo;
+}
+
+static const Cinfo* zombieIzhIFCinfo = ZombieIzhIF::initCinfo();
+
+//////////////////////////////////////////////////////////////////
+// Here we put the ZombieIzhIF class functions.
+//////////////////////////////////////////////////////////////////
+
+void ZombieIzhIF::setA0( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::A0, val );
+}
+
+double ZombieIzhIF::getA0( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::A0 );
+}
+
+void ZombieIzhIF::setB0( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::B0, val );
+}
+
+double ZombieIzhIF::getB0( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::B0 );
+}
+
+void ZombieIzhIF::setC0( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::C0, val );
+}
+
+double ZombieIzhIF::getC0( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::C0 );
+}
+
+void ZombieIzhIF::setA( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::IZH_A, val );
+}
+
+double ZombieIzhIF::getA( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::IZH_A );
+}
+
+void ZombieIzhIF::setB( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::IZH_B, val );
+}
+
+double ZombieIzhIF::getB( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::IZH_B );
+}
+
+void ZombieIzhIF::setD( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::IZH_D, val );
+}
+
+double ZombieIzhIF::getD( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::IZH_D );
+}
+
+void ZombieIzhIF::setVPeak( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::V_PEAK, val );
+}
+
+double ZombieIzhIF::getVPeak( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::V_PEAK );
+}
+
+void ZombieIzhIF::setU( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::U, val );
+}
+
+double ZombieIzhIF::getU( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::U );
+}
+
+void ZombieIzhIF::setUInit( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::U_INIT, val );
+}
+
+double ZombieIzhIF::getUInit( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::U_INIT );
+}
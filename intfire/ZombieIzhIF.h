@@ -0,0 +1,46 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ZOMBIE_IZHIF_H
+#define _ZOMBIE_IZHIF_H
+
+namespace moose
+{
+/**
+ * Zombie IzhIF whose state lives in a LIFSolver, along with the rest
+ * of its array. The IzhIF fields go through to the solver as well.
+ */
+class ZombieIzhIF: public ZombieIntFire< IzhIF >
+{
+	public:
+		// IzhIF fields handled by the solver.
+		void setA0( const Eref& e, double val );
+		double getA0( const Eref& e ) const;
+		void setB0( const Eref& e, double val );
+		double getB0( const Eref& e ) const;
+		void setC0( const Eref& e, double val );
+		double getC0( const Eref& e ) const;
+		void setA( const Eref& e, double val );
+		double getA( const Eref& e ) const;
+		void setB( const Eref& e, double val );
+		double getB( const Eref& e ) const;
+		void setD( const Eref& e, double val );
+		double getD( const Eref& e ) const;
+		void setVPeak( const Eref& e, double val );
+		double getVPeak( const Eref& e ) const;
+		void setU( const Eref& e, double val );
+		double getU( const Eref& e ) const;
+		void setUInit( const Eref& e, double val );
+		double getUInit( const Eref& e ) const;
+
+		static const Cinfo* initCinfo();
+};
+}
+
+#endif // _ZOMBIE_IZHIF_H
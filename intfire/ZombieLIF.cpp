@@ -0,0 +1,44 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "ElementValueFinfo.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "IntFireBase.h"
+#include "LIF.h"
+#include "LIFSolver.h"
+#include "ZombieIntFire.h"
+#include "ZombieLIF.h"
+
+using namespace moose;
+
+const Cinfo* ZombieLIF::initCinfo()
+{
+	static string doc[] =
+	{
+		"Name", "ZombieLIF",
+		"Author", "Upi Bhalla",
+		"Description", "LIF neuron whose calculations are done by a "
+		"LIFSolver, along with the rest of its array."
+	};
+	static Dinfo< ZombieLIF > dinfo;
+	static Cinfo zombieLIFCinfo(
+				"ZombieLIF",
+				LIF::initCinfo(),
+				0, 0,
+				&dinfo,
+				doc,
+				sizeof(doc)/sizeof(string)
+	);
+
+	return &zombieLIFCinfo;
+}
+
+static const Cinfo* zombieLIFCinfo = ZombieLIF::initCinfo();
@@ -0,0 +1,26 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ZOMBIE_LIF_H
+#define _ZOMBIE_LIF_H
+
+namespace moose
+{
+/**
+ * Zombie LIF whose state lives in a LIFSolver, along with the rest
+ * of its array.
+ */
+class ZombieLIF: public ZombieIntFire< LIF >
+{
+	public:
+		static const Cinfo* initCinfo();
+};
+}
+
+#endif // _ZOMBIE_LIF_H
@@ -0,0 +1,68 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "ElementValueFinfo.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "IntFireBase.h"
+#include "QIF.h"
+#include "LIFSolver.h"
+#include "ZombieIntFire.h"
+#include "ZombieQIF.h"
+
+using namespace moose;
+
+const Cinfo* ZombieQIF::initCinfo()
+{
+	static string doc[] =
+	{
+		"Name", "ZombieQIF",
+		"Author", "Upi Bhalla",
+		"Description", "QIF neuron whose calculations are done by a "
+		"LIFSolver, along with the rest of its array."
+	};
+	static Dinfo< ZombieQIF > dinfo;
+	static Cinfo zombieQIFCinfo(
+				"ZombieQIF",
+				QIF::initCinfo(),
+				0, 0,
+				&dinfo,
+				doc,
+				sizeof(doc)/sizeof(string)
+	);
+
+	return &zombieQIFCinfo;
+}
+
+static const Cinfo* zombieQIFCinfo = ZombieQIF::initCinfo();
+
+//////////////////////////////////////////////////////////////////
+// Here we put the ZombieQIF class functions.
+//////////////////////////////////////////////////////////////////
+
+void ZombieQIF::setVCritical( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::V_CRITICAL, val );
+}
+
+double ZombieQIF::getVCritical( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::V_CRITICAL );
+}
+
+void ZombieQIF::setA0( const Eref& e, double val )
+{
+	solver_->set( e, LIFSolver::A0, val );
+}
+
+double ZombieQIF::getA0( const Eref& e ) const
+{
+	return solver_->get( e, LIFSolver::A0 );
+}
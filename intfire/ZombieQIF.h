@@ -0,0 +1,32 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ZOMBIE_QIF_H
+#define _ZOMBIE_QIF_H
+
+namespace moose
+{
+/**
+ * Zombie QIF whose state lives in a LIFSolver, along with the rest
+ * of its array. The QIF fields go through to the solver as well.
+ */
+class ZombieQIF: public ZombieIntFire< QIF >
+{
+	public:
+		// QIF fields handled by the solver.
+		void setVCritical( const Eref& e, double val );
+		double getVCritical( const Eref& e ) const;
+		void setA0( const Eref& e, double val );
+		double getA0( const Eref& e ) const;
+
+		static const Cinfo* initCinfo();
+};
+}
+
+#endif // _ZOMBIE_QIF_H
@@ -22,7 +22,261 @@ void testIntFire()
 #endif
 }
 
+/**
+ * Builds an array of integrate-and-fire neurons of class cls, driven by
+ * their own injection and recurrently connected through a
+ * SimpleSynHandler. The parameters depend only on the index, so two
+ * calls make identical networks. In the LIF network every tenth
+ * neuron has too large an Rm for the exponential Euler method.
+ */
+static Id makeIntFireNetwork( Shell* shell, const string& cls,
+				const string& name, unsigned int size )
+{
+	Id lif = shell->doCreate( cls, Id(), name, size );
+	Id syns = shell->doCreate( "SimpleSynHandler", lif, "syns", size );
+	Id synId( syns.value() + 1 );
+	ObjId mid = shell->doAddMsg( "Sparse", lif, "spikeOut",
+		ObjId( synId, 0 ), "addSpike" );
+	SetGet2< double, long >::set( mid, "setRandomConnectivity",
+		0.1, 1234UL );
+	mid = shell->doAddMsg( "OneToOne", syns, "activationOut",
+		lif, "activation" );
+	assert( !mid.bad() );
+
+	vector< double > Rm( size, 1e8 );
+	vector< double > Cm( size );
+	vector< double > inject( size );
+	vector< double > initVm( size );
+	for ( unsigned int i = 0; i < size; ++i ) {
+		if ( cls == "LIF" && i % 10 == 3 )
+			Rm[i] = 1e16;
+		Cm[i] = 1e-10 * ( 1.0 + 0.01 * ( i % 7 ) );
+		if ( cls == "IzhIF" )
+			Cm[i] *= 0.3;
+		inject[i] = 1e-12 * ( 250 + ( i * 37 ) % 200 );
+		initVm[i] = -0.07 + 0.0002 * ( i % 50 );
+	}
+	Field< double >::setVec( lif, "Rm", Rm );
+	Field< double >::setVec( lif, "Cm", Cm );
+	Field< double >::setVec( lif, "inject", inject );
+	Field< double >::setVec( lif, "initVm", initVm );
+	Field< double >::setRepeat( lif, "Em", -0.07 );
+	Field< double >::setRepeat( lif, "thresh", -0.05 );
+	Field< double >::setRepeat( lif, "vReset", -0.07 );
+	Field< double >::setRepeat( lif, "refractoryPeriod", 0.002 );
+	if ( cls == "ExIF" || cls == "AdExIF" ) {
+		Field< double >::setRepeat( lif, "deltaThresh", 0.002 );
+		Field< double >::setRepeat( lif, "vPeak", 0.0 );
+	}
+	if ( cls == "AdExIF" ) {
+		Field< double >::setRepeat( lif, "a0", 1e-9 );
+		Field< double >::setRepeat( lif, "b0", 5e-11 );
+		Field< double >::setRepeat( lif, "tauW", 0.1 );
+	} else if ( cls == "QIF" ) {
+		Field< double >::setRepeat( lif, "thresh", -0.03 );
+		Field< double >::setRepeat( lif, "vCritical", -0.05 );
+		Field< double >::setRepeat( lif, "a0", 20.0 );
+	} else if ( cls == "AdThreshIF" ) {
+		Field< double >::setRepeat( lif, "a0", 0.1 );
+		Field< double >::setRepeat( lif, "tauThresh", 0.05 );
+		Field< double >::setRepeat( lif, "threshJump", 0.005 );
+	} else if ( cls == "IzhIF" ) {
+		Field< double >::setRepeat( lif, "a", 20.0 );
+		Field< double >::setRepeat( lif, "b", 200.0 );
+		Field< double >::setRepeat( lif, "d", 8.0 );
+		Field< double >::setRepeat( lif, "vPeak", 0.03 );
+		Field< double >::setRepeat( lif, "uInit", -14.0 );
+	}
+
+	vector< unsigned int > numSyn;
+	Field< unsigned int >::getVec( syns, "numSynapses", numSyn );
+	assert( numSyn.size() == size );
+	for ( unsigned int i = 0; i < size; ++i ) {
+		vector< double > weight( numSyn[i] );
+		vector< double > delay( numSyn[i] );
+		for ( unsigned int j = 0; j < numSyn[i]; ++j ) {
+			weight[j] = 0.001 * ( 1 + ( i + j ) % 5 );
+			delay[j] = 0.001 * ( 1 + ( i * j ) % 4 );
+		}
+		Field< double >::setVec( ObjId( synId, i ), "weight", weight );
+		Field< double >::setVec( ObjId( synId, i ), "delay", delay );
+	}
+	return lif;
+}
+
+/**
+ * Runs the same network of class cls as plain objects and under a
+ * LIFSolver, and checks that the two give the same Vm and spike times.
+ * For the classes which have some other state that changes as they
+ * run, this must also be the same. Then checks that unzombifying puts
+ * back the fields.
+ */
+static void testLIFSolver( const string& cls, const string& state )
+{
+	const unsigned int size = 100;
+	const double dt = 1e-4;
+	Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+	Id lif = makeIntFireNetwork( shell, cls, "lif", size );
+	Id zlif = makeIntFireNetwork( shell, cls, "zlif", size );
+	Id solver = shell->doCreate( "LIFSolver", Id(), "lifSolver", 1 );
+	Field< Id >::set( solver, "target", zlif );
+	assert( Field< Id >::get( solver, "target" ) == zlif );
+	assert( Field< unsigned int >::get( solver, "numNeurons" ) == size );
+	assert( zlif.element()->cinfo()->name() == "Zombie" + cls );
+	assert( zlif.element()->cinfo()->isA( cls ) );
+	assert( doubleEq( Field< double >::get( ObjId( zlif, 7 ), "Cm" ),
+				Field< double >::get( ObjId( lif, 7 ), "Cm" ) ) );
+	assert( doubleEq( Field< double >::get( ObjId( zlif, 7 ), "thresh" ),
+				Field< double >::get( ObjId( lif, 7 ), "thresh" ) ) );
+
+	for ( unsigned int i = 0; i < 10; ++i )
+		shell->doSetClock( i, dt );
+	shell->doReinit();
+	shell->doStart( 0.1 );
+
+	vector< double > Vm;
+	vector< double > zVm;
+	vector< double > t;
+	vector< double > zt;
+	vector< double > x;
+	vector< double > zx;
+	Field< double >::getVec( lif, "Vm", Vm );
+	Field< double >::getVec( zlif, "Vm", zVm );
+	Field< double >::getVec( lif, "lastEventTime", t );
+	Field< double >::getVec( zlif, "lastEventTime", zt );
+	if ( state != "" ) {
+		Field< double >::getVec( lif, state, x );
+		Field< double >::getVec( zlif, state, zx );
+	}
+	assert( Vm.size() == size && zVm.size() == size );
+	assert( x.size() == zx.size() );
+	unsigned int numFired = 0;
+	for ( unsigned int i = 0; i < size; ++i ) {
+		assert( doubleEq( Vm[i], zVm[i] ) );
+		assert( doubleEq( t[i], zt[i] ) );
+		if ( t[i] > 0.0 )
+			numFired++;
+	}
+	assert( numFired > size / 2 );
+
+	Field< Id >::set( solver, "target", Id() );
+	assert( zlif.element()->cinfo()->name() == cls );
+	assert( Field< unsigned int >::get( solver, "numNeurons" ) == 0 );
+	Field< double >::getVec( zlif, "Vm", zVm );
+	for ( unsigned int i = 0; i < size; ++i )
+		assert( doubleEq( Vm[i], zVm[i] ) );
+	if ( state != "" ) {
+		Field< double >::getVec( zlif, state, zx );
+		for ( unsigned int i = 0; i < size; ++i ) {
+			assert( doubleEq( x[i], zx[i] ) );
+			assert( x[i] != 0.0 );
+		}
+	}
+	assert( doubleEq( Field< double >::get( ObjId( zlif, 7 ), "Cm" ),
+				Field< double >::get( ObjId( lif, 7 ), "Cm" ) ) );
+	assert( doubleEq( Field< double >::get(
+				ObjId( zlif, 7 ), "refractoryPeriod" ), 0.002 ) );
+
+	shell->doDelete( solver );
+	shell->doDelete( zlif );
+	shell->doDelete( lif );
+	cout << "." << flush;
+}
+
+/**
+ * Checks that the solver turns down a target it cannot solve, and
+ * leaves it alone.
+ */
+static void testLIFSolverBadTarget()
+{
+	Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+	Id comp = shell->doCreate( "Compartment", Id(), "comp", 10 );
+	Id solver = shell->doCreate( "LIFSolver", Id(), "lifSolver", 1 );
+	Field< Id >::set( solver, "target", comp );
+	assert( Field< Id >::get( solver, "target" ) == Id() );
+	assert( Field< unsigned int >::get( solver, "numNeurons" ) == 0 );
+	assert( comp.element()->cinfo()->name() == "Compartment" );
+	shell->doDelete( solver );
+	shell->doDelete( comp );
+	cout << "." << flush;
+}
+
+/**
+ * Gives Compartments, LIFs and solved LIFs the same seed, so entry i
+ * of each draws the same randInject numbers. Checks that the same
+ * entries get the current in all three, that the streams restart on
+ * reinit, and that a different seed picks different entries.
+ */
+static void testRandInjectStreams()
+{
+	const unsigned int size = 100;
+	const double dt = 1e-4;
+	Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+	Id comp = shell->doCreate( "Compartment", Id(), "comp", size );
+	Id lif = shell->doCreate( "LIF", Id(), "lif", size );
+	Id zlif = shell->doCreate( "LIF", Id(), "zlif", size );
+	Id cells[] = { comp, lif, zlif };
+	for ( unsigned int j = 0; j < 3; ++j ) {
+		// The injection moves Vm by about 10 mV in one step.
+		Field< double >::setRepeat( cells[j], "Rm", 1e9 );
+		Field< double >::setRepeat( cells[j], "Cm", 1e-11 );
+		Field< long >::setRepeat( cells[j], "seed", 1234 );
+	}
+	Id solver = shell->doCreate( "LIFSolver", Id(), "lifSolver", 1 );
+	Field< Id >::set( solver, "target", zlif );
+	assert( Field< long >::get( ObjId( zlif, 7 ), "seed" ) == 1234 );
+
+	for ( unsigned int i = 0; i < 10; ++i )
+		shell->doSetClock( i, dt );
+	vector< bool > first;
+	for ( unsigned int pass = 0; pass < 3; ++pass ) {
+		if ( pass == 2 )
+			Field< long >::setRepeat( zlif, "seed", 4321 );
+		shell->doReinit();
+		for ( unsigned int j = 0; j < 3; ++j )
+			for ( unsigned int i = 0; i < size; ++i )
+				SetGet2< double, double >::set( ObjId( cells[j], i ),
+					"randInject", 0.5 / dt, 1e-9 );
+		shell->doStart( dt );
+		vector< bool > injected[3];
+		for ( unsigned int j = 0; j < 3; ++j ) {
+			vector< double > Vm;
+			Field< double >::getVec( cells[j], "Vm", Vm );
+			assert( Vm.size() == size );
+			for ( unsigned int i = 0; i < size; ++i )
+				injected[j].push_back( Vm[i] > -0.055 );
+		}
+		unsigned int numInjected = 0;
+		for ( unsigned int i = 0; i < size; ++i )
+			numInjected += injected[0][i];
+		assert( numInjected > size / 4 && numInjected < 3 * size / 4 );
+		assert( injected[1] == injected[0] );
+		if ( pass < 2 )
+			assert( injected[2] == injected[0] );
+		else
+			assert( injected[2] != injected[0] );
+		if ( pass == 0 )
+			first = injected[0];
+		else
+			assert( injected[0] == first );
+	}
+
+	shell->doDelete( solver );
+	shell->doDelete( zlif );
+	shell->doDelete( lif );
+	shell->doDelete( comp );
+	cout << "." << flush;
+}
+
 // This is applicable to tests that use the messaging and scheduling.
 void testIntFireProcess()
 {
+	testLIFSolver( "LIF", "" );
+	testLIFSolver( "ExIF", "" );
+	testLIFSolver( "AdExIF", "w" );
+	testLIFSolver( "QIF", "" );
+	testLIFSolver( "AdThreshIF", "threshAdaptive" );
+	testLIFSolver( "IzhIF", "u" );
+	testLIFSolverBadTarget();
+	testRandInjectStreams();
 }
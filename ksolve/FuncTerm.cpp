@@ -20,7 +20,10 @@
  */
 
 #include <vector>
+#include <map>
+#include <string>
 #include <sstream>
+#include <cassert>
 using namespace std;
 
 #include "muParser.h"
@@ -60,6 +63,7 @@ void FuncTerm::setReactantIndex( const vector< unsigned int >& mol )
 	// Define a 't' variable even if we don't always use it.
 	args_[mol.size()] = 0.0;
 	parser_.DefineVar( "t", &args_[mol.size()] );
+	compile();
 }
 
 const vector< unsigned int >& FuncTerm::getReactantIndex() const
@@ -94,6 +98,32 @@ void FuncTerm::setExpr( const string& expr )
 		//_clearBuffer();
 		return;
 	}
+	compile();
+}
+
+/**
+ * The compiled program reads the arguments straight out of S, rather
+ * than copying them into args_ for the parser. This also means that
+ * compiled FuncTerms can be evaluated from several threads at once.
+ */
+void FuncTerm::compile()
+{
+	program_.clear();
+	if ( !args_ || expr_.empty() )
+		return;
+	map< string, ExprProgram::Var > vars;
+	for ( unsigned int i = 0; i < reactantIndex_.size(); ++i ) {
+		stringstream ss;
+		ss << "x" << i;
+		vars[ ss.str() ] = ExprProgram::Var::arg( reactantIndex_[i] );
+	}
+	vars[ "t" ] = ExprProgram::Var::time();
+	program_.compile( expr_, parser_.GetConst(), vars );
+}
+
+bool FuncTerm::isCompiled() const
+{
+	return program_.isCompiled();
 }
 
 const string& FuncTerm::getExpr() const
@@ -129,6 +159,8 @@ double FuncTerm::operator() ( const double* S, double t ) const
 {
 	if ( !args_ )
 		return 0.0;
+	if ( program_.isCompiled() )
+		return program_.eval( S, t );
 	unsigned int i;
 	for ( i = 0; i < reactantIndex_.size(); ++i )
 		args_[i] = S[reactantIndex_[i]];
@@ -140,9 +172,29 @@ void FuncTerm::evalPool( double* S, double t ) const
 {
 	if ( !args_ || target_ == ~0U )
 		return;
+	if ( program_.isCompiled() ) {
+		S[ target_ ] = program_.eval( S, t );
+		return;
+	}
 	unsigned int i;
 	for ( i = 0; i < reactantIndex_.size(); ++i )
 		args_[i] = S[reactantIndex_[i]];
 	args_[i] = t;
 	S[ target_] = parser_.Eval();
 }
+
+void FuncTerm::evalPoolBulk( double* const* S, unsigned int numVoxels,
+				double t ) const
+{
+	if ( !args_ || target_ == ~0U || numVoxels == 0 )
+		return;
+	if ( !program_.isCompiled() ) {
+		for ( unsigned int i = 0; i < numVoxels; ++i )
+			evalPool( S[i], t );
+		return;
+	}
+	vector< double > ret( numVoxels );
+	program_.evalBulk( S, numVoxels, t, &ret[0] );
+	for ( unsigned int i = 0; i < numVoxels; ++i )
+		S[i][ target_ ] = ret[i];
+}
@@ -11,6 +11,7 @@
 #define _FUNC_TERM_H
 
 #include "../external/muparser/muParser.h"
+#include "../builtins/ExprProgram.h"
 class FuncTerm
 {
 	public:
@@ -24,6 +25,14 @@ class FuncTerm
 		const FuncTerm& operator=( const FuncTerm& other );
 
 		void evalPool( double* s, double t ) const;
+		/**
+		 * Does evalPool on each of the numVoxels pool vectors in S,
+		 * evaluating the expression for all of them in one pass.
+		 */
+		void evalPoolBulk( double* const* S, unsigned int numVoxels,
+				double t ) const;
+		/// True if the expression runs as a compiled ExprProgram.
+		bool isCompiled() const;
 
 		/**
 		 * This function finds the reactant indices in the vector
@@ -37,10 +46,15 @@ class FuncTerm
 		const unsigned int getTarget() const;
 		void setTarget( unsigned int tgt );
 	private: 
+		/// Compiles expr_ on reactantIndex_ into program_, if it can.
+		void compile();
+
 		double* args_;
 		// Look up reactants in the S vec.
 		vector< unsigned int > reactantIndex_; 
 		mu::Parser parser_;
+		/// Used in place of parser_ when the expression compiles.
+		ExprProgram program_;
 		string expr_;
 		unsigned int target_; /// Index of the entity to be updated by Func
 };
@@ -19,7 +19,10 @@
 #include "KinSparseMatrix.h"
 #include "GssaSystem.h"
 #include "Stoich.h"
+#include "../randnum/randnum.h"
+#include "../randnum/CounterRng.h"
 #include "GssaVoxelPools.h"
+#include "../utility/ThreadPool.h"
 
 #include "Gsolve.h"
 
@@ -105,6 +108,43 @@ const Cinfo* Gsolve::initCinfo()
 			&Gsolve::getRandInit
 		);
 
+		static ValueFinfo< Gsolve, string > selectMethod(
+			"selectMethod",
+			"Method used to pick the next reaction event. Options are: "
+			"linear: The default. Scans the list of reaction propensities "
+			"in order. Fast for small systems, but the cost grows "
+			"linearly with the number of reactions. "
+			"tree: Uses a binary sum tree of propensities, so that the "
+			"cost grows with log( number of reactions ). Use this for "
+			"systems with more than a few hundred reactions.",
+			&Gsolve::setSelectMethod,
+			&Gsolve::getSelectMethod
+		);
+
+		static ValueFinfo< Gsolve, unsigned int > seed(
+			"seed",
+			"Seed for the random number streams of the voxels. Each voxel "
+			"has its own independent stream, derived from the seed and the "
+			"voxel index, so that a given seed gives the same results "
+			"irrespective of the number of threads. "
+			"If the seed is zero (the default), a new seed is drawn from "
+			"the global random number generator on each reinit, so that "
+			"moose.seed() controls reproducibility.",
+			&Gsolve::setSeed,
+			&Gsolve::getSeed
+		);
+
+		static ValueFinfo< Gsolve, unsigned int > numThreads(
+			"numThreads",
+			"Number of threads used to advance the voxels on each "
+			"timestep. The voxels are split into contiguous blocks, one "
+			"per thread. Default is 1, which does all voxels serially "
+			"on the calling thread. "
+			"Systems with Functions are always done serially.",
+			&Gsolve::setNumThreads,
+			&Gsolve::getNumThreads
+		);
+
 		///////////////////////////////////////////////////////
 		// DestFinfo definitions
 		///////////////////////////////////////////////////////
@@ -179,6 +219,9 @@ const Cinfo* Gsolve::initCinfo()
 		&xCompt,			// SharedFinfo
 		// Here we put new fields that were not there in the Ksolve. 
 		&useRandInit,		// Value
+		&selectMethod,		// Value
+		&seed,				// Value
+		&numThreads,		// Value
 	};
 	
 	static Dinfo< Gsolve > dinfo;
@@ -187,7 +230,9 @@ const Cinfo* Gsolve::initCinfo()
 		Neutral::initCinfo(),
 		gsolveFinfos,
 		sizeof(gsolveFinfos)/sizeof(Finfo *),
-		&dinfo
+		&dinfo,
+		0, 0, false,
+		&Gsolve::isSelfContained
 	);
 
 	return &gsolveCinfo;
@@ -204,7 +249,10 @@ Gsolve::Gsolve()
 		pools_( 1 ),
 		startVoxel_( 0 ),
 		dsolve_(),
-		dsolvePtr_( 0 )
+		dsolvePtr_( 0 ),
+		seed_( 0 ),
+		threadPool_( 1 ),
+		currProc_( 0 )
 {;}
 
 Gsolve::~Gsolve()
@@ -309,6 +357,57 @@ void Gsolve::setRandInit( bool val )
 	sys_.useRandInit = val;
 }
 
+string Gsolve::getSelectMethod() const
+{
+	if ( sys_.useSumTree )
+		return "tree";
+	return "linear";
+}
+
+void Gsolve::setSelectMethod( string method )
+{
+	if ( method == "tree" ) {
+		sys_.useSumTree = true;
+	} else if ( method == "linear" ) {
+		sys_.useSumTree = false;
+	} else {
+		cout << "Warning: Gsolve::setSelectMethod: '" << method << 
+				"' not known, using linear\n";
+		sys_.useSumTree = false;
+	}
+	if ( sys_.isReady ) {
+		for ( unsigned int i = 0; i < pools_.size(); ++i )
+			pools_[i].refreshAtot( &sys_ );
+	}
+}
+
+unsigned int Gsolve::getSeed() const
+{
+	return seed_;
+}
+
+void Gsolve::setSeed( unsigned int seed )
+{
+	seed_ = seed;
+}
+
+unsigned int Gsolve::getNumThreads() const
+{
+	return threadPool_.getNumThreads();
+}
+
+void Gsolve::setNumThreads( unsigned int num )
+{
+	threadPool_.setNumThreads( num );
+}
+
+// Static function
+bool Gsolve::isSelfContained( const Eref& e )
+{
+	const Gsolve* k = reinterpret_cast< const Gsolve* >( e.data() );
+	return ( k->dsolvePtr_ == 0 && k->xfer_.empty() );
+}
+
 //////////////////////////////////////////////////////////////
 // Process operations.
 //////////////////////////////////////////////////////////////
@@ -350,11 +449,16 @@ void Gsolve::process( const Eref& e, ProcPtr p )
 		}
 	}
 
-	// Fourth, update the mol #s
-	for ( vector< GssaVoxelPools >::iterator 
-					i = pools_.begin(); i != pools_.end(); ++i ) {
-		i->advance( p, &sys_ );
-	}
+	// Fourth, update the mol #s. Each voxel has its own random number
+	// stream so they can be split among threads, except that the 
+	// FuncTerms on the Stoich are shared by all voxels. Compiled ones keep
+	// no scratch state, so they do not get in the way.
+	currProc_ = p;
+	if ( stoichPtr_->funcsAreReentrant() )
+		threadPool_.process( pools_.size(), &Gsolve::advanceVoxels, this );
+	else
+		advanceVoxels( this, 0, pools_.size() );
+	currProc_ = 0;
 
 	// Finally, assemble and send the integrated values off for the Dsolve.
 	if ( dsolvePtr_ ) {
@@ -374,6 +478,7 @@ void Gsolve::reinit( const Eref& e, ProcPtr p )
 		return;
 	if ( !sys_.isReady )
 		rebuildGssaSystem();
+	seedVoxels();
 	// First reinit concs.
 	for ( vector< GssaVoxelPools >::iterator 
 					i = pools_.begin(); i != pools_.end(); ++i ) {
@@ -426,6 +531,7 @@ void Gsolve::initProc( const Eref& e, ProcPtr p )
 
 void Gsolve::initReinit( const Eref& e, ProcPtr p )
 {
+	seedVoxels();
 	for ( unsigned int i = 0 ; i < pools_.size(); ++i ) {
 		pools_[i].reinit( &sys_ );
 	}
@@ -442,6 +548,28 @@ void Gsolve::initReinit( const Eref& e, ProcPtr p )
 		xComptOut()->sendTo( e, xf.ksolve, e.id(), xf.lastValues );
 	}
 }
+// static func. Work function for the ThreadPool.
+void Gsolve::advanceVoxels( void* arg, unsigned int begin, unsigned int end )
+{
+	Gsolve* gs = reinterpret_cast< Gsolve* >( arg );
+	for ( unsigned int i = begin; i < end; ++i )
+		gs->pools_[i].advance( gs->currProc_, &gs->sys_ );
+}
+
+/**
+ * Each voxel gets its own stream, indexed by its global voxel number,
+ * so the random numbers used in a voxel do not depend on how the voxels
+ * are divided among threads or nodes.
+ */
+void Gsolve::seedVoxels()
+{
+	uint64_t seed = seed_;
+	if ( seed == 0 )
+		seed = genrand_int32();
+	for ( unsigned int i = 0; i < pools_.size(); ++i )
+		pools_[i].setRandSeed( seed, startVoxel_ + i );
+}
+
 //////////////////////////////////////////////////////////////
 // Solver setup
 //////////////////////////////////////////////////////////////
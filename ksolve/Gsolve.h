@@ -110,6 +110,36 @@ class Gsolve: public ZombiePoolInterface
 		/// Flag: set true if randomized round to integers is to be done.
 		void setRandInit( bool val );
 
+		/// Method used to pick reactions: 'linear' or 'tree'.
+		string getSelectMethod() const;
+		void setSelectMethod( string method );
+
+		/**
+		 * Seed for the per-voxel random number streams. If zero, a new
+		 * seed is drawn from the global generator (mtrand) on each reinit.
+		 */
+		unsigned int getSeed() const;
+		void setSeed( unsigned int seed );
+
+		/// Number of threads used to advance the voxels.
+		unsigned int getNumThreads() const;
+		void setNumThreads( unsigned int num );
+
+		/**
+		 * Advances the voxels in the range [begin, end). This is the
+		 * work function handed to the ThreadPool, arg is the Gsolve.
+		 */
+		static void advanceVoxels( void* arg, 
+						unsigned int begin, unsigned int end );
+
+		/**
+		 * ConcurrencyCheck for the Cinfo. True if the Gsolve on e has
+		 * neither a Dsolve nor cross-compartment reactions, so that its
+		 * process call touches no other object and can run on a
+		 * different thread from other solvers.
+		 */
+		static bool isSelfContained( const Eref& e );
+
 		//////////////////////////////////////////////////////////////////
 		static SrcFinfo2< Id, vector< double > >* xComptOut();
 		static const Cinfo* initCinfo();
@@ -137,6 +167,18 @@ class Gsolve: public ZombiePoolInterface
 
 		/// Pointer to diffusion solver
 		ZombiePoolInterface* dsolvePtr_;
+
+		/// Seed for the voxel random number streams. 0 means use mtrand.
+		unsigned int seed_;
+
+		/// Threads used to advance the voxels in process.
+		ThreadPool threadPool_;
+
+		/// ProcInfo for the current process call, used by advanceVoxels.
+		const ProcInfo* currProc_;
+
+		/// Assigns the random number stream for each voxel.
+		void seedVoxels();
 };
 
 #endif	// _GSOLVE_H
@@ -20,7 +20,8 @@ class GssaSystem
 {
 	public: 
 		GssaSystem()
-			: stoich( 0 ), useRandInit( true ), isReady( false )
+			: stoich( 0 ), useRandInit( true ), useSumTree( false ),
+				isReady( false )
 		{;}
 		vector< vector< unsigned int > > dependency;
 		vector< vector< unsigned int > > dependentMathExpn;
@@ -43,6 +44,15 @@ class GssaSystem
 		 */
 		bool useRandInit;
 
+		/**
+		 * Flag: True when reactions are picked using a binary sum tree
+		 * of propensities, rather than by a linear scan. The tree takes
+		 * log(numReacs) time per reaction event both to pick the reaction
+		 * and to update the dependent rates, so it wins for large
+		 * reaction systems. The linear scan is faster for small ones.
+		 */
+		bool useSumTree;
+
 		/**
 		 * Flag: True when all initialization is done.
 		 */
@@ -17,8 +17,8 @@
 #include "ZombiePoolInterface.h"
 #include "Stoich.h"
 #include "GssaSystem.h"
+#include "../randnum/CounterRng.h"
 #include "GssaVoxelPools.h"
-#include "../randnum/randnum.h"
 
 /**
  * The SAFETY_FACTOR Protects against the total propensity exceeding
@@ -45,7 +45,8 @@ GssaVoxelPools::GssaVoxelPools()
 	: 
 			VoxelPoolsBase(),
 			t_( 0.0 ),
-			atot_( 0.0 )
+			atot_( 0.0 ),
+			numLeaves_( 0 )
 {;}
 
 GssaVoxelPools::~GssaVoxelPools()
@@ -73,6 +74,15 @@ void GssaVoxelPools::updateDependentMathExpn(
 void GssaVoxelPools::updateDependentRates( 
 	const vector< unsigned int >& deps, const Stoich* stoich )
 {
+	if ( sumTree_.size() > 0 ) {
+		for ( vector< unsigned int >::const_iterator
+				i = deps.begin(); i != deps.end(); ++i ) {
+			v_[ *i ] = getReacVelocity( *i, S() );
+			updateSumTree( *i );
+		}
+		atot_ = sumTree_[1] * SAFETY_FACTOR;
+		return;
+	}
 	for ( vector< unsigned int >::const_iterator
 			i = deps.begin(); i != deps.end(); ++i ) {
 		atot_ -= v_[ *i ];
@@ -81,11 +91,30 @@ void GssaVoxelPools::updateDependentRates(
 	}
 }
 
-unsigned int GssaVoxelPools::pickReac() const
+unsigned int GssaVoxelPools::pickReac()
 {
 	// double r =  gsl_rng_uniform( rng ) * atot_;
-	double r = mtrand() * atot_;
-	double sum = 0.0;
+	double r = rng_.uniform() * atot_;
+
+	if ( sumTree_.size() > 0 ) {
+		// Walk down from the root, going left if r lies within the
+		// left subtree's sum. Roundoff can occasionally land us on a
+		// zero-rate reac at the edge of a subtree, and r falls past the
+		// total in the SAFETY_FACTOR margin: return out of range in
+		// both cases so that advance() repicks.
+		if ( r >= sumTree_[1] )
+			return v_.size();
+		unsigned int k = 1;
+		while ( k < numLeaves_ ) {
+			k *= 2;
+			if ( r >= sumTree_[k] )
+				r -= sumTree_[k++];
+		}
+		k -= numLeaves_;
+		if ( k < v_.size() && v_[k] > 0.0 )
+			return k;
+		return v_.size();
+	}
 
 	// This is an inefficient way to do it. Can easily get to 
 	// log time or thereabouts by doing one or two levels of 
@@ -93,6 +122,7 @@ unsigned int GssaVoxelPools::pickReac() const
 	// of overhead in managing the tree. 
 	// Slepoy, Thompson and Plimpton 2008
 	// report a linear time version.
+	double sum = 0.0;
 	for ( vector< double >::const_iterator 
 			i = v_.begin(); i != v_.end(); ++i ) {
 		if ( r < ( sum += *i ) )
@@ -105,6 +135,28 @@ void GssaVoxelPools::setNumReac( unsigned int n )
 {
 	v_.clear();
 	v_.resize( n, 0.0 );
+	sumTree_.clear();
+	numLeaves_ = 0;
+}
+
+void GssaVoxelPools::buildSumTree()
+{
+	numLeaves_ = 1;
+	while ( numLeaves_ < v_.size() )
+		numLeaves_ *= 2;
+	sumTree_.assign( 2 * numLeaves_, 0.0 );
+	for ( unsigned int i = 0; i < v_.size(); ++i )
+		sumTree_[ numLeaves_ + i ] = v_[i];
+	for ( unsigned int k = numLeaves_ - 1; k > 0; --k )
+		sumTree_[k] = sumTree_[ 2 * k ] + sumTree_[ 2 * k + 1 ];
+}
+
+void GssaVoxelPools::updateSumTree( unsigned int r )
+{
+	unsigned int k = numLeaves_ + r;
+	sumTree_[k] = v_[r];
+	for ( k /= 2; k > 0; k /= 2 )
+		sumTree_[k] = sumTree_[ 2 * k ] + sumTree_[ 2 * k + 1 ];
 }
 
 /**
@@ -115,6 +167,13 @@ void GssaVoxelPools::setNumReac( unsigned int n )
 bool GssaVoxelPools::refreshAtot( const GssaSystem* g )
 {
 	updateReacVelocities( g, S(), v_ );
+	if ( g->useSumTree ) {
+		buildSumTree();
+		atot_ = sumTree_[1] * SAFETY_FACTOR;
+		return ( atot_ > 0.0 );
+	}
+	sumTree_.clear();
+	numLeaves_ = 0;
 	atot_ = 0;
 	for ( vector< double >::const_iterator 
 			i = v_.begin(); i != v_.end(); ++i )
@@ -137,6 +196,11 @@ void GssaVoxelPools::advance( const ProcInfo* p, const GssaSystem* g )
 		}
 		unsigned int rindex = pickReac();
 		assert( g->stoich->getNumRates() == v_.size() );
+		if ( rindex >= g->stoich->getNumRates() && sumTree_.size() > 0 ) {
+			// Roundoff in the sum tree. Its sums are exact to within
+			// roundoff, so it is enough to pick again.
+			continue;
+		}
 		if ( rindex >= g->stoich->getNumRates() ) {
 			// probably cumulative roundoff error here. 
 			// Recalculate atot to avoid, and redo.
@@ -156,9 +220,9 @@ void GssaVoxelPools::advance( const ProcInfo* p, const GssaSystem* g )
 		}
 
 		g->transposeN.fireReac( rindex, Svec() );
-		double r = mtrand();
+		double r = rng_.uniform();
 		while ( r <= 0.0 ) {
-			r = mtrand();
+			r = rng_.uniform();
 		}
 		t_ -= ( 1.0 / atot_ ) * log( r );
 		g->stoich->updateFuncs( varS(), t_ );
@@ -181,7 +245,7 @@ void GssaVoxelPools::reinit( const GssaSystem* g )
 			double base = floor( n[i] );
 			double frac = n[i] - base;
 			// if ( gsl_rng_uniform( rng ) > frac )
-			if ( mtrand() > frac )
+			if ( rng_.uniform() > frac )
 				n[i] = base;
 			else
 				n[i] = base + 1.0;
@@ -195,6 +259,11 @@ void GssaVoxelPools::reinit( const GssaSystem* g )
 	refreshAtot( g );
 }
 
+void GssaVoxelPools::setRandSeed( uint64_t seed, uint64_t stream )
+{
+	rng_.setSeed( seed, stream );
+}
+
 /////////////////////////////////////////////////////////////////////////
 // Rate computation functions
 /////////////////////////////////////////////////////////////////////////
@@ -26,7 +26,7 @@ class GssaVoxelPools: public VoxelPoolsBase
 				const GssaSystem* g, unsigned int rindex );
 		void updateDependentRates( 
 			const vector< unsigned int >& deps, const Stoich* stoich );
-		unsigned int pickReac() const;
+		unsigned int pickReac();
 		void setNumReac( unsigned int n );
 
 		void advance( const ProcInfo* p, const GssaSystem* g );
@@ -43,6 +43,14 @@ class GssaVoxelPools: public VoxelPoolsBase
 		 */
 		void reinit( const GssaSystem* g );
 
+		/**
+		 * Assigns the random number stream for this voxel. Each voxel
+		 * uses its own stream so that the results do not depend on the
+		 * order in which voxels are advanced, or on the number of
+		 * threads used.
+		 */
+		void setRandSeed( uint64_t seed, uint64_t stream );
+
 		void updateAllRateTerms( const vector< RateTerm* >& rates,
 					   unsigned int numCoreRates	);
 		void updateRateTerms( const vector< RateTerm* >& rates,
@@ -92,8 +100,30 @@ class GssaVoxelPools: public VoxelPoolsBase
 		 * recalculated on each step.
 		 */
 		vector< double > v_; 
-		// Possibly we should put independent RNGS, so save one here.
-		
+
+		/**
+		 * Binary sum tree of reaction velocities, used to pick reactions
+		 * in log time when GssaSystem::useSumTree is set. Empty otherwise.
+		 * The leaves are at sumTree_[ numLeaves_ + i ] for reac i, and
+		 * each internal node k holds the sum of nodes 2k and 2k+1, so
+		 * sumTree_[1] is the total propensity.
+		 * Nodes are recomputed rather than incremented, so unlike atot_
+		 * in the linear scan they do not accumulate roundoff error.
+		 */
+		vector< double > sumTree_;
+
+		/// Number of leaves in sumTree_: the next power of 2 >= v_.size()
+		unsigned int numLeaves_;
+
+		/// Rebuilds the whole sumTree_ from v_.
+		void buildSumTree();
+
+		/// Updates the sumTree_ entries above reaction r.
+		void updateSumTree( unsigned int r );
+
+		/// Independent random number stream for this voxel.
+		CounterRng rng_;
+
 };
 
 #endif	// _GSSA_VOXEL_POOLS_H
@@ -14,13 +14,16 @@
 #endif
 
 #include "OdeSystem.h"
+#include "RateTerm.h"
+#include "RateProgram.h"
+#include "SparseLU.h"
+#include "Rosenbrock.h"
 #include "VoxelPoolsBase.h"
 #include "VoxelPools.h"
 #include "../mesh/VoxelJunction.h"
 #include "XferInfo.h"
 #include "ZombiePoolInterface.h"
 
-#include "RateTerm.h"
 #include "FuncTerm.h"
 #include "SparseMatrix.h"
 #include "KinSparseMatrix.h"
@@ -30,6 +33,7 @@
 #include "../mesh/MeshEntry.h"
 #include "../mesh/Boundary.h"
 #include "../mesh/ChemCompt.h"
+#include "../utility/ThreadPool.h"
 #include "Ksolve.h"
 
 const unsigned int OFFNODE = ~0;
@@ -58,13 +62,15 @@ const Cinfo* Ksolve::initCinfo()
 		
 		static ValueFinfo< Ksolve, string > method (
 			"method",
-			"Integration method, using GSL. So far only explict. Options are:"
+			"Integration method. The explicit methods use GSL. Options are:"
 			"rk5: The default Runge-Kutta-Fehlberg 5th order adaptive dt method"
 			"gsl: alias for the above"
 			"rk4: The Runge-Kutta 4th order fixed dt method"
 			"rk2: The Runge-Kutta 2,3 embedded fixed dt method"
 			"rkck: The Runge-Kutta Cash-Karp (4,5) method"
-			"rk8: The Runge-Kutta Prince-Dormand (8,9) method" ,
+			"rk8: The Runge-Kutta Prince-Dormand (8,9) method"
+			"rosenbrock: An implicit Rosenbrock (2,3) adaptive dt method "
+			"with an analytic sparse Jacobian, for stiff models" ,
 			&Ksolve::setMethod,
 			&Ksolve::getMethod
 		);
@@ -83,6 +89,18 @@ const Cinfo* Ksolve::initCinfo()
 			&Ksolve::getEpsRel
 		);
 		
+		static ValueFinfo< Ksolve, unsigned int > numThreads (
+			"numThreads",
+			"Number of threads used to advance the voxels on each "
+			"timestep. The voxels are split into contiguous blocks, one "
+			"per thread, so the results are identical to the serial "
+			"calculation. Default is 1, which does all voxels serially "
+			"on the calling thread. "
+			"Systems with Functions are always done serially.",
+			&Ksolve::setNumThreads,
+			&Ksolve::getNumThreads
+		);
+
 		static ValueFinfo< Ksolve, Id > compartment(
 			"compartment",
 			"Compartment in which the Ksolve reaction system lives.",
@@ -196,6 +214,7 @@ const Cinfo* Ksolve::initCinfo()
 		&method,			// Value
 		&epsAbs,			// Value
 		&epsRel,			// Value
+		&numThreads,		// Value
 		&compartment,		// Value
 		&numLocalVoxels,	// ReadOnlyValue
 		&nVec,				// LookupValue
@@ -215,7 +234,9 @@ const Cinfo* Ksolve::initCinfo()
 		Neutral::initCinfo(),
 		ksolveFinfos,
 		sizeof(ksolveFinfos)/sizeof(Finfo *),
-		&dinfo
+		&dinfo,
+		0, 0, false,
+		&Ksolve::isSelfContained
 	);
 
 	return &ksolveCinfo;
@@ -235,7 +256,9 @@ Ksolve::Ksolve()
 		pools_( 1 ),
 		startVoxel_( 0 ),
 		dsolve_(),
-		dsolvePtr_( 0 )
+		dsolvePtr_( 0 ),
+		threadPool_( 1 ),
+		currProc_( 0 )
 {;}
 
 Ksolve::~Ksolve()
@@ -255,7 +278,8 @@ void Ksolve::setMethod( string method )
 	if ( method == "rk5" || method == "gsl" ) {
 		method_ = "rk5";
 	} else if ( method == "rk4"  || method == "rk2" || 
-					method == "rk8" || method == "rkck" ) {
+					method == "rk8" || method == "rkck" || 
+					method == "rosenbrock" ) {
 		method_ = method;
 	} else {
 		cout << "Warning: Ksolve::setMethod: '" << method << 
@@ -293,6 +317,23 @@ void Ksolve::setEpsRel( double epsRel )
 	}
 }
 
+unsigned int Ksolve::getNumThreads() const
+{
+	return threadPool_.getNumThreads();
+}
+
+void Ksolve::setNumThreads( unsigned int num )
+{
+	threadPool_.setNumThreads( num );
+}
+
+// Static function
+bool Ksolve::isSelfContained( const Eref& e )
+{
+	const Ksolve* k = reinterpret_cast< const Ksolve* >( e.data() );
+	return ( k->dsolvePtr_ == 0 && k->xfer_.empty() );
+}
+
 Id Ksolve::getStoich() const
 {
 	return stoich_;
@@ -312,7 +353,7 @@ void innerSetMethod( OdeSystem& ode, const string& method )
 		ode.gslStep = gsl_odeiv2_step_rkck;
 	} else if ( method == "rk8" ) {
 		ode.gslStep = gsl_odeiv2_step_rk8pd;
-	} else {
+	} else { // Also for rosenbrock, which does not use the GSL stepper.
 		ode.gslStep = gsl_odeiv2_step_rkf45;
 	}
 }
@@ -355,6 +396,7 @@ Id Ksolve::getDsolve() const
 
 void Ksolve::setDsolve( Id dsolve )
 {
+	unshareState();
 	if ( dsolve == Id () ) {
 		dsolvePtr_ = 0;
 		dsolve_ = Id();
@@ -362,6 +404,7 @@ void Ksolve::setDsolve( Id dsolve )
 		dsolve_ = dsolve;
 		dsolvePtr_ = reinterpret_cast< ZombiePoolInterface* >( 
 						dsolve.eref().data() );
+		shareState();
 	} else {
 		cout << "Warning: Ksolve::setDsolve: Object '" << dsolve.path() <<
 				"' should be class Dsolve, is: " << 
@@ -369,6 +412,24 @@ void Ksolve::setDsolve( Id dsolve )
 	}
 }
 
+void Ksolve::shareState()
+{
+	unshareState();
+	if ( !dsolvePtr_ || !stoichPtr_ || pools_.size() == 0 || 
+			pools_[0].size() < stoichPtr_->getNumVarPools() )
+		return;
+	vector< double* > voxelS( pools_.size() );
+	for ( unsigned int i = 0; i < pools_.size(); ++i )
+		voxelS[i] = pools_[i].varS();
+	dsolvePtr_->setSharedState( voxelS, stoichPtr_->getNumVarPools() );
+}
+
+void Ksolve::unshareState()
+{
+	if ( dsolvePtr_ )
+		dsolvePtr_->clearSharedState();
+}
+
 unsigned int Ksolve::getNumLocalVoxels() const
 {
 	return pools_.size();
@@ -385,6 +446,7 @@ void Ksolve::setNumAllVoxels( unsigned int numVoxels )
 	if ( numVoxels == 0 ) {
 		return;
 	}
+	unshareState();
 	pools_.resize( numVoxels );
 }
 
@@ -440,7 +502,8 @@ void Ksolve::process( const Eref& e, ProcPtr p )
 	if ( isBuilt_ == false )
 		return;
 	// First, handle incoming diffusion values, update S with those.
-	if ( dsolvePtr_ ) {
+	// If the state is shared, the Dsolve has already put them there.
+	if ( dsolvePtr_ && !dsolvePtr_->isStateShared() ) {
 		vector< double > dvalues( 4 );
 		dvalues[0] = 0;
 		dvalues[1] = getNumLocalVoxels();
@@ -475,12 +538,26 @@ void Ksolve::process( const Eref& e, ProcPtr p )
 	}
 
 	// Fourth, do the numerical integration for all reactions.
-	for ( vector< VoxelPools >::iterator 
-				i = pools_.begin(); i != pools_.end(); ++i ) {
-		i->advance( p );
+	// The voxels are independent so they can be split among threads,
+	// except that the FuncTerms on the Stoich are shared by all voxels,
+	// and those which fall back to muParser use it as scratch space.
+	currProc_ = p;
+	if ( stoichPtr_->funcsAreReentrant() )
+		threadPool_.process( pools_.size(), &Ksolve::advanceVoxels, this );
+	else
+		advanceVoxels( this, 0, pools_.size() );
+	currProc_ = 0;
+	// The pools set by FuncTerms hold the value from the last rate
+	// evaluation, so bring them up to the end of the step, all voxels
+	// at once.
+	if ( stoichPtr_->getNumFuncs() > 0 ) {
+		vector< double* > voxelS( pools_.size() );
+		for ( unsigned int i = 0; i < pools_.size(); ++i )
+			voxelS[i] = pools_[i].varS();
+		stoichPtr_->updateFuncsBulk( voxelS, p->currTime );
 	}
 	// Finally, assemble and send the integrated values off for the Dsolve.
-	if ( dsolvePtr_ ) {
+	if ( dsolvePtr_ && !dsolvePtr_->isStateShared() ) {
 		vector< double > kvalues( 4 );
 		kvalues[0] = 0;
 		kvalues[1] = getNumLocalVoxels();
@@ -501,6 +578,10 @@ void Ksolve::reinit( const Eref& e, ProcPtr p )
 		cout << "Warning:Ksolve::reinit: Reaction system not initialized\n";
 		return;
 	}
+	// The Dsolve drops the sharing whenever it reallocates its pools,
+	// so offer the S arrays again now that both sides are set up.
+	if ( dsolvePtr_ && !dsolvePtr_->isStateShared() )
+		shareState();
 	for ( unsigned int i = 0; i < xfer_.size(); ++i ) {
 		const XferInfo& xf = xfer_[i];
 		for ( unsigned int j = 0; j < xf.xferVoxel.size(); ++j ) {
@@ -558,6 +639,14 @@ void Ksolve::initReinit( const Eref& e, ProcPtr p )
 	// xComptOut()->sendVec( e, values );
 }
 
+// static func. Work function for the ThreadPool.
+void Ksolve::advanceVoxels( void* arg, unsigned int begin, unsigned int end )
+{
+	Ksolve* ks = reinterpret_cast< Ksolve* >( arg );
+	for ( unsigned int i = begin; i < end; ++i )
+		ks->pools_[i].advance( ks->currProc_ );
+}
+
 /**
  * updateRateTerms obtains the latest parameters for the rates_ vector,
  * and has each of the pools update its parameters including rescaling
@@ -643,10 +732,12 @@ double Ksolve::getDiffConst( const Eref& e ) const
 
 void Ksolve::setNumPools( unsigned int numPoolSpecies )
 {
+	unshareState();
 	unsigned int numVoxels = pools_.size();
 	for ( unsigned int i = 0 ; i < numVoxels; ++i ) {
 		pools_[i].resizeArrays( numPoolSpecies );
 	}
+	shareState();
 }
 
 unsigned int Ksolve::getNumPools() const
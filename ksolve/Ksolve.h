@@ -33,6 +33,14 @@ class Ksolve: public ZombiePoolInterface
 		double getEpsRel() const;
 		void setEpsRel( double val );
 
+		/**
+		 * Assigns number of threads used to advance the voxels. 
+		 * The voxels are split into contiguous blocks, one per thread.
+		 * 0 or 1 means that all voxels are done serially.
+		 */
+		unsigned int getNumThreads() const;
+		void setNumThreads( unsigned int num );
+
 		/// Assigns Stoich object to Ksolve.
 		Id getStoich() const;
 		void setStoich( Id stoich ); /// Inherited from ZombiePoolInterface.
@@ -115,6 +123,13 @@ class Ksolve: public ZombiePoolInterface
 		 */
 		void updateRateTerms( unsigned int index );
 
+		/**
+		 * Advances the voxels in the range [begin, end). This is the
+		 * work function handed to the ThreadPool, arg is the Ksolve.
+		 */
+		static void advanceVoxels( void* arg, 
+						unsigned int begin, unsigned int end );
+
 		//////////////////////////////////////////////////////////////////
 		// Functions for cross-compartment transfer
 		//////////////////////////////////////////////////////////////////
@@ -137,10 +152,23 @@ class Ksolve: public ZombiePoolInterface
 		// for debugging
 		void print() const;
 
+		/**
+		 * ConcurrencyCheck for the Cinfo. True if the Ksolve on e has
+		 * neither a Dsolve nor cross-compartment reactions, so that its
+		 * process call touches no other object and can run on a
+		 * different thread from other solvers.
+		 */
+		static bool isSelfContained( const Eref& e );
+
 		//////////////////////////////////////////////////////////////////
 		static SrcFinfo2< Id, vector< double > >* xComptOut();
 		static const Cinfo* initCinfo();
 	private:
+		/// Offers the S arrays of pools_ to the Dsolve to work on.
+		void shareState();
+		/// Ends the sharing, before pools_ may be reallocated.
+		void unshareState();
+
 		string method_;
 		double epsAbs_;
 		double epsRel_;
@@ -166,6 +194,12 @@ class Ksolve: public ZombiePoolInterface
 
 		/// Pointer to diffusion solver
 		ZombiePoolInterface* dsolvePtr_;
+
+		/// Threads used to advance the voxels in process.
+		ThreadPool threadPool_;
+
+		/// ProcInfo for the current process call, used by advanceVoxels.
+		const ProcInfo* currProc_;
 };
 
 #endif	// _KSOLVE_H
@@ -0,0 +1,236 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include <float.h>
+#include "RateTerm.h"
+#include "RateProgram.h"
+
+RateProgram::RateProgram()
+	: version_( 0 )
+{;}
+
+void RateProgram::addDerivs( unsigned int reac, 
+				const vector< unsigned int >& pools )
+{
+	for ( unsigned int i = 0; i < pools.size(); ++i ) {
+		derivReac_.push_back( reac );
+		derivPool_.push_back( pools[i] );
+	}
+}
+
+void RateProgram::fallbackPools( const RateTerm* term, 
+				vector< unsigned int >& pools )
+{
+	term->getReactants( pools );
+	sort( pools.begin(), pools.end() );
+	pools.erase( unique( pools.begin(), pools.end() ), pools.end() );
+}
+
+void RateProgram::build( const vector< RateTerm* >& rates )
+{
+	for ( unsigned int i = 0; i < 2 * RateOp::NUM_KINDS; ++i )
+		ops_[i].clear();
+	fallback_.clear();
+	fallbackReac_.clear();
+	fallbackDeriv_.clear();
+	derivReac_.clear();
+	derivPool_.clear();
+	numOps_.assign( rates.size(), 0 );
+	opKind_.assign( 2 * rates.size(), 0 );
+	opPos_.assign( 2 * rates.size(), 0 );
+
+	RateOp rop[2];
+	vector< unsigned int > pools;
+	for ( unsigned int i = 0; i < rates.size(); ++i ) {
+		unsigned int n = rates[i]->getRateOps( rop );
+		numOps_[i] = n;
+		if ( n == 0 ) {
+			opPos_[ 2 * i ] = fallback_.size();
+			fallback_.push_back( rates[i] );
+			fallbackReac_.push_back( i );
+			fallbackDeriv_.push_back( derivReac_.size() );
+			fallbackPools( rates[i], pools );
+			addDerivs( i, pools );
+			fallbackDeriv_.push_back( derivReac_.size() );
+			continue;
+		}
+		for ( unsigned int half = 0; half < n; ++half ) {
+			const RateOp& r = rop[ half ];
+			assert( r.kind < RateOp::NUM_KINDS );
+			vector< Op >& g = ops_[ group( r.kind, half ) ];
+			opKind_[ 2 * i + half ] = r.kind;
+			opPos_[ 2 * i + half ] = g.size();
+			Op op;
+			op.reac = i;
+			op.y1 = r.y1;
+			op.y2 = r.y2;
+			op.k1 = r.k1;
+			op.k2 = r.k2;
+			op.d = derivReac_.size();
+			g.push_back( op );
+			pools.clear();
+			if ( r.kind != RateOp::ZERO )
+				pools.push_back( r.y1 );
+			if ( r.kind == RateOp::SECOND || r.kind == RateOp::MMENZ1 )
+				pools.push_back( r.y2 );
+			addDerivs( i, pools );
+		}
+	}
+	++version_;
+}
+
+void RateProgram::update( const vector< RateTerm* >& rates,
+				unsigned int index )
+{
+	if ( rates.size() != numOps_.size() ) {
+		build( rates );
+		return;
+	}
+	assert( index < rates.size() );
+	RateOp rop[2];
+	unsigned int n = rates[ index ]->getRateOps( rop );
+	if ( n != numOps_[ index ] ) {
+		build( rates );
+		return;
+	}
+	// The terms must also have the same reactants, else the derivative
+	// slots change.
+	if ( n == 0 ) {
+		unsigned int j = opPos_[ 2 * index ];
+		vector< unsigned int > pools;
+		fallbackPools( rates[ index ], pools );
+		if ( pools.size() != fallbackDeriv_[2*j + 1] - fallbackDeriv_[2*j] ||
+			!equal( pools.begin(), pools.end(), 
+			derivPool_.begin() + fallbackDeriv_[2*j] ) ) {
+			build( rates );
+			return;
+		}
+		fallback_[j] = rates[ index ];
+		return;
+	}
+	for ( unsigned int half = 0; half < n; ++half ) {
+		const RateOp& r = rop[ half ];
+		if ( r.kind != opKind_[ 2 * index + half ] ) {
+			build( rates );
+			return;
+		}
+		const Op& op = 
+			ops_[ group( r.kind, half ) ][ opPos_[ 2 * index + half ] ];
+		if ( op.y1 != r.y1 || op.y2 != r.y2 ) {
+			build( rates );
+			return;
+		}
+	}
+	for ( unsigned int half = 0; half < n; ++half ) {
+		const RateOp& r = rop[ half ];
+		Op& op = ops_[ group( r.kind, half ) ][ opPos_[ 2 * index + half ] ];
+		assert( op.reac == index );
+		op.k1 = r.k1;
+		op.k2 = r.k2;
+	}
+}
+
+// The expressions below must stay the same as the operator() of the
+// corresponding RateTerms, so that the results are identical.
+void RateProgram::evaluate( const double* S, double* v ) const
+{
+	vector< Op >::const_iterator i;
+	const vector< Op >* g = ops_;
+	for ( i = g[ RateOp::ZERO ].begin(); i != g[ RateOp::ZERO ].end(); ++i )
+		v[ i->reac ] = i->k1;
+	for ( i = g[ RateOp::FIRST ].begin(); i != g[ RateOp::FIRST ].end(); ++i )
+		v[ i->reac ] = i->k1 * S[ i->y1 ];
+	for ( i = g[ RateOp::SECOND ].begin(); i != g[ RateOp::SECOND ].end(); ++i )
+		v[ i->reac ] = i->k1 * S[ i->y1 ] * S[ i->y2 ];
+	for ( i = g[ RateOp::MMENZ1 ].begin(); i != g[ RateOp::MMENZ1 ].end(); ++i )
+		v[ i->reac ] = ( i->k2 * S[ i->y1 ] * S[ i->y2 ] ) /
+				( i->k1 + S[ i->y1 ] );
+
+	// Backward halves of reactions.
+	g = ops_ + RateOp::NUM_KINDS;
+	for ( i = g[ RateOp::ZERO ].begin(); i != g[ RateOp::ZERO ].end(); ++i )
+		v[ i->reac ] -= i->k1;
+	for ( i = g[ RateOp::FIRST ].begin(); i != g[ RateOp::FIRST ].end(); ++i )
+		v[ i->reac ] -= i->k1 * S[ i->y1 ];
+	for ( i = g[ RateOp::SECOND ].begin(); i != g[ RateOp::SECOND ].end(); ++i )
+		v[ i->reac ] -= i->k1 * S[ i->y1 ] * S[ i->y2 ];
+	assert( g[ RateOp::MMENZ1 ].size() == 0 );
+
+	for ( unsigned int j = 0; j < fallback_.size(); ++j )
+		v[ fallbackReac_[j] ] = ( *fallback_[j] )( S );
+}
+
+void RateProgram::evaluateDerivs( double* S, double* d ) const
+{
+	vector< Op >::const_iterator i;
+	for ( unsigned int half = 0; half < 2; ++half ) {
+		const vector< Op >* g = ops_ + half * RateOp::NUM_KINDS;
+		double sign = ( half == 0 ) ? 1.0 : -1.0;
+		for ( i = g[ RateOp::FIRST ].begin(); 
+						i != g[ RateOp::FIRST ].end(); ++i )
+			d[ i->d ] = sign * i->k1;
+		for ( i = g[ RateOp::SECOND ].begin(); 
+						i != g[ RateOp::SECOND ].end(); ++i ) {
+			d[ i->d ] = sign * i->k1 * S[ i->y2 ];
+			d[ i->d + 1 ] = sign * i->k1 * S[ i->y1 ];
+		}
+		for ( i = g[ RateOp::MMENZ1 ].begin(); 
+						i != g[ RateOp::MMENZ1 ].end(); ++i ) {
+			double denom = i->k1 + S[ i->y1 ];
+			d[ i->d ] = sign * i->k2 * S[ i->y2 ] * i->k1 / ( denom * denom );
+			d[ i->d + 1 ] = sign * i->k2 * S[ i->y1 ] / denom;
+		}
+	}
+
+	static const double delta = sqrt( DBL_EPSILON );
+	for ( unsigned int j = 0; j < fallback_.size(); ++j ) {
+		const RateTerm& term = *fallback_[j];
+		double v0 = term( S );
+		for ( unsigned int k = fallbackDeriv_[2*j]; 
+						k < fallbackDeriv_[2*j + 1]; ++k ) {
+			double& y = S[ derivPool_[k] ];
+			double orig = y;
+			y += delta * max( fabs( orig ), 1.0 );
+			double h = y - orig;
+			d[k] = ( term( S ) - v0 ) / h;
+			y = orig;
+		}
+	}
+}
+
+unsigned int RateProgram::getNumRates() const
+{
+	return numOps_.size();
+}
+
+unsigned int RateProgram::getNumFallback() const
+{
+	return fallback_.size();
+}
+
+unsigned int RateProgram::getNumDerivs() const
+{
+	return derivReac_.size();
+}
+
+const vector< unsigned int >& RateProgram::getDerivReac() const
+{
+	return derivReac_;
+}
+
+const vector< unsigned int >& RateProgram::getDerivPool() const
+{
+	return derivPool_;
+}
+
+unsigned int RateProgram::getVersion() const
+{
+	return version_;
+}
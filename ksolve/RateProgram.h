@@ -0,0 +1,132 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _RATE_PROGRAM_H
+#define _RATE_PROGRAM_H
+
+/**
+ * RateProgram is a compiled form of a vector of RateTerms, used to
+ * compute reaction velocities in the inner loop of the deterministic
+ * solver without virtual calls.
+ * The simple terms (zero, first and second order, and single-substrate
+ * MM enzymes, including the two halves of bidirectional reactions) are
+ * stored as flat ops with their own rate constants, grouped by kind.
+ * Each group is evaluated in a tight loop. The forward halves assign
+ * the velocity, and the backward halves are then subtracted, so the
+ * results are identical to calling the RateTerms. All other terms are
+ * called through RateTerm::operator() as before.
+ * Each VoxelPools compiles its own volume-scaled RateTerms, so the rate
+ * constants of a voxel are held in its own program.
+ *
+ * The program also computes the partial derivatives of the velocities
+ * with respect to the pools, for the Jacobian used by implicit
+ * methods. Each derivative has a fixed slot, so that the sparsity
+ * pattern is known once the program is built. The derivatives of the
+ * flat ops are analytic, and those of the other terms are estimated by
+ * finite differences over their reactants.
+ */
+class RateProgram
+{
+	public:
+		RateProgram();
+
+		/// Compiles the program for the rate terms.
+		void build( const vector< RateTerm* >& rates );
+
+		/**
+		 * Refreshes the program after rates[ index ] has been replaced.
+		 * This is cheap if the new term has the same form as the old.
+		 */
+		void update( const vector< RateTerm* >& rates, unsigned int index );
+
+		/**
+		 * Computes the velocity of each reaction from the mol # vector
+		 * S, into v, which must have one entry per rate term.
+		 */
+		void evaluate( const double* S, double* v ) const;
+
+		/**
+		 * Computes the derivative in each slot, into d, which must have
+		 * getNumDerivs() entries. S is perturbed for the finite
+		 * differences, but restored before returning.
+		 */
+		void evaluateDerivs( double* S, double* d ) const;
+
+		unsigned int getNumRates() const;
+		/// Returns the number of terms that are called as RateTerms.
+		unsigned int getNumFallback() const;
+
+		/// Returns the number of derivative slots.
+		unsigned int getNumDerivs() const;
+		/// Reaction whose velocity is differentiated, for each slot.
+		const vector< unsigned int >& getDerivReac() const;
+		/// Pool that the velocity is differentiated by, for each slot.
+		const vector< unsigned int >& getDerivPool() const;
+
+		/**
+		 * Goes up each time the program is rebuilt, which is whenever
+		 * the derivative slots may have changed.
+		 */
+		unsigned int getVersion() const;
+
+	private:
+		class Op
+		{
+			public:
+				unsigned int reac;
+				unsigned int y1;
+				unsigned int y2;
+				double k1;
+				double k2;
+				/// First derivative slot of the op.
+				unsigned int d;
+		};
+
+		/// Assigns derivative slots for reaction reac by pools.
+		void addDerivs( unsigned int reac, const vector< unsigned int >& pools );
+
+		/// Lists the distinct reactants of a fallback term.
+		static void fallbackPools( const RateTerm* term, 
+						vector< unsigned int >& pools );
+
+		/// Index of the group for the given kind and half.
+		static unsigned int group( unsigned int kind, unsigned int half )
+		{
+			return half * RateOp::NUM_KINDS + kind;
+		}
+
+		/**
+		 * ops_[ group( kind, half ) ] holds the ops of that kind. Half 0
+		 * holds single terms and forward halves, half 1 backward halves.
+		 */
+		vector< Op > ops_[ 2 * RateOp::NUM_KINDS ];
+
+		/// Terms evaluated through RateTerm::operator().
+		vector< const RateTerm* > fallback_;
+		vector< unsigned int > fallbackReac_;
+		/// Start and end of the derivative slots of each fallback term.
+		vector< unsigned int > fallbackDeriv_;
+
+		vector< unsigned int > derivReac_;
+		vector< unsigned int > derivPool_;
+		unsigned int version_;
+
+		/// Number of ops for each rate term, as from getRateOps.
+		vector< unsigned int > numOps_;
+		/// Kind of each op of each rate term, two entries per term.
+		vector< unsigned int > opKind_;
+		/**
+		 * Position of each op of each rate term within its group, two
+		 * entries per term. For fallback terms the first entry is the
+		 * position in fallback_.
+		 */
+		vector< unsigned int > opPos_;
+};
+
+#endif // _RATE_PROGRAM_H
@@ -15,6 +15,28 @@ double assignRates( RateCalculation& r )
 }
 */
 #include "../utility/numutil.h"
+
+/**
+ * Flat description of a simple rate term, used by RateProgram to
+ * evaluate the term without a virtual call.
+ */
+class RateOp
+{
+	public:
+		enum Kind {
+			ZERO,	///< k1
+			FIRST,	///< k1 * S[y1]
+			SECOND,	///< k1 * S[y1] * S[y2]
+			MMENZ1,	///< k2 * S[y1] * S[y2] / ( k1 + S[y1] ): y1 is sub
+			NUM_KINDS
+		};
+		unsigned int kind;
+		unsigned int y1;
+		unsigned int y2;
+		double k1;
+		double k2;
+};
+
 class RateTerm
 {
 	public:
@@ -74,6 +96,17 @@ class RateTerm
 		 */
 		virtual RateTerm* copyWithVolScaling( 
 				double vol, double sub, double prd ) const = 0;
+
+		/**
+		 * Describes the term for RateProgram. Fills in ops, which must
+		 * have room for two entries, and returns the number used:
+		 * 1 for a simple term, 2 for a reaction whose second op is
+		 * subtracted from the first, and 0 if the term has to be
+		 * evaluated through operator().
+		 */
+		virtual unsigned int getRateOps( RateOp* ops ) const {
+			return 0;
+		}
 };
 
 // Base class MMEnzme for the purposes of setting rates
@@ -165,6 +198,15 @@ class MMEnzyme1: public MMEnzymeBase
 			return new MMEnzyme1( ratio * Km_, kcat_, enz_, sub_);
 		}
 
+		unsigned int getRateOps( RateOp* ops ) const {
+			ops[0].kind = RateOp::MMENZ1;
+			ops[0].y1 = sub_;
+			ops[0].y2 = enz_;
+			ops[0].k1 = Km_;
+			ops[0].k2 = kcat_;
+			return 1;
+		}
+
 	private:
 		unsigned int sub_;
 };
@@ -307,6 +349,14 @@ class ZeroOrder: public RateTerm
 		{
 			return new ZeroOrder( k_ );
 		}
+
+		unsigned int getRateOps( RateOp* ops ) const {
+			ops[0].kind = RateOp::ZERO;
+			ops[0].y1 = ops[0].y2 = 0;
+			ops[0].k1 = k_;
+			ops[0].k2 = 0.0;
+			return 1;
+		}
 	protected:
 		double k_;
 };
@@ -346,6 +396,14 @@ class Flux: public ZeroOrder
 			return new Flux( k_, y_ );
 		}
 
+		unsigned int getRateOps( RateOp* ops ) const {
+			ops[0].kind = RateOp::FIRST;
+			ops[0].y1 = ops[0].y2 = y_;
+			ops[0].k1 = k_;
+			ops[0].k2 = 0.0;
+			return 1;
+		}
+
 	private:
 		unsigned int y_;
 };
@@ -380,6 +438,14 @@ class FirstOrder: public ZeroOrder
 			return new FirstOrder( k_ / sub, y_ );
 		}
 
+		unsigned int getRateOps( RateOp* ops ) const {
+			ops[0].kind = RateOp::FIRST;
+			ops[0].y1 = ops[0].y2 = y_;
+			ops[0].k1 = k_;
+			ops[0].k2 = 0.0;
+			return 1;
+		}
+
 	private:
 		unsigned int y_;
 };
@@ -419,6 +485,15 @@ class SecondOrder: public ZeroOrder
 			return new SecondOrder( k_ / ratio, y1_, y2_ );
 		}
 
+		unsigned int getRateOps( RateOp* ops ) const {
+			ops[0].kind = RateOp::SECOND;
+			ops[0].y1 = y1_;
+			ops[0].y2 = y2_;
+			ops[0].k1 = k_;
+			ops[0].k2 = 0.0;
+			return 1;
+		}
+
 	private:
 		unsigned int y1_;
 		unsigned int y2_;
@@ -465,6 +540,10 @@ class StochSecondOrderSingleSubstrate: public ZeroOrder
 			return new StochSecondOrderSingleSubstrate( k_ / ratio, y_ );
 		}
 
+		unsigned int getRateOps( RateOp* ops ) const {
+			return 0;
+		}
+
 	private:
 		const unsigned int y_;
 };
@@ -508,6 +587,10 @@ class NOrder: public ZeroOrder
 			return new NOrder( k_ / ratio, v_ );
 		}
 
+		unsigned int getRateOps( RateOp* ops ) const {
+			return 0;
+		}
+
 	protected:
 		vector< unsigned int > v_;
 };
@@ -604,6 +687,13 @@ class BidirectionalReaction: public RateTerm
 			return new BidirectionalReaction( f, b );
 		}
 
+		unsigned int getRateOps( RateOp* ops ) const {
+			if ( forward_->getRateOps( ops ) == 1 && 
+				backward_->getRateOps( ops + 1 ) == 1 )
+				return 2;
+			return 0;
+		}
+
 	private:
 		ZeroOrder* forward_;
 		ZeroOrder* backward_;
@@ -0,0 +1,196 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include <float.h>
+#include "SparseLU.h"
+#include "Rosenbrock.h"
+
+Rosenbrock::Rosenbrock()
+	:
+		dim_( 0 ),
+		func_( 0 ),
+		jac_( 0 ),
+		params_( 0 ),
+		epsAbs_( 1e-6 ),
+		epsRel_( 1e-6 ),
+		h_( 0.01 ),
+		numSteps_( 0 ),
+		numRejected_( 0 )
+{;}
+
+void Rosenbrock::setSystem( unsigned int dim, Func func, Jacobian jac,
+				void* params )
+{
+	dim_ = dim;
+	func_ = func;
+	jac_ = jac;
+	params_ = params;
+	f0_.assign( dim, 0.0 );
+	f1_.assign( dim, 0.0 );
+	f2_.assign( dim, 0.0 );
+	k1_.assign( dim, 0.0 );
+	k2_.assign( dim, 0.0 );
+	k3_.assign( dim, 0.0 );
+	ynew_.assign( dim, 0.0 );
+	numSteps_ = 0;
+	numRejected_ = 0;
+	// Until a pattern is assigned, the Jacobian is taken as zero.
+	setJacobianPattern( vector< unsigned int >( dim + 1, 0 ),
+					vector< unsigned int >() );
+}
+
+void Rosenbrock::setJacobianPattern( const vector< unsigned int >& rowStart,
+				const vector< unsigned int >& colIndex )
+{
+	assert( rowStart.size() == dim_ + 1 );
+	assert( colIndex.size() == rowStart[ dim_ ] );
+	vector< unsigned int > wRowStart( 1, 0 );
+	vector< unsigned int > wColIndex;
+	jacToW_.resize( colIndex.size() );
+	wDiag_.resize( dim_ );
+	for ( unsigned int i = 0; i < dim_; ++i ) {
+		bool doneDiag = false;
+		for ( unsigned int p = rowStart[i]; p < rowStart[i + 1]; ++p ) {
+			unsigned int j = colIndex[p];
+			if ( !doneDiag && j >= i ) {
+				wDiag_[i] = wColIndex.size();
+				if ( j > i )
+					wColIndex.push_back( i );
+				doneDiag = true;
+			}
+			jacToW_[p] = wColIndex.size();
+			wColIndex.push_back( j );
+		}
+		if ( !doneDiag ) {
+			wDiag_[i] = wColIndex.size();
+			wColIndex.push_back( i );
+		}
+		wRowStart.push_back( wColIndex.size() );
+	}
+	jacValues_.assign( colIndex.size(), 0.0 );
+	wValues_.assign( wColIndex.size(), 0.0 );
+	lu_.setup( dim_, wRowStart, wColIndex );
+}
+
+void Rosenbrock::setTolerance( double epsAbs, double epsRel )
+{
+	epsAbs_ = epsAbs;
+	epsRel_ = epsRel;
+}
+
+void Rosenbrock::reset( double hstart )
+{
+	if ( hstart > 0.0 )
+		h_ = hstart;
+}
+
+bool Rosenbrock::factorW( double h )
+{
+	static const double d = 1.0 / ( 2.0 + sqrt( 2.0 ) );
+	wValues_.assign( wValues_.size(), 0.0 );
+	for ( unsigned int p = 0; p < jacValues_.size(); ++p )
+		wValues_[ jacToW_[p] ] = -h * d * jacValues_[p];
+	for ( unsigned int i = 0; i < dim_; ++i )
+		wValues_[ wDiag_[i] ] += 1.0;
+	return lu_.factor( &wValues_[0] );
+}
+
+int Rosenbrock::advance( double* t, double t1, double* y )
+{
+	static const double e32 = 6.0 + sqrt( 2.0 );
+	if ( dim_ == 0 ) {
+		*t = t1;
+		return 0;
+	}
+	// The caller may have changed y since the last call, so f0 is not
+	// carried over.
+	int status = func_( *t, y, &f0_[0], params_ );
+	if ( status != 0 )
+		return status;
+	bool haveJac = false;
+	while ( *t < t1 ) {
+		double h = h_;
+		bool isLast = false;
+		if ( *t + 1.01 * h >= t1 ) {
+			h = t1 - *t;
+			isLast = true;
+		}
+		if ( !haveJac ) {
+			jac_( *t, y, &jacValues_[0], params_ );
+			haveJac = true;
+		}
+		double err = 2.0;
+		if ( factorW( h ) ) {
+			for ( unsigned int i = 0; i < dim_; ++i )
+				k1_[i] = f0_[i];
+			lu_.solve( &k1_[0] );
+			for ( unsigned int i = 0; i < dim_; ++i )
+				ynew_[i] = y[i] + 0.5 * h * k1_[i];
+			status = func_( *t + 0.5 * h, &ynew_[0], &f1_[0], params_ );
+			if ( status != 0 )
+				return status;
+			for ( unsigned int i = 0; i < dim_; ++i )
+				k2_[i] = f1_[i] - k1_[i];
+			lu_.solve( &k2_[0] );
+			for ( unsigned int i = 0; i < dim_; ++i ) {
+				k2_[i] += k1_[i];
+				ynew_[i] = y[i] + h * k2_[i];
+			}
+			status = func_( *t + h, &ynew_[0], &f2_[0], params_ );
+			if ( status != 0 )
+				return status;
+			for ( unsigned int i = 0; i < dim_; ++i )
+				k3_[i] = f2_[i] - e32 * ( k2_[i] - f1_[i] ) -
+						2.0 * ( k1_[i] - f0_[i] );
+			lu_.solve( &k3_[0] );
+			err = 0.0;
+			for ( unsigned int i = 0; i < dim_; ++i ) {
+				double e = fabs( h * ( k1_[i] - 2.0 * k2_[i] + k3_[i] ) / 6.0 );
+				double scale = epsAbs_ +
+						epsRel_ * max( fabs( y[i] ), fabs( ynew_[i] ) );
+				e /= scale;
+				if ( std::isnan( e ) ) { // Reject the step and cut h hard.
+					err = 1.0e10;
+					break;
+				}
+				if ( e > err )
+					err = e;
+			}
+		}
+		double factor = ( err > 0.0 ) ? 0.8 * pow( err, -1.0 / 3.0 ) : 5.0;
+		if ( err <= 1.0 ) {
+			*t = isLast ? t1 : *t + h;
+			for ( unsigned int i = 0; i < dim_; ++i )
+				y[i] = ynew_[i];
+			f0_.swap( f2_ );
+			haveJac = false;
+			++numSteps_;
+			double hNext = h * min( 5.0, factor );
+			// A step cut short to land on t1 says little about the next.
+			h_ = isLast ? max( h_, hNext ) : hNext;
+		} else {
+			++numRejected_;
+			h_ = h * max( 0.2, factor );
+			if ( h_ < 4.0 * DBL_EPSILON * max( fabs( *t ), fabs( t1 ) ) )
+				return -1;
+		}
+	}
+	return 0;
+}
+
+unsigned long Rosenbrock::getNumSteps() const
+{
+	return numSteps_;
+}
+
+unsigned long Rosenbrock::getNumRejected() const
+{
+	return numRejected_;
+}
@@ -0,0 +1,96 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ROSENBROCK_H
+#define _ROSENBROCK_H
+
+/**
+ * Rosenbrock is an adaptive timestep implicit integrator for stiff
+ * systems, such as signaling models with fast binding steps, where the
+ * explicit Runge-Kutta methods are held to tiny timesteps.
+ * It uses the L-stable second order Rosenbrock method with a third
+ * order error estimate of Shampine and Reichelt (the MATLAB ode23s
+ * method). Each step evaluates the Jacobian once and solves three
+ * linear systems with the iteration matrix W = I - h d J. The Jacobian
+ * is supplied as a fixed sparsity pattern plus a function to fill in
+ * its values, so the symbolic factorization of W is only done when the
+ * pattern changes.
+ * The system functions are in the same form as for the GSL steppers.
+ */
+class Rosenbrock
+{
+	public:
+		/// Computes dydt at y. As in GSL, returns 0 on success.
+		typedef int ( *Func )( double t, const double* y, double* dydt,
+						void* params );
+		/// Fills in the Jacobian at y, in the order of the pattern.
+		typedef void ( *Jacobian )( double t, const double* y,
+						double* dfdy, void* params );
+
+		Rosenbrock();
+
+		void setSystem( unsigned int dim, Func func, Jacobian jac,
+						void* params );
+		/**
+		 * Assigns the sparsity pattern of the Jacobian, in compressed row
+		 * form with increasing columns in each row.
+		 */
+		void setJacobianPattern( const vector< unsigned int >& rowStart,
+						const vector< unsigned int >& colIndex );
+		/// Absolute and relative error tolerances for each step.
+		void setTolerance( double epsAbs, double epsRel );
+		/// Sets the timestep to try next, if it is positive.
+		void reset( double hstart );
+
+		/**
+		 * Advances y from *t to t1, and sets *t to t1. Returns 0 on
+		 * success, or the non-zero code of the system function, or -1
+		 * if the timestep has become too small.
+		 */
+		int advance( double* t, double t1, double* y );
+
+		/// Number of accepted steps since the system was set.
+		unsigned long getNumSteps() const;
+		/// Number of steps rejected for error or for a singular W.
+		unsigned long getNumRejected() const;
+
+	private:
+		/// Computes W = I - h d J from jac_ and factorizes it.
+		bool factorW( double h );
+
+		unsigned int dim_;
+		Func func_;
+		Jacobian jac_;
+		void* params_;
+		double epsAbs_;
+		double epsRel_;
+		double h_;
+
+		/// Position in wValues_ of each Jacobian entry.
+		vector< unsigned int > jacToW_;
+		/// Position in wValues_ of each diagonal entry.
+		vector< unsigned int > wDiag_;
+		vector< double > jacValues_;
+		vector< double > wValues_;
+		SparseLU lu_;
+
+		/// Work vectors, all of size dim_.
+		vector< double > f0_;
+		vector< double > f1_;
+		vector< double > f2_;
+		vector< double > k1_;
+		vector< double > k2_;
+		vector< double > k3_;
+		vector< double > ynew_;
+
+		unsigned long numSteps_;
+		unsigned long numRejected_;
+};
+
+#endif // _ROSENBROCK_H
@@ -0,0 +1,172 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include <set>
+#include "SparseLU.h"
+
+SparseLU::SparseLU()
+	: n_( 0 )
+{;}
+
+void SparseLU::setup( unsigned int n,
+				const vector< unsigned int >& rowStart,
+				const vector< unsigned int >& colIndex )
+{
+	assert( rowStart.size() == n + 1 );
+	assert( colIndex.size() == rowStart[n] );
+	n_ = n;
+
+	// Order by minimum degree on the symmetrized pattern. Eliminating
+	// a node joins up all its neighbours, as the fill-in would.
+	vector< set< unsigned int > > adj( n );
+	for ( unsigned int i = 0; i < n; ++i ) {
+		for ( unsigned int p = rowStart[i]; p < rowStart[i + 1]; ++p ) {
+			unsigned int j = colIndex[p];
+			assert( j < n );
+			if ( j != i ) {
+				adj[i].insert( j );
+				adj[j].insert( i );
+			}
+		}
+	}
+	perm_.resize( 0 );
+	vector< bool > done( n, false );
+	for ( unsigned int step = 0; step < n; ++step ) {
+		unsigned int best = n;
+		for ( unsigned int i = 0; i < n; ++i ) {
+			if ( !done[i] && ( best == n || adj[i].size() < adj[best].size() ) )
+				best = i;
+		}
+		perm_.push_back( best );
+		done[ best ] = true;
+		const set< unsigned int >& nb = adj[ best ];
+		for ( set< unsigned int >::const_iterator
+						i = nb.begin(); i != nb.end(); ++i ) {
+			adj[ *i ].erase( best );
+			for ( set< unsigned int >::const_iterator
+							j = nb.begin(); j != nb.end(); ++j )
+				if ( *i != *j )
+					adj[ *i ].insert( *j );
+		}
+		adj[ best ].clear();
+	}
+	vector< unsigned int > inv( n );
+	for ( unsigned int i = 0; i < n; ++i )
+		inv[ perm_[i] ] = i;
+
+	// Symbolic elimination, a row at a time. Each earlier row k in the
+	// lower part of row i brings in the upper pattern of row k.
+	rowStart_.assign( 1, 0 );
+	colIndex_.resize( 0 );
+	diag_.resize( n );
+	for ( unsigned int i = 0; i < n; ++i ) {
+		unsigned int r = perm_[i];
+		set< unsigned int > cols;
+		cols.insert( i );
+		for ( unsigned int p = rowStart[r]; p < rowStart[r + 1]; ++p )
+			cols.insert( inv[ colIndex[p] ] );
+		for ( set< unsigned int >::iterator
+						k = cols.begin(); *k < i; ++k ) {
+			for ( unsigned int q = diag_[ *k ] + 1;
+							q < rowStart_[ *k + 1 ]; ++q )
+				cols.insert( colIndex_[q] );
+		}
+		for ( set< unsigned int >::iterator
+						k = cols.begin(); k != cols.end(); ++k ) {
+			if ( *k == i )
+				diag_[i] = colIndex_.size();
+			colIndex_.push_back( *k );
+		}
+		rowStart_.push_back( colIndex_.size() );
+	}
+	lu_.assign( colIndex_.size(), 0.0 );
+	work_.assign( n, 0.0 );
+
+	map_.resize( colIndex.size() );
+	for ( unsigned int r = 0; r < n; ++r ) {
+		unsigned int i = inv[r];
+		vector< unsigned int >::const_iterator begin =
+				colIndex_.begin() + rowStart_[i];
+		vector< unsigned int >::const_iterator end =
+				colIndex_.begin() + rowStart_[i + 1];
+		for ( unsigned int p = rowStart[r]; p < rowStart[r + 1]; ++p ) {
+			vector< unsigned int >::const_iterator q =
+					lower_bound( begin, end, inv[ colIndex[p] ] );
+			assert( q != end && *q == inv[ colIndex[p] ] );
+			map_[p] = q - colIndex_.begin();
+		}
+	}
+}
+
+bool SparseLU::factor( const double* values )
+{
+	lu_.assign( lu_.size(), 0.0 );
+	for ( unsigned int p = 0; p < map_.size(); ++p )
+		lu_[ map_[p] ] += values[p];
+
+	for ( unsigned int i = 0; i < n_; ++i ) {
+		unsigned int end = rowStart_[i + 1];
+		for ( unsigned int p = rowStart_[i]; p < end; ++p )
+			work_[ colIndex_[p] ] = lu_[p];
+		for ( unsigned int p = rowStart_[i]; p < diag_[i]; ++p ) {
+			unsigned int k = colIndex_[p];
+			double l = work_[k] / lu_[ diag_[k] ];
+			work_[k] = l;
+			for ( unsigned int q = diag_[k] + 1; q < rowStart_[k + 1]; ++q )
+				work_[ colIndex_[q] ] -= l * lu_[q];
+		}
+		double rowMax = 0.0;
+		for ( unsigned int p = rowStart_[i]; p < end; ++p ) {
+			unsigned int j = colIndex_[p];
+			lu_[p] = work_[j];
+			work_[j] = 0.0;
+			if ( p >= diag_[i] && fabs( lu_[p] ) > rowMax )
+				rowMax = fabs( lu_[p] );
+		}
+		// The negated test also catches NaNs.
+		if ( !( fabs( lu_[ diag_[i] ] ) > 1.0e-14 * rowMax ) )
+			return false;
+	}
+	return true;
+}
+
+void SparseLU::solve( double* x ) const
+{
+	if ( n_ == 0 )
+		return;
+	double* y = &work_[0];
+	for ( unsigned int i = 0; i < n_; ++i ) {
+		double sum = x[ perm_[i] ];
+		for ( unsigned int p = rowStart_[i]; p < diag_[i]; ++p )
+			sum -= lu_[p] * y[ colIndex_[p] ];
+		y[i] = sum;
+	}
+	for ( unsigned int i = n_; i > 0; --i ) {
+		unsigned int r = i - 1;
+		double sum = y[r];
+		for ( unsigned int p = diag_[r] + 1; p < rowStart_[r + 1]; ++p )
+			sum -= lu_[p] * y[ colIndex_[p] ];
+		y[r] = sum / lu_[ diag_[r] ];
+	}
+	for ( unsigned int i = 0; i < n_; ++i ) {
+		x[ perm_[i] ] = y[i];
+		y[i] = 0.0;
+	}
+}
+
+unsigned int SparseLU::getSize() const
+{
+	return n_;
+}
+
+unsigned int SparseLU::getNumEntries() const
+{
+	return colIndex_.size();
+}
@@ -0,0 +1,78 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _SPARSE_LU_H
+#define _SPARSE_LU_H
+
+/**
+ * SparseLU solves A x = b for a square sparse matrix A whose sparsity
+ * pattern stays the same while its values change, as for the iteration
+ * matrix of an implicit ODE method.
+ * The symbolic work is done once in setup(): the rows and columns are
+ * reordered by a minimum degree heuristic to limit fill-in, and the
+ * pattern of the factors, fill-in included, is computed. Each factor()
+ * call then only does the numeric elimination over that pattern.
+ * There is no pivoting, so factor() fails if a pivot becomes too small.
+ * The caller is expected to recover, for example by taking a smaller
+ * timestep, which makes the iteration matrix closer to the identity.
+ */
+class SparseLU
+{
+	public:
+		SparseLU();
+
+		/**
+		 * Does the symbolic factorization for an n by n matrix with the
+		 * given pattern, in compressed row form. The column indices of
+		 * each row must be in increasing order. The diagonal is added
+		 * if it is not in the pattern.
+		 */
+		void setup( unsigned int n,
+						const vector< unsigned int >& rowStart,
+						const vector< unsigned int >& colIndex );
+
+		/**
+		 * Factorizes the matrix whose entries are given in the order of
+		 * the pattern passed to setup. Returns false if a pivot is zero
+		 * or too small compared to the rest of its row.
+		 */
+		bool factor( const double* values );
+
+		/// Solves in place for x, using the last factorization.
+		void solve( double* x ) const;
+
+		unsigned int getSize() const;
+		/// Number of entries in the factors, including fill-in.
+		unsigned int getNumEntries() const;
+
+	private:
+		unsigned int n_;
+
+		/// perm_[i] is the original index of row and column i.
+		vector< unsigned int > perm_;
+
+		/**
+		 * Pattern of the factors in the reordered indices, in
+		 * compressed row form with sorted columns. L has a unit diagonal
+		 * and is stored below the diagonal, U on and above it.
+		 */
+		vector< unsigned int > rowStart_;
+		vector< unsigned int > colIndex_;
+		/// Position of the diagonal entry of each row.
+		vector< unsigned int > diag_;
+		vector< double > lu_;
+
+		/// Position in lu_ of each entry of the input pattern.
+		vector< unsigned int > map_;
+
+		/// Dense work vector, kept all zero between calls.
+		mutable vector< double > work_;
+};
+
+#endif // _SPARSE_LU_H
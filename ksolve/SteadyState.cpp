@@ -22,6 +22,9 @@
 #include "SparseMatrix.h"
 #include "KinSparseMatrix.h"
 #include "RateTerm.h"
+#include "RateProgram.h"
+#include "SparseLU.h"
+#include "Rosenbrock.h"
 #include "FuncTerm.h"
 #include "VoxelPoolsBase.h"
 #include "../mesh/VoxelJunction.h"
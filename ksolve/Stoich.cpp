@@ -559,6 +559,16 @@ const FuncTerm* Stoich::funcs( unsigned int i ) const
 	return funcs_[i];
 }
 
+bool Stoich::funcsAreReentrant() const
+{
+	for ( vector< FuncTerm* >::const_iterator i = funcs_.begin();
+					i != funcs_.end(); ++i ) {
+		if ( *i && !(*i)->isCompiled() )
+			return false;
+	}
+	return true;
+}
+
 vector< int > Stoich::getMatrixEntry() const
 {
 	return N_.matrixEntry();
@@ -1802,6 +1812,17 @@ void Stoich::updateFuncs( double* s, double t ) const
 	}
 }
 
+void Stoich::updateFuncsBulk( const vector< double* >& s, double t ) const
+{
+	if ( s.empty() )
+		return;
+	for ( vector< FuncTerm* >::const_iterator i = funcs_.begin();
+					i != funcs_.end(); ++i ) {
+		if ( *i )
+			(*i)->evalPoolBulk( &s[0], s.size(), t );
+	}
+}
+
 /**
  * updateJunctionRates:
  * Updates the rates for cross-compartment reactions. These are located
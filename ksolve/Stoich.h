@@ -126,6 +126,11 @@ class Stoich
 
 		unsigned int getNumFuncs() const;
 		const FuncTerm* funcs( unsigned int i ) const;
+		/**
+		 * True if all the FuncTerms are compiled. These keep no scratch
+		 * state while they run, so the voxels may be split among threads.
+		 */
+		bool funcsAreReentrant() const;
 
 		vector< int > getMatrixEntry() const;
 		vector< unsigned int > getColIndex() const;
@@ -438,6 +443,8 @@ class Stoich
 
 		/// Updates the function values, within s.
 		void updateFuncs( double* s, double t ) const;
+		/// Updates the function values in the pool vectors of all voxels.
+		void updateFuncsBulk( const vector< double* >& s, double t ) const;
 
 		/// Updates the rates for cross-compartment reactions.
 		/*
@@ -14,9 +14,12 @@
 #endif
 
 #include "OdeSystem.h"
+#include "RateTerm.h"
+#include "RateProgram.h"
+#include "SparseLU.h"
+#include "Rosenbrock.h"
 #include "VoxelPoolsBase.h"
 #include "VoxelPools.h"
-#include "RateTerm.h"
 #include "FuncTerm.h"
 #include "SparseMatrix.h"
 #include "KinSparseMatrix.h"
@@ -30,6 +33,10 @@
 //////////////////////////////////////////////////////////////
 
 VoxelPools::VoxelPools()
+	:
+		useStiff_( false ),
+		jacVersion_( ~0U ),
+		numJacEntries_( 0 )
 {
 #ifdef USE_GSL
 		driver_ = 0;
@@ -52,6 +59,8 @@ VoxelPools::~VoxelPools()
 void VoxelPools::reinit( double dt )
 {
 	VoxelPoolsBase::reinit();
+	if ( useStiff_ )
+		stiff_.reset( dt );
 #ifdef USE_GSL
 	if ( !driver_ )
 		return;
@@ -63,8 +72,19 @@ void VoxelPools::reinit( double dt )
 void VoxelPools::setStoich( Stoich* s, const OdeSystem* ode )
 {
 	stoichPtr_ = s;
-#ifdef USE_GSL
 	if ( ode ) {
+		useStiff_ = ( ode->method == "rosenbrock" );
+		if ( useStiff_ ) {
+			stiff_.setSystem( 
+				stoichPtr_->getNumAllPools() + stoichPtr_->getNumProxyPools(),
+				&VoxelPools::gslFunc, &VoxelPools::stiffJacobian, this );
+			stiff_.setTolerance( ode->epsAbs, ode->epsRel );
+			stiff_.reset( ode->initStepSize );
+			jacVersion_ = ~0U; // The pattern is built on the first advance.
+		}
+	}
+#ifdef USE_GSL
+	if ( ode && !useStiff_ ) {
 		sys_ = ode->gslSys;
 		if ( driver_ )
 			gsl_odeiv2_driver_free( driver_ );
@@ -78,6 +98,18 @@ void VoxelPools::setStoich( Stoich* s, const OdeSystem* ode )
 
 void VoxelPools::advance( const ProcInfo* p )
 {
+	if ( useStiff_ ) {
+		if ( jacVersion_ != rateProgram_.getVersion() )
+			buildJacobianPattern();
+		double t = p->currTime - p->dt;
+		int status = stiff_.advance( &t, p->currTime, varS() );
+		if ( status != 0 ) {
+			cout << "Error: VoxelPools::advance: Rosenbrock integration "
+				"error at time " << t << ", status " << status << endl;
+			assert( 0 );
+		}
+		return;
+	}
 #ifdef USE_GSL
 	double t = p->currTime - p->dt;
 	int status = gsl_odeiv2_driver_apply( driver_, &t, p->currTime, varS());
@@ -99,6 +131,10 @@ void VoxelPools::advance( const ProcInfo* p )
 
 void VoxelPools::setInitDt( double dt )
 {
+	if ( useStiff_ ) {
+		stiff_.reset( dt );
+		return;
+	}
 #ifdef USE_GSL
 	gsl_odeiv2_driver_reset_hstart( driver_, dt );
 #endif
@@ -130,6 +166,83 @@ int VoxelPools::gslFunc( double t, const double* y, double *dydt,
 	return 0;
 #endif
 }
+
+// static func. Fills in the Jacobian for the Rosenbrock method.
+void VoxelPools::stiffJacobian( double t, const double* y, double* dfdy,
+				void* params )
+{
+	VoxelPools* vp = reinterpret_cast< VoxelPools* >( params );
+	double* q = const_cast< double* >( y ); // Assign the func portion.
+	vp->stoichPtr_->updateFuncs( q, t );
+	if ( !vp->derivs_.empty() )
+		vp->rateProgram_.evaluateDerivs( q, &vp->derivs_[0] );
+	for ( unsigned int i = 0; i < vp->numJacEntries_; ++i )
+		dfdy[i] = 0.0;
+	for ( unsigned int i = 0; i < vp->jacIndex_.size(); ++i )
+		dfdy[ vp->jacIndex_[i] ] += 
+				vp->jacCoeff_[i] * vp->derivs_[ vp->jacSlot_[i] ];
+}
+
+void VoxelPools::buildJacobianPattern()
+{
+	const KinSparseMatrix& N = stoichPtr_->getStoichiometryMatrix();
+	unsigned int dim = 
+			stoichPtr_->getNumAllPools() + stoichPtr_->getNumProxyPools();
+	unsigned int totVar = stoichPtr_->getNumVarPools() + 
+			stoichPtr_->getNumProxyPools();
+	assert( N.nColumns() == rateProgram_.getNumRates() );
+
+	// Gather the columns of N, over the rows of the variable pools.
+	vector< vector< unsigned int > > colRows( N.nColumns() );
+	vector< vector< int > > colEntries( N.nColumns() );
+	for ( unsigned int i = 0; i < totVar && i < N.nRows(); ++i ) {
+		const int* entry = 0;
+		const unsigned int* colIndex = 0;
+		unsigned int num = N.getRow( i, &entry, &colIndex );
+		for ( unsigned int j = 0; j < num; ++j ) {
+			colRows[ colIndex[j] ].push_back( i );
+			colEntries[ colIndex[j] ].push_back( entry[j] );
+		}
+	}
+
+	// Each term of J = N dv/dS, keyed by its position in J.
+	const vector< unsigned int >& reac = rateProgram_.getDerivReac();
+	const vector< unsigned int >& pool = rateProgram_.getDerivPool();
+	vector< pair< unsigned long, unsigned int > > terms;
+	jacSlot_.resize( 0 );
+	jacCoeff_.resize( 0 );
+	for ( unsigned int k = 0; k < reac.size(); ++k ) {
+		assert( pool[k] < dim );
+		const vector< unsigned int >& rows = colRows[ reac[k] ];
+		for ( unsigned int m = 0; m < rows.size(); ++m ) {
+			unsigned long key = 
+					static_cast< unsigned long >( rows[m] ) * dim + pool[k];
+			terms.push_back( pair< unsigned long, unsigned int >( 
+				key, jacSlot_.size() ) );
+			jacSlot_.push_back( k );
+			jacCoeff_.push_back( colEntries[ reac[k] ][m] );
+		}
+	}
+	sort( terms.begin(), terms.end() );
+
+	vector< unsigned int > rowStart( dim + 1, 0 );
+	vector< unsigned int > colIndex;
+	jacIndex_.resize( terms.size() );
+	for ( unsigned int k = 0; k < terms.size(); ++k ) {
+		if ( k == 0 || terms[k].first != terms[k - 1].first ) {
+			colIndex.push_back( terms[k].first % dim );
+			rowStart[ terms[k].first / dim + 1 ]++;
+		}
+		jacIndex_[ terms[k].second ] = colIndex.size() - 1;
+	}
+	for ( unsigned int i = 0; i < dim; ++i )
+		rowStart[i + 1] += rowStart[i];
+	numJacEntries_ = colIndex.size();
+	derivs_.resize( rateProgram_.getNumDerivs() );
+	stiff_.setJacobianPattern( rowStart, colIndex );
+	jacVersion_ = rateProgram_.getVersion();
+}
+
 ///////////////////////////////////////////////////////////////////////
 // Here are the internal reaction rate calculation functions
 ///////////////////////////////////////////////////////////////////////
@@ -149,6 +262,7 @@ void VoxelPools::updateAllRateTerms( const vector< RateTerm* >& rates,
 				getXreacScaleSubstrates(i - numCoreRates),
 				getXreacScaleProducts(i - numCoreRates ) );
 	}
+	rateProgram_.build( rates_ );
 }
 
 void VoxelPools::updateRateTerms( const vector< RateTerm* >& rates,
@@ -167,13 +281,19 @@ void VoxelPools::updateRateTerms( const vector< RateTerm* >& rates,
 	else
 		rates_[index] = rates[index]->copyWithVolScaling(  
 				getVolume(), 1.0, 1.0 );
+	rateProgram_.update( rates_, index );
+}
+
+void VoxelPools::rateTermsReplaced()
+{
+	rateProgram_.build( rates_ );
 }
 
 void VoxelPools::updateRates( const double* s, double* yprime ) const
 {
 	const KinSparseMatrix& N = stoichPtr_->getStoichiometryMatrix();
-	vector< double > v( N.nColumns(), 0.0 );
-	vector< double >::iterator j = v.begin();
+	vector< double >& v = v_;
+	v.resize( N.nColumns() );
 	// totVar should include proxyPools only if this voxel uses them
 	unsigned int totVar = stoichPtr_->getNumVarPools() + 
 			stoichPtr_->getNumProxyPools();
@@ -183,12 +303,14 @@ void VoxelPools::updateRates( const double* s, double* yprime ) const
 			N.nRows() == 
 			stoichPtr_->getNumAllPools() + stoichPtr_->getNumProxyPools() );
 	assert( N.nColumns() == rates_.size() );
+	assert( rateProgram_.getNumRates() == rates_.size() );
 
-	for ( vector< RateTerm* >::const_iterator
-		i = rates_.begin(); i != rates_.end(); i++) {
-		*j++ = (**i)( s );
-		assert( !std::isnan( *( j-1 ) ) );
-	}
+	if ( !v.empty() )
+		rateProgram_.evaluate( s, &v[0] );
+#ifndef NDEBUG
+	for ( unsigned int i = 0; i < v.size(); ++i )
+		assert( !std::isnan( v[i] ) );
+#endif
 
 	for (unsigned int i = 0; i < totVar; ++i)
 		*yprime++ = N.computeRowRate( i , v );
@@ -207,15 +329,16 @@ void VoxelPools::updateReacVelocities(
 	const KinSparseMatrix& N = stoichPtr_->getStoichiometryMatrix();
 	assert( N.nColumns() == rates_.size() );
 
-	vector< RateTerm* >::const_iterator i;
+	assert( rateProgram_.getNumRates() == rates_.size() );
 	v.clear();
 	v.resize( rates_.size(), 0.0 );
-	vector< double >::iterator j = v.begin();
 
-	for ( i = rates_.begin(); i != rates_.end(); i++) {
-		*j++ = (**i)( s );
-		assert( !std::isnan( *( j-1 ) ) );
-	}
+	if ( !v.empty() )
+		rateProgram_.evaluate( s, &v[0] );
+#ifndef NDEBUG
+	for ( unsigned int i = 0; i < v.size(); ++i )
+		assert( !std::isnan( v[i] ) );
+#endif
 }
 
 /// For debugging: Print contents of voxel pool
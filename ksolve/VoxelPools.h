@@ -43,6 +43,13 @@ class VoxelPools: public VoxelPoolsBase
 		static int gslFunc( double t, const double* y, double *dydt, 
 						void* params );
 
+		/**
+		 * Evaluates the Jacobian of the rates for the Rosenbrock method,
+		 * in the order of the pattern from buildJacobianPattern.
+		 */
+		static void stiffJacobian( double t, const double* y, 
+						double* dfdy, void* params );
+
 		//////////////////////////////////////////////////////////////////
 		// Rate manipulation and calculation functions
 		//////////////////////////////////////////////////////////////////
@@ -83,7 +90,39 @@ class VoxelPools: public VoxelPoolsBase
 
 		/// Used for debugging.
 		void print() const;
+	protected:
+		/// Recompiles rateProgram_ after rates_ entries are replaced.
+		void rateTermsReplaced();
 	private:
+		/**
+		 * Assembles the sparsity pattern of the Jacobian of the rates,
+		 * J = N dv/dS, from the stoichiometry matrix N and the
+		 * derivative slots of rateProgram_, and passes it to stiff_.
+		 * Only the rows of the variable pools are filled.
+		 */
+		void buildJacobianPattern();
+
+		/// True if the voxel uses the Rosenbrock method rather than GSL.
+		bool useStiff_;
+		Rosenbrock stiff_;
+		/// Version of rateProgram_ that the Jacobian pattern is from.
+		unsigned int jacVersion_;
+		/**
+		 * Each term of the Jacobian adds jacCoeff_[i] times derivative
+		 * slot jacSlot_[i] into entry jacIndex_[i] of the pattern.
+		 */
+		vector< unsigned int > jacIndex_;
+		vector< unsigned int > jacSlot_;
+		vector< double > jacCoeff_;
+		unsigned int numJacEntries_;
+		/// Scratch vector for the derivatives of the reaction velocities.
+		vector< double > derivs_;
+
+		/// Flat form of rates_, used to compute the reaction velocities.
+		RateProgram rateProgram_;
+
+		/// Scratch vector for reaction velocities, to avoid allocation.
+		mutable vector< double > v_;
 #ifdef USE_GSL
 		gsl_odeiv2_driver* driver_;
 		gsl_odeiv2_system sys_;
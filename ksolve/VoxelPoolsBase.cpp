@@ -314,6 +314,7 @@ void VoxelPoolsBase::filterCrossRateTerms(
 			}
 		}
 	}
+	rateTermsReplaced();
 }
 
 ////////////////////////////////////////////////////////////////////////
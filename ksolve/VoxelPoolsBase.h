@@ -198,6 +198,13 @@ class VoxelPoolsBase
 		void print() const;
 
 	protected:
+		/**
+		 * Called after entries of rates_ have been replaced, so that
+		 * derived classes can refresh anything they built from them.
+		 */
+		virtual void rateTermsReplaced()
+		{;}
+
 		const Stoich* stoichPtr_;
 		vector< RateTerm* > rates_;
 
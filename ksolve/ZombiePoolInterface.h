@@ -81,6 +81,38 @@ class ZombiePoolInterface
 		 */
 		virtual void setBlock( const vector< double >& values ) = 0;
 
+		/**
+		 * Asks a diffusion solver to keep the 'n' of its pools directly
+		 * in the S arrays of the reac solver, so that no values need to
+		 * be passed by getBlock and setBlock each timestep.
+		 * voxelS[i] is the S array of voxel i, whose first numPools
+		 * entries are the pools in the order of the Stoich.
+		 * Returns false if the solver cannot do this.
+		 */
+		virtual bool setSharedState( const vector< double* >& voxelS,
+						unsigned int numPools )
+		{
+			return false;
+		}
+
+		/**
+		 * Ends the sharing set up by setSharedState. Must be called
+		 * before the reac solver reallocates its S arrays. The diffusion
+		 * solver also calls it itself when it reallocates its pools.
+		 */
+		virtual void clearSharedState()
+		{;}
+
+		/**
+		 * True while the sharing set up by setSharedState is in force.
+		 * This is the only record of it, so the reac solver must check
+		 * here rather than remember the return of setSharedState.
+		 */
+		virtual bool isStateShared() const
+		{
+			return false;
+		}
+
 		/**
 		 * Informs the ZPI about the stoich, used during subsequent
 		 * computations.
@@ -8,7 +8,10 @@
 **********************************************************************/
 #include "header.h"
 #include "../shell/Shell.h"
+#include "../scheduling/Clock.h"
 #include "RateTerm.h"
+#include "RateProgram.h"
+#include "SparseLU.h"
 #include "muParser.h"
 #include "FuncTerm.h"
 #include "SparseMatrix.h"
@@ -311,6 +314,174 @@ void testRunGsolve()
 	cout << "." << flush;
 }
 
+/**
+ * Runs A <===> B in a 10-voxel cylinder, using the specified solver class
+ * (Ksolve or Gsolve) and number of threads. Each voxel starts with a 
+ * different amount of A. Returns the final n of B in each voxel.
+ * The selectMethod is only used by the Gsolve.
+ */
+vector< double > runMultiVoxelSolver( const string& method, 
+	unsigned int numThreads, const string& selectMethod = "linear" )
+{
+	double simDt = 0.1;
+	Shell* s = reinterpret_cast< Shell* >( Id().eref().data() );
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	Id cyl = s->doCreate( "CylMesh", model, "cyl", 1 );
+	Field< double >::set( cyl, "r0", 1e-6 );
+	Field< double >::set( cyl, "r1", 1e-6 );
+	Field< double >::set( cyl, "x0", 0 );
+	Field< double >::set( cyl, "x1", 10e-6 );
+	Field< double >::set( cyl, "diffLength", 1e-6 );
+	unsigned int numVoxels = Field< unsigned int >::get( cyl, "numMesh" );
+	assert( numVoxels == 10 );
+	Id A = s->doCreate( "Pool", cyl, "A", 1 );
+	Id B = s->doCreate( "Pool", cyl, "B", 1 );
+	Id r = s->doCreate( "Reac", cyl, "r", 1 );
+	s->doAddMsg( "Single", r, "sub", A, "reac" );
+	s->doAddMsg( "Single", r, "prd", B, "reac" );
+	Field< double >::set( r, "Kf", 0.2 );
+	Field< double >::set( r, "Kb", 0.1 );
+
+	Id ksolve = s->doCreate( method, model, "ksolve", 1 );
+	Field< unsigned int >::set( ksolve, "numThreads", numThreads );
+	assert( Field< unsigned int >::get( ksolve, "numThreads" ) == 
+					( numThreads > 0 ? numThreads : 1 ) );
+	if ( method == "Gsolve" ) {
+		Field< unsigned int >::set( ksolve, "seed", 1234 );
+		Field< string >::set( ksolve, "selectMethod", selectMethod );
+		assert( Field< string >::get( ksolve, "selectMethod" ) == 
+						selectMethod );
+	}
+	Id stoich = s->doCreate( "Stoich", ksolve, "stoich", 1 );
+	Field< Id >::set( stoich, "compartment", cyl );
+	Field< Id >::set( stoich, "ksolve", ksolve );
+	Field< string >::set( stoich, "path", "/model/cyl/##" );
+	assert( A.element()->numData() == numVoxels );
+
+	vector< double > nInit( numVoxels );
+	for ( unsigned int i = 0; i < numVoxels; ++i )
+		nInit[i] = 100.0 * ( i + 1 );
+	Field< double >::setVec( A, "nInit", nInit );
+
+	s->doUseClock( "/model/ksolve", "process", 4 ); 
+	s->doSetClock( 4, simDt );
+	s->doReinit();
+	s->doStart( 10.0 );
+
+	vector< double > ret;
+	Field< double >::getVec( B, "n", ret );
+	assert( ret.size() == numVoxels );
+	s->doDelete( model );
+	return ret;
+}
+
+void testRunKsolveThreaded()
+{
+	vector< double > serial = runMultiVoxelSolver( "Ksolve", 1 );
+	vector< double > threaded = runMultiVoxelSolver( "Ksolve", 3 );
+	assert( serial.size() == threaded.size() );
+	for ( unsigned int i = 0; i < serial.size(); ++i ) {
+		assert( serial[i] == threaded[i] ); // Should be bitwise equal.
+		if ( i > 0 )
+			assert( serial[i] > serial[i-1] );
+	}
+	cout << "." << flush;
+}
+
+/**
+ * With a fixed seed each voxel has its own random number stream, so the
+ * stochastic run should be identical however the voxels are divided
+ * among threads.
+ */
+void testRunGsolveThreaded()
+{
+	const char* selectMethod[] = { "linear", "tree" };
+	for ( unsigned int j = 0; j < 2; ++j ) {
+		vector< double > serial = 
+				runMultiVoxelSolver( "Gsolve", 1, selectMethod[j] );
+		vector< double > threaded = 
+				runMultiVoxelSolver( "Gsolve", 3, selectMethod[j] );
+		assert( serial.size() == threaded.size() );
+		for ( unsigned int i = 0; i < serial.size(); ++i ) {
+			assert( serial[i] == threaded[i] );
+			// Roughly 2/3 of A should have gone to B by now.
+			assert( serial[i] > 0.4 * 100.0 * ( i + 1 ) );
+			assert( serial[i] < 0.9 * 100.0 * ( i + 1 ) );
+		}
+	}
+	cout << "." << flush;
+}
+
+/**
+ * Runs A <===> B in each of 4 separate compartments, each with its own
+ * Ksolve, with the Clock using the specified number of threads.
+ * Returns the final n of B in each compartment, and puts the number of
+ * ticks that the Clock split among threads into numThreadedTicks.
+ */
+vector< double > runKsolvesOnClockThreads( unsigned int numThreads,
+				unsigned long& numThreadedTicks )
+{
+	Shell* s = reinterpret_cast< Shell* >( Id().eref().data() );
+	Id clock( 1 );
+	Field< unsigned int >::set( clock, "numThreads", numThreads );
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	vector< Id > B( 4 );
+	for ( unsigned int i = 0; i < B.size(); ++i ) {
+		stringstream ss;
+		ss << "compt" << i;
+		Id compt = s->doCreate( "CubeMesh", model, ss.str(), 1 );
+		Field< double >::set( compt, "volume", 1e-18 );
+		Id A = s->doCreate( "Pool", compt, "A", 1 );
+		B[i] = s->doCreate( "Pool", compt, "B", 1 );
+		Id r = s->doCreate( "Reac", compt, "r", 1 );
+		s->doAddMsg( "Single", r, "sub", A, "reac" );
+		s->doAddMsg( "Single", r, "prd", B[i], "reac" );
+		Field< double >::set( r, "Kf", 0.1 * ( i + 1 ) );
+		Field< double >::set( r, "Kb", 0.1 );
+		Field< double >::set( A, "nInit", 100 );
+		Id ksolve = s->doCreate( "Ksolve", model, "ksolve" + ss.str(), 1 );
+		Id stoich = s->doCreate( "Stoich", ksolve, "stoich", 1 );
+		Field< Id >::set( stoich, "compartment", compt );
+		Field< Id >::set( stoich, "ksolve", ksolve );
+		Field< string >::set( stoich, "path", "/model/" + ss.str() + "/##" );
+	}
+	s->doUseClock( "/model/#[ISA=Ksolve]", "process", 4 ); 
+	s->doSetClock( 4, 0.1 );
+	s->doReinit();
+	s->doStart( 10.0 );
+
+	vector< double > ret;
+	for ( unsigned int i = 0; i < B.size(); ++i )
+		ret.push_back( Field< double >::get( B[i], "n" ) );
+	numThreadedTicks = reinterpret_cast< const Clock* >( 
+					clock.eref().data() )->getNumThreadedTicks();
+	s->doDelete( model );
+	Field< unsigned int >::set( clock, "numThreads", 1 );
+	return ret;
+}
+
+void testRunKsolvesOnClockThreads()
+{
+	unsigned long numSerialTicks = 0;
+	unsigned long numThreadedTicks = 0;
+	vector< double > serial = runKsolvesOnClockThreads( 1, numSerialTicks );
+	vector< double > threaded = 
+			runKsolvesOnClockThreads( 3, numThreadedTicks );
+	assert( numSerialTicks == 0 );
+	// Every one of the 100 steps of each tick that calls the Ksolves
+	// went to the threads. The Ksolves are on their default ticks as
+	// well as on tick 4, so there is more than one such tick.
+	assert( numThreadedTicks > 0 );
+	assert( numThreadedTicks % 100 == 0 );
+	assert( serial.size() == threaded.size() );
+	for ( unsigned int i = 0; i < serial.size(); ++i ) {
+		assert( serial[i] == threaded[i] );
+		if ( i > 0 )
+			assert( serial[i] > serial[i-1] );
+	}
+	cout << "." << flush;
+}
+
 void testFuncTerm()
 {
 	FuncTerm ft;
@@ -332,6 +503,196 @@ void testFuncTerm()
 	ft.setReactantIndex( mol );
 	ans = ft( args, 2.0 );
 	assert( doubleEq( ans, 21.0 ) );
+	assert( ft.isCompiled() );
+
+	// All voxels at once, with the target pool also an argument.
+	double v0[] = { 1, 2, 3 };
+	double v1[] = { 4, 5, 6 };
+	double* voxels[] = { v0, v1 };
+	mol[0] = 2;
+	mol[1] = 1;
+	ft.setReactantIndex( mol );
+	ft.setTarget( 2 );
+	ft.setExpr( "x0 * x1 + t" );
+	ft.evalPoolBulk( voxels, 2, 0.5 );
+	assert( doubleEq( v0[2], 6.5 ) );
+	assert( doubleEq( v1[2], 30.5 ) );
+	cout << "." << flush;
+}
+
+void testRateProgram()
+{
+	double S[] = { 1.5, 2.0, 0.25, 7.0, 3.0 };
+	vector< unsigned int > v3( 3 );
+	v3[0] = 0; v3[1] = 3; v3[2] = 4;
+	vector< unsigned int > v2( 2, 1 );
+	vector< RateTerm* > rates;
+	rates.push_back( new FirstOrder( 0.3, 2 ) );
+	rates.push_back( new BidirectionalReaction( 
+		new SecondOrder( 0.7, 0, 1 ), new FirstOrder( 0.11, 3 ) ) );
+	rates.push_back( new MMEnzyme1( 0.9, 4.0, 4, 2 ) );
+	rates.push_back( new NOrder( 0.05, v3 ) );
+	rates.push_back( new ZeroOrder( 0.2 ) );
+	rates.push_back( new BidirectionalReaction( 
+		new NOrder( 0.01, v3 ), new ZeroOrder( 0.4 ) ) );
+	rates.push_back( new StochSecondOrderSingleSubstrate( 0.6, 1 ) );
+	rates.push_back( new Flux( 0.8, 4 ) );
+	rates.push_back( new ExternReac );
+	rates.push_back( new BidirectionalReaction( 
+		new FirstOrder( 2.5, 1 ), new SecondOrder( 1.25, 2, 4 ) ) );
+
+	RateProgram rp;
+	rp.build( rates );
+	assert( rp.getNumRates() == rates.size() );
+	assert( rp.getNumFallback() == 4 );
+	vector< double > v( rates.size(), -1.0 );
+	rp.evaluate( S, &v[0] );
+	for ( unsigned int i = 0; i < rates.size(); ++i )
+		assert( v[i] == ( *rates[i] )( S ) ); // Must be identical.
+
+	// Same form: only the constants change.
+	delete rates[1];
+	rates[1] = new BidirectionalReaction( 
+		new SecondOrder( 0.35, 1, 1 ), new FirstOrder( 0.22, 4 ) );
+	rp.update( rates, 1 );
+	// Different form: the program is rebuilt.
+	delete rates[3];
+	rates[3] = new SecondOrder( 3.0, 2, 3 );
+	rp.update( rates, 3 );
+	assert( rp.getNumFallback() == 3 );
+	delete rates[0];
+	rates[0] = new NOrder( 0.5, v2 );
+	rp.update( rates, 0 );
+	assert( rp.getNumFallback() == 4 );
+	rp.evaluate( S, &v[0] );
+	for ( unsigned int i = 0; i < rates.size(); ++i )
+		assert( v[i] == ( *rates[i] )( S ) );
+
+	// Check the derivatives against central differences. A second
+	// order term with the same substrate twice has two slots to add up.
+	vector< double > d( rp.getNumDerivs() );
+	rp.evaluateDerivs( S, &d[0] );
+	map< pair< unsigned int, unsigned int >, double > deriv;
+	for ( unsigned int k = 0; k < d.size(); ++k )
+		deriv[ make_pair( rp.getDerivReac()[k], rp.getDerivPool()[k] ) ]
+				+= d[k];
+	map< pair< unsigned int, unsigned int >, double >::iterator k;
+	for ( k = deriv.begin(); k != deriv.end(); ++k ) {
+		unsigned int j = k->first.first;
+		double& y = S[ k->first.second ];
+		double orig = y;
+		y = orig + 1e-5;
+		double vp = ( *rates[j] )( S );
+		y = orig - 1e-5;
+		double vm = ( *rates[j] )( S );
+		y = orig;
+		assert( fabs( k->second - ( vp - vm ) / 2e-5 ) < 
+						1e-5 * ( 1 + fabs( k->second ) ) );
+	}
+	for ( unsigned int i = 0; i < rates.size(); ++i )
+		delete rates[i];
+	cout << "." << flush;
+}
+
+void testSparseLU()
+{
+	// A 5x5 unsymmetric matrix with a zero where fill-in must go.
+	static const double A[5][5] = {
+		{ 4, 1, 0, 0, 2 },
+		{ 0, 3, 1, 0, 0 },
+		{ 1, 0, 5, 2, 0 },
+		{ 0, 0, 1, 6, 1 },
+		{ 2, 0, 0, 1, 7 }
+	};
+	vector< unsigned int > rowStart( 1, 0 );
+	vector< unsigned int > colIndex;
+	vector< double > values;
+	for ( unsigned int i = 0; i < 5; ++i ) {
+		for ( unsigned int j = 0; j < 5; ++j ) {
+			if ( A[i][j] != 0 ) {
+				colIndex.push_back( j );
+				values.push_back( A[i][j] );
+			}
+		}
+		rowStart.push_back( colIndex.size() );
+	}
+	SparseLU lu;
+	lu.setup( 5, rowStart, colIndex );
+	assert( lu.getSize() == 5 );
+	assert( lu.getNumEntries() >= colIndex.size() );
+	for ( unsigned int trial = 0; trial < 2; ++trial ) {
+		// The second time round, reuse the symbolic factorization.
+		if ( trial == 1 )
+			for ( unsigned int i = 0; i < values.size(); ++i )
+				values[i] *= 1.0 + 0.1 * i;
+		bool ok = lu.factor( &values[0] );
+		assert( ok );
+		double x[] = { 1, -2, 3, 0.5, -1 };
+		double b[5];
+		for ( unsigned int i = 0; i < 5; ++i ) {
+			b[i] = 0.0;
+			for ( unsigned int p = rowStart[i]; p < rowStart[i+1]; ++p )
+				b[i] += values[p] * x[ colIndex[p] ];
+		}
+		lu.solve( b );
+		for ( unsigned int i = 0; i < 5; ++i )
+			assert( doubleEq( b[i], x[i] ) );
+	}
+	cout << "." << flush;
+}
+
+/**
+ * Runs a stiff model, A + B <===> C with fast binding and C ---> D
+ * slowly, with the specified Ksolve method. Returns the final n of D.
+ */
+double runStiffKsolve( const string& method )
+{
+	Shell* s = reinterpret_cast< Shell* >( Id().eref().data() );
+	Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+	Id compt = s->doCreate( "CubeMesh", model, "compt", 1 );
+	Field< double >::set( compt, "volume", 1e-18 );
+	Id A = s->doCreate( "Pool", compt, "A", 1 );
+	Id B = s->doCreate( "Pool", compt, "B", 1 );
+	Id C = s->doCreate( "Pool", compt, "C", 1 );
+	Id D = s->doCreate( "Pool", compt, "D", 1 );
+	Id r1 = s->doCreate( "Reac", compt, "r1", 1 );
+	Id r2 = s->doCreate( "Reac", compt, "r2", 1 );
+	s->doAddMsg( "Single", r1, "sub", A, "reac" );
+	s->doAddMsg( "Single", r1, "sub", B, "reac" );
+	s->doAddMsg( "Single", r1, "prd", C, "reac" );
+	s->doAddMsg( "Single", r2, "sub", C, "reac" );
+	s->doAddMsg( "Single", r2, "prd", D, "reac" );
+	Field< double >::set( A, "concInit", 1 );
+	Field< double >::set( B, "concInit", 2 );
+	Field< double >::set( r1, "Kf", 1000 );
+	Field< double >::set( r1, "Kb", 500 );
+	Field< double >::set( r2, "Kf", 0.2 );
+	Field< double >::set( r2, "Kb", 0 );
+
+	Id ksolve = s->doCreate( "Ksolve", model, "ksolve", 1 );
+	Field< string >::set( ksolve, "method", method );
+	assert( Field< string >::get( ksolve, "method" ) == method );
+	Id stoich = s->doCreate( "Stoich", ksolve, "stoich", 1 );
+	Field< Id >::set( stoich, "compartment", compt );
+	Field< Id >::set( stoich, "ksolve", ksolve );
+	Field< string >::set( stoich, "path", "/model/compt/##" );
+	s->doUseClock( "/model/ksolve", "process", 4 ); 
+	s->doSetClock( 4, 0.1 );
+	s->doReinit();
+	s->doStart( 10.0 );
+
+	double ret = Field< double >::get( D, "n" );
+	s->doDelete( model );
+	return ret;
+}
+
+void testRunKsolveStiff()
+{
+	double explicitD = runStiffKsolve( "rk5" );
+	double implicitD = runStiffKsolve( "rosenbrock" );
+	// About 3/4 of A ends up as D.
+	assert( explicitD > 0.7 * 602214 && explicitD < 0.8 * 602214 );
+	assert( fabs( implicitD - explicitD ) < 1e-3 * explicitD );
 	cout << "." << flush;
 }
 
@@ -341,7 +702,13 @@ void testKsolve()
 	testBuildStoich();
 	testRunKsolve();
 	testRunGsolve();
+	testRunKsolveThreaded();
+	testRunGsolveThreaded();
+	testRunKsolvesOnClockThreads();
 	testFuncTerm();
+	testRateProgram();
+	testSparseLU();
+	testRunKsolveStiff();
 }
 
 void testKsolveProcess()
@@ -1058,8 +1058,8 @@ void CubeMesh::buildStencil()
 			assert( q >= nx_ * ny_ );
 			e.push_back( Ecol( dx_ * dy_ / dz_, s2m_[q - nx_ * ny_] ) );
 		}
-		if ( iz < nz_ - 1 && s2m_[ q + nx_*ny_ ] ) {
-			assert( q+nx_ < s2m_.size() );
+		if ( iz < nz_ - 1 && s2m_[ q + nx_*ny_ ] != flag ) {
+			assert( q + nx_ * ny_ < s2m_.size() );
 			e.push_back( Ecol( dx_ * dy_ / dz_, s2m_[q + nx_ * ny_] ) );
 		}
 		sort( e.begin(), e.end() );
@@ -1142,6 +1142,30 @@ unsigned int CubeMesh::spaceToIndex( double x, double y, double z ) const
 	return EMPTY;
 }
 
+static bool hitLess( const pair< unsigned int, double >& a, 
+				const pair< unsigned int, double >& b )
+{
+	return a.first < b.first;
+}
+
+// The hits are sorted stably, so the areas in each entry are added up
+// in the order they were found, as they would be in a dense vector.
+void CubeMesh::addAreaJunctions( vector< pair< unsigned int, double > >& hits,
+				unsigned int index, vector< VoxelJunction >& ret )
+{
+	const double EPSILON = 1e-18;
+	stable_sort( hits.begin(), hits.end(), hitLess );
+	for ( unsigned int k = 0; k < hits.size(); ) {
+		unsigned int entry = hits[k].first;
+		double area = 0.0;
+		for ( ; k < hits.size() && hits[k].first == entry; ++k )
+			area += hits[k].second;
+		if ( area > EPSILON )
+			ret.push_back( VoxelJunction( index, entry, area ) );
+	}
+	hits.clear();
+}
+
 double CubeMesh::nearest( double x, double y, double z, 
 				unsigned int& index ) const
 {
@@ -201,6 +201,18 @@ class CubeMesh: public MeshCompt
 		/// Converts the 3-D coords to an index. EMPTY if out of range.
 		unsigned int spaceToIndex( double x, double y, double z ) const;
 
+		/**
+		 * Sums up the areas of the surface points of another mesh
+		 * which fall in each entry of this one, as (entry, area) hits,
+		 * and appends a junction from voxel index of the other mesh for
+		 * each entry with nonzero area, in order of entry. Clears hits.
+		 * The cost depends only on the number of hits, not on the size
+		 * of this mesh.
+		 */
+		static void addAreaJunctions( 
+						vector< pair< unsigned int, double > >& hits,
+						unsigned int index, vector< VoxelJunction >& ret );
+
 		/**
 		 * Virtual function to return the distance and index of nearest
 		 * meshEntry. Places entry at centre of voxel.
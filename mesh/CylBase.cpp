@@ -262,7 +262,8 @@ double CylBase::selectGridSize( double h, double dia1,
 
 static void fillPointsOnCircle( 
 				const Vec& u, const Vec& v, const Vec& q,
-				double h, double r, vector< double >& area,
+				double h, double r,
+				vector< pair< unsigned int, double > >& hits,
 				const CubeMesh* other
 				)
 {
@@ -284,13 +285,14 @@ static void fillPointsOnCircle(
 		double p2 = q.a2() + r * ( u.a2() * c + v.a2() * s );
 		unsigned int index = other->spaceToIndex( p0, p1, p2 );
 		if ( index != CubeMesh::EMPTY )
-			area[index] += dArea;
+			hits.push_back( make_pair( index, dArea ) );
 	}
 }
 
 static void fillPointsOnDisc( 
 				const Vec& u, const Vec& v, const Vec& q,
-				double h, double r, vector< double >& area,
+				double h, double r,
+				vector< pair< unsigned int, double > >& hits,
 				const CubeMesh* other
 				)
 {
@@ -312,7 +314,7 @@ static void fillPointsOnDisc(
 			double p2 = q.a2() + a * ( u.a2() * c + v.a2() * s );
 			unsigned int index = other->spaceToIndex( p0, p1, p2 );
 			if ( index != CubeMesh::EMPTY )
-				area[index] += dArea;
+				hits.push_back( make_pair( index, dArea ) );
 		}
 	}
 }
@@ -326,7 +328,6 @@ void CylBase::matchCubeMeshEntries( const ChemCompt* compt,
 {
 	const CubeMesh* other = dynamic_cast< const CubeMesh* >( compt );
 	assert( other );
-	const double EPSILON = 1e-18;
 	Vec a( parent.x_ - x_, parent.y_ - y_, parent.z_ - z_ );
 	Vec u;
 	Vec v;
@@ -339,8 +340,8 @@ void CylBase::matchCubeMeshEntries( const ChemCompt* compt,
 	// March along axis of cylinder.
 	// q is the location of the point along axis.
 	double rSlope = ( dia_ - parent.dia_ ) * 0.5 / length_;
+	vector< pair< unsigned int, double > > hits;
 	for ( unsigned int i = 0; i < numDivs_; ++i ) {
-		vector< double >area( other->getNumEntries(), 0.0 );
 		if ( useCylinderCurve ) {
 			for ( unsigned int j = 0; j < num; ++j ) {
 				unsigned int m = i * num + j;
@@ -353,21 +354,17 @@ void CylBase::matchCubeMeshEntries( const ChemCompt* compt,
 				if ( !isCylinder_ ) // Use the more complicated conic value
 				r = parent.dia_/2.0 + frac * rSlope;
 				fillPointsOnCircle( u, v, Vec( q0, q1, q2 ),
-							h, r, area, other );
+							h, r, hits, other );
 			}
 		}
 		if ( useCylinderCap && i == numDivs_ - 1 ) {
 			fillPointsOnDisc( u, v, Vec( x_, y_, z_ ), 
-							h, dia_/2.0, area, other );
+							h, dia_/2.0, hits, other );
 		}
-		// Go through all cubeMesh entries and compute diffusion 
+		// Go through the cubeMesh entries hit and compute diffusion 
 		// cross-section. Assume this is through a membrane, so the 
 		// only factor relevant is area. Not the distance.
-		for ( unsigned int k = 0; k < area.size(); ++k ) {
-			if ( area[k] > EPSILON ) {
-				ret.push_back( VoxelJunction( i + startIndex, k, area[k] ));
-			}
-		}
+		CubeMesh::addAreaJunctions( hits, i + startIndex, ret );
 	}
 }
 
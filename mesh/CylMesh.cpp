@@ -20,6 +20,7 @@
 #include "CylBase.h"
 #include "NeuroNode.h"
 // #include "NeuroStencil.h"
+#include "SpatialIndex.h"
 #include "NeuroMesh.h"
 #include "CylMesh.h"
 #include "../utility/numutil.h"
@@ -933,7 +934,8 @@ double CylMesh::selectGridVolume( double h ) const
 
 void fillPointsOnCircle( 
 				const Vec& u, const Vec& v, const Vec& q,
-				double h, double r, vector< double >& area,
+				double h, double r,
+				vector< pair< unsigned int, double > >& hits,
 				const CubeMesh* other
 				)
 {
@@ -955,14 +957,13 @@ void fillPointsOnCircle(
 		double p2 = q.a2() + r * ( u.a2() * c + v.a2() * s );
 		unsigned int index = other->spaceToIndex( p0, p1, p2 );
 		if ( index != CubeMesh::EMPTY )
-			area[index] += dArea;
+			hits.push_back( make_pair( index, dArea ) );
 	}
 }
 
 void CylMesh::matchCubeMeshEntries( const CubeMesh* other,
 vector< VoxelJunction >& ret ) const
 {
-	const double EPSILON = 1e-18;
 	Vec a( x1_ - x0_, y1_ - y0_, z1_ - z0_ );
 	Vec u;
 	Vec v;
@@ -973,8 +974,8 @@ vector< VoxelJunction >& ret ) const
 	unsigned int num = floor( 0.1 + diffLength_ / h );
 	// March along axis of cylinder.
 	// q is the location of the point along axis.
+	vector< pair< unsigned int, double > > hits;
 	for ( unsigned int i = 0; i < numEntries_; ++i ) {
-		vector< double >area( other->getNumEntries(), 0.0 );
 		for ( unsigned int j = 0; j < num; ++j ) {
 			unsigned int m = i * num + j;
 			double frac = ( m * h + h/2.0 ) / totLen_;
@@ -984,16 +985,12 @@ vector< VoxelJunction >& ret ) const
 			// get radius of cylinder at this point.
 			double r = r0_ + ( m * h + h / 2.0 ) * rSlope_;
 			fillPointsOnCircle( u, v, Vec( q0, q1, q2 ),
-						h, r, area, other );
+						h, r, hits, other );
 			}
-		// Go through all cubeMesh entries and compute diffusion 
+		// Go through the cubeMesh entries hit and compute diffusion 
 		// cross-section. Assume this is through a membrane, so the 
 		// only factor relevant is area. Not the distance.
-		for ( unsigned int k = 0; k < area.size(); ++k ) {
-			if ( area[k] > EPSILON ) {
-				ret.push_back( VoxelJunction( i, k, area[k] ) );
-			}
-		}
+		CubeMesh::addAreaJunctions( hits, i, ret );
 	}
 }
 
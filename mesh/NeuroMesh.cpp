@@ -20,6 +20,7 @@
 #include "CubeMesh.h"
 #include "CylBase.h"
 #include "NeuroNode.h"
+#include "SpatialIndex.h"
 #include "NeuroMesh.h"
 #include "SpineEntry.h"
 #include "SpineMesh.h"
@@ -311,6 +312,7 @@ NeuroMesh& NeuroMesh::operator=( const NeuroMesh& other )
 {
 	nodes_ = other.nodes_;
 	nodeIndex_ = other.nodeIndex_;
+	segmentIndex_ = other.segmentIndex_;
 	vs_ = other.vs_;
 	area_ = other.area_;
 	diffLength_ = other.diffLength_;
@@ -376,6 +378,22 @@ void NeuroMesh::updateCoords()
 		}
 	}
 	buildStencil();
+	buildSegmentIndex();
+}
+
+void NeuroMesh::buildSegmentIndex()
+{
+	segmentIndex_.clear();
+	for ( unsigned int i = 0; i < nodes_.size(); ++i ) {
+		const NeuroNode& nn = nodes_[i];
+		if ( !nn.isDummyNode() ) {
+			assert( nn.parent() < nodes_.size() );
+			const NeuroNode& pa = nodes_[ nn.parent() ];
+			segmentIndex_.addBox( i, pa.getX(), pa.getY(), pa.getZ(),
+							nn.getX(), nn.getY(), nn.getZ() );
+		}
+	}
+	segmentIndex_.build();
 }
 
 void NeuroMesh::setDiffLength( double v )
@@ -1209,29 +1227,52 @@ void NeuroMesh::indexToSpace( unsigned int index,
 	z = pt.a2();
 }
 
-double NeuroMesh::nearest( double x, double y, double z, 
-				unsigned int& index ) const
+/**
+ * Distance from a point to the segment of a node, for the segmentIndex_.
+ * Points which are not alongside the segment do not count.
+ */
+class SegmentDistance
 {
-	double best = 1e12;
-	index = 0;
-	for( unsigned int i = 0; i < nodes_.size(); ++i ) {
-		const NeuroNode& nn = nodes_[i];
-		if ( !nn.isDummyNode() ) {
+	public:
+		SegmentDistance( const vector< NeuroNode >& nodes, 
+						double x, double y, double z )
+			: nodes_( nodes ), x_( x ), y_( y ), z_( z )
+		{;}
+
+		double operator()( unsigned int i ) const
+		{
+			const NeuroNode& nn = nodes_[i];
 			assert( nn.parent() < nodes_.size() );
 			const NeuroNode& pa = nodes_[ nn.parent() ];
 			double linePos;
 			double r;
-			double near = nn.nearest( x, y, z, pa, linePos, r );
-			if ( linePos >= 0 && linePos < 1.0 ) {
-				if ( best > near ) {
-					best = near;
-					index = linePos * nn.getNumDivs() + nn.startFid();
-				}
-			}
+			double near = nn.nearest( x_, y_, z_, pa, linePos, r );
+			if ( linePos >= 0 && linePos < 1.0 )
+				return near;
+			return -1.0;
 		}
-	}
-	if ( best == 1e12 )
+
+	private:
+		const vector< NeuroNode >& nodes_;
+		double x_;
+		double y_;
+		double z_;
+};
+
+double NeuroMesh::nearest( double x, double y, double z, 
+				unsigned int& index ) const
+{
+	unsigned int i = 0;
+	double best = segmentIndex_.nearest( x, y, z, 
+					SegmentDistance( nodes_, x, y, z ), i );
+	index = 0;
+	if ( best < 0.0 )
 		return -1;
+	const NeuroNode& nn = nodes_[i];
+	double linePos;
+	double r;
+	nn.nearest( x, y, z, nodes_[ nn.parent() ], linePos, r );
+	index = linePos * nn.getNumDivs() + nn.startFid();
 	return best;
 }
 
@@ -197,6 +197,9 @@ class NeuroMesh: public MeshCompt
 		/// Utility function to set up Stencil for diffusion in NeuroMesh
 		void buildStencil();
 
+		/// Fills segmentIndex_ from the current nodes_.
+		void buildSegmentIndex();
+
 		//////////////////////////////////////////////////////////////////
 		// inherited virtual funcs for Boundary
 		//////////////////////////////////////////////////////////////////
@@ -291,6 +294,13 @@ class NeuroMesh: public MeshCompt
 		 */
 		vector< unsigned int > nodeIndex_;
 
+		/**
+		 * Grid over the segments of the non-dummy nodes, each from its
+		 * parent to itself, used to find the nearest segment to a point.
+		 * Rebuilt in updateCoords.
+		 */
+		SpatialIndex segmentIndex_;
+
 		/**
 		 * Volscale pre-calculations for each MeshEntry. 
 		 * vs = #molecules / vol
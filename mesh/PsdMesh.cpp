@@ -20,6 +20,7 @@
 #include "CubeMesh.h"
 #include "CylBase.h"
 #include "NeuroNode.h"
+#include "SpatialIndex.h"
 #include "NeuroMesh.h"
 #include "PsdMesh.h"
 #include "SpineEntry.h"
@@ -140,11 +141,13 @@ PsdMesh::PsdMesh()
 	psd_[0].setLength( thickness_ );
 	psd_[0].setNumDivs( 1 );
 	psd_[0].setIsCylinder( true );
+	buildPsdIndex();
 }
 
 PsdMesh::PsdMesh( const PsdMesh& other )
 	: 
 		psd_( other.psd_ ),
+		psdIndex_( other.psdIndex_ ),
 		surfaceGranularity_( other.surfaceGranularity_ )
 {;}
 
@@ -194,6 +197,16 @@ vector< unsigned int > PsdMesh::getEndVoxelInCompt() const
 void PsdMesh::updateCoords()
 {
 	buildStencil();
+	buildPsdIndex();
+}
+
+void PsdMesh::buildPsdIndex()
+{
+	psdIndex_.clear();
+	for ( unsigned int i = 0; i < psd_.size(); ++i )
+		psdIndex_.addPoint( i, psd_[i].getX(), psd_[i].getY(), 
+						psd_[i].getZ() );
+	psdIndex_.build();
 }
 
 Id PsdMesh::getCell() const
@@ -437,23 +450,31 @@ void PsdMesh::indexToSpace( unsigned int index,
 	z = psd_[index].getZ();
 }
 
+/// Distance from a point to the centre of a psd, for the psdIndex_.
+class PsdDistance
+{
+	public:
+		PsdDistance( const vector< CylBase >& psd, 
+						double x, double y, double z )
+			: psd_( psd ), b_( x, y, z )
+		{;}
+
+		double operator()( unsigned int i ) const
+		{
+			Vec a( psd_[i].getX(), psd_[i].getY(), psd_[i].getZ() );
+			return a.distance( b_ );
+		}
+
+	private:
+		const vector< CylBase >& psd_;
+		Vec b_;
+};
+
 double PsdMesh::nearest( double x, double y, double z, 
 				unsigned int& index ) const
 {
-	double best = 1e12;
-	index = 0;
-	for( unsigned int i = 0; i < psd_.size(); ++i ) {
-		Vec a( psd_[i].getX(), psd_[i].getY(), psd_[i].getZ() );
-		Vec b( x, y, z );
-		double d = a.distance( b );
-		if ( best > d ) {
-			best = d;
-			index = i;
-		}
-	}
-	if ( best == 1e12 )
-		return -1;
-	return best;
+	return psdIndex_.nearest( x, y, z, 
+					PsdDistance( psd_, x, y, z ), index );
 }
 
 void PsdMesh::matchSpineMeshEntries( const ChemCompt* other,
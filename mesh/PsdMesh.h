@@ -134,6 +134,9 @@ class PsdMesh: public MeshCompt
 
 		void buildStencil();
 
+		/// Fills psdIndex_ from the current psd_.
+		void buildPsdIndex();
+
 		//////////////////////////////////////////////////////////////////
 		// inherited virtual funcs for Boundary
 		//////////////////////////////////////////////////////////////////
@@ -177,6 +180,7 @@ class PsdMesh: public MeshCompt
 		 * These do the actual work.
 		 */
 		vector< CylBase > psd_; /// Specified disk of psd.
+		SpatialIndex psdIndex_; /// Grid over the psd_ centres, for nearest.
 		vector< CylBase > pa_; ///Specifies direction of psd. Length ignored
 		vector< double > parentDist_; /// Specifies diff distance to PSD.
 		vector< unsigned int > parent_; /// Parent voxel index.
@@ -0,0 +1,193 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "header.h"
+#include "SpatialIndex.h"
+
+SpatialIndex::SpatialIndex()
+	: cellSize_( 1.0 )
+{
+	for ( unsigned int d = 0; d < 3; ++d ) {
+		origin_[d] = 0.0;
+		n_[d] = 0;
+	}
+}
+
+void SpatialIndex::clear()
+{
+	boxes_.clear();
+	items_.clear();
+	cellStart_.clear();
+	cellItems_.clear();
+	for ( unsigned int d = 0; d < 3; ++d )
+		n_[d] = 0;
+}
+
+void SpatialIndex::addBox( unsigned int item,
+				double x0, double y0, double z0,
+				double x1, double y1, double z1 )
+{
+	boxes_.push_back( x0 < x1 ? x0 : x1 );
+	boxes_.push_back( y0 < y1 ? y0 : y1 );
+	boxes_.push_back( z0 < z1 ? z0 : z1 );
+	boxes_.push_back( x0 < x1 ? x1 : x0 );
+	boxes_.push_back( y0 < y1 ? y1 : y0 );
+	boxes_.push_back( z0 < z1 ? z1 : z0 );
+	items_.push_back( item );
+}
+
+void SpatialIndex::addPoint( unsigned int item,
+				double x, double y, double z )
+{
+	addBox( item, x, y, z, x, y, z );
+}
+
+unsigned int SpatialIndex::getNumItems() const
+{
+	return items_.size();
+}
+
+unsigned int SpatialIndex::getNumCells() const
+{
+	return n_[0] * n_[1] * n_[2];
+}
+
+int SpatialIndex::cellCoord( double x, unsigned int d ) const
+{
+	double f = floor( ( x - origin_[d] ) / cellSize_ );
+	if ( !( f > 0.0 ) ) // Also catches NaN.
+		return 0;
+	if ( f >= n_[d] )
+		return n_[d] - 1;
+	return static_cast< int >( f );
+}
+
+/**
+ * The cell size starts at the typical size of an item, so that long
+ * segments do not land in many cells, or at the size that gives about
+ * one cell per item, if that is larger. It is then raised till there
+ * are at most a few cells per item, which bounds the memory used for
+ * scattered items.
+ */
+void SpatialIndex::build()
+{
+	unsigned int numItems = items_.size();
+	cellStart_.clear();
+	cellItems_.clear();
+	if ( numItems == 0 ) {
+		for ( unsigned int d = 0; d < 3; ++d )
+			n_[d] = 0;
+		return;
+	}
+
+	double hi[3];
+	double meanSize = 0.0;
+	for ( unsigned int d = 0; d < 3; ++d ) {
+		origin_[d] = boxes_[d];
+		hi[d] = boxes_[d + 3];
+	}
+	for ( unsigned int i = 0; i < numItems; ++i ) {
+		const double* b = &boxes_[ 6 * i ];
+		double size = 0.0;
+		for ( unsigned int d = 0; d < 3; ++d ) {
+			if ( origin_[d] > b[d] )
+				origin_[d] = b[d];
+			if ( hi[d] < b[d + 3] )
+				hi[d] = b[d + 3];
+			if ( size < b[d + 3] - b[d] )
+				size = b[d + 3] - b[d];
+		}
+		meanSize += size;
+	}
+	meanSize /= numItems;
+
+	double maxExtent = 0.0;
+	for ( unsigned int d = 0; d < 3; ++d )
+		if ( maxExtent < hi[d] - origin_[d] )
+			maxExtent = hi[d] - origin_[d];
+	cellSize_ = maxExtent /
+			( 1.0 + floor( pow( double( numItems ), 1.0 / 3.0 ) ) );
+	if ( cellSize_ < meanSize )
+		cellSize_ = meanSize;
+	if ( !( cellSize_ > 0.0 ) ) // All items at one point.
+		cellSize_ = 1.0;
+
+	double maxCells = 4.0 * numItems + 8.0;
+	for ( ; ; ) {
+		double numCells = 1.0;
+		for ( unsigned int d = 0; d < 3; ++d ) {
+			n_[d] = 1 + static_cast< int >(
+							floor( ( hi[d] - origin_[d] ) / cellSize_ ) );
+			numCells *= n_[d];
+		}
+		if ( numCells <= maxCells )
+			break;
+		cellSize_ *= 1.5;
+	}
+
+	// Two passes to fill the cells: count, then place the items.
+	unsigned int numCells = getNumCells();
+	cellStart_.assign( numCells + 1, 0 );
+	for ( unsigned int pass = 0; pass < 2; ++pass ) {
+		vector< unsigned int > fill;
+		if ( pass == 1 ) {
+			for ( unsigned int i = 0; i < numCells; ++i )
+				cellStart_[i + 1] += cellStart_[i];
+			cellItems_.resize( cellStart_[ numCells ] );
+			fill.assign( cellStart_.begin(), cellStart_.end() - 1 );
+		}
+		for ( unsigned int i = 0; i < numItems; ++i ) {
+			const double* b = &boxes_[ 6 * i ];
+			int lo[3];
+			int up[3];
+			for ( unsigned int d = 0; d < 3; ++d ) {
+				lo[d] = cellCoord( b[d], d );
+				up[d] = cellCoord( b[d + 3], d );
+			}
+			for ( int iz = lo[2]; iz <= up[2]; ++iz ) {
+				for ( int iy = lo[1]; iy <= up[1]; ++iy ) {
+					for ( int ix = lo[0]; ix <= up[0]; ++ix ) {
+						unsigned int cell =
+								( iz * n_[1] + iy ) * n_[0] + ix;
+						if ( pass == 0 )
+							cellStart_[ cell + 1 ]++;
+						else
+							cellItems_[ fill[ cell ]++ ] = i;
+					}
+				}
+			}
+		}
+	}
+}
+
+double SpatialIndex::outsideDistance( const double* q,
+				const int* lo, const int* hi ) const
+{
+	bool isWhole = true;
+	double ret = 0.0;
+	for ( unsigned int d = 0; d < 3; ++d ) {
+		if ( lo[d] > 0 ) {
+			double dist = q[d] - ( origin_[d] + lo[d] * cellSize_ );
+			if ( isWhole || dist < ret )
+				ret = dist;
+			isWhole = false;
+		}
+		if ( hi[d] < n_[d] - 1 ) {
+			double dist = origin_[d] + ( hi[d] + 1 ) * cellSize_ - q[d];
+			if ( isWhole || dist < ret )
+				ret = dist;
+			isWhole = false;
+		}
+	}
+	if ( isWhole )
+		return -1.0;
+	// Allow for roundoff in placing the items in cells.
+	ret -= 1e-9 * cellSize_;
+	return ret > 0.0 ? ret : 0.0;
+}
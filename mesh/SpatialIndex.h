@@ -0,0 +1,139 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _SPATIAL_INDEX_H
+#define _SPATIAL_INDEX_H
+
+/**
+ * SpatialIndex is a uniform grid over the bounding boxes of the items
+ * of a mesh: the cylinder segments of a NeuroMesh, or the points of a
+ * SpineMesh or PsdMesh. It finds the nearest item to a point by looking
+ * at the grid cells around the point, nearest ones first, rather than
+ * at every item in the mesh.
+ */
+class SpatialIndex
+{
+	public:
+		SpatialIndex();
+
+		/// Removes all items and the grid.
+		void clear();
+
+		/**
+		 * Adds an item with the bounding box (x0,y0,z0) to (x1,y1,z1).
+		 * The corners may be given in either order. Items are
+		 * identified by the index passed in, which need not be
+		 * contiguous.
+		 */
+		void addBox( unsigned int item, double x0, double y0, double z0,
+						double x1, double y1, double z1 );
+
+		/// Adds an item which is a single point.
+		void addPoint( unsigned int item, double x, double y, double z );
+
+		/// Lays out the grid over the items added so far.
+		void build();
+
+		unsigned int getNumItems() const;
+		unsigned int getNumCells() const;
+
+		/**
+		 * Finds the item nearest to (x,y,z), and returns its distance,
+		 * or -1 if there is none. The distance to each candidate item
+		 * is given by dist( item ), which returns a negative value for
+		 * items that do not qualify. This must be no less than the
+		 * distance from (x,y,z) to the bounding box of the item.
+		 * Of items at the same distance, the one with the lowest index
+		 * is chosen, as a linear scan over the items would.
+		 */
+		template< class D > double nearest( double x, double y, double z,
+						const D& dist, unsigned int& item ) const;
+
+	private:
+		/// Cell coordinate of position x along dimension d, clamped.
+		int cellCoord( double x, unsigned int d ) const;
+
+		/// Lower bound on distance from q to items outside the cells
+		/// lo to hi, or -1 if these cells cover the whole grid.
+		double outsideDistance( const double* q,
+						const int* lo, const int* hi ) const;
+
+		/// Corners of item bounding boxes, 6 entries per item.
+		vector< double > boxes_;
+		/// Index of each item as passed in to addBox.
+		vector< unsigned int > items_;
+
+		double origin_[3];
+		double cellSize_;
+		int n_[3];
+		/// Start of each cell in cellItems_, in compressed row form.
+		vector< unsigned int > cellStart_;
+		/// Positions in items_ of the items in each cell.
+		vector< unsigned int > cellItems_;
+};
+
+template< class D > double SpatialIndex::nearest(
+		double x, double y, double z, const D& dist,
+		unsigned int& item ) const
+{
+	double best = -1.0;
+	item = 0;
+	if ( items_.empty() )
+		return best;
+	assert( cellStart_.size() ==
+		static_cast< unsigned int >( n_[0] * n_[1] * n_[2] ) + 1 );
+
+	double q[3] = { x, y, z };
+	int c[3];
+	for ( unsigned int d = 0; d < 3; ++d )
+		c[d] = cellCoord( q[d], d );
+
+	// Go out in shells of cells around the one holding q.
+	for ( int r = 0; ; ++r ) {
+		int lo[3];
+		int hi[3];
+		for ( unsigned int d = 0; d < 3; ++d ) {
+			lo[d] = c[d] - r < 0 ? 0 : c[d] - r;
+			hi[d] = c[d] + r >= n_[d] ? n_[d] - 1 : c[d] + r;
+		}
+		for ( int iz = lo[2]; iz <= hi[2]; ++iz ) {
+			for ( int iy = lo[1]; iy <= hi[1]; ++iy ) {
+				// Inside the shell, only the two ends of each row in x
+				// are new.
+				bool onFace = ( iz == c[2] - r || iz == c[2] + r ||
+								iy == c[1] - r || iy == c[1] + r );
+				int step = onFace || r == 0 ? 1 : 2 * r;
+				for ( int ix = onFace ? lo[0] : c[0] - r;
+								ix <= hi[0]; ix += step ) {
+					if ( ix < 0 )
+						continue;
+					unsigned int cell = ( iz * n_[1] + iy ) * n_[0] + ix;
+					for ( unsigned int k = cellStart_[ cell ];
+									k < cellStart_[ cell + 1 ]; ++k ) {
+						unsigned int i = items_[ cellItems_[k] ];
+						double near = dist( i );
+						if ( near < 0.0 )
+							continue;
+						if ( best < 0.0 || near < best ||
+										( near == best && i < item ) ) {
+							best = near;
+							item = i;
+						}
+					}
+				}
+			}
+		}
+		double bound = outsideDistance( q, lo, hi );
+		if ( bound < 0.0 || ( best >= 0.0 && best < bound ) )
+			break;
+	}
+	return best;
+}
+
+#endif // _SPATIAL_INDEX_H
@@ -20,6 +20,7 @@
 #include "CubeMesh.h"
 #include "CylBase.h"
 #include "NeuroNode.h"
+#include "SpatialIndex.h"
 #include "NeuroMesh.h"
 #include "SpineEntry.h"
 #include "SpineMesh.h"
@@ -157,11 +158,14 @@ SpineMesh::SpineMesh()
 		vs_( 1, 1.0e-18 ),
 		area_( 1, 1.0e-12 ),
 		length_( 1, 1.0e-6 )
-{;}
+{
+	buildSpineIndex();
+}
 
 SpineMesh::SpineMesh( const SpineMesh& other )
 	: 
 		spines_( other.spines_ ),
+		spineIndex_( other.spineIndex_ ),
 		surfaceGranularity_( other.surfaceGranularity_ )
 {;}
 
@@ -234,6 +238,18 @@ vector< unsigned int > SpineMesh::getEndVoxelInCompt() const
 void SpineMesh::updateCoords()
 {
 	buildStencil();
+	buildSpineIndex();
+}
+
+void SpineMesh::buildSpineIndex()
+{
+	spineIndex_.clear();
+	for ( unsigned int i = 0; i < spines_.size(); ++i ) {
+		double x, y, z;
+		spines_[i].mid( x, y, z );
+		spineIndex_.addPoint( i, x, y, z );
+	}
+	spineIndex_.build();
 }
 
 Id SpineMesh::getCell() const
@@ -430,6 +446,7 @@ bool SpineMesh::vSetVolumeNotRates( double volume )
 		area_[i] *= linscale * linscale;
 		length_[i] *= linscale;
 	}
+	buildSpineIndex(); // The spine heads have moved.
 	return true;
 }
 
@@ -511,26 +528,33 @@ void SpineMesh::indexToSpace( unsigned int index,
 	spines_[ index ].mid( x, y, z );
 }
 
+/// Distance from a point to the middle of a spine, for the spineIndex_.
+class SpineDistance
+{
+	public:
+		SpineDistance( const vector< SpineEntry >& spines, 
+						double x, double y, double z )
+			: spines_( spines ), b_( x, y, z )
+		{;}
+
+		double operator()( unsigned int i ) const
+		{
+			double a0, a1, a2;
+			spines_[i].mid( a0, a1, a2 );
+			Vec a( a0, a1, a2 );
+			return a.distance( b_ );
+		}
+
+	private:
+		const vector< SpineEntry >& spines_;
+		Vec b_;
+};
+
 double SpineMesh::nearest( double x, double y, double z, 
 				unsigned int& index ) const
 {
-	double best = 1e12;
-	index = 0;
-	for( unsigned int i = 0; i < spines_.size(); ++i ) {
-		const SpineEntry& se = spines_[i];
-		double a0, a1, a2;
-		se.mid( a0, a1, a2 );
-		Vec a( a0, a1, a2 );
-		Vec b( x, y, z );
-		double d = a.distance( b );
-		if ( best > d ) {
-			best = d;
-			index = i;
-		}
-	}
-	if ( best == 1e12 )
-		return -1;
-	return best;
+	return spineIndex_.nearest( x, y, z, 
+					SpineDistance( spines_, x, y, z ), index );
 }
 
 void SpineMesh::matchSpineMeshEntries( const ChemCompt* other,
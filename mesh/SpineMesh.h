@@ -137,6 +137,9 @@ class SpineMesh: public MeshCompt
 
 		void buildStencil();
 
+		/// Fills spineIndex_ from the current spines_.
+		void buildSpineIndex();
+
 		//////////////////////////////////////////////////////////////////
 		// inherited virtual funcs for Boundary
 		//////////////////////////////////////////////////////////////////
@@ -185,6 +188,9 @@ class SpineMesh: public MeshCompt
 		 */
 		vector< SpineEntry > spines_;
 
+		/// Grid over the midpoints of the spines_, for nearest.
+		SpatialIndex spineIndex_;
+
 		/**
 		 * Decides how finely to subdivide diffLength_ or radius or cubic
 		 * mesh side when computing surfacearea of intersections with 
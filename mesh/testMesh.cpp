@@ -20,8 +20,10 @@
 #include "NeuroNode.h"
 #include "SparseMatrix.h"
 // #include "NeuroStencil.h"
+#include "SpatialIndex.h"
 #include "NeuroMesh.h"
 #include "../utility/Vec.h"
+#include "../randnum/randnum.h"
 #include "CylMesh.h"
 #include "SpineEntry.h"
 #include "SpineMesh.h"
@@ -1708,6 +1710,101 @@ void testVec()
 	cout << "." << flush;
 }
 
+/**
+ * Distance from a point to the segments used in testSpatialIndex. Only
+ * the segments with an even index qualify, as NeuroMesh only takes
+ * segments which the point is alongside.
+ */
+class TestSegmentDistance
+{
+	public:
+		TestSegmentDistance( const vector< double >& seg, const Vec& c )
+			: seg_( seg ), c_( c )
+		{;}
+
+		double operator()( unsigned int i ) const
+		{
+			if ( i % 2 != 0 )
+				return -1.0;
+			Vec a( seg_[6*i], seg_[6*i + 1], seg_[6*i + 2] );
+			Vec b( seg_[6*i + 3], seg_[6*i + 4], seg_[6*i + 5] );
+			double len = b.distance( a );
+			double k = 0.0;
+			if ( len > 0.0 )
+				k = ( b - a ).dotProduct( c_ - a ) / ( len * len );
+			if ( k < 0.0 )
+				k = 0.0;
+			if ( k > 1.0 )
+				k = 1.0;
+			return c_.distance( a.pointOnLine( b, k ) );
+		}
+
+	private:
+		const vector< double >& seg_;
+		Vec c_;
+};
+
+/**
+ * Compares SpatialIndex::nearest against a scan over all items, for
+ * scattered segments of various lengths and for points, with queries
+ * inside and outside the indexed region.
+ */
+void testSpatialIndex()
+{
+	for ( unsigned int pass = 0; pass < 2; ++pass ) {
+		const unsigned int numItems = 500;
+		double maxLen = ( pass == 0 ) ? 20.0 : 0.0; // Points on pass 1.
+		vector< double > seg;
+		SpatialIndex si;
+		for ( unsigned int i = 0; i < numItems; ++i ) {
+			double x = 100.0 * mtrand();
+			double y = 100.0 * mtrand();
+			double z = 10.0 * mtrand();
+			seg.push_back( x );
+			seg.push_back( y );
+			seg.push_back( z );
+			seg.push_back( x + maxLen * ( mtrand() - 0.5 ) );
+			seg.push_back( y + maxLen * ( mtrand() - 0.5 ) );
+			seg.push_back( z + maxLen * ( mtrand() - 0.5 ) );
+			si.addBox( i, seg[6*i], seg[6*i + 1], seg[6*i + 2],
+						seg[6*i + 3], seg[6*i + 4], seg[6*i + 5] );
+		}
+		si.build();
+		assert( si.getNumItems() == numItems );
+		assert( si.getNumCells() > 1 );
+		assert( si.getNumCells() <= 4 * numItems + 8 );
+
+		for ( unsigned int q = 0; q < 200; ++q ) {
+			Vec c( 140.0 * mtrand() - 20.0, 140.0 * mtrand() - 20.0, 
+							50.0 * mtrand() - 20.0 );
+			TestSegmentDistance dist( seg, c );
+			double best = -1.0;
+			unsigned int bestItem = 0;
+			for ( unsigned int i = 0; i < numItems; ++i ) {
+				double d = dist( i );
+				if ( d >= 0.0 && ( best < 0.0 || d < best ) ) {
+					best = d;
+					bestItem = i;
+				}
+			}
+			unsigned int item = ~0;
+			double near = si.nearest( c.a0(), c.a1(), c.a2(), dist, item );
+			assert( doubleEq( near, best ) );
+			assert( item == bestItem );
+		}
+	}
+
+	SpatialIndex empty;
+	empty.build();
+	unsigned int item = 1;
+	vector< double > noSeg;
+	assert( empty.nearest( 0, 0, 0, 
+			TestSegmentDistance( noSeg, Vec() ), item ) < 0.0 );
+	assert( item == 0 );
+
+	cout << "." << flush;
+}
+
 #if 0
 void testSpineEntry()
 {
@@ -2138,6 +2235,7 @@ void testCellPortion()
 void testMesh()
 {
 	testVec();
+	testSpatialIndex();
 	testVolScaling();
 	// testCylBase();
 	// testNeuroNode();
@@ -29,13 +29,20 @@ PostMaster::PostMaster()
 				setRecvBuf_( setRecvBufSize, 0 ),
 				sendBuf_( Shell::numNodes() ),
 				recvBuf_( Shell::numNodes() ),
+				flightBuf_( Shell::numNodes() ),
 				sendSize_( Shell::numNodes(), 0 ),
+				recvSize_( Shell::numNodes(), 0 ),
 				getHandlerBuf_( TgtInfo::headerSize, 0 ),
 				doneIndices_( Shell::numNodes(), 0 ),
 				isSetSent_( 1 ), // Flag. Have any pending 'set' gone?
 				isSetRecv_( 0 ), // Flag. Has some data come in?
 				setSendSize_( 0 ),
-				numRecvDone_( 0 )
+				numRecvDone_( 0 ),
+				minDelay_( 0.0 ),
+				stepsInWindow_( 0 ),
+				windowSteps_( 1 ),
+				splitPhase_( false ),
+				isExchangePending_( false )
 {
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i ) {
 		sendBuf_[i].resize( reserveBufSize, 0 );
@@ -55,8 +62,8 @@ PostMaster::PostMaster()
 					&getHandlerReq_
 	);
 	recvReq_.resize( Shell::numNodes() );
-	sendReq_.resize( Shell::numNodes() );
-	unsigned int k = 0;
+	// Windowed exchange leaves the requests of idle nodes null.
+	sendReq_.resize( Shell::numNodes(), MPI_REQUEST_NULL );
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i ) {
 		// Set up the Recv already for later sends. This might be a problem
 		// for some polling-based implementations, but let's try for now.
@@ -65,17 +72,27 @@ PostMaster::PostMaster()
 		doneStatus_.resize( Shell::numNodes(), temp );
 		if ( i != Shell::myNode() ) {
 			recvBuf_[i].resize( recvBufSize_, 0 );
-			MPI_Irecv( &recvBuf_[i][0], recvBufSize_, MPI_DOUBLE,
-				i, MSGTAG, MPI_COMM_WORLD,
-				&recvReq_[k++] 
-				// Need to be careful about contiguous indexing for 
-				// the MPI_request array.
-			);
+			postRecv( i );
 		}
 	}
 #endif
 }
 
+void PostMaster::postRecv( unsigned int node )
+{
+#ifdef USE_MPI
+	// Need to be careful about contiguous indexing for the MPI_request
+	// array, so myNode is skipped.
+	unsigned int k = node;
+	if ( node > Shell::myNode() ) 
+		k--;
+	MPI_Irecv( &recvBuf_[node][0], recvBufSize_, MPI_DOUBLE,
+		node, MSGTAG, MPI_COMM_WORLD,
+		&recvReq_[k] 
+	);
+#endif
+}
+
 ///////////////////////////////////////////////////////////////
 // Moose class stuff.
 ///////////////////////////////////////////////////////////////
@@ -96,10 +113,40 @@ const Cinfo* PostMaster::initCinfo()
 		);
 		static ValueFinfo< PostMaster, unsigned int > bufferSize(
 			"bufferSize",
-			"Size of the send a receive buffers for each node.",
+			"Size of the send a receive buffers for each node. "
+			"If minDelay is set, reinit enlarges them to hold all the "
+			"timesteps of a window.",
 			&PostMaster::setBufferSize,
 			&PostMaster::getBufferSize
 		);
+		static ValueFinfo< PostMaster, double > minDelay(
+			"minDelay",
+			"Shortest delay of any message between nodes, typically the "
+			"smallest axonal delay of a synapse whose SpikeGen is on "
+			"another node. If nonzero, outgoing data are batched up over "
+			"as many timesteps as fit in minDelay, and then exchanged "
+			"only with the nodes that have data to send or receive, "
+			"without a barrier. This is safe only if every cross-node "
+			"message can tolerate being held back by minDelay, as spike "
+			"messages to synapses can. "
+			"The window and the buffers for it are set up at reinit, "
+			"so changes take effect from the next reinit. "
+			"Zero, the default, exchanges data with all nodes on "
+			"every timestep.",
+			&PostMaster::setMinDelay,
+			&PostMaster::getMinDelay
+		);
+		static ValueFinfo< PostMaster, bool > splitPhase(
+			"splitPhase",
+			"Flag. If true, process posts the sends and returns without "
+			"waiting for data from other nodes. The Clock completes the "
+			"exchange on the next step, just before the first tick whose "
+			"objects have messages from other nodes, so that the ticks "
+			"ahead of it overlap with the communication. "
+			"Ignored if minDelay is set.",
+			&PostMaster::setSplitPhase,
+			&PostMaster::getSplitPhase
+		);
 		//////////////////////////////////////////////////////////////
 		// MsgDest Definitions
 		//////////////////////////////////////////////////////////////
@@ -124,7 +171,9 @@ const Cinfo* PostMaster::initCinfo()
 	static Finfo* postMasterFinfos[] = {
 		&numNodes,	// ReadOnlyValue
 		&myNode,	// ReadOnlyValue
-		&bufferSize,	// ReadOnlyValue
+		&bufferSize,	// Value
+		&minDelay,	// Value
+		&splitPhase,	// Value
 		&proc		// SharedFinfo
 	};
 
@@ -163,7 +212,11 @@ void PostMaster::finalizeSends()
  */
 void PostMaster::reinit( const Eref& e, ProcPtr p )
 {
+	unsigned int windowSteps = 1;
+	if ( minDelay_ > 0.0 )
+		windowSteps = minDelay_ / p->dt + 1e-6;
 #ifdef USE_MPI
+	completeExchange();
 	// MPI_Barrier( MPI_COMM_WORLD );
 	unsigned int reqIndex = 0;
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
@@ -182,14 +235,69 @@ void PostMaster::reinit( const Eref& e, ProcPtr p )
 	while ( numRecvDone_ < Shell::numNodes() -1 )
 		clearPending();
 	finalizeSends();
+	// No node can send again till all are past the barrier, so the
+	// buffers can be replaced here.
+	setWindowSteps( windowSteps );
 	MPI_Barrier( MPI_COMM_WORLD );
 	numRecvDone_ = 0;
+	stepsInWindow_ = 0;
+#else
+	setWindowSteps( windowSteps );
 #endif
 }
 
+/**
+ * All the data of a window pile up in the buffers before they go out,
+ * so the buffers are made windowSteps times the size for a single step.
+ * The posted Irecvs are cancelled and posted again on the new buffers,
+ * so this must only be called when no data are on their way.
+ */
+void PostMaster::setWindowSteps( unsigned int steps )
+{
+	if ( steps == 0 )
+		steps = 1;
+	if ( steps == windowSteps_ )
+		return;
+	windowSteps_ = steps;
+	recvBufSize_ = steps * reserveBufSize;
+	for ( unsigned int i = 0; i < Shell::numNodes(); ++i ) {
+		sendBuf_[i].resize( recvBufSize_, 0 );
+#ifdef USE_MPI
+		if ( i == Shell::myNode() ) continue;
+		unsigned int k = i;
+		if ( i > Shell::myNode() ) 
+			k--;
+		MPI_Cancel( &recvReq_[k] );
+		MPI_Wait( &recvReq_[k], MPI_STATUS_IGNORE );
+		recvBuf_[i].resize( recvBufSize_, 0 );
+		postRecv( i );
+#endif
+	}
+}
+
+/**
+ * If minDelay is set, the data for other nodes are left in the send
+ * buffers till a whole window of floor( minDelay / dt ) steps has gone by,
+ * and then exchanged in one go. Any data still held at the end of a run
+ * go out on the next process or reinit call.
+ */
 void PostMaster::process( const Eref& e, ProcPtr p )
 {
 #ifdef USE_MPI
+	if ( splitPhase_ && !( minDelay_ > 0.0 ) ) {
+		startExchange();
+		return;
+	}
+	completeExchange(); // Left over if splitPhase was just turned off.
+	if ( minDelay_ > 0.0 ) {
+		if ( ++stepsInWindow_ < windowSteps_ ) {
+			clearPending(); // Keep serving set and get calls.
+			return;
+		}
+		stepsInWindow_ = 0;
+		exchangeWindow();
+		return;
+	}
 	unsigned int reqIndex = 0;
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
 	{
@@ -212,6 +320,130 @@ void PostMaster::process( const Eref& e, ProcPtr p )
 #endif
 }
 
+/**
+ * The nodes first swap the sizes of what they have for each other. This
+ * small MPI_Alltoall is the only collective call. The data then go
+ * point-to-point and only between nodes which have something for each
+ * other. No barrier is needed because a node cannot start sending the
+ * next window till all nodes have got to its MPI_Alltoall, by which time
+ * they have finished receiving this one.
+ */
+void PostMaster::exchangeWindow()
+{
+#ifdef USE_MPI
+	if ( Shell::numNodes() == 1 )
+		return;
+	MPI_Alltoall( &sendSize_[0], 1, MPI_UNSIGNED,
+					&recvSize_[0], 1, MPI_UNSIGNED, MPI_COMM_WORLD );
+	unsigned int numExpected = 0;
+	unsigned int reqIndex = 0;
+	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
+	{
+		if ( i == Shell::myNode() ) continue;
+		assert( recvSize_[i] <= recvBufSize_ );
+		if ( recvSize_[i] > 0 )
+			numExpected++;
+		if ( sendSize_[i] > 0 ) {
+			MPI_Isend( 
+				&sendBuf_[i][0], sendSize_[i], MPI_DOUBLE,
+				i, MSGTAG, MPI_COMM_WORLD,
+				&sendReq_[ reqIndex ]
+			);
+		} else {
+			sendReq_[ reqIndex ] = MPI_REQUEST_NULL;
+		}
+		reqIndex++;
+		clearPending();
+	}
+	while ( numRecvDone_ < numExpected )
+		clearPending();
+	finalizeSends();
+	numRecvDone_ = 0;
+#endif
+}
+
+/**
+ * The send buffers are swapped out, so that the ticks which run before
+ * completeExchange can fill them up for the next step while these go
+ * out. The spare buffers are only allocated when first used.
+ */
+void PostMaster::startExchange()
+{
+#ifdef USE_MPI
+	completeExchange(); // In case no tick needed it.
+	if ( Shell::numNodes() == 1 )
+		return;
+	unsigned int reqIndex = 0;
+	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
+	{
+		if ( i == Shell::myNode() ) continue;
+		if ( flightBuf_[i].size() < sendBuf_[i].size() )
+			flightBuf_[i].resize( sendBuf_[i].size(), 0 );
+		flightBuf_[i].swap( sendBuf_[i] );
+		MPI_Isend( 
+			&flightBuf_[i][0], sendSize_[i], MPI_DOUBLE,
+			i, MSGTAG, MPI_COMM_WORLD,
+			&sendReq_[ reqIndex++ ]
+		);
+		sendSize_[i] = 0;
+	}
+	isExchangePending_ = true;
+	clearPending(); // Get the communications going.
+#endif
+}
+
+/**
+ * The Irecvs are not reposted as data come in, but only here once data
+ * from every node have arrived. Otherwise data sent on the next step by
+ * a node that is ahead could be counted as part of this step.
+ */
+void PostMaster::completeExchange()
+{
+#ifdef USE_MPI
+	if ( !isExchangePending_ )
+		return;
+	while ( numRecvDone_ < Shell::numNodes() -1 )
+		clearPending();
+	MPI_Waitall( Shell::numNodes() -1, &sendReq_[0], MPI_STATUSES_IGNORE );
+	numRecvDone_ = 0;
+	isExchangePending_ = false;
+	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
+		if ( i != Shell::myNode() )
+			postRecv( i );
+#endif
+}
+
+bool PostMaster::isExchangePending() const
+{
+	return isExchangePending_;
+}
+
+/**
+ * The Element lists all its Msgs, whichever way they go. Only those
+ * that the other Element has bound to one of its SrcFinfos bring data
+ * in. This may be either end of the Msg, as shared Msgs go both ways.
+ */
+bool PostMaster::hasRemoteInput( const Element* e )
+{
+	const vector< ObjId >& msgs = e->msgIn();
+	for ( vector< ObjId >::const_iterator 
+			i = msgs.begin(); i != msgs.end(); ++i ) {
+		const Msg* m = Msg::getMsg( *i );
+		const Element* other = ( m->e1() == e ) ? m->e2() : m->e1();
+		if ( other->isGlobal() || 
+						other->numLocalData() == other->numData() )
+			continue;
+		const vector< MsgFuncBinding >* mfb = 0;
+		for ( BindIndex b = 0; ( mfb = other->getMsgAndFunc( b ) ); ++b ) {
+			for ( vector< MsgFuncBinding >::const_iterator 
+					j = mfb->begin(); j != mfb->end(); ++j )
+				if ( j->mid == *i )
+					return true;
+		}
+	}
+	return false;
+}
+
 void PostMaster::clearPending()
 {
 	if ( Shell::numNodes() == 1 )
@@ -419,17 +651,9 @@ void PostMaster::clearPendingRecv()
 			j += TgtInfo::headerSize + tgt->dataSize();
 			assert( buf - &recvBuf_[recvNode][0] == j );
 		}
-		// Post the next Irecv.
-		unsigned int k = recvNode;
-		if ( recvNode > Shell::myNode() ) 
-			k--;
-		MPI_Irecv( &recvBuf_[recvNode][0],
-						recvBufSize_, MPI_DOUBLE, 
-						recvNode,
-						MSGTAG, MPI_COMM_WORLD,
-						&recvReq_[ k ] 
-						// Ensure we have contiguous entries in recvReq_
-				 );
+		// Post the next Irecv, unless completeExchange is to do so.
+		if ( !isExchangePending_ )
+			postRecv( recvNode );
 	}
 	numRecvDone_ += done;
 #endif
@@ -453,6 +677,9 @@ double* PostMaster::addToSendBuf( const Eref& e, unsigned int bindIndex,
 				": Data size (" << size << ") goes past end of buffer\n";
 		assert( 0 );
 	}
+	// Never write past the end, even if the receiver cannot take it all.
+	if ( end + TgtInfo::headerSize + size > sendBuf_[node].size() )
+		sendBuf_[node].resize( end + TgtInfo::headerSize + size, 0 );
 	TgtInfo* tgt = reinterpret_cast< TgtInfo* >( &sendBuf_[node][end] );
 	tgt->set( e.objId(), bindIndex, size );
 	end += TgtInfo::headerSize;
@@ -724,3 +951,28 @@ void PostMaster::setBufferSize( unsigned int size )
 	for ( unsigned int i =0; i < sendBuf_.size(); ++i )
 		sendBuf_[i].resize( size );
 }
+
+double PostMaster::getMinDelay() const
+{
+	return minDelay_;
+}
+
+void PostMaster::setMinDelay( double v )
+{
+	if ( v < 0.0 ) {
+		cout << "Warning: PostMaster::setMinDelay: delay must be >= 0.\n";
+		return;
+	}
+	minDelay_ = v;
+	stepsInWindow_ = 0;
+}
+
+bool PostMaster::getSplitPhase() const
+{
+	return splitPhase_;
+}
+
+void PostMaster::setSplitPhase( bool v )
+{
+	splitPhase_ = v;
+}
@@ -108,6 +108,10 @@ class PostMaster {
 		unsigned int getMyNode() const;
 		unsigned int getBufferSize() const;
 		void setBufferSize( unsigned int size );
+		double getMinDelay() const;
+		void setMinDelay( double v );
+		bool getSplitPhase() const;
+		void setSplitPhase( bool v );
 		void reinit( const Eref& e, ProcPtr p );
 		void process( const Eref& e, ProcPtr p );
 
@@ -119,6 +123,28 @@ class PostMaster {
 		void clearPendingRecv();
 		/// Checks that all sends have gone out
 		void finalizeSends();
+		/// Exchanges data batched over a minDelay window, see process.
+		void exchangeWindow();
+
+		/**
+		 * Split-phase exchange. startExchange posts the sends and
+		 * returns without waiting. completeExchange then waits for and
+		 * dispatches the incoming data, and for the sends to clear.
+		 * It does nothing if no exchange is pending, so the Clock can
+		 * call it before any tick that needs remote input.
+		 */
+		void startExchange();
+		void completeExchange();
+		/// True if an exchange has been started but not completed.
+		bool isExchangePending() const;
+
+		/**
+		 * True if the Element may receive data from other nodes, that
+		 * is, if it has a Msg from an Element with data entries that
+		 * are not all on this node. Used by the Clock to find the ticks
+		 * that must wait for a split-phase exchange to complete.
+		 */
+		static bool hasRemoteInput( const Element* e );
 
 		/// Handles 'get' calls from another node, to an object on mynode.
 		void handleRemoteGet( const Eref& e, 
@@ -160,7 +186,11 @@ class PostMaster {
 		vector< double > setRecvBuf_; 
 		vector< vector< double > > sendBuf_;
 		vector< vector< double > > recvBuf_;
+		/// Send buffers in flight during a split-phase exchange.
+		vector< vector< double > > flightBuf_;
 		vector< unsigned int > sendSize_;
+		/// Sizes of incoming data from each node in windowed exchange.
+		vector< unsigned int > recvSize_;
 		vector< double > getHandlerBuf_; // Just enough for one TgtInfo.
 #ifdef USE_MPI
 		MPI_Request setSendReq_;
@@ -176,7 +206,21 @@ class PostMaster {
 		int isSetSent_;
 		int isSetRecv_;
 		int setSendSize_;
+		/// Posts the Irecv for data from the specified node.
+		void postRecv( unsigned int node );
+		/// Sizes the buffers for a window of the given number of steps.
+		void setWindowSteps( unsigned int steps );
+
 		unsigned int numRecvDone_;
+		/// Shortest delay of cross-node messages. Zero if unwindowed.
+		double minDelay_;
+		/// Timesteps since the last windowed exchange.
+		unsigned int stepsInWindow_;
+		/// Timesteps in a window, floor( minDelay / dt ) as of reinit.
+		unsigned int windowSteps_;
+		/// Flag: process only starts the exchange. See startExchange.
+		bool splitPhase_;
+		bool isExchangePending_;
 };
 
 #endif	// _POST_MASTER_H
@@ -7,7 +7,169 @@
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
 
+#include "header.h"
+#include "PostMaster.h"
+#include "../shell/Shell.h"
+
+/**
+ * Checks the split-phase exchange. On step k, a[i] sends k * ( i + 1 )
+ * to b[i + 2], which is on the next node when there are several, and b
+ * adds up all it gets. Only b takes input from other nodes. b runs
+ * before the PostMaster, so values from other nodes reach it a step
+ * later in either mode, and the totals must be the same with and
+ * without splitPhase. No exchange may be left pending after a run.
+ */
+void testSplitPhaseExchange()
+{
+	Shell* shell = reinterpret_cast< Shell* >( ObjId().data() );
+	unsigned int size = 2 * Shell::numNodes();
+	Id a = shell->doCreate( "Arith", ObjId(), "a", size );
+	Id b = shell->doCreate( "Arith", ObjId(), "b", size );
+	Id c = shell->doCreate( "Arith", ObjId(), "c", 1 );
+	ObjId mid = shell->doAddMsg( "Diagonal", a, "output", b, "arg3" );
+	assert( !mid.bad() );
+	Field< int >::set( mid, "stride", 2 );
+	assert( PostMaster::hasRemoteInput( b.element() ) == 
+					( Shell::numNodes() > 1 ) );
+	assert( !PostMaster::hasRemoteInput( a.element() ) );
+	assert( !PostMaster::hasRemoteInput( c.element() ) );
+	mid = shell->doAddMsg( "OneToOne", a, "output", a, "arg2" );
+	assert( !mid.bad() );
+	mid = shell->doAddMsg( "OneToOne", b, "output", b, "arg2" );
+	assert( !mid.bad() );
+
+	// With several nodes main has put the PostMaster on tick 9, dt 1.
+	ObjId pm( 3 );
+	PostMaster* p = reinterpret_cast< PostMaster* >( pm.data() );
+	ObjId clock( 1 );
+	double oldDt = LookupField< unsigned int, double >::get( 
+					clock, "tickDt", 1 );
+	shell->doSetClock( 0, 1 );
+	shell->doSetClock( 1, 1 );
+	shell->doUseClock( "/a", "process", 0 );
+	shell->doUseClock( "/b", "process", 1 );
+	vector< double > arg1( size );
+	for ( unsigned int i = 0; i < size; ++i )
+		arg1[i] = i + 1;
+	const unsigned int numSteps = 5;
+	vector< double > blocking;
+	for ( unsigned int pass = 0; pass < 2; ++pass ) {
+		bool splitPhase = ( pass == 1 );
+		Field< bool >::set( pm, "splitPhase", splitPhase );
+		assert( Field< bool >::get( pm, "splitPhase" ) == splitPhase );
+		shell->doReinit();
+		SetGet1< double >::setVec( a, "arg1", arg1 );
+		shell->doStart( numSteps );
+		assert( !p->isExchangePending() );
+		vector< double > totals;
+		Field< double >::getVec( b, "outputValue", totals );
+		assert( totals.size() == size );
+		if ( !splitPhase ) {
+			blocking = totals;
+			continue;
+		}
+		for ( unsigned int j = 0; j < size; ++j ) {
+			assert( doubleEq( totals[j], blocking[j] ) );
+			if ( j < 2 ) {
+				assert( doubleEq( totals[j], 0.0 ) );
+				continue;
+			}
+			// Values from another node miss the last step.
+			double n = numSteps;
+			if ( a.element()->getNode( j - 2 ) != b.element()->getNode( j ) )
+				n = numSteps - 1;
+			assert( doubleEq( totals[j], ( j - 1 ) * n * ( n + 1 ) / 2 ) );
+		}
+	}
+	Field< bool >::set( pm, "splitPhase", false );
+	assert( !Field< bool >::get( pm, "splitPhase" ) );
+	shell->doSetClock( 1, oldDt );
+
+	shell->doDelete( a );
+	shell->doDelete( b );
+	shell->doDelete( c );
+}
+
+/**
+ * Checks the windowed exchange. On step k, a[i] sends k * ( i + 1 ) to
+ * b[i + 2], which is on the next node when there are several. b runs
+ * after the PostMaster and adds up all it gets, so after a run of whole
+ * windows everything sent must have come in, the same as without
+ * windowing, while after a part of the first window nothing from
+ * another node may have come in yet. The buffers must be able to hold
+ * a whole window.
+ */
+void testWindowedExchange()
+{
+	Shell* shell = reinterpret_cast< Shell* >( ObjId().data() );
+	unsigned int size = 2 * Shell::numNodes();
+	Id a = shell->doCreate( "Arith", ObjId(), "a", size );
+	Id b = shell->doCreate( "Arith", ObjId(), "b", size );
+	ObjId mid = shell->doAddMsg( "OneToOne", a, "output", a, "arg2" );
+	assert( !mid.bad() );
+	mid = shell->doAddMsg( "OneToOne", b, "output", b, "arg2" );
+	assert( !mid.bad() );
+	mid = shell->doAddMsg( "Diagonal", a, "output", b, "arg3" );
+	assert( !mid.bad() );
+	Field< int >::set( mid, "stride", 2 );
+
+	// With several nodes main has put the PostMaster on tick 9, dt 1.
+	ObjId pm( 3 );
+	PostMaster* p = reinterpret_cast< PostMaster* >( pm.data() );
+	ObjId clock( 1 );
+	double oldDt = LookupField< unsigned int, double >::get( 
+					clock, "tickDt", 10 );
+	shell->doSetClock( 0, 1 );
+	shell->doSetClock( 10, 1 );
+	shell->doUseClock( "/a", "process", 0 );
+	shell->doUseClock( "/b", "process", 10 );
+	vector< double > arg1( size );
+	for ( unsigned int i = 0; i < size; ++i )
+		arg1[i] = i + 1;
+	const unsigned int windowSteps = 3;
+	const unsigned int numSteps = 4 * windowSteps;
+	for ( unsigned int pass = 0; pass < 2; ++pass ) {
+		bool windowed = ( pass == 0 ); // Ends with the default, unwindowed.
+		Field< double >::set( pm, "minDelay", windowed ? windowSteps : 0 );
+		for ( unsigned int runSteps = 2; runSteps <= numSteps; 
+						runSteps += numSteps - 2 ) {
+			shell->doReinit();
+			if ( Shell::numNodes() == 1 ) {
+				ProcInfo info;
+				info.dt = 1;
+				p->reinit( pm.eref(), &info );
+			}
+			assert( Field< unsigned int >::get( pm, "bufferSize" ) ==
+				( windowed ? windowSteps : 1 ) * PostMaster::reserveBufSize );
+			SetGet1< double >::setVec( a, "arg1", arg1 );
+			shell->doStart( runSteps );
+			double sumK = runSteps * ( runSteps + 1 ) / 2;
+			vector< double > totals;
+			Field< double >::getVec( b, "outputValue", totals );
+			assert( totals.size() == size );
+			for ( unsigned int j = 0; j < size; ++j ) {
+				double total = totals[j];
+				if ( j < 2 ) {
+					assert( doubleEq( total, 0.0 ) );
+				} else if ( windowed && runSteps < windowSteps &&
+					a.element()->getNode( j - 2 ) != 
+					b.element()->getNode( j ) ) {
+					assert( doubleEq( total, 0.0 ) );
+				} else {
+					assert( doubleEq( total, ( j - 1 ) * sumK ) );
+				}
+			}
+		}
+	}
+	assert( doubleEq( Field< double >::get( pm, "minDelay" ), 0.0 ) );
+	shell->doSetClock( 10, oldDt );
+
+	shell->doDelete( a );
+	shell->doDelete( b );
+}
+
 void testMpi()
 {
-		;
+	testSplitPhaseExchange();
+	testWindowedExchange();
 }
@@ -10,7 +10,8 @@
 #include "header.h"
 #include "SparseMatrix.h"
 #include "SparseMsg.h"
-#include "../randnum/randnum.h"
+#include "../randnum/CounterRng.h"
+#include "../utility/ThreadPool.h"
 #include "../shell/Shell.h"
 
 // Initializing static variables
@@ -140,7 +141,6 @@ static const Cinfo* sparseMsgCinfo = SparseMsg::initCinfo();
 void SparseMsg::setProbability ( double probability )
 {
 	p_ = probability;
-	mtseed( seed_ );
 	randomConnect( probability );
 }
 
@@ -152,7 +152,6 @@ double SparseMsg::getProbability ( ) const
 void SparseMsg::setSeed ( long seed )
 {
 	seed_ = seed;
-	mtseed( seed_ );
 	randomConnect( p_ );
 }
 
@@ -184,7 +183,6 @@ void SparseMsg::setRandomConnectivity( double probability, long seed )
 {
 	p_ = probability;
 	seed_ = seed;
-	mtseed( seed );
 	randomConnect( probability );
 }
 
@@ -248,7 +246,9 @@ void SparseMsg::tripletFill( vector< unsigned int > src,
 
 SparseMsg::SparseMsg( Element* e1, Element* e2, unsigned int msgIndex )
 	: Msg( ObjId( managerId_, (msgIndex != 0) ? msgIndex: msg_.size() ),
-					e1, e2 )
+					e1, e2 ),
+		p_( 0.0 ),
+		seed_( 0 )
 {
 	unsigned int nrows = 0;
 	unsigned int ncolumns = 0;
@@ -299,68 +299,111 @@ Eref SparseMsg::firstTgt( const Eref& src ) const
 	return Eref( 0, 0 );
 }
 
+/**
+ * Fills in the sources connected to one target, in increasing order.
+ * Instead of drawing a random number for every source, it draws the
+ * geometrically distributed gap to the next connected source, so the
+ * work is proportional to the number of connections.
+ */
+static void connectColumn( CounterRng& rng, double probability, 
+				unsigned int nRows, vector< unsigned int >& src )
+{
+	src.clear();
+	if ( probability >= 1.0 ) {
+		for ( unsigned int j = 0; j < nRows; ++j )
+			src.push_back( j );
+		return;
+	}
+	if ( !( probability > 0.0 ) )
+		return;
+	double scale = 1.0 / log1p( -probability );
+	double j = -1.0; // double so that the skips cannot overflow.
+	for ( ; ; ) {
+		double r = 1.0 - rng.uniform(); // On (0,1] so the log is finite.
+		j += 1.0 + floor( log( r ) * scale );
+		if ( j >= nRows )
+			break;
+		src.push_back( static_cast< unsigned int >( j ) );
+	}
+}
+
+/// Arguments for randomConnectBlock, as handed in by the ThreadPool.
+struct RandomConnectJob
+{
+	double probability;
+	unsigned int nRows;
+	unsigned long seed;
+	vector< vector< unsigned int > >* src;
+};
+
+/**
+ * ThreadPool work function for randomConnect. Each target column has its
+ * own random number stream, so the connections do not depend on the
+ * number of threads.
+ */
+static void randomConnectBlock( void* arg, 
+				unsigned int begin, unsigned int end )
+{
+	RandomConnectJob* job = reinterpret_cast< RandomConnectJob* >( arg );
+	for ( unsigned int i = begin; i < end; ++i ) {
+		CounterRng rng( job->seed, i );
+		connectColumn( rng, job->probability, job->nRows, 
+						( *job->src )[i] );
+	}
+}
+
 /**
  * Returns number of synapses formed.
- * Fills it in transpose form, because we need to count and index the 
- * number of synapses on the target, so we need to iterate over the sources
- * in the inner loop. Once full, does the transpose.
- * Should really have a seed argument for the random number.
- * Later need a way to fast-forward mtrand to just the entries we
- * need to fill.
+ * Connects each source to each target with the given probability. The 
+ * result depends only on the probability and seed_. The synapse index
+ * of each connection on its target follows the order of the sources.
+ * The connections for each target are generated on their own, in
+ * parallel, and then put straight into the matrix in compressed row 
+ * form, so both time and memory scale with the number of connections.
  */
 unsigned int SparseMsg::randomConnect( double probability )
 {
 	unsigned int nRows = matrix_.nRows(); // Sources
 	unsigned int nCols = matrix_.nColumns();	// Destinations
-	matrix_.clear();
-	unsigned int totalSynapses = 0;
-	vector< unsigned int > sizes( nCols, 0 );
-	unsigned int totSynNum = 0;
 	Element* syn = e2_;
 	unsigned int startData = syn->localDataStart();
 	unsigned int endData = startData + syn->numLocalData();
 
 	assert( nCols == syn->numData() );
 
-	matrix_.transpose();
+	vector< vector< unsigned int > > src( nCols );
+	RandomConnectJob job;
+	job.probability = probability;
+	job.nRows = nRows;
+	job.seed = seed_;
+	job.src = &src;
+	ThreadPool pool( Shell::numCores() );
+	pool.process( nCols, &randomConnectBlock, &job );
+
+	// Count up the entries of each source row, then fill in the rows.
+	// Going through the targets in order keeps each row sorted.
+	vector< unsigned int > rowStart( nRows + 1, 0 );
+	for ( unsigned int i = 0; i < nCols; ++i )
+		for ( unsigned int k = 0; k < src[i].size(); ++k )
+			rowStart[ src[i][k] + 1 ]++;
+	for ( unsigned int j = 0; j < nRows; ++j )
+		rowStart[j + 1] += rowStart[j];
+	unsigned int totalSynapses = rowStart[ nRows ];
+	vector< unsigned int > entry( totalSynapses );
+	vector< unsigned int > colIndex( totalSynapses );
+	vector< unsigned int > next( rowStart.begin(), rowStart.end() - 1 );
 	for ( unsigned int i = 0; i < nCols; ++i ) {
-		vector< unsigned int > synIndex;
-		// This needs to be obtained from current size of syn array.
-		// unsigned int synNum = sizes[ i ];
-		unsigned int synNum = 0;
-		for ( unsigned int j = 0; j < nRows; ++j ) {
-			double r = mtrand(); // Want to ensure it is called each time round the loop.
-			if ( r < probability ) {
-				synIndex.push_back( synNum );
-				++synNum;
-				++totSynNum;
-			} else {
-				synIndex.push_back( ~0 );
-			}
+		for ( unsigned int k = 0; k < src[i].size(); ++k ) {
+			unsigned int pos = next[ src[i][k] ]++;
+			colIndex[ pos ] = i;
+			entry[ pos ] = k; // Synapse index on target.
 		}
-			
-		if ( i >= startData && i < endData ) {
-			e2_->resizeField( i - startData, synNum );
-		}
-			totalSynapses += synNum;
-			matrix_.addRow( i, synIndex );
-		/*
-		 * This is the correct form, but I need to implement something
-		 * to check up for target nodes in order to use this.
-		if ( i >= startData && i < endData ) {
-			e2_->resizeField( i - startData, synNum );
-			totalSynapses += synNum;
-			matrix_.addRow( i, synIndex );
-		} else {
-			synIndex.resize( 0 );
-			synIndex.assign( nRows, ~0 );
-			matrix_.addRow( i, synIndex );
-		}
-		*/
+		if ( i >= startData && i < endData )
+			e2_->resizeField( i - startData, src[i].size() );
+		vector< unsigned int >().swap( src[i] ); // Free as we go.
 	}
+	matrix_.csrFill( entry, colIndex, rowStart );
 
-	matrix_.transpose();
-	// cout << Shell::myNode() << ": sizes.size() = " << sizes.size() << ", ncols = " << nCols << ", startSynapse = " << startSynapse << endl;
 	e1()->markRewired();
 	e2()->markRewired();
 	return totalSynapses;
@@ -522,8 +522,9 @@ extern "C" {
                 break;
             }
             case 'D': {
-                vector< double > value = Field< vector < double > >::get(self->oid_, fieldName);
-                _ret = to_py(&value, ftype);
+                vector< double > * value = new vector< double >();
+                Field< vector < double > >::get(self->oid_, fieldName).swap(*value);
+                _ret = to_pyarray(value, innerType(ftype));
                 break;
             }
             case 'X': { // vector<Id>
@@ -537,13 +538,15 @@ extern "C" {
                 break;
             } 
             case 'M': {
-                vector< long > value = Field< vector <long> >::get(self->oid_, fieldName);
-                _ret = to_py(&value, ftype);
+                vector< long > * value = new vector< long >();
+                Field< vector <long> >::get(self->oid_, fieldName).swap(*value);
+                _ret = to_pyarray(value, innerType(ftype));
                 break;
             }
             case 'P': {
-                vector < unsigned long > value = Field< vector < unsigned long > >::get(self->oid_, fieldName);
-                _ret = to_py(&value, ftype);
+                vector< unsigned long > * value = new vector< unsigned long >();
+                Field< vector < unsigned long > >::get(self->oid_, fieldName).swap(*value);
+                _ret = to_pyarray(value, innerType(ftype));
                 break;
             }
             case 'S': {
@@ -552,13 +555,15 @@ extern "C" {
                 break;
             }
             case 'v': {
-                vector < int > value = Field<vector <int> >::get(self->oid_, fieldName);
-                _ret = to_py(&value, ftype);
+                vector< int > * value = new vector< int >();
+                Field<vector <int> >::get(self->oid_, fieldName).swap(*value);
+                _ret = to_pyarray(value, innerType(ftype));
                 break;
             }
             case 'N': {
-                vector <unsigned int > value = Field< vector < unsigned int> >::get(self->oid_, fieldName);
-                _ret = to_py(&value, ftype);
+                vector< unsigned int > * value = new vector< unsigned int >();
+                Field< vector < unsigned int> >::get(self->oid_, fieldName).swap(*value);
+                _ret = to_pyarray(value, innerType(ftype));
                 break;
             }
             case 'T': { // vector<vector < unsigned int >>
@@ -577,8 +582,9 @@ extern "C" {
                 break;
             }
             case 'F': {
-                vector <float> value = Field< vector < float > >::get(self->oid_, fieldName);
-                _ret = to_py(&value, ftype);
+                vector< float > * value = new vector< float >();
+                Field< vector < float > >::get(self->oid_, fieldName).swap(*value);
+                _ret = to_pyarray(value, innerType(ftype));
                 break;
             }
             case 'c': {
@@ -750,7 +756,11 @@ extern "C" {
                 } else {
                     Py_ssize_t length = PySequence_Length(value);
                     vector<double> _value;
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, innerType(ftype), length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         double v = PyFloat_AsDouble(vo);
                         Py_XDECREF(vo);
@@ -796,7 +806,11 @@ extern "C" {
                 }
                 Py_ssize_t length = PySequence_Length(value);
                 vector<int> _value;
-                for ( int ii = 0; ii < length; ++ii){
+                int filled = pyarray_to_vector(value, &_value, innerType(ftype), length);
+                if (filled < 0){
+                    return -1;
+                }
+                for ( int ii = 0; filled == 0 && ii < length; ++ii){
                     PyObject * vo = PySequence_GetItem(value, ii);
                     int v = PyInt_AsLong(vo);
                     Py_XDECREF(vo);
@@ -828,7 +842,11 @@ extern "C" {
                 } else {
                     Py_ssize_t length = PySequence_Length(value);
                     vector<long> _value;
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, innerType(ftype), length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         long v = PyInt_AsLong(vo);
                         Py_XDECREF(vo);
@@ -844,7 +862,11 @@ extern "C" {
                 } else {
                     Py_ssize_t length = PySequence_Length(value);
                     vector<unsigned int> _value;
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, innerType(ftype), length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         unsigned int v = PyInt_AsUnsignedLongMask(vo);
                         Py_XDECREF(vo);
@@ -860,7 +882,11 @@ extern "C" {
                 } else {
                     Py_ssize_t length = PySequence_Length(value);
                     vector<unsigned long> _value;
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, innerType(ftype), length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         unsigned long v = PyInt_AsUnsignedLongMask(vo);
                         Py_XDECREF(vo);
@@ -876,7 +902,11 @@ extern "C" {
                 } else {
                     Py_ssize_t length = PySequence_Length(value);
                     vector<float> _value;
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, innerType(ftype), length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         float v = PyFloat_AsDouble(vo);
                         Py_XDECREF(vo);
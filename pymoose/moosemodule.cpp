@@ -142,6 +142,80 @@ extern void speedTestMultiNodeIntFireNetwork(
 extern void mooseBenchmarks( unsigned int option );
 
 
+#ifdef USE_NUMPY
+/**
+   Capsule destructor for vectors handed over to NumPy arrays by
+   to_pyarray.
+*/
+template <typename T>
+void delete_vector_capsule(PyObject * capsule)
+{
+    delete static_cast< vector< T > * >(PyCapsule_GetPointer(capsule, NULL));
+}
+
+/**
+   Wrap the data of a heap-allocated vector in a NumPy array, without
+   copying. A capsule holding the vector is set as the base object of
+   the array, so the vector is freed along with the array. On failure
+   the vector is still owned by the caller.
+*/
+template <typename T>
+PyObject * vector_to_pyarray(vector< T > * vec, int npytype)
+{
+    npy_intp size = (npy_intp)(vec->size());
+    PyObject * ret = PyArray_SimpleNewFromData(1, &size, npytype,
+                                               size? &(*vec)[0]: NULL);
+    if (ret == NULL){
+        return NULL;
+    }
+    if (size == 0){ // NumPy has allocated its own (empty) buffer.
+        delete vec;
+        return ret;
+    }
+    PyObject * base = PyCapsule_New(vec, NULL, delete_vector_capsule< T >);
+    if (base == NULL){
+        Py_DECREF(ret);
+        return NULL;
+    }
+    // This steals the reference to base.
+    if (PyArray_SetBaseObject((PyArrayObject*)ret, base) != 0){
+        PyCapsule_SetDestructor(base, NULL);
+        Py_DECREF(base);
+        Py_DECREF(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+/**
+   Copy a NumPy array into vec in one go.
+*/
+template <typename T>
+void pyarray_assign(PyArrayObject * arr, void * vec)
+{
+    const T * data = static_cast< const T * >(PyArray_DATA(arr));
+    static_cast< vector< T > * >(vec)->assign(data, data + PyArray_SIZE(arr));
+}
+
+/**
+   NumPy type matching a scalar typecode, or NPY_NOTYPE if the values
+   are not stored as plain numbers.
+*/
+static int npy_typenum(char typecode)
+{
+    switch (typecode){
+        case 'd': return NPY_DOUBLE;
+        case 'f': return NPY_FLOAT;
+        case 'i': return NPY_INT;
+        case 'I': return NPY_UINT;
+        case 'l': return NPY_LONG;
+        case 'k': return NPY_ULONG;
+        case 'h': return NPY_SHORT;
+        default: return NPY_NOTYPE;
+    }
+}
+#endif // USE_NUMPY
+
 // C-wrapper to be used by Python
 extern "C" {
 
@@ -710,6 +784,151 @@ extern "C" {
             return ret;
     }
     
+    /**
+       Convert a heap-allocated C++ vector to a Python object, taking
+       ownership of the vector. Numeric vectors become NumPy arrays
+       which use the vector's own storage, so the values are neither
+       copied nor boxed one by one. Other vectors, and all vectors when
+       built without NumPy, go through to_pytuple.
+    */
+    PyObject * to_pyarray(void * vec, char typecode)
+    {
+        PyObject * ret = NULL;
+#ifdef USE_NUMPY
+        int npytype = npy_typenum(typecode);
+        switch (typecode){
+            case 'd':
+                ret = vector_to_pyarray(static_cast< vector< double > * >(vec), npytype);
+                break;
+            case 'f':
+                ret = vector_to_pyarray(static_cast< vector< float > * >(vec), npytype);
+                break;
+            case 'i':
+                ret = vector_to_pyarray(static_cast< vector< int > * >(vec), npytype);
+                break;
+            case 'I':
+                ret = vector_to_pyarray(static_cast< vector< unsigned int > * >(vec), npytype);
+                break;
+            case 'l':
+                ret = vector_to_pyarray(static_cast< vector< long > * >(vec), npytype);
+                break;
+            case 'k':
+                ret = vector_to_pyarray(static_cast< vector< unsigned long > * >(vec), npytype);
+                break;
+            case 'h':
+                ret = vector_to_pyarray(static_cast< vector< short > * >(vec), npytype);
+                break;
+            default:
+                break;
+        }
+        if (ret != NULL){
+            return ret;
+        }
+        if (npytype != NPY_NOTYPE){
+            // NumPy failed and has set the error. The vector is still ours.
+            switch (typecode){
+                case 'd': delete static_cast< vector< double > * >(vec); break;
+                case 'f': delete static_cast< vector< float > * >(vec); break;
+                case 'i': delete static_cast< vector< int > * >(vec); break;
+                case 'I': delete static_cast< vector< unsigned int > * >(vec); break;
+                case 'l': delete static_cast< vector< long > * >(vec); break;
+                case 'k': delete static_cast< vector< unsigned long > * >(vec); break;
+                case 'h': delete static_cast< vector< short > * >(vec); break;
+            }
+            return NULL;
+        }
+#endif
+        ret = to_pytuple(vec, typecode);
+        switch (typecode){
+            case 'd': delete static_cast< vector< double > * >(vec); break;
+            case 'f': delete static_cast< vector< float > * >(vec); break;
+            case 'i': delete static_cast< vector< int > * >(vec); break;
+            case 'I': delete static_cast< vector< unsigned int > * >(vec); break;
+            case 'l': delete static_cast< vector< long > * >(vec); break;
+            case 'k': delete static_cast< vector< unsigned long > * >(vec); break;
+            case 'h': delete static_cast< vector< short > * >(vec); break;
+            default:
+                PyErr_SetString(PyExc_TypeError, "to_pyarray: unhandled type");
+                Py_XDECREF(ret);
+                return NULL;
+        }
+        return ret;
+    }
+
+    /**
+       Fill vec from value in one copy, if value is a NumPy array of
+       length entries. Returns 1 if it did, 0 if value is not an array
+       (or typecode not a plain number) so the caller should go through
+       it as a sequence, and -1 with the Python error set on failure.
+       An array that does not cast safely into an integer field, or
+       a complex array, is only accepted if every value survives the
+       cast, so that, say, 1.5 is not silently truncated into an int
+       field; otherwise this raises TypeError. Casting into a floating
+       point field may round.
+    */
+    int pyarray_to_vector(PyObject * value, void * vec, char typecode, Py_ssize_t length)
+    {
+#ifdef USE_NUMPY
+        int npytype = npy_typenum(typecode);
+        if (npytype == NPY_NOTYPE || !PyArray_Check(value)){
+            return 0;
+        }
+        int srctype = PyArray_TYPE((PyArrayObject*)value);
+        bool safe = PyArray_CanCastSafely(srctype, npytype);
+        bool checked = !safe && (PyTypeNum_ISINTEGER(npytype) ||
+                                 PyTypeNum_ISCOMPLEX(srctype));
+        PyArrayObject * arr = (PyArrayObject*)PyArray_FROMANY(
+            value, npytype, 1, 1,
+            safe? NPY_ARRAY_IN_ARRAY: NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+        if (arr == NULL){
+            return -1;
+        }
+        if (PyArray_SIZE(arr) != length){
+            Py_DECREF(arr);
+            PyErr_SetString(PyExc_IndexError,
+                            "pyarray_to_vector: length of the array does not match Id size.");
+            return -1;
+        }
+        if (checked){
+            // Cast back and compare, to catch values the cast changed.
+            int lossless = -1;
+            PyObject * back = PyArray_Cast(arr, srctype);
+            PyObject * same = back? PyObject_RichCompare(back, value, Py_EQ): NULL;
+            PyObject * all = same? PyArray_All((PyArrayObject*)same, 0, NULL): NULL;
+            if (all != NULL){
+                lossless = PyObject_IsTrue(all);
+            }
+            Py_XDECREF(all);
+            Py_XDECREF(same);
+            Py_XDECREF(back);
+            if (lossless != 1){
+                Py_DECREF(arr);
+                if (lossless == 0){
+                    ostringstream error;
+                    error << "pyarray_to_vector: values of the array would be changed by the cast from "
+                          << PyArray_DESCR((PyArrayObject*)value)->type << " to " << typecode
+                          << " for the field.";
+                    PyErr_SetString(PyExc_TypeError, error.str().c_str());
+                }
+                return -1;
+            }
+        }
+        switch (typecode){
+            case 'd': pyarray_assign< double >(arr, vec); break;
+            case 'f': pyarray_assign< float >(arr, vec); break;
+            case 'i': pyarray_assign< int >(arr, vec); break;
+            case 'I': pyarray_assign< unsigned int >(arr, vec); break;
+            case 'l': pyarray_assign< long >(arr, vec); break;
+            case 'k': pyarray_assign< unsigned long >(arr, vec); break;
+            case 'h': pyarray_assign< short >(arr, vec); break;
+        }
+        Py_DECREF(arr);
+        return 1;
+#else
+        return 0;
+#endif
+    }
+
     // Global store of defined MOOSE classes.
     map<string, PyTypeObject *>& get_moose_classes()
     {
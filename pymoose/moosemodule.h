@@ -308,6 +308,18 @@ extern "C" {
     */
     PyObject * to_pytuple(void * obj, char typecode);
     
+    /**
+       Convert a heap-allocated C++ vector to Python, taking ownership
+       of it. Numeric vectors become NumPy arrays over the vector's own
+       storage.
+    */
+    PyObject * to_pyarray(void * vec, char typecode);
+    /**
+       Fill a C++ vector from a NumPy array in one copy. Returns 0 if
+       value is not an array, 1 if vec was filled, -1 on error.
+    */
+    int pyarray_to_vector(PyObject * value, void * vec, char typecode, Py_ssize_t length);
+
     /* inner fn for use in to_pytuple */
     PyObject * convert_and_set_tuple_entry(PyObject * tuple, unsigned int index, void * vptr, char typecode);
     
@@ -48,6 +48,7 @@ extern void testMpiBuiltins();
 extern void testMpiShell();
 extern void testMsg();
 extern void testMpiMsg();
+extern void testMpi();
 // extern void testKinetics();
 // extern void testKineticSolvers();
 // extern void	testKineticSolversProcess();
@@ -327,5 +328,7 @@ void mpiTests()
 		cout << "." << flush;
 		testMpiScheduling();
 		cout << "." << flush;
+		testMpi();
+		cout << "." << flush;
 #endif
 }
@@ -752,9 +752,9 @@ extern "C" {
 
         switch (ftype){
             case 'd': {
-                vector < double > val;
-                Field< double >::getVec(self->id_, string(field), val);
-                _ret = to_pytuple(&val, ftype);
+                vector < double > * val = new vector< double >();
+                Field< double >::getVec(self->id_, string(field), *val);
+                _ret = to_pyarray(val, ftype);
                 break;
             }
             case 's': {
@@ -764,9 +764,9 @@ extern "C" {
                 break;
             }
             case 'l': {
-                vector < long > val;
-                Field< long >::getVec(self->id_, string(field), val);
-                _ret = to_pytuple(&val, ftype);
+                vector < long > * val = new vector< long >();
+                Field< long >::getVec(self->id_, string(field), *val);
+                _ret = to_pyarray(val, ftype);
                 break;
             }
             case 'x': {
@@ -782,27 +782,27 @@ extern "C" {
                 break;
             }
             case 'i': {
-                vector < int > val;
-                Field< int >::getVec(self->id_, string(field), val);
-                _ret = to_pytuple(&val, ftype);
+                vector < int > * val = new vector< int >();
+                Field< int >::getVec(self->id_, string(field), *val);
+                _ret = to_pyarray(val, ftype);
                 break;
             }
             case 'I': {
-                vector < unsigned int > val;
-                Field< unsigned int >::getVec(self->id_, string(field), val);
-                _ret = to_pytuple(&val, ftype);
+                vector < unsigned int > * val = new vector< unsigned int >();
+                Field< unsigned int >::getVec(self->id_, string(field), *val);
+                _ret = to_pyarray(val, ftype);
                 break;
             }
             case 'k': {
-                vector < unsigned long > val;
-                Field< unsigned long >::getVec(self->id_, string(field), val);
-                _ret = to_pytuple(&val, ftype);
+                vector < unsigned long > * val = new vector< unsigned long >();
+                Field< unsigned long >::getVec(self->id_, string(field), *val);
+                _ret = to_pyarray(val, ftype);
                 break;
             }
             case 'f': {
-                vector < float > val;
-                Field< float >::getVec(self->id_, string(field), val);
-                _ret = to_pytuple(&val, ftype);
+                vector < float > * val = new vector< float >();
+                Field< float >::getVec(self->id_, string(field), *val);
+                _ret = to_pyarray(val, ftype);
                 break;
             }            
             case 'b': {                                                               
@@ -818,9 +818,9 @@ extern "C" {
                 break;
             }
             case 'h': {
-                vector < short > val;
-                Field< short >::getVec(self->id_, string(field), val);
-                _ret = to_pytuple(&val, ftype);
+                vector < short > * val = new vector< short >();
+                Field< short >::getVec(self->id_, string(field), *val);
+                _ret = to_pyarray(val, ftype);
                 break;
             }
             case 'z': {
@@ -907,7 +907,11 @@ extern "C" {
             case 'd': {//SET_VECFIELD(double, d)
                 vector<double> _value;
                 if (is_seq){
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, ftype, length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         double v = PyFloat_AsDouble(vo);
                         Py_XDECREF(vo);
@@ -939,7 +943,11 @@ extern "C" {
             case 'i': {
                 vector<int> _value;
                 if (is_seq){
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, ftype, length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         int v = PyInt_AsLong(vo);
                         Py_XDECREF(vo);
@@ -955,7 +963,11 @@ extern "C" {
             case 'I': {//SET_VECFIELD(unsigned int, I)
                 vector<unsigned int> _value;
                 if (is_seq){
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, ftype, length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         unsigned int v = PyInt_AsUnsignedLongMask(vo);
                         Py_DECREF(vo);
@@ -971,7 +983,11 @@ extern "C" {
             case 'l': {//SET_VECFIELD(long, l)
                 vector<long> _value;
                 if (is_seq){
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, ftype, length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         long v = PyInt_AsLong(vo);
                         Py_DECREF(vo);
@@ -987,7 +1003,11 @@ extern "C" {
             case 'k': {//SET_VECFIELD(unsigned long, k)
                 vector<unsigned long> _value;
                 if (is_seq){
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, ftype, length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         unsigned long v = PyInt_AsUnsignedLongMask(vo);
                         Py_XDECREF(vo);
@@ -1047,7 +1067,11 @@ extern "C" {
             case 'h': {
                 vector<short> _value;
                 if (is_seq){
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, ftype, length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         short v = PyInt_AsLong(vo);
                         Py_XDECREF(vo);
@@ -1063,7 +1087,11 @@ extern "C" {
             case 'f': {//SET_VECFIELD(float, f)
                 vector<float> _value;
                 if (is_seq){
-                    for ( int ii = 0; ii < length; ++ii){
+                    int filled = pyarray_to_vector(value, &_value, ftype, length);
+                    if (filled < 0){
+                        return -1;
+                    }
+                    for ( int ii = 0; filled == 0 && ii < length; ++ii){
                         PyObject * vo = PySequence_GetItem(value, ii);
                         float v = PyFloat_AsDouble(vo);
                         Py_XDECREF(vo);
@@ -82,7 +82,7 @@ inline double getFc(unsigned int k)
    Binomial distribution generator with parameters n and p.  p is the
    probability of the favoured outcome, n is the number of trials.
  */
-Binomial::Binomial( long n, double p):n_(n), p_(p)
+Binomial::Binomial( long n, double p):isInverted_(false), n_(n), p_(p), mean_(0.0)
 {
     
     if (( p < 0 ) || ( p > 1 ))
@@ -100,7 +100,6 @@ Binomial::Binomial( long n, double p):n_(n), p_(p)
     
     double tmpMean;
     double tmp;
-    isInverted_ = false;
     
 //     tmpMean = n*((p < 0.5)? p : (1-p));
     
@@ -189,7 +188,8 @@ double Binomial::getNextSample() const
     }
     else 
     {
-        if ( mean_ > 10 )
+        // The parameters for BTRD are only set up for n > 20.
+        if ( n_ > 20 && mean_ > 10 )
         {
             sample = isInverted_? n_ - generateTrd(): generateTrd();
         }
@@ -197,12 +197,16 @@ double Binomial::getNextSample() const
         {
             for ( unsigned int i = 0; i < n_; ++i)
             {
-                double myRand = mtrand();
+                double myRand = uniform();
                 if ( myRand < p_ )
                 {
                     sample+=1;
                 }     
             }    
+            if ( isInverted_ )
+            {
+                sample = n_ - sample;
+            }
         }
 //        cerr << "Sample value: " << sample << " " << isInverted_<< endl;            
     }
@@ -234,7 +238,7 @@ double Binomial::generateTrd() const
     while ( true )
     {
         // 1a: generate a uniform random number v
-        varV = mtrand();
+        varV = uniform();
         if ( varV <= paramUrVr_ )
         {
             // 1b: if v <= urvr then u = v/vr - 0.43
@@ -245,7 +249,7 @@ double Binomial::generateTrd() const
         // 2a: if ( v >= vr ) then generate a uniform random number u in (-0.5,+0.5)
         if ( varV >= paramVr_ )
         {
-            varU = mtrand() - 0.5;
+            varU = uniform() - 0.5;
         }
         else  // 2b: otherwise
         {
@@ -254,7 +258,7 @@ double Binomial::generateTrd() const
             // 2b(ii): set u = sign(u)*0.5 - u
             varU = (varU > 0)? 0.5 - varU : - 0.5 - varU;
             // 2b(iii) generate a uniform random number v in (0,vr)
-            varV = mtrand()*paramVr_;
+            varV = uniform()*paramVr_;
         }
         // 3.0a: us = 0.5 - |u|        
         varUs = (varU < 0) ? 0.5 + varU : 0.5 - varU;
@@ -0,0 +1,155 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "CounterRng.h"
+
+// Philox4x32 multipliers and Weyl key increments.
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+static const unsigned int PHILOX_ROUNDS = 10;
+
+CounterRng::CounterRng( uint64_t seed, uint64_t stream )
+{
+	setSeed( seed, stream );
+}
+
+void CounterRng::setSeed( uint64_t seed, uint64_t stream )
+{
+	key_[0] = static_cast< uint32_t >( seed );
+	key_[1] = static_cast< uint32_t >( seed >> 32 );
+	// The stream occupies the upper half of the counter.
+	ctr_[0] = 0;
+	ctr_[1] = 0;
+	ctr_[2] = static_cast< uint32_t >( stream );
+	ctr_[3] = static_cast< uint32_t >( stream >> 32 );
+	used_ = 4; // Forces a refill on the first call.
+}
+
+void CounterRng::refill()
+{
+	uint32_t c0 = ctr_[0];
+	uint32_t c1 = ctr_[1];
+	uint32_t c2 = ctr_[2];
+	uint32_t c3 = ctr_[3];
+	uint32_t k0 = key_[0];
+	uint32_t k1 = key_[1];
+	for ( unsigned int i = 0; i < PHILOX_ROUNDS; ++i ) {
+		uint64_t p0 = static_cast< uint64_t >( PHILOX_M0 ) * c0;
+		uint64_t p1 = static_cast< uint64_t >( PHILOX_M1 ) * c2;
+		uint32_t hi0 = static_cast< uint32_t >( p0 >> 32 );
+		uint32_t lo0 = static_cast< uint32_t >( p0 );
+		uint32_t hi1 = static_cast< uint32_t >( p1 >> 32 );
+		uint32_t lo1 = static_cast< uint32_t >( p1 );
+		c0 = hi1 ^ c1 ^ k0;
+		c1 = lo1;
+		c2 = hi0 ^ c3 ^ k1;
+		c3 = lo0;
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+	out_[0] = c0;
+	out_[1] = c1;
+	out_[2] = c2;
+	out_[3] = c3;
+	used_ = 0;
+	// Increment the lower 64 bits of the counter, leaving the stream.
+	if ( ++ctr_[0] == 0 )
+		++ctr_[1];
+}
+
+void CounterRng::advance( uint64_t n )
+{
+	uint64_t lo = ctr_[0] | ( static_cast< uint64_t >( ctr_[1] ) << 32 );
+	lo += n;
+	ctr_[0] = static_cast< uint32_t >( lo );
+	ctr_[1] = static_cast< uint32_t >( lo >> 32 );
+}
+
+/**
+ * The same rounds as refill, laid out with one lane per counter so that
+ * each step is a simple loop over the lanes. The 32x32 bit multiplies
+ * then map onto the vector unsigned multiplies of SSE2 and later.
+ */
+void CounterRng::bulk( uint32_t* x )
+{
+	uint32_t c0[ Lanes ];
+	uint32_t c1[ Lanes ];
+	uint32_t c2[ Lanes ];
+	uint32_t c3[ Lanes ];
+	uint64_t base = ctr_[0] | ( static_cast< uint64_t >( ctr_[1] ) << 32 );
+	for ( unsigned int j = 0; j < Lanes; ++j ) {
+		uint64_t v = base + j;
+		c0[j] = static_cast< uint32_t >( v );
+		c1[j] = static_cast< uint32_t >( v >> 32 );
+		c2[j] = ctr_[2];
+		c3[j] = ctr_[3];
+	}
+	uint32_t k0 = key_[0];
+	uint32_t k1 = key_[1];
+	for ( unsigned int i = 0; i < PHILOX_ROUNDS; ++i ) {
+		for ( unsigned int j = 0; j < Lanes; ++j ) {
+			uint64_t p0 = static_cast< uint64_t >( PHILOX_M0 ) * c0[j];
+			uint64_t p1 = static_cast< uint64_t >( PHILOX_M1 ) * c2[j];
+			c0[j] = static_cast< uint32_t >( p1 >> 32 ) ^ c1[j] ^ k0;
+			c1[j] = static_cast< uint32_t >( p1 );
+			c2[j] = static_cast< uint32_t >( p0 >> 32 ) ^ c3[j] ^ k1;
+			c3[j] = static_cast< uint32_t >( p0 );
+		}
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+	for ( unsigned int j = 0; j < Lanes; ++j ) {
+		x[ 4 * j ] = c0[j];
+		x[ 4 * j + 1 ] = c1[j];
+		x[ 4 * j + 2 ] = c2[j];
+		x[ 4 * j + 3 ] = c3[j];
+	}
+	advance( Lanes );
+}
+
+void CounterRng::fillInt( uint32_t* x, unsigned int n )
+{
+	unsigned int i = 0;
+	// Use up what is left of the last refill, to stay in sequence.
+	for ( ; i < n && used_ < 4; ++i )
+		x[i] = out_[ used_++ ];
+	for ( ; i + 4 * Lanes <= n; i += 4 * Lanes )
+		bulk( x + i );
+	for ( ; i < n; ++i )
+		x[i] = randInt();
+}
+
+void CounterRng::fill( double* x, unsigned int n )
+{
+	const double scale = 1.0 / 4294967296.0;
+	uint32_t buf[ 4 * Lanes ];
+	unsigned int i = 0;
+	for ( ; i < n && used_ < 4; ++i )
+		x[i] = out_[ used_++ ] * scale;
+	for ( ; i + 4 * Lanes <= n; i += 4 * Lanes ) {
+		bulk( buf );
+		for ( unsigned int j = 0; j < 4 * Lanes; ++j )
+			x[ i + j ] = buf[j] * scale;
+	}
+	for ( ; i < n; ++i )
+		x[i] = uniform();
+}
+
+void CounterRng::discard( uint64_t n )
+{
+	for ( ; n > 0 && used_ < 4; --n )
+		++used_;
+	advance( n / 4 );
+	if ( n % 4 != 0 ) {
+		refill();
+		used_ = n % 4;
+	}
+}
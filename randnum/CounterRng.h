@@ -0,0 +1,88 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _COUNTER_RNG_H
+#define _COUNTER_RNG_H
+
+#include <stdint.h>
+
+/**
+ * CounterRng is a counter-based random number generator using the
+ * Philox4x32-10 bijection (Salmon et al, SC 2011). 
+ * Unlike the global Mersenne Twister behind mtrand(), each CounterRng 
+ * keeps its own tiny state, so every thread or voxel can have its own
+ * generator. 
+ * The sequence is fully determined by the (seed, stream) pair: each
+ * stream gets its own disjoint block of 2^64 counter values, so the 
+ * numbers drawn on one stream do not depend on how many other streams
+ * exist or in what order they are used.
+ */
+class CounterRng
+{
+	public:
+		CounterRng( uint64_t seed = 0, uint64_t stream = 0 );
+
+		/// Restart the sequence for the specified seed and stream.
+		void setSeed( uint64_t seed, uint64_t stream );
+
+		/// Returns a random 32-bit integer.
+		uint32_t randInt()
+		{
+			if ( used_ >= 4 )
+				refill();
+			return out_[ used_++ ];
+		}
+
+		/// Returns a random number on the [0,1) interval, like mtrand.
+		double uniform()
+		{
+			return randInt() * ( 1.0 / 4294967296.0 );
+		}
+
+		/**
+		 * Fills x with n numbers on the [0,1) interval. These are the
+		 * same numbers that n calls to uniform() would return, but
+		 * whole blocks of counters go through Philox together, in
+		 * loops which the compiler can vectorize.
+		 */
+		void fill( double* x, unsigned int n );
+
+		/// Fills x with n random 32-bit integers, as from randInt().
+		void fillInt( uint32_t* x, unsigned int n );
+
+		/// Skips ahead over the next n numbers without generating them.
+		void discard( uint64_t n );
+
+		/**
+		 * Number of counters put through Philox together by fill.
+		 * Fewer than this are unrolled into shuffles rather than
+		 * vectorized as a loop.
+		 */
+		static const unsigned int Lanes = 32;
+
+	private:
+		/// Generates the next four numbers and increments the counter.
+		void refill();
+
+		/**
+		 * Generates the 4 * Lanes numbers for the next Lanes counters,
+		 * into x, and advances the counter past them.
+		 */
+		void bulk( uint32_t* x );
+
+		/// Adds n to the lower 64 bits of the counter.
+		void advance( uint64_t n );
+
+		uint32_t key_[2];
+		uint32_t ctr_[4];
+		uint32_t out_[4];
+		unsigned int used_;
+};
+
+#endif // _COUNTER_RNG_H
@@ -54,23 +54,21 @@ double Exponential::getVariance() const
 
 double Exponential::getNextSample() const
 {
-    return generator_(mean_);    
+    return generator_(*this);    
 }
 
 
-double Exponential::logarithmic(double mean)
+double Exponential::logarithmic(const Exponential& e)
 {
-    double uniform = mtrand();
+    double uniform = e.uniform();
     if ( uniform <= 0 )
     {
         uniform = 1.0e-6;
     }
     
-    return - mean*log(uniform);    
+    return - e.mean_*log(uniform);    
 }
 
-extern unsigned long genrand_int32(void);
-
 /**
    successive entries in the series
    {Qk} = {(ln2/1! + (ln2)^2/2! + (ln2)^3/3! + ... + (ln2)^k/k!)}
@@ -96,11 +94,11 @@ static const double q[] =
    See Knuth, Vol II Sec 3.4.1 : Algorithm S
  */
 
-double Exponential::randomMinimization(double mean)
+double Exponential::randomMinimization(const Exponential& e)
 {
     double result;
     
-    unsigned long uniform = genrand_int32(); // 1) generate t+1 (=32) bit uniform random binary fraction .b0..bt
+    unsigned long uniform = e.randInt(); // 1) generate t+1 (=32) bit uniform random binary fraction .b0..bt
     int j = 0;
 
     if ( uniform == 0 )
@@ -118,7 +116,7 @@ double Exponential::randomMinimization(double mean)
     
     if ( uniform_frac < LN2 ) // 2) u < ln2?
     {
-        result = mean*(j*LN2 + uniform_frac); // x <- mean * ( j * ln2 + u )        
+        result = e.mean_*(j*LN2 + uniform_frac); // x <- mean * ( j * ln2 + u )        
     }
     else 
     {
@@ -133,14 +131,14 @@ double Exponential::randomMinimization(double mean)
         }
         for ( unsigned int i = 0; i < k; ++i )
         {
-            u = genrand_int32();
+            u = e.randInt();
             if ( u < v )
             {
                 v = u;
             }
         }
         
-        result = mean*( j + v/4294967296.0 )*LN2;
+        result = e.mean_*( j + v/4294967296.0 )*LN2;
     }
     
     return result;    
@@ -36,9 +36,9 @@ class Exponential: public Probability
     double getNextSample() const;
   private:
     double mean_;
-    double (*generator_)(double);
-    static double logarithmic(double mean);
-    static double randomMinimization(double mean);
+    double (*generator_)(const Exponential&);
+    static double logarithmic(const Exponential& e);
+    static double randomMinimization(const Exponential& e);
     
     
 };
@@ -84,14 +84,14 @@ double Gamma::gammaLarge() const// alpha > 1
     
     while (true)
     {
-        uniformU = mtrand();        
+        uniformU = uniform();        
         yValue = tan(M_PI*uniformU);
         tmp = sqrt(2*alpha_ - 1)*yValue;
         
         result = tmp + alpha_ - 1;
         if (result > 0)
         {
-            uniformV = mtrand();
+            uniformV = uniform();
             check = ( 1 + yValue*yValue )*exp((alpha_ - 1.0)*log(result/(alpha_ - 1.0)) - tmp);
             if (uniformV < check )
             {
@@ -106,11 +106,12 @@ double Gamma::gammaLarge() const// alpha > 1
 // See: TAOCP by Knuth, Vol 2, 3.4.1 Exercise 16
 double Gamma::gammaSmall() const // 0 < alpha < 1
 {
-    static Exponential expGen(1.0);
+    Exponential expGen(1.0);
+    expGen.setRng( getRng() );
     
     // G1. initialize
-    static double p = NATURAL_E/(alpha_+NATURAL_E);
-    static double pByE = 1.0/(alpha_+NATURAL_E);
+    double p = NATURAL_E/(alpha_+NATURAL_E);
+    double pByE = 1.0/(alpha_+NATURAL_E);
     double uniformU;
     double expSample;
     double xValue = 0.0;
@@ -119,7 +120,7 @@ double Gamma::gammaSmall() const // 0 < alpha < 1
     while ( true )
     {
         // G2. generate G deviate
-        uniformU = mtrand();
+        uniformU = uniform();
         expSample = expGen.getNextSample();
         while (expSample == 0 )
         {
@@ -24,7 +24,6 @@
 #include <iostream>
 using namespace std;
 
-extern unsigned long genrand_int32(void);
 Normal::Normal(double mean, double variance, NormalGenerator method):mean_(mean), variance_(variance), method_(method)
 {
     if (variance <= 0.0 )
@@ -61,7 +60,7 @@ double dummy()
 double Normal::getNextSample() const
 {
     double sd = sqrt(variance_);
-    double sample = generator_();
+    double sample = generator_(*this);
     if (!isStandard_)
     {
         sample = mean_ + sd*sample;
@@ -127,7 +126,8 @@ void Normal::setMethod(NormalGenerator method)
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_randist.h>
 
-double Normal::gslZiggurat()
+// Uses the GSL generator rather than the one set by setRng.
+double Normal::gslZiggurat(const Normal& n)
 {
     static const gsl_rng_type * T;
     static gsl_rng * r;
@@ -150,14 +150,14 @@ double Normal::gslZiggurat()
 /**
    Very simple but costly implementation
 */
-double Normal::BoxMueller()
+double Normal::BoxMueller(const Normal& n)
 {
     double result;    
     double a, b, r;
     do
     {
-        a = 2.0 * mtrand() - 1.0;
-        b = 2.0 * mtrand() - 1.0;
+        a = 2.0 * n.uniform() - 1.0;
+        b = 2.0 * n.uniform() - 1.0;
         r = a * a + b * b;
     } while ( r >= 1.0 );
     r = sqrt( - 2.0 * log(r) / r );
@@ -196,7 +196,7 @@ const double d = 1.861970434352886050;
  * Need to make sure that this is not due to 32/64 bit incompatibility. 
  */
 /*********************************************************************************************************************************/
-double Normal::aliasMethod()
+double Normal::aliasMethod(const Normal& n)
 {
     double result;
     
@@ -212,7 +212,7 @@ double Normal::aliasMethod()
     {
         
         // 1) u = .B1..B7 (base 256) - we take the little endian approach
-        uniform = genrand_int32(); // .B1B2B3B4 - limited by precision
+        uniform = n.randInt(); // .B1B2B3B4 - limited by precision
     
         // 1a) s = B1[0]    
         sgn = uniform  & 0x80000000UL;
@@ -266,7 +266,7 @@ double Normal::aliasMethod()
             }
     
             // 9) u' = .B1'..B7' .. using B1-B4 for precision limitation
-            uniform_prime = genrand_int32();
+            uniform_prime = n.randInt();
             // 9a) t = x*x/2
             t_num = x_num*(x_num/2);
     
@@ -290,7 +290,7 @@ double Normal::aliasMethod()
         }        
     
         // 11) u = .B1..B7
-        uniform = genrand_int32();
+        uniform = n.randInt();
     
         // 11a) u < 1/9? goto 1
         if ( uniform/4294967296.0 < 1.0/9.0)
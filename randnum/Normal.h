@@ -41,12 +41,12 @@ class Normal : public Probability
   private:
     double mean_;
     double variance_;
-    double (*generator_)();
+    double (*generator_)(const Normal&);
     bool isStandard_;
     NormalGenerator method_;
-    static double BoxMueller();
-    static double aliasMethod();
-    static double gslZiggurat();
+    static double BoxMueller(const Normal& n);
+    static double aliasMethod(const Normal& n);
+    static double gslZiggurat(const Normal& n);
     static bool testAcceptance(unsigned long t, unsigned long v);    
 };
 
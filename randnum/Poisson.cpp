@@ -53,6 +53,7 @@ Poisson::Poisson(double mean):mean_(mean), gammaGen_(NULL), binomialGen_(NULL),
             delete gammaGen_;
         }
         gammaGen_ = new Gamma(mValue_, 1.0);
+        gammaGen_->setRng( getRng() );
     }
 }
 
@@ -86,6 +87,7 @@ void Poisson::setMean(double mean)
             delete gammaGen_;
         }
         gammaGen_ = new Gamma(mValue_, 1.0);
+        gammaGen_->setRng( getRng() );
     }
 }
 
@@ -99,6 +101,15 @@ double Poisson::getVariance() const
     return mean_;
 }
 
+void Poisson::setRng( CounterRng* rng )
+{
+    Probability::setRng( rng );
+    if ( gammaGen_ )
+    {
+        gammaGen_->setRng( rng );
+    }
+}
+
 double Poisson::getNextSample() const
 {
     if (!generator_)
@@ -120,7 +131,7 @@ double Poisson::poissonSmall(const Poisson& poisson)
     int i = 0;
     while ( product > poisson.mValue_ )
     {
-        product *= mtrand();
+        product *= poisson.uniform();
         ++i;        
     }
     return i;
@@ -163,9 +174,11 @@ double Poisson::poissonLarge(const Poisson& poisson)
     if (xValue < poisson.mean_)
     {
         Poisson poissonGen(poisson.mean_ - xValue);
+        poissonGen.setRng( poisson.getRng() );
         return poisson.mValue_ + poissonGen.getNextSample();
     }
     Binomial binomialGen((long)poisson.mValue_ - 1, poisson.mean_/xValue);
+    binomialGen.setRng( poisson.getRng() );
     return binomialGen.getNextSample();
 }
 
@@ -38,6 +38,7 @@ class Poisson:public Probability
     double getMean() const;
     double getVariance() const;
     double getNextSample() const;
+    void setRng( CounterRng* rng );
   private:
     double mean_;
     static double poissonSmall(const Poisson&);
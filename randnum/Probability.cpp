@@ -19,6 +19,26 @@
 #define _PROBABILITY_CPP
 #include "Probability.h"
 
+Probability::Probability()
+    : rng_( 0 )
+{;}
+
+void Probability::fill( double* x, unsigned int n ) const
+{
+    for ( unsigned int i = 0; i < n; ++i )
+        x[i] = getNextSample();
+}
+
+void Probability::setRng( CounterRng* rng )
+{
+    rng_ = rng;
+}
+
+CounterRng* Probability::getRng() const
+{
+    return rng_;
+}
+
 //const Cinfo* initProbabilityCinfo
 // TODO: implement some tests for generated distributions
 // Kolmogorov-Smirnov test in particular
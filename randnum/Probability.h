@@ -19,20 +19,55 @@
 #ifndef _PROBABILITY_H
 #define _PROBABILITY_H
 
+#include "randnum.h"
+#include "CounterRng.h"
 
 /**
    Base class for implementing various probability distributions.
+
+   Samples are built from the global Mersenne Twister behind mtrand(),
+   unless a CounterRng has been set with setRng. Each thread or object
+   can then draw from its own stream, and gets the same samples however
+   the work is shared out.
  */
 class Probability
 {
   public:
+    Probability();
     virtual ~Probability(){};
     
     virtual double getMean() const =0;
     virtual double getVariance()const =0;
     virtual double getNextSample()const =0;
-    
+
+    /**
+       Fills x with the next n samples. Distributions which can do
+       better than one getNextSample call per sample override this.
+     */
+    virtual void fill( double* x, unsigned int n ) const;
+
+    /**
+       Draw the underlying uniform numbers from rng, which is not owned
+       by this object. NULL goes back to the global mtrand.
+     */
+    virtual void setRng( CounterRng* rng );
+    CounterRng* getRng() const;
+
+  protected:
+    /// Uniform number on [0,1) from the selected generator.
+    double uniform() const
+    {
+        return rng_ ? rng_->uniform() : mtrand();
+    }
+
+    /// Random 32-bit integer from the selected generator.
+    unsigned long randInt() const
+    {
+        return rng_ ? rng_->randInt() : genrand_int32();
+    }
+
   private:
+    CounterRng* rng_;
 //     long double mean_; // TODO : do we really need this?
 //     long double variance_;// TODO : do we really need this?    
 };
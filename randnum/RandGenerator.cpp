@@ -70,11 +70,21 @@ const Cinfo * RandGenerator::initCinfo()
         "variance",
         "Variance of the distribution.",
         &RandGenerator::getVariance);
+    static ValueFinfo< RandGenerator, long > seed(
+        "seed",
+        "Seed for a stream of random numbers private to this object."
+        " Each entry of an array draws from its own stream, which is"
+        " restarted on reinit, so the samples do not depend on the"
+        " other random numbers used in the simulation. The default of 0"
+        " uses the global generator seeded by moose.seed.",
+        &RandGenerator::setSeed,
+        &RandGenerator::getSeed);
 
     static Finfo * randGeneratorFinfos[] = {
         &sample,
         &mean,
         &variance,
+        &seed,
         output(),
         &proc,
     };
@@ -107,6 +117,7 @@ RandGenerator::RandGenerator()
 {
     sample_ = 0.0;
     rng_ = NULL;    
+    seed_ = 0;
 }
 
 RandGenerator::~RandGenerator()
@@ -141,9 +152,22 @@ double RandGenerator::getSample() const
     return sample_;
 }
 
+void RandGenerator::setSeed( long seed )
+{
+    seed_ = seed;
+}
+
+long RandGenerator::getSeed() const
+{
+    return seed_;
+}
+
 void RandGenerator::process( const Eref& e, ProcPtr p )
 {
     if (rng_){
+        // Pointed to here rather than in reinit, as the stream moves
+        // with this object if its array is resized.
+        rng_->setRng( seed_ ? &stream_ : NULL );
         sample_ = rng_->getNextSample();
         output()->send(e, sample_);
     }
@@ -151,6 +175,7 @@ void RandGenerator::process( const Eref& e, ProcPtr p )
 
 void RandGenerator::reinit(const Eref& e, ProcPtr p)
 {
+    stream_.setSeed( seed_, e.dataIndex() );
     vReinit(e, p);    
 }
 
@@ -34,6 +34,8 @@ class RandGenerator
     double getMean() const;    
     double getVariance() const;
     double getSample() const;
+    void setSeed( long seed );
+    long getSeed() const;
     void process( const Eref& e, ProcPtr info);
     void reinit( const Eref& e, ProcPtr info);
     virtual void vReinit( const Eref& e, ProcPtr info);
@@ -42,6 +44,10 @@ class RandGenerator
   protected:
     Probability* rng_;
     double sample_;
+  private:
+    /// Seed of this object's own stream, or 0 to use the global mtrand.
+    long seed_;
+    CounterRng stream_;
 };
 
     
@@ -72,7 +72,21 @@ void Uniform::setMax(double max)
 double Uniform::getNextSample() const
 {
     assert( max_ > min_ );
-    return mtrand()*(max_-min_)+min_;
+    return uniform()*(max_-min_)+min_;
+}
+
+void Uniform::fill( double* x, unsigned int n ) const
+{
+    assert( max_ > min_ );
+    CounterRng* rng = getRng();
+    if ( !rng ) {
+        Probability::fill( x, n );
+        return;
+    }
+    rng->fill( x, n );
+    double range = max_ - min_;
+    for ( unsigned int i = 0; i < n; ++i )
+        x[i] = x[i] * range + min_;
 }
 
 #ifdef DO_UNIT_TESTS
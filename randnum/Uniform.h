@@ -28,6 +28,7 @@ class Uniform: public Probability
     double getMean() const;
     double getVariance() const;
     double getNextSample() const;
+    void fill( double* x, unsigned int n ) const;
     double getMin() const;
     double getMax() const;
     void setMin(double min);
@@ -50,6 +50,8 @@
 
 #include "header.h"
 #include "Clock.h"
+#include "../shell/Shell.h"
+#include "../mpi/PostMaster.h"
 
 // Declaration of some static variables.
 const unsigned int Clock::numTicks = 32;
@@ -190,6 +192,24 @@ const Cinfo* Clock::initCinfo()
 			&Clock::getTickDt
 		);
 
+		static ValueFinfo< Clock, unsigned int > numThreads(
+			"numThreads",
+			"Number of threads used to run the process calls of a tick. "
+			"Default is 1, in which case all targets are called in turn "
+			"on the main thread. If more than one, the targets of each "
+			"tick are divided among the threads, but only if every "
+			"target is of a class that declares that it is safe to run "
+			"concurrently, and the object passes the class's check. At "
+			"present these are Ksolves and Gsolves that have neither a "
+			"Dsolve nor cross-compartment reactions, and HSolve entries "
+			"whose cells send no Vm, Ca or spikes out, since those fetch "
+			"or send data to other objects during process. Other ticks "
+			"run as usual. "
+			"All targets of a tick complete before the next tick starts.",
+			&Clock::setNumThreads,
+			&Clock::getNumThreads
+		);
+
 		static ReadOnlyLookupValueFinfo< Clock, string, unsigned int > defaultTick(
 			"defaultTick",
 			"Looks up the default Tick to use for the specified class. "
@@ -254,6 +274,7 @@ const Cinfo* Clock::initCinfo()
 		&isRunning,			// ReadOnlyValue
 		&tickStep,			// LookupValue
 		&tickDt,			// LookupValue
+		&numThreads,		// Value
 		&defaultTick,		// ReadOnlyLookupValue
 		&clockControl,		// Shared
 		finished(),			// Src
@@ -353,6 +374,7 @@ const Cinfo* Clock::initCinfo()
 		"	IntFire				2		50e-6\n"
 		"	IntFireBase			2		50e-6\n"
 		"	LIF				2		50e-6\n"
+		"	LIFSolver			2		50e-6\n"
 		"	QIF				2		50e-6\n"
 		"	ExIF				2		50e-6\n"
 		"	AdExIF				2		50e-6\n"
@@ -442,7 +464,10 @@ Clock::Clock()
 	  isRunning_( false ),
 	  doingReinit_( false ),
 	  info_(),
-	  ticks_( Clock::numTicks, 0 )
+	  ticks_( Clock::numTicks, 0 ),
+	  currTick_( 0 ),
+	  threadPool_( 1 ),
+	  numThreadedTicks_( 0 )
 {
 	buildDefaultTick();
 	dt_ = defaultDt_[0];
@@ -507,6 +532,25 @@ unsigned int Clock::getStride() const
 	return stride_;
 }
 
+void Clock::setNumThreads( unsigned int num )
+{
+	if ( isRunning_ ) {
+		cout << "Warning: Clock::setNumThreads: Cannot change numThreads while simulation is running\n";
+		return;
+	}
+	threadPool_.setNumThreads( num );
+}
+
+unsigned int Clock::getNumThreads() const
+{
+	return threadPool_.getNumThreads();
+}
+
+unsigned long Clock::getNumThreadedTicks() const
+{
+	return numThreadedTicks_;
+}
+
 vector< double > Clock::getDts() const
 {
 	vector< double > ret;
@@ -644,6 +688,85 @@ void Clock::buildTicks( const Eref& e )
 		}
 	}
 	// Should really do the HCF of N numbers here to get the stride.
+	buildTickTargets( e );
+	buildRemoteInputTicks( e );
+}
+
+/**
+ * Expands the process message of each active tick into its individual
+ * targets, so that they can be split among threads. A tick is left to
+ * the regular serial send if any target has not declared through its
+ * Cinfo that it is safe to run concurrently, or if it has too few 
+ * targets to be worth it.
+ */
+void Clock::buildTickTargets( const Eref& e )
+{
+	tickTargets_.clear();
+	tickTargets_.resize( activeTicksMap_.size() );
+	if ( threadPool_.getNumThreads() <= 1 )
+		return;
+	for ( unsigned int i = 0; i < activeTicksMap_.size(); ++i ) {
+		vector< ProcTarget >& tt = tickTargets_[i];
+		const vector< MsgDigest >& md = 
+			e.msgDigest( processVec()[ activeTicksMap_[i] ]->getBindIndex() );
+		bool ok = true;
+		for ( vector< MsgDigest >::const_iterator 
+				j = md.begin(); ok && j != md.end(); ++j ) {
+			ProcTarget pt;
+			pt.func = dynamic_cast< const OpFunc1Base< ProcPtr >* >( j->func );
+			ok = ( pt.func != 0 );
+			for ( vector< Eref >::const_iterator 
+				k = j->targets.begin(); ok && k != j->targets.end(); ++k ) {
+				pt.elm = k->element();
+				const Cinfo* cinfo = pt.elm->cinfo();
+				if ( k->dataIndex() == ALLDATA ) {
+					unsigned int start = pt.elm->localDataStart();
+					unsigned int end = start + pt.elm->numLocalData();
+					for ( unsigned int q = start; ok && q < end; ++q ) {
+						pt.dataIndex = q;
+						ok = cinfo->isConcurrent( Eref( pt.elm, q ) );
+						tt.push_back( pt );
+					}
+				} else {
+					pt.dataIndex = k->dataIndex();
+					ok = cinfo->isConcurrent( *k );
+					tt.push_back( pt );
+				}
+			}
+		}
+		if ( !ok || tt.size() < 2 )
+			tt.clear();
+	}
+}
+
+void Clock::buildRemoteInputTicks( const Eref& e )
+{
+	tickNeedsRemote_.assign( activeTicksMap_.size(), false );
+	if ( Shell::numNodes() == 1 )
+		return;
+	for ( unsigned int i = 0; i < activeTicksMap_.size(); ++i ) {
+		const vector< MsgDigest >& md = 
+			e.msgDigest( processVec()[ activeTicksMap_[i] ]->getBindIndex() );
+		for ( vector< MsgDigest >::const_iterator 
+			j = md.begin(); !tickNeedsRemote_[i] && j != md.end(); ++j ) {
+			for ( vector< Eref >::const_iterator k = j->targets.begin();
+					k != j->targets.end(); ++k ) {
+				if ( PostMaster::hasRemoteInput( k->element() ) ) {
+					tickNeedsRemote_[i] = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+// Static function
+void Clock::processTargets( void* arg, unsigned int begin, unsigned int end )
+{
+	Clock* c = reinterpret_cast< Clock* >( arg );
+	const vector< ProcTarget >& tt = c->tickTargets_[ c->currTick_ ];
+	for ( unsigned int i = begin; i < end; ++i )
+		tt[i].func->op( Eref( tt[i].elm, tt[i].dataIndex ), &c->info_ );
 }
 
 /**
@@ -671,6 +794,10 @@ void Clock::handleStep( const Eref& e, unsigned long numSteps )
 	assert( activeTicks_.size() == activeTicksMap_.size() );
 	nSteps_ += numSteps;
 	runTime_ = nSteps_ * dt_;
+	info_.runTime = runTime_;
+	PostMaster* pm = 0;
+	if ( Shell::numNodes() > 1 )
+		pm = reinterpret_cast< PostMaster* >( ObjId( 3 ).data() );
 	for ( isRunning_ = true;
 		isRunning_ && currentStep_ < nSteps_; currentStep_ += stride_ )
 	{
@@ -682,11 +809,24 @@ void Clock::handleStep( const Eref& e, unsigned long numSteps )
 			activeTicks_.begin(); j != activeTicks_.end(); ++j ) {
 			if ( endStep % *j == 0 ) {
 				info_.dt = *j * dt_;
-				processVec()[*k]->send( e, &info_ );
+				currTick_ = j - activeTicks_.begin();
+				// Ticks ahead of this one overlap with any split-phase
+				// exchange started by the PostMaster on the last step.
+				if ( pm && tickNeedsRemote_[ currTick_ ] )
+					pm->completeExchange();
+				const vector< ProcTarget >& tt = tickTargets_[ currTick_ ];
+				if ( tt.size() > 0 ) {
+					threadPool_.process( tt.size(), 
+									&Clock::processTargets, this );
+					++numThreadedTicks_;
+				} else
+					processVec()[*k]->send( e, &info_ );
 			}
 			++k;
 		}
 	}
+	if ( pm )
+		pm->completeExchange();
 	info_.dt = dt_;
 	isRunning_ = false;
 	finished()->send( e );
@@ -704,10 +844,12 @@ void Clock::handleReinit( const Eref& e )
 	currentTime_ = 0.0;
 	currentStep_ = 0;
 	nSteps_ = 0;
+	numThreadedTicks_ = 0;
 	buildTicks( e );
 	doingReinit_ = true;
 	// Curr time is end of current step.
 	info_.currTime = 0.0;
+	info_.runTime = 0.0;
 	vector< unsigned int >::const_iterator k = activeTicksMap_.begin();
 	for ( vector< unsigned int>::iterator j = 
 		activeTicks_.begin(); j != activeTicks_.end(); ++j ) {
@@ -778,6 +920,7 @@ void Clock::buildDefaultTick()
 	defaultTick_["IntFire"] = 2;
 	defaultTick_["IntFireBase"] = 2;
 	defaultTick_["LIF"] = 2;
+	defaultTick_["LIFSolver"] = 2;
 	defaultTick_["QIF"] = 2;
 	defaultTick_["ExIF"] = 2;
 	defaultTick_["AdExIF"] = 2;
@@ -874,6 +1017,12 @@ void Clock::buildDefaultTick()
 	defaultTick_["ZombieBufPool"] = ~0U;
 	defaultTick_["ZombieCaConc"] = ~0U;
 	defaultTick_["ZombieCompartment"] = ~0U;
+	defaultTick_["ZombieLIF"] = ~0U;
+	defaultTick_["ZombieExIF"] = ~0U;
+	defaultTick_["ZombieAdExIF"] = ~0U;
+	defaultTick_["ZombieQIF"] = ~0U;
+	defaultTick_["ZombieAdThreshIF"] = ~0U;
+	defaultTick_["ZombieIzhIF"] = ~0U;
 	defaultTick_["ZombieEnz"] = ~0U;
 	// defaultTick_["ZombieFuncPool"] = ~0U;
 	defaultTick_["ZombieHHChannel"] = ~0U;
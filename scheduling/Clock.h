@@ -10,6 +10,8 @@
 #ifndef _CLOCK_H
 #define _CLOCK_H
 
+#include "../utility/ThreadPool.h"
+
 /**
  * Clock now uses integral scheduling. The Clock has an array of child
  * Ticks, each of which controls the process and reinit calls of its 
@@ -20,6 +22,11 @@
  * of execution of target objects is undefined.
  *
  * The Reinit call goes through all Ticks in order.
+ *
+ * If numThreads > 1, the process calls for a Tick whose targets are all
+ * of classes that opt in through their Cinfo (see Cinfo::isConcurrent) are split
+ * among a pool of threads. All targets of a Tick complete before the
+ * next Tick is called.
  */
 
 class Clock
@@ -44,6 +51,13 @@ class Clock
 		unsigned int getTickStep( unsigned int i ) const;
 		void setTickDt( unsigned int i, double v );
 		double getTickDt( unsigned int i ) const;
+		void setNumThreads( unsigned int num );
+		unsigned int getNumThreads() const;
+		/**
+		 * Number of tick calls since the last reinit that were split
+		 * among threads. Used to check that the threaded path ran.
+		 */
+		unsigned long getNumThreadedTicks() const;
 		unsigned int getDefaultTick( string className ) const;
 
 		vector< double > getDts() const;
@@ -108,6 +122,13 @@ class Clock
 		/// Builds the default scheduling map of classes to ticks.
 		static void buildDefaultTick();
 
+		/**
+		 * Work function for the ThreadPool: calls process on targets
+		 * [begin, end) of the current Tick. arg is the Clock.
+		 */
+		static void processTargets( void* arg, 
+						unsigned int begin, unsigned int end );
+
 		/*
 		 * Does nasty message traversal to look up the clock tick that
 		 * sends the Process/reinit message to the Dsolve (specified by e)
@@ -122,6 +143,25 @@ class Clock
 
 	private:
 		void buildTicks( const Eref& e );
+
+		/**
+		 * Fills in tickTargets_ for the active ticks that can be 
+		 * dispatched to multiple threads.
+		 */
+		void buildTickTargets( const Eref& e );
+
+		/**
+		 * Fills in tickNeedsRemote_, by checking each target of the
+		 * active ticks with PostMaster::hasRemoteInput.
+		 */
+		void buildRemoteInputTicks( const Eref& e );
+
+		/// A single target of a Tick's process message.
+		struct ProcTarget {
+			const OpFunc1Base< ProcPtr >* func;
+			Element* elm;
+			unsigned int dataIndex;
+		};
 		double runTime_;
 		double currentTime_;
 		unsigned long nSteps_;
@@ -162,6 +202,29 @@ class Clock
 		 */
 		vector< unsigned int > activeTicksMap_;
 
+		/**
+		 * Expanded list of process targets for each active tick, used
+		 * when the tick is dispatched to multiple threads. Empty for
+		 * ticks that are to be sent serially.
+		 */
+		vector< vector< ProcTarget > > tickTargets_;
+
+		/**
+		 * Flag for each active tick: true if a split-phase exchange
+		 * by the PostMaster has to complete before the tick is
+		 * processed, as some of its targets take input from other nodes.
+		 */
+		vector< bool > tickNeedsRemote_;
+
+		/// Index into tickTargets_ for the tick currently being processed.
+		unsigned int currTick_;
+
+		/// Threads used to process the targets of a tick.
+		ThreadPool threadPool_;
+
+		/// Count of tick calls dispatched to threadPool_ since reinit.
+		unsigned long numThreadedTicks_;
+
 		/**
 		 * This is the database of default scheduling. Assigns
 		 * classes to ticks. Filled in at Clock creation time.
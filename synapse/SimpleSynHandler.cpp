@@ -21,7 +21,8 @@ const Cinfo* SimpleSynHandler::initCinfo()
 		"Author", "Upi Bhalla",
 		"Description", 
 		"The SimpleSynHandler handles simple synapses without plasticity. "
-		"It uses a priority queue to manage them."
+		"It keeps pending spikes in a ring of timestep bins, so it "
+		"scales to large numbers of synapses."
 	};
 
 	static FieldElementFinfo< SynHandlerBase, Synapse > synFinfo( 
@@ -53,6 +54,144 @@ const Cinfo* SimpleSynHandler::initCinfo()
 
 static const Cinfo* synHandlerCinfo = SimpleSynHandler::initCinfo();
 
+///////////////////////////////////////////////////////////////////////
+// SynEventBuffer
+///////////////////////////////////////////////////////////////////////
+
+static bool synEventEarlier( const SynEvent& lhs, const SynEvent& rhs )
+{
+	return lhs.time < rhs.time;
+}
+
+SynEventBuffer::SynEventBuffer()
+	: dt_( 1.0 ), firstBin_( 0 ), numEvents_( 0 ), bins_( 16 )
+{;}
+
+void SynEventBuffer::reinit( double dt )
+{
+	assert( dt > 0.0 );
+	dt_ = dt;
+	clear();
+}
+
+void SynEventBuffer::clear()
+{
+	// The bins hold on to their storage.
+	for ( vector< vector< SynEvent > >::iterator 
+					i = bins_.begin(); i != bins_.end(); ++i )
+		i->clear();
+	due_.clear();
+	firstBin_ = 0;
+	numEvents_ = 0;
+}
+
+unsigned int SynEventBuffer::size() const
+{
+	return numEvents_;
+}
+
+unsigned long SynEventBuffer::binIndex( double t ) const
+{
+	if ( t <= 0.0 )
+		return 0;
+	return static_cast< unsigned long >( t / dt_ );
+}
+
+void SynEventBuffer::insert( const SynEvent& ev )
+{
+	unsigned long bin = binIndex( ev.time );
+	// Late events go into the earliest bin, so they are delivered on the
+	// next step.
+	if ( bin < firstBin_ )
+		bin = firstBin_;
+	assert( bin - firstBin_ < bins_.size() );
+	bins_[ bin & ( bins_.size() - 1 ) ].push_back( ev );
+}
+
+void SynEventBuffer::addEvent( double time, double weight )
+{
+	unsigned long bin = binIndex( time );
+	if ( bin >= firstBin_ + bins_.size() )
+		grow( bin );
+	insert( SynEvent( time, weight ) );
+	++numEvents_;
+}
+
+void SynEventBuffer::grow( unsigned long lastBin )
+{
+	unsigned int numBins = bins_.size();
+	while ( lastBin >= firstBin_ + numBins )
+		numBins *= 2;
+	rebin( numBins );
+}
+
+void SynEventBuffer::rebin( unsigned int numBins )
+{
+	vector< vector< SynEvent > > old( numBins );
+	old.swap( bins_ );
+	for ( vector< vector< SynEvent > >::const_iterator 
+					i = old.begin(); i != old.end(); ++i )
+		for ( vector< SynEvent >::const_iterator 
+						j = i->begin(); j != i->end(); ++j )
+			insert( *j );
+}
+
+const vector< SynEvent >& SynEventBuffer::popDue( double currTime, double dt )
+{
+	due_.clear();
+	if ( dt != dt_ ) {
+		// Work out the span of the pending events in the new bins.
+		double lastTime = 0.0;
+		for ( vector< vector< SynEvent > >::const_iterator 
+						i = bins_.begin(); i != bins_.end(); ++i )
+			for ( vector< SynEvent >::const_iterator 
+							j = i->begin(); j != i->end(); ++j )
+				if ( j->time > lastTime )
+					lastTime = j->time;
+		dt_ = dt;
+		firstBin_ = binIndex( currTime );
+		unsigned int numBins = 16;
+		while ( binIndex( lastTime ) >= firstBin_ + numBins )
+			numBins *= 2;
+		rebin( numBins );
+	}
+
+	unsigned long currBin = binIndex( currTime );
+	unsigned int mask = bins_.size() - 1;
+	if ( numEvents_ > 0 ) {
+		// Events in the bin after currBin may also be due if currTime
+		// has rounding error. Each slot of the ring is scanned only once.
+		unsigned long lastBin = currBin + 1;
+		if ( lastBin >= firstBin_ + bins_.size() )
+			lastBin = firstBin_ + bins_.size() - 1;
+		for ( unsigned long b = firstBin_; b <= lastBin; ++b ) {
+			vector< SynEvent >& bin = bins_[ b & mask ];
+			unsigned int k = 0;
+			for ( unsigned int j = 0; j < bin.size(); ++j ) {
+				if ( bin[j].time <= currTime )
+					due_.push_back( bin[j] );
+				else
+					bin[k++] = bin[j];
+			}
+			bin.resize( k );
+		}
+		numEvents_ -= due_.size();
+		if ( due_.size() > 1 )
+			sort( due_.begin(), due_.end(), synEventEarlier );
+	}
+
+	// Advance over the empty bins, up to the current one.
+	if ( numEvents_ == 0 ) {
+		if ( firstBin_ < currBin )
+			firstBin_ = currBin;
+	} else {
+		while ( firstBin_ < currBin && bins_[ firstBin_ & mask ].empty() )
+			++firstBin_;
+	}
+
+	return due_;
+}
+
 SimpleSynHandler::SimpleSynHandler()
 { ; }
 
@@ -66,9 +205,7 @@ SimpleSynHandler& SimpleSynHandler::operator=( const SimpleSynHandler& ssh)
 					i = synapses_.begin(); i != synapses_.end(); ++i )
 			i->setHandler( this );
 
-	// For no apparent reason, priority queues don't have a clear operation.
-	while( !events_.empty() )
-		events_.pop();
+	events_.clear();
 
 	return *this;
 }
@@ -100,21 +237,22 @@ void SimpleSynHandler::addSpike(
 				unsigned int index, double time, double weight )
 {
 	assert( index < synapses_.size() );
-	events_.push( SynEvent( time, weight ) );
+	events_.addEvent( time, weight );
 }
 
 void SimpleSynHandler::vProcess( const Eref& e, ProcPtr p ) 
 {
 	double activation = 0.0;
-	while( !events_.empty() && events_.top().time <= p->currTime ) {
+	const vector< SynEvent >& due = events_.popDue( p->currTime, p->dt );
+	for ( vector< SynEvent >::const_iterator 
+					i = due.begin(); i != due.end(); ++i ) {
         // Send out weight / dt for every spike
         //      Since it is an impulse active only for one dt,
         //      need to send it divided by dt.
         // Can connect activation to SynChan (double exp)
         //      or to LIF as an impulse to voltage.
         // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-		activation += events_.top().weight / p->dt;
-		events_.pop();
+		activation += i->weight / p->dt;
 	}
 	if ( activation != 0.0 )
 		SynHandlerBase::activationOut()->send( e, activation );
@@ -122,9 +260,7 @@ void SimpleSynHandler::vProcess( const Eref& e, ProcPtr p )
 
 void SimpleSynHandler::vReinit( const Eref& e, ProcPtr p ) 
 {
-	// For no apparent reason, priority queues don't have a clear operation.
-	while( !events_.empty() )
-		events_.pop();
+	events_.reinit( p->dt );
 }
 
 unsigned int SimpleSynHandler::addSynapse()
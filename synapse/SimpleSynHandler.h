@@ -36,9 +36,70 @@ struct CompareSynEvent
 };
 
 /**
- * This handles simple synapses without plasticity. It uses a priority
- * queue to manage them. This gets inefficient for large numbers of 
- * synapses but is pretty robust.
+ * SynEventBuffer is a calendar queue for incoming spike events. The events
+ * are kept in a ring of bins, one bin per timestep dt, so adding an event
+ * and collecting the events that are due take constant time rather than
+ * the log( n ) of a priority queue. The ring grows to span the longest
+ * pending delay. The bins keep their storage from step to step, so once
+ * the ring has warmed up no further allocation is done.
+ * Each event keeps its own time, and is delivered at the first step where
+ * it is at or before currTime, exactly as it would be from a priority
+ * queue. Events that are due together are returned in order of time.
+ */
+class SynEventBuffer
+{
+	public:
+		SynEventBuffer();
+
+		/// Empties the buffer, and sets the bin width to dt.
+		void reinit( double dt );
+
+		/// Empties the buffer, keeping the bin width.
+		void clear();
+
+		void addEvent( double time, double weight );
+
+		/**
+		 * Removes all the events at or before currTime, and returns them
+		 * sorted by time. The returned vector is reused by the next call.
+		 * If dt differs from the bin width the events are rebinned.
+		 */
+		const vector< SynEvent >& popDue( double currTime, double dt );
+
+		/// Number of pending events.
+		unsigned int size() const;
+
+	private:
+		/// Returns the index of the bin for time t.
+		unsigned long binIndex( double t ) const;
+
+		/// Puts the event into its bin, with no check on the ring size.
+		void insert( const SynEvent& ev );
+
+		/// Enlarges the ring so that it reaches the specified bin.
+		void grow( unsigned long lastBin );
+
+		/// Moves all events into a ring of the specified size.
+		void rebin( unsigned int numBins );
+
+		double dt_;
+
+		/// Index of the earliest bin that may hold events.
+		unsigned long firstBin_;
+
+		unsigned int numEvents_;
+
+		/// Ring of bins. Its size is a power of 2, so bin i is at i & mask.
+		vector< vector< SynEvent > > bins_;
+
+		/// Events returned by popDue.
+		vector< SynEvent > due_;
+};
+
+/**
+ * This handles simple synapses without plasticity. It uses a
+ * SynEventBuffer to manage the pending spikes, so that it scales to
+ * large numbers of synapses.
  */
 class SimpleSynHandler: public SynHandlerBase
 {
@@ -63,7 +124,7 @@ class SimpleSynHandler: public SynHandlerBase
 		static const Cinfo* initCinfo();
 	private:
 		vector< Synapse > synapses_;
-		priority_queue< SynEvent, vector< SynEvent >, CompareSynEvent > events_;
+		SynEventBuffer events_;
 };
 
 #endif // _SIMPLE_SYN_HANDLER_H
@@ -18,9 +18,70 @@
 #include "../randnum/randnum.h"
 
 
+/**
+ * Checks that the SynEventBuffer delivers the same events at the same
+ * steps, in the same order, as the priority queue it replaces.
+ */
+void testSynEventBuffer()
+{
+	const double dt = 1e-4;
+	SynEventBuffer buf;
+	priority_queue< SynEvent, vector< SynEvent >, CompareSynEvent > ref;
+	buf.reinit( dt );
+	unsigned int numDelivered = 0;
+	for ( unsigned int step = 0; step < 2000; ++step ) {
+		double currTime = step * dt;
+		if ( step == 1000 ) { // Change dt partway, without a reinit.
+			for ( unsigned int i = 0; i < 100; ++i ) {
+				double t = currTime + mtrand() * 0.05;
+				buf.addEvent( t, 1.0 );
+				ref.push( SynEvent( t, 1.0 ) );
+			}
+		}
+		double stepDt = step < 1000 ? dt : dt * 0.5;
+		if ( step >= 1000 )
+			currTime = 1000 * dt + ( step - 1000 ) * stepDt;
+		// Mostly short delays, some long ones that make the ring grow,
+		// and some that are already late.
+		unsigned int n = mtrand() * 20;
+		for ( unsigned int i = 0; i < n; ++i ) {
+			double r = mtrand();
+			double t = currTime + mtrand() * ( r < 0.1 ? 0.2 : 0.005 );
+			if ( r > 0.95 )
+				t = currTime - mtrand() * 0.001;
+			double w = mtrand();
+			buf.addEvent( t, w );
+			ref.push( SynEvent( t, w ) );
+		}
+		const vector< SynEvent >& due = buf.popDue( currTime, stepDt );
+		double x = 0.0;
+		double y = 0.0;
+		unsigned int k = 0;
+		while ( !ref.empty() && ref.top().time <= currTime ) {
+			assert( k < due.size() );
+			assert( due[k].time == ref.top().time );
+			x += ref.top().weight / stepDt;
+			y += due[k].weight / stepDt;
+			ref.pop();
+			++k;
+		}
+		assert( k == due.size() );
+		assert( x == y );
+		assert( buf.size() == ref.size() );
+		numDelivered += k;
+	}
+	assert( numDelivered > 10000 );
+
+	buf.reinit( dt );
+	assert( buf.size() == 0 );
+	assert( buf.popDue( 1.0, dt ).size() == 0 );
+	cout << "." << flush;
+}
+
 // This tests stuff without using the messaging.
 void testSynapse()
 {
+	testSynEventBuffer();
 }
 
 // This is applicable to tests that use the messaging and scheduling.
@@ -300,6 +300,69 @@ class TestFieldAccess(unittest.TestCase):
 #         x = moose.element('%s/kinetics' % (self.model.path))
 #         self.assertTrue(len(x.meshToSpace) > 0)
         
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+@unittest.skipIf(np is None, 'NumPy is not available')
+class TestNumpyFields(unittest.TestCase):
+    """Numeric fields across a vec, and vector fields, as NumPy arrays"""
+    def setUp(self):
+        self.pools = moose.vec('/testNumpyFields%d' % (uuid.uuid4().int), n=5, g=0, dtype='Pool')
+        self.table = moose.Table('/testNumpyFieldsTable%d' % (uuid.uuid4().int))
+
+    def testVecRoundTrip(self):
+        values = np.linspace(0.5, 2.5, 5)
+        self.pools.nInit = values
+        got = self.pools.nInit
+        self.assertTrue(isinstance(got, np.ndarray))
+        self.assertEqual(got.dtype, np.float64)
+        self.assertTrue(np.array_equal(got, values))
+
+    def testVecDtype(self):
+        self.pools.speciesId = np.arange(5, dtype=np.uint32)
+        got = self.pools.speciesId
+        self.assertEqual(got.dtype, np.uintc)
+        self.assertTrue(np.array_equal(got, np.arange(5)))
+
+    def testVecNonContiguous(self):
+        values = np.arange(10.0)[::2]
+        self.assertFalse(values.flags['C_CONTIGUOUS'])
+        self.pools.nInit = values
+        self.assertTrue(np.array_equal(self.pools.nInit, values))
+        self.pools.speciesId = np.arange(15)[::3]
+        self.assertTrue(np.array_equal(self.pools.speciesId, np.arange(15)[::3]))
+
+    def testVecLossyCast(self):
+        self.pools.speciesId = np.arange(5.0) # Exact, so allowed.
+        self.assertTrue(np.array_equal(self.pools.speciesId, np.arange(5)))
+        with self.assertRaises(TypeError):
+            self.pools.speciesId = np.arange(5.0) + 0.5
+        with self.assertRaises(TypeError):
+            self.pools.speciesId = np.arange(5) - 1
+        self.assertTrue(np.array_equal(self.pools.speciesId, np.arange(5)))
+
+    def testVecLengthMismatch(self):
+        with self.assertRaises(IndexError):
+            self.pools.nInit = np.arange(4.0)
+
+    def testVectorFieldRoundTrip(self):
+        values = np.random.rand(7)
+        self.table.vector = values
+        got = self.table.vector
+        self.assertTrue(isinstance(got, np.ndarray))
+        self.assertTrue(np.array_equal(got, values))
+        self.table.vector = values[::-2]
+        got = self.table.vector
+        self.assertTrue(np.array_equal(got, values[::-2]))
+        got[0] = -1.0 # The array owns its data, not a view of the table.
+        self.assertTrue(np.array_equal(self.table.vector, values[::-2]))
+
+    def testVectorFieldEmpty(self):
+        self.table.vector = np.zeros(0)
+        self.assertEqual(len(self.table.vector), 0)
+
 if __name__ == '__main__':
     print 'PyMOOSE Regression Tests:'
     unittest.main()
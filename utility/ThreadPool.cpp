@@ -0,0 +1,156 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <cassert>
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool( unsigned int numThreads )
+	:
+		numThreads_( numThreads < 1 ? 1 : numThreads ),
+		generation_( 0 ),
+		pending_( 0 ),
+		quit_( false ),
+		func_( 0 ),
+		arg_( 0 ),
+		numItems_( 0 )
+{;}
+
+ThreadPool::ThreadPool( const ThreadPool& other )
+	:
+		numThreads_( other.numThreads_ ),
+		generation_( 0 ),
+		pending_( 0 ),
+		quit_( false ),
+		func_( 0 ),
+		arg_( 0 ),
+		numItems_( 0 )
+{;}
+
+ThreadPool::~ThreadPool()
+{
+	stopWorkers();
+}
+
+ThreadPool& ThreadPool::operator=( const ThreadPool& other )
+{
+	if ( this != &other )
+		setNumThreads( other.numThreads_ );
+	return *this;
+}
+
+void ThreadPool::setNumThreads( unsigned int num )
+{
+	if ( num < 1 )
+		num = 1;
+	if ( num == numThreads_ )
+		return;
+	stopWorkers();
+	numThreads_ = num;
+}
+
+unsigned int ThreadPool::getNumThreads() const
+{
+	return numThreads_;
+}
+
+unsigned int ThreadPool::blockStart( unsigned int thread,
+	unsigned int numItems, unsigned int numThreads )
+{
+	// Spread the remainder over the first few blocks.
+	unsigned int blockSize = numItems / numThreads;
+	unsigned int remainder = numItems % numThreads;
+	if ( thread < remainder )
+		return thread * ( blockSize + 1 );
+	return remainder * ( blockSize + 1 ) + ( thread - remainder ) * blockSize;
+}
+
+void ThreadPool::process( unsigned int numItems, BlockFunc func, void* arg )
+{
+	if ( numItems == 0 )
+		return;
+	if ( numThreads_ <= 1 || numItems == 1 ) {
+		func( arg, 0, numItems );
+		return;
+	}
+	startWorkers();
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		func_ = func;
+		arg_ = arg;
+		numItems_ = numItems;
+		pending_ = workers_.size();
+		++generation_;
+	}
+	startCond_.notify_all();
+
+	// The calling thread handles block 0.
+	func( arg, 0, blockStart( 1, numItems, numThreads_ ) );
+
+	std::unique_lock< std::mutex > lock( mutex_ );
+	while ( pending_ > 0 )
+		doneCond_.wait( lock );
+}
+
+void ThreadPool::workerLoop( unsigned int thread )
+{
+	unsigned long lastGeneration = 0;
+	while ( true ) {
+		BlockFunc func;
+		void* arg;
+		unsigned int numItems;
+		{
+			std::unique_lock< std::mutex > lock( mutex_ );
+			while ( !quit_ && generation_ == lastGeneration )
+				startCond_.wait( lock );
+			if ( quit_ )
+				return;
+			lastGeneration = generation_;
+			func = func_;
+			arg = arg_;
+			numItems = numItems_;
+		}
+		unsigned int begin = blockStart( thread, numItems, numThreads_ );
+		unsigned int end = blockStart( thread + 1, numItems, numThreads_ );
+		if ( begin < end )
+			func( arg, begin, end );
+		{
+			std::lock_guard< std::mutex > lock( mutex_ );
+			assert( pending_ > 0 );
+			--pending_;
+			if ( pending_ == 0 )
+				doneCond_.notify_one();
+		}
+	}
+}
+
+void ThreadPool::startWorkers()
+{
+	if ( workers_.size() + 1 == numThreads_ )
+		return;
+	stopWorkers();
+	quit_ = false;
+	generation_ = 0;
+	workers_.reserve( numThreads_ - 1 );
+	for ( unsigned int i = 1; i < numThreads_; ++i )
+		workers_.push_back( std::thread( &ThreadPool::workerLoop, this, i ) );
+}
+
+void ThreadPool::stopWorkers()
+{
+	if ( workers_.size() == 0 )
+		return;
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		quit_ = true;
+	}
+	startCond_.notify_all();
+	for ( unsigned int i = 0; i < workers_.size(); ++i )
+		workers_[i].join();
+	workers_.clear();
+}
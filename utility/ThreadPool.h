@@ -0,0 +1,96 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2015 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * ThreadPool is a small set of persistent worker threads used by the
+ * solvers to split up independent work, such as the voxels of a Ksolve,
+ * within a single process call.
+ * The calling thread does the first block of work itself, and returns
+ * only when all the blocks are done, so each call to process() acts
+ * as a barrier.
+ * Work is always divided into the same contiguous blocks for a given
+ * number of items and threads, so that results do not depend on
+ * thread scheduling.
+ * Copying a ThreadPool copies only the thread count: the copy starts
+ * its own workers when it is first used.
+ */
+class ThreadPool
+{
+	public:
+		/**
+		 * Signature of the work function. It is called on the half-open
+		 * range [begin, end) of item indices, with the argument passed
+		 * into process().
+		 */
+		typedef void ( *BlockFunc )( void* arg,
+			unsigned int begin, unsigned int end );
+
+		ThreadPool( unsigned int numThreads = 1 );
+		ThreadPool( const ThreadPool& other );
+		~ThreadPool();
+		ThreadPool& operator=( const ThreadPool& other );
+
+		/**
+		 * Assigns the number of threads, including the calling thread.
+		 * Values of 0 or 1 mean that everything runs serially on the
+		 * calling thread. Existing workers are shut down.
+		 */
+		void setNumThreads( unsigned int num );
+		unsigned int getNumThreads() const;
+
+		/**
+		 * Splits the range [0, numItems) into contiguous blocks, one per
+		 * thread, and calls func on each block. Returns when all blocks
+		 * are complete.
+		 */
+		void process( unsigned int numItems, BlockFunc func, void* arg );
+
+		/**
+		 * Utility function: returns the start of the block handled by
+		 * the specified thread when numItems are divided among
+		 * numThreads. The end is blockStart( thread + 1, ... ).
+		 */
+		static unsigned int blockStart( unsigned int thread,
+			unsigned int numItems, unsigned int numThreads );
+
+	private:
+		/// Loop run by each worker thread.
+		void workerLoop( unsigned int thread );
+		/// Creates the worker threads if they are not already running.
+		void startWorkers();
+		/// Stops and joins all the worker threads.
+		void stopWorkers();
+
+		unsigned int numThreads_;
+		std::vector< std::thread > workers_;
+		std::mutex mutex_;
+		std::condition_variable startCond_;
+		std::condition_variable doneCond_;
+
+		/// Incremented for each call to process(), wakes the workers.
+		unsigned long generation_;
+		/// Number of workers yet to finish the current generation.
+		unsigned int pending_;
+		bool quit_;
+
+		/// Current job.
+		BlockFunc func_;
+		void* arg_;
+		unsigned int numItems_;
+};
+
+#endif // _THREAD_POOL_H